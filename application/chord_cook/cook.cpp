@@ -0,0 +1,523 @@
+#include "cook.h"
+#include "corpus.h"
+
+#include <utils/log.h>
+#include <utils/cvar.h>
+#include <utils/job_system.h>
+#include <utils/profiler.h>
+#include <project.h>
+#include <application/application.h>
+
+#include <charconv>
+
+#include <asset/cook_stats.h>
+#include <asset/asset_pack.h>
+#include <asset/asset_prefetch.h>
+#include <asset/asset.h>
+#include <asset/texture/asset_texture.h>
+#include <asset/texture/asset_texture_helper.h>
+#include <asset/gltf/asset_gltf.h>
+#include <asset/gltf/asset_gltf_helper.h>
+#include <asset/pmx/asset_pmx_importer.h>
+
+namespace chord::cook
+{
+	enum class EItemType
+	{
+		Texture,
+		GLTF,
+
+		// No pmx asset type yet, only parse to validate source.
+		PMX,
+	};
+
+	struct CookItem
+	{
+		EItemType type;
+		std::filesystem::path srcPath;
+		std::filesystem::path storePath;
+
+		bool bSucceed = false;
+		double seconds = 0.0;
+	};
+
+	static std::string toLower(std::string value)
+	{
+		std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c) { return (char)std::tolower(c); });
+		return value;
+	}
+
+	// Asset type meta extension list like "jpg,jpeg;png", no period.
+	static bool isExtensionMatch(const std::string& extensionList, const std::filesystem::path& path)
+	{
+		std::string ext = toLower(path.extension().string());
+		if (ext.empty())
+		{
+			return false;
+		}
+		ext = ext.substr(1);
+
+		size_t start = 0;
+		while (start <= extensionList.size())
+		{
+			size_t end = extensionList.find_first_of(",;", start);
+			end = (end == std::string::npos) ? extensionList.size() : end;
+
+			if (extensionList.compare(start, end - start, ext) == 0)
+			{
+				return true;
+			}
+			start = end + 1;
+		}
+		return false;
+	}
+
+	static bool getItemType(const std::filesystem::path& path, EItemType& outType)
+	{
+		if (isExtensionMatch(TextureAsset::kAssetTypeMeta.importConfig.rawDataExtension, path))
+		{
+			outType = EItemType::Texture;
+			return true;
+		}
+		if (isExtensionMatch(GLTFAsset::kAssetTypeMeta.importConfig.rawDataExtension, path))
+		{
+			outType = EItemType::GLTF;
+			return true;
+		}
+		if (isExtensionMatch("pmx", path))
+		{
+			outType = EItemType::PMX;
+			return true;
+		}
+		return false;
+	}
+
+	static bool parseFloat(const std::string& value, float& outValue)
+	{
+		const auto result = std::from_chars(value.data(), value.data() + value.size(), outValue);
+		return result.ec == std::errc() && result.ptr == value.data() + value.size();
+	}
+
+	static bool parseTextureFormat(const std::string& name, ETextureFormat& outFormat)
+	{
+		for (uint32 i = 0; i < uint32(ETextureFormat::MAX); i++)
+		{
+			if (nameof::nameof_enum(ETextureFormat(i)) == name)
+			{
+				outFormat = ETextureFormat(i);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	static bool parseMeshletPartitioner(const std::string& name, EMeshletPartitioner& outPartitioner)
+	{
+		for (uint32 i = 0; i < uint32(EMeshletPartitioner::MAX); i++)
+		{
+			if (nameof::nameof_enum(EMeshletPartitioner(i)) == name)
+			{
+				outPartitioner = EMeshletPartitioner(i);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	void printUsage()
+	{
+		LOG_INFO("Usage: chord_cook <project file> [options] <file or folder>...");
+		LOG_INFO("  --out <folder>         Store folder relative to project asset folder, default 'Cooked'.");
+		LOG_INFO("  --srgb                 Texture is encoded in srgb color space.");
+		LOG_INFO("  --mipmap               Generate texture mipmap.");
+		LOG_INFO("  --alpha-cutoff <value> Texture alpha coverage mipmap cutoff, default 0.5.");
+		LOG_INFO("  --format <name>        Texture format, ETextureFormat name, default R8G8B8A8.");
+		LOG_INFO("  --smooth-normal        GLTF generate smooth normal.");
+		LOG_INFO("  --no-fuse              GLTF no fuse close vertices.");
+		LOG_INFO("  --fuse-ignore-normal   GLTF fuse vertices without normal consider.");
+		LOG_INFO("  --cone-weight <value>  GLTF meshlet cone weight, default 0.7.");
+		LOG_INFO("  --partitioner <name>   GLTF meshlet grouping partitioner, Metis or Spatial, default Metis.");
+		LOG_INFO("  --cvar <name>=<value>  Console variable override, e.g. --cvar r.ddc=0.");
+		LOG_INFO("  --corpus <folder>      Generate procedural benchmark corpus into folder and cook it.");
+		LOG_INFO("  --corpus-scale <value> Corpus size scale, power of two, default 1.");
+		LOG_INFO("  --report <file>        Write cook result and stage timing json.");
+		LOG_INFO("  --pack                 Build project asset pack after cook, no input meaning pack only.");
+		LOG_INFO("  --pack-compress        Compress pack entries which lz4 can save size.");
+	}
+
+	bool parseCommandLine(int argc, const char** argv, CookOptions& outOptions)
+	{
+		std::vector<std::string> args(argv + 1, argv + argc);
+		if (args.empty())
+		{
+			return false;
+		}
+
+		outOptions.projectPath = utf8::utf8to16(args[0]);
+		for (size_t i = 1; i < args.size(); i++)
+		{
+			const std::string& arg = args[i];
+
+			// Option with value.
+			auto nextValue = [&](std::string& outValue) -> bool
+			{
+				if (i + 1 >= args.size())
+				{
+					LOG_ERROR("Option '{}' require a value.", arg);
+					return false;
+				}
+				outValue = args[++i];
+				return true;
+			};
+
+			std::string value;
+			if (arg == "--srgb") { outOptions.bSRGB = true; }
+			else if (arg == "--mipmap") { outOptions.bGenerateMipmap = true; }
+			else if (arg == "--smooth-normal") { outOptions.bGenerateSmoothNormal = true; }
+			else if (arg == "--no-fuse") { outOptions.bFuse = false; }
+			else if (arg == "--fuse-ignore-normal") { outOptions.bFuseIgnoreNormal = true; }
+			else if (arg == "--pack") { outOptions.bPack = true; }
+			else if (arg == "--pack-compress") { outOptions.bPackCompress = true; }
+			else if (arg == "--out")
+			{
+				if (!nextValue(value)) { return false; }
+				outOptions.outputFolder = utf8::utf8to16(value);
+			}
+			else if (arg == "--format")
+			{
+				if (!nextValue(value)) { return false; }
+				outOptions.textureFormat = value;
+			}
+			else if (arg == "--alpha-cutoff")
+			{
+				if (!nextValue(value) || !parseFloat(value, outOptions.alphaMipmapCutoff)) { return false; }
+			}
+			else if (arg == "--cone-weight")
+			{
+				if (!nextValue(value) || !parseFloat(value, outOptions.meshletConeWeight)) { return false; }
+			}
+			else if (arg == "--partitioner")
+			{
+				if (!nextValue(value)) { return false; }
+				outOptions.meshletPartitioner = value;
+			}
+			else if (arg == "--cvar")
+			{
+				if (!nextValue(value)) { return false; }
+				outOptions.cvars.push_back(value);
+			}
+			else if (arg == "--corpus")
+			{
+				if (!nextValue(value)) { return false; }
+				outOptions.corpusFolder = utf8::utf8to16(value);
+			}
+			else if (arg == "--corpus-scale")
+			{
+				if (!nextValue(value)) { return false; }
+				const auto result = std::from_chars(value.data(), value.data() + value.size(), outOptions.corpusScale);
+				if (result.ec != std::errc() || result.ptr != value.data() + value.size()) { return false; }
+			}
+			else if (arg == "--report")
+			{
+				if (!nextValue(value)) { return false; }
+				outOptions.reportPath = utf8::utf8to16(value);
+			}
+			else if (arg.starts_with("--"))
+			{
+				LOG_ERROR("Unknown option '{}'.", arg);
+				return false;
+			}
+			else
+			{
+				outOptions.inputs.push_back(utf8::utf8to16(arg));
+			}
+		}
+
+		return !outOptions.inputs.empty() || !outOptions.corpusFolder.empty() || outOptions.bPack;
+	}
+
+	static bool applyCVars(const std::vector<std::string>& cvars)
+	{
+		// Cooker write per import report by default, --cvar r.asset.import.report=0 can still disable it.
+		CVarSystem::get().getCVarCheck<uint32>("r.asset.import.report")->set(1);
+
+		for (const auto& cvar : cvars)
+		{
+			const size_t pos = cvar.find('=');
+			if (pos == std::string::npos || !CVarSystem::get().setValueIfExistGeneric(cvar.substr(0, pos), cvar.substr(pos + 1)))
+			{
+				LOG_ERROR("Invalid console variable override '{}'.", cvar);
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// Expand folders and assign unique store path for every item.
+	static bool collectItems(const CookOptions& options, const std::vector<std::filesystem::path>& inputs, std::vector<CookItem>& outItems)
+	{
+		std::vector<std::filesystem::path> files;
+		for (const auto& input : inputs)
+		{
+			std::error_code ec;
+			if (std::filesystem::is_directory(input, ec))
+			{
+				for (const auto& entry : std::filesystem::recursive_directory_iterator(input, ec))
+				{
+					EItemType type;
+					if (entry.is_regular_file(ec) && getItemType(entry.path(), type))
+					{
+						files.push_back(entry.path());
+					}
+				}
+			}
+			else if (std::filesystem::is_regular_file(input, ec))
+			{
+				files.push_back(input);
+			}
+			else
+			{
+				LOG_ERROR("Input '{}' no exist.", utf8::utf16to8(input.u16string()));
+				return false;
+			}
+		}
+
+		// Stable order, report and store path no depend on directory iterate order.
+		std::sort(files.begin(), files.end());
+
+		const auto storeFolder = std::filesystem::path(Project::get().getPath().assetPath.u16()) / options.outputFolder;
+		std::filesystem::create_directories(storeFolder);
+
+		std::unordered_set<std::u16string> usedStorePaths;
+		for (const auto& file : files)
+		{
+			CookItem item { };
+			if (!getItemType(file, item.type))
+			{
+				LOG_ERROR("Input '{}' is not a supported source file.", utf8::utf16to8(file.u16string()));
+				return false;
+			}
+
+			item.srcPath = std::filesystem::absolute(file);
+
+			// Items cook in parallel, so resolve name conflict here instead of in import.
+			std::filesystem::path storePath = buildStillNonExistPath(storeFolder / file.stem());
+			for (uint32 index = 1; usedStorePaths.contains(storePath.u16string()); index++)
+			{
+				storePath = buildStillNonExistPath(storeFolder / std::format("{}_{}", file.stem().string(), index));
+			}
+			usedStorePaths.insert(storePath.u16string());
+
+			item.storePath = storePath;
+			outItems.push_back(std::move(item));
+		}
+
+		return true;
+	}
+
+	static bool cookItem(const CookItem& item, const CookOptions& options, ETextureFormat textureFormat, EMeshletPartitioner meshletPartitioner)
+	{
+		switch (item.type)
+		{
+		case EItemType::Texture:
+		{
+			auto config = std::static_pointer_cast<TextureAssetImportConfig>(TextureAsset::kAssetTypeMeta.importConfig.getAssetImportConfig());
+			config->importFilePath = item.srcPath;
+			config->storeFilePath = item.storePath;
+			config->bSRGB = options.bSRGB;
+			config->bGenerateMipmap = options.bGenerateMipmap;
+			config->alphaMipmapCutoff = options.alphaMipmapCutoff;
+			config->format = textureFormat;
+
+			return TextureAsset::kAssetTypeMeta.importConfig.importAssetFromConfig(config);
+		}
+		case EItemType::GLTF:
+		{
+			auto config = std::static_pointer_cast<GLTFAssetImportConfig>(GLTFAsset::kAssetTypeMeta.importConfig.getAssetImportConfig());
+			config->importFilePath = item.srcPath;
+			config->storeFilePath = item.storePath;
+			config->bGenerateSmoothNormal = options.bGenerateSmoothNormal;
+			config->bFuse = options.bFuse;
+			config->bFuseIgnoreNormal = options.bFuseIgnoreNormal;
+			config->meshletConeWeight = options.meshletConeWeight;
+			config->meshletPartitioner = meshletPartitioner;
+
+			return GLTFAsset::kAssetTypeMeta.importConfig.importAssetFromConfig(config);
+		}
+		case EItemType::PMX:
+		{
+			return cookstats::importWithReport("pmx", item.srcPath, item.storePath, nullptr, [&](cookstats::Report* report)
+			{
+				cookstats::ScopedStage stage("pmx.parse", report);
+
+				pmx::PMXRawData model { };
+				return pmx::importPMX(model, item.srcPath);
+			});
+		}
+		default:
+			checkEntry();
+		}
+		return false;
+	}
+
+	static void report(const std::vector<CookItem>& items, double totalSeconds, const std::filesystem::path& reportPath)
+	{
+		uint32 failedCount = 0;
+
+		LOG_INFO("| Result | Seconds  | Source");
+		for (const auto& item : items)
+		{
+			LOG_INFO("| {:<6} | {:>8.3f} | {}", item.bSucceed ? "ok" : "failed", item.seconds, utf8::utf16to8(item.srcPath.u16string()));
+			failedCount += item.bSucceed ? 0 : 1;
+		}
+
+		// Stage time accumulate across threads, so sum can be larger than wall time.
+		const auto stages = cookstats::collect();
+		LOG_INFO("| Stage                | Count  | Seconds  | Average ms | MB       |");
+		for (const auto& [name, stage] : stages)
+		{
+			LOG_INFO("| {:<20} | {:>6} | {:>8.3f} | {:>10.3f} | {:>8.1f} |", name, stage.count, stage.seconds, stage.seconds * 1000.0 / double(stage.count), double(stage.bytes) / (1024.0 * 1024.0));
+		}
+
+		const auto memory = getProcessMemoryInfo();
+		LOG_INFO("Cook {} files in {:.3f} seconds, {} succeed, {} failed, peak resident {} MB.", 
+			items.size(), totalSeconds, items.size() - failedCount, failedCount, memory.peakResidentBytes / (1024 * 1024));
+
+		if (reportPath.empty())
+		{
+			return;
+		}
+
+		// Stable keys and order, diff two reports to catch stage regression.
+		nlohmann::json json;
+		json["seconds"] = totalSeconds;
+		json["peakResidentBytes"] = memory.peakResidentBytes;
+
+		auto& itemsJson = json["items"];
+		itemsJson = nlohmann::json::array();
+		for (const auto& item : items)
+		{
+			itemsJson.push_back({ { "source", utf8::utf16to8(item.srcPath.u16string()) }, { "succeed", item.bSucceed }, { "seconds", item.seconds } });
+		}
+
+		auto& stagesJson = json["stages"];
+		stagesJson = nlohmann::json::object();
+		for (const auto& [name, stage] : stages)
+		{
+			stagesJson[name] = { { "count", stage.count }, { "seconds", stage.seconds }, { "bytes", stage.bytes } };
+		}
+
+		std::ofstream os(reportPath, std::ios::trunc);
+		os << json.dump(4);
+		if (!os.good())
+		{
+			LOG_ERROR("Fail to write cook report {}.", utf8::utf16to8(reportPath.u16string()));
+		}
+	}
+
+	// Pack store bins as is, so rewrite legacy lz4 cereal bins of project to current format first.
+	static bool upgradeLegacyBinaries()
+	{
+		const std::filesystem::path cacheFolder = Project::get().getPath().cachePath.u16();
+		const auto& assetManager = Application::get().getAssetManager();
+
+		bool bResult = true;
+		for (const auto& path : assetManager.getClassifiedAssetPaths(GLTFAsset::kAssetTypeMeta.suffix))
+		{
+			bResult &= GLTFBinary::upgradeLegacy(cacheFolder / AssetSaveInfo::buildRelativeAsset(path).getBinCachePath());
+		}
+		for (const auto& path : assetManager.getClassifiedAssetPaths(TextureAsset::kAssetTypeMeta.suffix))
+		{
+			bResult &= TextureAssetBin::upgradeLegacy(cacheFolder / AssetSaveInfo::buildRelativeAsset(path).getBinCachePath());
+		}
+		return bResult;
+	}
+
+	int32 run(const CookOptions& options)
+	{
+		if (!applyCVars(options.cvars))
+		{
+			return kExitInvalidArgument;
+		}
+
+		ETextureFormat textureFormat;
+		if (!parseTextureFormat(options.textureFormat, textureFormat))
+		{
+			LOG_ERROR("Unknown texture format '{}'.", options.textureFormat);
+			return kExitInvalidArgument;
+		}
+
+		EMeshletPartitioner meshletPartitioner;
+		if (!parseMeshletPartitioner(options.meshletPartitioner, meshletPartitioner))
+		{
+			LOG_ERROR("Unknown meshlet partitioner '{}'.", options.meshletPartitioner);
+			return kExitInvalidArgument;
+		}
+
+		const auto begin = std::chrono::high_resolution_clock::now();
+
+		Project::get().setup(options.projectPath);
+
+		// Cook read and write loose files, stale pack must not shadow them. Pack rebuild at end when required.
+		assetpack::unmountAll();
+
+		std::vector<std::filesystem::path> inputs = options.inputs;
+		if (!options.corpusFolder.empty() && !corpus::generate(options.corpusFolder, options.corpusScale, inputs))
+		{
+			return kExitCookFailed;
+		}
+
+		std::vector<CookItem> items;
+		if (!collectItems(options, inputs, items))
+		{
+			return kExitInvalidArgument;
+		}
+
+		struct CookContext
+		{
+			const CookOptions* options;
+			ETextureFormat textureFormat;
+			EMeshletPartitioner meshletPartitioner;
+		};
+		const CookContext context { &options, textureFormat, meshletPartitioner };
+
+		cookstats::reset();
+		FutureCollection futures;
+		for (auto& item : items)
+		{
+			futures.add(jobsystem::launch("CookAsset", EJobFlags::Foreground, [&item, &context]()
+			{
+				ZoneScopedN("CookAsset");
+				const auto itemBegin = std::chrono::high_resolution_clock::now();
+
+				item.bSucceed = cookItem(item, *context.options, context.textureFormat, context.meshletPartitioner);
+				item.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - itemBegin).count();
+
+				if (!item.bSucceed)
+				{
+					LOG_ERROR("Cook '{}' failed.", utf8::utf16to8(item.srcPath.u16string()));
+				}
+			}));
+		}
+		futures.wait(EBusyWaitType::All);
+
+		report(items, std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count(), options.reportPath);
+
+		const bool bAllSucceed = std::all_of(items.begin(), items.end(), [](const CookItem& item) { return item.bSucceed; });
+		if (!bAllSucceed)
+		{
+			return kExitCookFailed;
+		}
+
+		if (options.bPack && !upgradeLegacyBinaries())
+		{
+			return kExitCookFailed;
+		}
+
+		if (options.bPack && !assetpack::buildProjectPack(assetpack::getProjectPackPath(), assetprefetch::collectProjectLoadOrder(), options.bPackCompress))
+		{
+			return kExitCookFailed;
+		}
+		return kExitSucceed;
+	}
+}
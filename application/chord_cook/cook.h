@@ -0,0 +1,58 @@
+#pragma once
+
+#include <utils/utils.h>
+
+namespace chord::cook
+{
+	constexpr int32 kExitSucceed = 0;
+	constexpr int32 kExitCookFailed = 1;
+	constexpr int32 kExitInvalidArgument = 2;
+
+	struct CookOptions
+	{
+		// Project file, create if no exist.
+		std::filesystem::path projectPath;
+
+		// Store folder relative to project asset folder.
+		std::filesystem::path outputFolder = "Cooked";
+
+		// Source files or folders, folder cook all supported files recursively.
+		std::vector<std::filesystem::path> inputs;
+
+		// Texture import config.
+		bool bSRGB = false;
+		bool bGenerateMipmap = false;
+		float alphaMipmapCutoff = 0.5f;
+		std::string textureFormat = "R8G8B8A8";
+
+		// GLTF import config.
+		bool bGenerateSmoothNormal = false;
+		bool bFuse = true;
+		bool bFuseIgnoreNormal = false;
+		float meshletConeWeight = 0.7f;
+		std::string meshletPartitioner = "Metis";
+
+		// Console variable override, "name=value".
+		std::vector<std::string> cvars;
+
+		// Generate procedural benchmark corpus into folder and cook it with inputs, see corpus.h.
+		std::filesystem::path corpusFolder;
+		uint32 corpusScale = 1;
+
+		// Json of item results, stage table and process memory, empty meaning no report.
+		std::filesystem::path reportPath;
+
+		// Build project asset pack after cook, inputs can be empty when only pack.
+		// Pack layout follow recorded scene load order first.
+		bool bPack = false;
+		bool bPackCompress = false;
+	};
+
+	extern void printUsage();
+
+	// Return false when argument invalid.
+	extern bool parseCommandLine(int argc, const char** argv, CookOptions& outOptions);
+
+	// Cook all inputs in parallel on job system, return process exit code.
+	extern int32 run(const CookOptions& options);
+}
@@ -0,0 +1,387 @@
+#include "corpus.h"
+
+#include <utils/log.h>
+
+namespace chord::cook::corpus
+{
+	constexpr uint32 kGLBMagic     = 0x46546C67; // "glTF"
+	constexpr uint32 kGLBVersion   = 2;
+	constexpr uint32 kGLBChunkJSON = 0x4E4F534A;
+	constexpr uint32 kGLBChunkBIN  = 0x004E4942;
+
+	constexpr int32 kComponentFloat  = 5126;
+	constexpr int32 kComponentUint32 = 5125;
+
+	constexpr int32 kTargetArrayBuffer        = 34962;
+	constexpr int32 kTargetElementArrayBuffer = 34963;
+
+	// Integer hash noise, no std distribution so output same on every platform.
+	static uint32 hashUint(uint32 x)
+	{
+		x ^= x >> 16;
+		x *= 0x7feb352d;
+		x ^= x >> 15;
+		x *= 0x846ca68b;
+		x ^= x >> 16;
+		return x;
+	}
+
+	static float latticeValue(int32 x, int32 y, uint32 seed)
+	{
+		return float(hashUint(uint32(x) * 73856093u ^ uint32(y) * 19349663u ^ seed) & 0xFFFF) / 65535.0f;
+	}
+
+	static float valueNoise(float x, float y, uint32 seed)
+	{
+		const int32 ix = int32(math::floor(x));
+		const int32 iy = int32(math::floor(y));
+		const float fx = math::smoothstep(0.0f, 1.0f, x - float(ix));
+		const float fy = math::smoothstep(0.0f, 1.0f, y - float(iy));
+
+		const float v0 = math::mix(latticeValue(ix, iy,     seed), latticeValue(ix + 1, iy,     seed), fx);
+		const float v1 = math::mix(latticeValue(ix, iy + 1, seed), latticeValue(ix + 1, iy + 1, seed), fx);
+		return math::mix(v0, v1, fy);
+	}
+
+	static float fbm(float x, float y, uint32 seed)
+	{
+		float sum = 0.0f;
+		float amplitude = 0.5f;
+		for (uint32 octave = 0; octave < 6; octave++)
+		{
+			sum += amplitude * valueNoise(x, y, seed + octave);
+			x *= 2.0f;
+			y *= 2.0f;
+			amplitude *= 0.5f;
+		}
+		return sum;
+	}
+
+	// 4x4 tiles, every tile one pattern.
+	static std::vector<uint8> buildAtlas(uint32 dim)
+	{
+		std::vector<uint8> pixels(uint64(dim) * dim * 4);
+		const uint32 tileDim = math::max(dim / 4, 1U);
+
+		for (uint32 y = 0; y < dim; y++)
+		{
+			for (uint32 x = 0; x < dim; x++)
+			{
+				const uint32 tile = (y / tileDim) * 4 + (x / tileDim);
+				const float u = float(x % tileDim) / float(tileDim);
+				const float v = float(y % tileDim) / float(tileDim);
+
+				math::vec4 color;
+				switch (tile % 4)
+				{
+				case 0:
+				{
+					const bool bChecker = ((x / 16) + (y / 16)) % 2 == 0;
+					color = bChecker ? math::vec4(0.9f, 0.9f, 0.9f, 1.0f) : math::vec4(0.1f, 0.1f, 0.1f, 1.0f);
+					break;
+				}
+				case 1:
+				{
+					color = math::vec4(u, v, 1.0f - u, 1.0f);
+					break;
+				}
+				case 2:
+				{
+					const float n = fbm(float(x) / 32.0f, float(y) / 32.0f, tile);
+					color = math::vec4(n, n * 0.8f, n * 0.6f, 1.0f);
+					break;
+				}
+				default:
+				{
+					// Alpha cutout leaves, exercise alpha coverage mipmap.
+					const float n = fbm(float(x) / 8.0f, float(y) / 8.0f, tile);
+					color = math::vec4(0.2f, 0.6f * n + 0.2f, 0.1f, n > 0.5f ? 1.0f : 0.0f);
+					break;
+				}
+				}
+
+				uint8* pixel = &pixels[(uint64(y) * dim + x) * 4];
+				for (uint32 c = 0; c < 4; c++)
+				{
+					pixel[c] = uint8(math::clamp(color[c], 0.0f, 1.0f) * 255.0f + 0.5f);
+				}
+			}
+		}
+		return pixels;
+	}
+
+	static std::vector<uint8> encodePNG(const std::vector<uint8>& pixels, uint32 dim)
+	{
+		std::vector<uint8> result;
+		stbi_write_png_to_func([](void* context, void* data, int size)
+		{
+			auto* out = (std::vector<uint8>*)context;
+			out->insert(out->end(), (const uint8*)data, (const uint8*)data + size);
+		}, &result, int32(dim), int32(dim), 4, pixels.data(), int32(dim * 4));
+		return result;
+	}
+
+	// Single buffer glb, views append into BIN chunk.
+	class GLBBuilder
+	{
+	public:
+		GLBBuilder()
+		{
+			m_json["asset"] = { { "version", "2.0" }, { "generator", "chord_cook corpus" } };
+			m_json["buffers"] = nlohmann::json::array();
+			m_json["bufferViews"] = nlohmann::json::array();
+			m_json["accessors"] = nlohmann::json::array();
+		}
+
+		nlohmann::json& json()
+		{
+			return m_json;
+		}
+
+		int32 addView(const void* data, uint64 size, int32 target)
+		{
+			m_bin.resize(alignRoundingUp<uint64>(m_bin.size(), 4), 0);
+
+			nlohmann::json view = { { "buffer", 0 }, { "byteOffset", m_bin.size() }, { "byteLength", size } };
+			if (target != 0)
+			{
+				view["target"] = target;
+			}
+
+			m_bin.insert(m_bin.end(), (const uint8*)data, (const uint8*)data + size);
+			m_json["bufferViews"].push_back(std::move(view));
+			return int32(m_json["bufferViews"].size() - 1);
+		}
+
+		template<typename T>
+		int32 addAccessor(const std::vector<T>& elements, int32 componentType, const char* type, int32 target)
+		{
+			nlohmann::json accessor =
+			{
+				{ "bufferView",    addView(elements.data(), elements.size() * sizeof(T), target) },
+				{ "componentType", componentType },
+				{ "count",         elements.size() },
+				{ "type",          type },
+			};
+
+			// Position accessor require bounds.
+			if constexpr (std::is_same_v<T, math::vec3>)
+			{
+				math::vec3 minPos(std::numeric_limits<float>::max());
+				math::vec3 maxPos(-std::numeric_limits<float>::max());
+				for (const auto& element : elements)
+				{
+					minPos = math::min(minPos, element);
+					maxPos = math::max(maxPos, element);
+				}
+				accessor["min"] = { minPos.x, minPos.y, minPos.z };
+				accessor["max"] = { maxPos.x, maxPos.y, maxPos.z };
+			}
+
+			m_json["accessors"].push_back(std::move(accessor));
+			return int32(m_json["accessors"].size() - 1);
+		}
+
+		bool save(const std::filesystem::path& path)
+		{
+			m_bin.resize(alignRoundingUp<uint64>(m_bin.size(), 4), 0);
+			m_json["buffers"] = nlohmann::json::array({ { { "byteLength", m_bin.size() } } });
+
+			std::string jsonChunk = m_json.dump();
+			jsonChunk.resize(alignRoundingUp<uint64>(jsonChunk.size(), 4), ' ');
+
+			const uint32 length = uint32(12 + 8 + jsonChunk.size() + 8 + m_bin.size());
+			const uint32 header[3] = { kGLBMagic, kGLBVersion, length };
+			const uint32 jsonChunkHeader[2] = { uint32(jsonChunk.size()), kGLBChunkJSON };
+			const uint32 binChunkHeader[2] = { uint32(m_bin.size()), kGLBChunkBIN };
+
+			std::ofstream os(path, std::ios::binary | std::ios::trunc);
+			os.write((const char*)header, sizeof(header));
+			os.write((const char*)jsonChunkHeader, sizeof(jsonChunkHeader));
+			os.write(jsonChunk.data(), jsonChunk.size());
+			os.write((const char*)binChunkHeader, sizeof(binChunkHeader));
+			os.write((const char*)m_bin.data(), m_bin.size());
+			return os.good();
+		}
+
+	private:
+		nlohmann::json m_json;
+		std::vector<uint8> m_bin;
+	};
+
+	// Grid of (segmentX + 1) * (segmentY + 1) vertices, two triangles per quad.
+	static std::vector<uint32> buildGridIndices(uint32 segmentX, uint32 segmentY)
+	{
+		std::vector<uint32> indices;
+		indices.reserve(uint64(segmentX) * segmentY * 6);
+
+		const uint32 rowSize = segmentX + 1;
+		for (uint32 y = 0; y < segmentY; y++)
+		{
+			for (uint32 x = 0; x < segmentX; x++)
+			{
+				const uint32 i0 = y * rowSize + x;
+				const uint32 i1 = i0 + 1;
+				const uint32 i2 = i0 + rowSize;
+				const uint32 i3 = i2 + 1;
+
+				indices.insert(indices.end(), { i0, i2, i1, i1, i2, i3 });
+			}
+		}
+		return indices;
+	}
+
+	static bool generateSphere(const std::filesystem::path& path, uint32 scale)
+	{
+		const uint32 segmentX = 256 * scale;
+		const uint32 segmentY = 128 * scale;
+
+		std::vector<math::vec3> positions;
+		std::vector<math::vec3> normals;
+		std::vector<math::vec2> uvs;
+		for (uint32 y = 0; y <= segmentY; y++)
+		{
+			for (uint32 x = 0; x <= segmentX; x++)
+			{
+				const float u = float(x) / float(segmentX);
+				const float v = float(y) / float(segmentY);
+				const float phi = u * math::two_pi<float>();
+				const float theta = v * math::pi<float>();
+
+				const math::vec3 normal(math::sin(theta) * math::cos(phi), math::cos(theta), math::sin(theta) * math::sin(phi));
+				positions.push_back(normal);
+				normals.push_back(normal);
+				uvs.push_back({ u * 4.0f, v * 2.0f });
+			}
+		}
+
+		GLBBuilder builder;
+		auto& json = builder.json();
+
+		const auto atlas = encodePNG(buildAtlas(1024 * scale), 1024 * scale);
+		json["images"] = { { { "bufferView", builder.addView(atlas.data(), atlas.size(), 0) }, { "mimeType", "image/png" }, { "name", "sphere_atlas" } } };
+		json["textures"] = { { { "source", 0 } } };
+		json["materials"] = { { { "name", "sphere" }, { "pbrMetallicRoughness", { { "baseColorTexture", { { "index", 0 } } } } } } };
+
+		nlohmann::json primitive =
+		{
+			{ "attributes",
+				{
+					{ "POSITION",   builder.addAccessor(positions, kComponentFloat, "VEC3", kTargetArrayBuffer) },
+					{ "NORMAL",     builder.addAccessor(normals,   kComponentFloat, "VEC3", kTargetArrayBuffer) },
+					{ "TEXCOORD_0", builder.addAccessor(uvs,       kComponentFloat, "VEC2", kTargetArrayBuffer) },
+				}
+			},
+			{ "indices", builder.addAccessor(buildGridIndices(segmentX, segmentY), kComponentUint32, "SCALAR", kTargetElementArrayBuffer) },
+			{ "material", 0 },
+			{ "mode", 4 },
+		};
+
+		json["meshes"] = { { { "name", "sphere" }, { "primitives", { primitive } } } };
+		json["nodes"] = { { { "name", "sphere" }, { "mesh", 0 } } };
+		json["scenes"] = { { { "nodes", { 0 } } } };
+		json["scene"] = 0;
+
+		return builder.save(path);
+	}
+
+	static bool generateTerrain(const std::filesystem::path& path, uint32 scale)
+	{
+		const uint32 segment = 512 * scale;
+		const float cellSize = 1.0f / float(segment);
+
+		auto height = [&](int32 x, int32 y)
+		{
+			return 0.2f * fbm(float(x) * 16.0f * cellSize, float(y) * 16.0f * cellSize, 0x7e77a1);
+		};
+
+		std::vector<math::vec3> positions;
+		std::vector<math::vec3> normals;
+		std::vector<math::vec2> uvs;
+		for (int32 y = 0; y <= int32(segment); y++)
+		{
+			for (int32 x = 0; x <= int32(segment); x++)
+			{
+				positions.push_back({ float(x) * cellSize, height(x, y), float(y) * cellSize });
+
+				// Central difference.
+				const float dx = height(x + 1, y) - height(x - 1, y);
+				const float dy = height(x, y + 1) - height(x, y - 1);
+				normals.push_back(math::normalize(math::vec3(-dx, 2.0f * cellSize, -dy)));
+
+				uvs.push_back({ float(x) * cellSize * 8.0f, float(y) * cellSize * 8.0f });
+			}
+		}
+
+		GLBBuilder builder;
+		auto& json = builder.json();
+
+		nlohmann::json primitive =
+		{
+			{ "attributes",
+				{
+					{ "POSITION",   builder.addAccessor(positions, kComponentFloat, "VEC3", kTargetArrayBuffer) },
+					{ "NORMAL",     builder.addAccessor(normals,   kComponentFloat, "VEC3", kTargetArrayBuffer) },
+					{ "TEXCOORD_0", builder.addAccessor(uvs,       kComponentFloat, "VEC2", kTargetArrayBuffer) },
+				}
+			},
+			{ "indices", builder.addAccessor(buildGridIndices(segment, segment), kComponentUint32, "SCALAR", kTargetElementArrayBuffer) },
+			{ "mode", 4 },
+		};
+
+		json["meshes"] = { { { "name", "terrain" }, { "primitives", { primitive } } } };
+		json["nodes"] = { { { "name", "terrain" }, { "mesh", 0 } } };
+		json["scenes"] = { { { "nodes", { 0 } } } };
+		json["scene"] = 0;
+
+		return builder.save(path);
+	}
+
+	static bool generateAtlas(const std::filesystem::path& path, uint32 scale)
+	{
+		const uint32 dim = 2048 * scale;
+		const auto pixels = buildAtlas(dim);
+		return stbi_write_png(path.string().c_str(), int32(dim), int32(dim), 4, pixels.data(), int32(dim * 4)) != 0;
+	}
+
+	bool generate(const std::filesystem::path& folder, uint32 scale, std::vector<std::filesystem::path>& outFiles)
+	{
+		if (scale == 0 || !isPOT(scale))
+		{
+			LOG_ERROR("Corpus scale {} must be power of two.", scale);
+			return false;
+		}
+
+		std::error_code ec;
+		std::filesystem::create_directories(folder, ec);
+
+		struct Generator
+		{
+			const char* name;
+			bool(*func)(const std::filesystem::path&, uint32);
+		};
+		const Generator generators[] =
+		{
+			{ "sphere.glb",  generateSphere  },
+			{ "terrain.glb", generateTerrain },
+			{ "atlas.png",   generateAtlas   },
+		};
+
+		for (const auto& generator : generators)
+		{
+			const auto path = folder / generator.name;
+			const auto begin = std::chrono::high_resolution_clock::now();
+			if (!generator.func(path, scale))
+			{
+				LOG_ERROR("Fail to generate corpus file {}.", utf8::utf16to8(path.u16string()));
+				return false;
+			}
+
+			LOG_INFO("Generate corpus file {} ({} KB) in {:.3f} s.", generator.name, std::filesystem::file_size(path, ec) / 1024,
+				std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count());
+			outFiles.push_back(path);
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <utils/utils.h>
+
+namespace chord::cook::corpus
+{
+	// Procedural import benchmark sources, same scale always generate same bytes.
+	//   sphere.glb  : uv sphere with embedded atlas texture, (256 * scale) x (128 * scale) quads.
+	//   terrain.glb : fbm noise height field without tangent, (512 * scale)^2 quads.
+	//   atlas.png   : 4x4 tiles of checker, gradient and noise, (2048 * scale)^2 pixels.
+	// Scale must be power of two so textures keep mipmap and block compression.
+	extern bool generate(const std::filesystem::path& folder, uint32 scale, std::vector<std::filesystem::path>& outFiles);
+}
@@ -0,0 +1,27 @@
+#include "cook.h"
+
+#include <application/application.h>
+#include <utils/log.h>
+
+int main(int argc, const char** argv)
+{
+	using namespace chord;
+
+	cook::CookOptions options { };
+	if (!cook::parseCommandLine(argc, argv, options))
+	{
+		cook::printUsage();
+		std::exit(cook::kExitInvalidArgument);
+	}
+
+	if (!Application::get().initHeadless("chord_cook"))
+	{
+		LOG_ERROR("Fail to init headless application.");
+		std::exit(cook::kExitCookFailed);
+	}
+
+	const int32 exitCode = cook::run(options);
+
+	Application::get().release();
+	std::exit(exitCode);
+}
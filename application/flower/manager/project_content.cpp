@@ -56,7 +56,7 @@ GPUTextureAssetRef ProjectContentEntry::computeSnapshotUV(ImVec2& outUv0, ImVec2
 			bool bSetFound = false;
 			if (path.extension().string().starts_with(".asset"))
 			{
-				if (auto asset = manager.getOrLoadAsset<IAsset>(path, true))
+				if (auto asset = manager.getOrLoadAsset<IAsset>(path))
 				{
 					result = asset->getSnapshotImage();
 
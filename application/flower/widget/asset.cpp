@@ -36,7 +36,7 @@ WidgetAssetConfig::WidgetAssetConfig(AssetConfigWidgetManager& manager, const st
 	, m_bRun(true)
 	, m_assetManager(Application::get().getAssetManager())
 {
-	m_asset = m_assetManager.getOrLoadAsset<IAsset>(path, true);
+	m_asset = m_assetManager.getOrLoadAsset<IAsset>(path);
 	m_name = buildRelativePath(Project::get().getPath().assetPath.u16(), path);
 }
 
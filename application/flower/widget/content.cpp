@@ -256,7 +256,24 @@ void WidgetContent::drawMenu(const chord::ApplicationTickData& tickData)
 
 		if (ImGui::Button((kIconContentSaveAll).c_str()))
 		{
+			// Scene save may need path dialog, other dirty assets (gltf, material, texture) write on job thread.
+			for (const auto& asset : Flower::get().getContentManager().getDirtyAsset<IAsset>())
+			{
+				if (std::dynamic_pointer_cast<Scene>(asset) || asset->isSaveInfoEmpty())
+				{
+					continue;
+				}
 
+				if (!asset->saveAsync())
+				{
+					LOG_ERROR("Fail to save asset {}.", utf8::utf16to8(asset->getStorePath().u16string()));
+				}
+			}
+
+			if (!Flower::get().getContentManager().getDirtyAsset<Scene>().empty())
+			{
+				Flower::get().getDockSpace().sceneAssetSave.open();
+			}
 		}
 		hoverTip("Save all assets.");
 		ImGui::TableNextColumn();
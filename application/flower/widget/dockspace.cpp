@@ -274,7 +274,7 @@ void SceneAssetSaveWidget::onDraw()
                     const AssetSaveInfo newInfo(u16str(assetNameUtf8), relativePath);
                     Application::get().getAssetManager().changeSaveInfo(newInfo, scene);
 
-                    if (!scene->save())
+                    if (!scene->saveAsync())
                     {
                         LOG_ERROR("Fail to save new created scene {0} in path {1}.", 
                             scene->getName().u8(), 
@@ -284,7 +284,7 @@ void SceneAssetSaveWidget::onDraw()
             }
             else
             {
-                if (!scene->save())
+                if (!scene->saveAsync())
                 {
                     LOG_ERROR("Fail to save edited scene {0} in path {1}.", 
                         scene->getName().u8(),
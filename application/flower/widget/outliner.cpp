@@ -415,7 +415,7 @@ void WidgetOutliner::acceptDragdrop(bool bRoot)
 				{
 					if (asset.extension() == ".assetgltf")
 					{
-						if (auto gltfRef = assetManager.getOrLoadAsset<GLTFAsset>(asset, true))
+						if (auto gltfRef = assetManager.getOrLoadAsset<GLTFAsset>(asset))
 						{
 							const auto& gltfScene  = gltfRef->getScene();
 							const auto& gltfNodes  = gltfRef->getNodes();
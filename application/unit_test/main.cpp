@@ -16,6 +16,16 @@ int main(int argc, const char** argv)
 		// future_mpsc_queue.wait();
 		// future_mpmc_queue.wait();
 		future_job_system.wait();
+
+		// Asset binary init job system too, so run after job system test.
+		chord::test::asset_binary::test();
+		chord::test::asset_registry::test();
+		chord::test::asset_pack::test();
+		chord::test::nanite_builder::test();
+		chord::test::compute_tangent::test();
+		chord::test::texture_mipmap::test();
+
+		chord::test::sharded_map::test();
 	}
 	catch (...)
 	{
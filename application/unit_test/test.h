@@ -5,6 +5,15 @@
 
 namespace chord::test
 {
+	// Wall time of func in seconds, shared by benchmark style tests.
+	template<typename Func>
+	inline double timeIt(Func&& func)
+	{
+		const auto begin = std::chrono::high_resolution_clock::now();
+		func();
+		return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+	}
+
 	namespace work_stealing_queue
 	{
 		void test();
@@ -24,4 +33,39 @@ namespace chord::test
 	{
 		void test();
 	}
+
+	namespace asset_binary
+	{
+		void test();
+	}
+
+	namespace asset_registry
+	{
+		void test();
+	}
+
+	namespace sharded_map
+	{
+		void test();
+	}
+
+	namespace asset_pack
+	{
+		void test();
+	}
+
+	namespace nanite_builder
+	{
+		void test();
+	}
+
+	namespace compute_tangent
+	{
+		void test();
+	}
+
+	namespace texture_mipmap
+	{
+		void test();
+	}
 }
\ No newline at end of file
@@ -0,0 +1,418 @@
+#include "test.h"
+
+#include <asset/asset_binary.h>
+#include <utils/job_system.h>
+#include <utils/cvar.h>
+#include <random>
+
+namespace chord::test::asset_binary
+{
+	// Ratio against compress and decompress throughput of all compression mode.
+	static void benchmark()
+	{
+		const auto savePath = std::filesystem::temp_directory_path() / "chord_benchmark_asset_binary.bin";
+		const uint64 schemaHash = assetbinary::buildSchemaHash({ { "positions", sizeof(math::vec3) }, { "indices", sizeof(uint32) } });
+
+		std::mt19937 rng(0);
+		std::uniform_real_distribution<float> noise(-0.01f, 0.01f);
+
+		// Grid mesh like data, 4M vertices.
+		constexpr uint32 kGridSize = 2048;
+		std::vector<math::vec3> positions(kGridSize * kGridSize);
+		for (uint32 y = 0; y < kGridSize; y++)
+		{
+			for (uint32 x = 0; x < kGridSize; x++)
+			{
+				positions[y * kGridSize + x] = math::vec3(float(x), noise(rng), float(y));
+			}
+		}
+
+		std::vector<uint32> indices;
+		indices.reserve((kGridSize - 1) * (kGridSize - 1) * 6);
+		for (uint32 y = 0; y < kGridSize - 1; y++)
+		{
+			for (uint32 x = 0; x < kGridSize - 1; x++)
+			{
+				const uint32 i0 = y * kGridSize + x;
+				const uint32 i1 = i0 + kGridSize;
+				indices.insert(indices.end(), { i0, i1, i0 + 1, i0 + 1, i1, i1 + 1 });
+			}
+		}
+
+		AssetBinaryWriter writer;
+		writer.addSection(positions);
+		writer.addSection(indices);
+
+		const double rawSizeMB = double(positions.size() * sizeof(math::vec3) + indices.size() * sizeof(uint32)) / (1024.0 * 1024.0);
+
+		std::vector<std::span<const char>> samples;
+		samples.push_back({ (const char*)positions.data(), assetbinary::kChunkRawSize });
+		samples.push_back({ (const char*)indices.data(), assetbinary::kChunkRawSize });
+		auto dictionary = assetbinary::buildDictionary(samples);
+
+		struct Config
+		{
+			const char* name;
+			ECompressionMode mode;
+			bool bDictionary;
+		};
+		const Config configs[] =
+		{
+			{ "None",       ECompressionMode::None,  false },
+			{ "Lz4",        ECompressionMode::Lz4,   false },
+			{ "Lz4HC",      ECompressionMode::Lz4HC, false },
+			{ "Lz4+Dict",   ECompressionMode::Lz4,   true  },
+			{ "Lz4HC+Dict", ECompressionMode::Lz4HC, true  },
+		};
+
+		LOG_INFO("Asset binary benchmark, raw size {:.2f} MB, worker count {}.", rawSizeMB, jobsystem::getUsableWorkerCount(true));
+		LOG_INFO("| Mode       | Ratio  | Compress MB/s | Decompress MB/s |");
+		for (const auto& config : configs)
+		{
+			if (config.bDictionary && !dictionary)
+			{
+				continue;
+			}
+
+			const auto compressBegin = std::chrono::high_resolution_clock::now();
+			check(writer.write(savePath, schemaHash, config.mode, config.bDictionary ? dictionary : nullptr));
+			const double compressSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - compressBegin).count();
+
+			const double fileSizeMB = double(std::filesystem::file_size(savePath)) / (1024.0 * 1024.0);
+
+			AssetBinaryReader reader;
+			check(reader.open(savePath, schemaHash));
+
+			std::vector<math::vec3> readPositions(positions.size());
+			std::vector<uint32> readIndices(indices.size());
+
+			const auto decompressBegin = std::chrono::high_resolution_clock::now();
+			check(reader.readSection(0, readPositions.data()));
+			check(reader.readSection(1, readIndices.data()));
+			const double decompressSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - decompressBegin).count();
+
+			check(readIndices == indices);
+
+			LOG_INFO("| {:<10} | {:>6.3f} | {:>13.1f} | {:>15.1f} |",
+				config.name,
+				rawSizeMB / fileSizeMB,
+				rawSizeMB / compressSeconds,
+				rawSizeMB / decompressSeconds);
+		}
+
+		std::filesystem::remove(savePath);
+	}
+
+	// Per stream type disk size and decode throughput of filter against plain lz4.
+	static void filterBenchmark()
+	{
+		const auto savePath = std::filesystem::temp_directory_path() / "chord_benchmark_asset_binary_filter.bin";
+
+		std::mt19937 rng(0);
+		std::uniform_real_distribution<float> noise(-0.01f, 0.01f);
+
+		constexpr uint32 kGridSize = 1024;
+		std::vector<math::vec3> positions(kGridSize * kGridSize);
+		std::vector<math::vec3> normals(positions.size());
+		std::vector<math::vec4> tangents(positions.size());
+		std::vector<math::vec2> texcoords(positions.size());
+		for (uint32 y = 0; y < kGridSize; y++)
+		{
+			for (uint32 x = 0; x < kGridSize; x++)
+			{
+				const uint32 i = y * kGridSize + x;
+				const float height = std::sin(float(x) * 0.05f) * std::cos(float(y) * 0.05f);
+
+				positions[i] = math::vec3(float(x), height + noise(rng), float(y));
+				normals[i]   = math::normalize(math::vec3(noise(rng), 1.0f, height));
+				tangents[i]  = math::vec4(math::normalize(math::vec3(1.0f, height, noise(rng))), 1.0f);
+				texcoords[i] = math::vec2(float(x), float(y)) / float(kGridSize);
+			}
+		}
+
+		std::vector<uint32> indices;
+		indices.reserve((kGridSize - 1) * (kGridSize - 1) * 6);
+		for (uint32 y = 0; y < kGridSize - 1; y++)
+		{
+			for (uint32 x = 0; x < kGridSize - 1; x++)
+			{
+				const uint32 i0 = y * kGridSize + x;
+				const uint32 i1 = i0 + kGridSize;
+				indices.insert(indices.end(), { i0, i1, i0 + 1, i0 + 1, i1, i1 + 1 });
+			}
+		}
+
+		struct Stream
+		{
+			const char* name;
+			const void* data;
+			uint64 size;
+			uint32 stride;
+			EAssetBinaryFilter filter;
+		};
+		const Stream streams[] =
+		{
+			{ "positions", positions.data(), positions.size() * sizeof(positions[0]), sizeof(positions[0]), EAssetBinaryFilter::MeshoptVertex },
+			{ "indices",   indices.data(),   indices.size()   * sizeof(indices[0]),   sizeof(indices[0]),   EAssetBinaryFilter::MeshoptIndexTriangle },
+			{ "normals",   normals.data(),   normals.size()   * sizeof(normals[0]),   sizeof(normals[0]),   EAssetBinaryFilter::Octahedral },
+			{ "tangents",  tangents.data(),  tangents.size()  * sizeof(tangents[0]),  sizeof(tangents[0]),  EAssetBinaryFilter::OctahedralTangent },
+			{ "texcoords", texcoords.data(), texcoords.size() * sizeof(texcoords[0]), sizeof(texcoords[0]), EAssetBinaryFilter::ShuffleDelta },
+		};
+
+		// Measure octahedral filter too, it is opt-in.
+		check(CVarSystem::get().setValueIfExistGeneric("r.asset.binary.filter.lossy", "1"));
+
+		LOG_INFO("Asset binary filter benchmark, lz4 compression.");
+		LOG_INFO("| Stream    | Raw MB | Lz4 MB | Filter+Lz4 MB | Lz4 Decode GB/s | Filter+Lz4 Decode GB/s |");
+		for (const auto& stream : streams)
+		{
+			const uint64 schemaHash = assetbinary::buildSchemaHash({ { stream.name, stream.stride } });
+			std::vector<uint8> readBack(stream.size);
+
+			double sizeMB[2] { };
+			double decodeGBs[2] { };
+			for (uint32 i = 0; i < 2; i++)
+			{
+				AssetBinaryWriter writer;
+				writer.addSection(stream.data, stream.size, stream.stride, i == 0 ? EAssetBinaryFilter::None : stream.filter);
+				check(writer.write(savePath, schemaHash, ECompressionMode::Lz4, nullptr));
+
+				AssetBinaryReader reader;
+				check(reader.open(savePath, schemaHash));
+
+				const auto decodeBegin = std::chrono::high_resolution_clock::now();
+				check(reader.readSection(0, readBack.data()));
+				const double decodeSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - decodeBegin).count();
+
+				sizeMB[i] = double(std::filesystem::file_size(savePath)) / (1024.0 * 1024.0);
+				decodeGBs[i] = double(stream.size) / (1024.0 * 1024.0 * 1024.0) / decodeSeconds;
+			}
+
+			LOG_INFO("| {:<9} | {:>6.2f} | {:>6.2f} | {:>13.2f} | {:>15.2f} | {:>22.2f} |",
+				stream.name,
+				double(stream.size) / (1024.0 * 1024.0),
+				sizeMB[0],
+				sizeMB[1],
+				decodeGBs[0],
+				decodeGBs[1]);
+		}
+		check(CVarSystem::get().setValueIfExistGeneric("r.asset.binary.filter.lossy", "0"));
+
+		std::filesystem::remove(savePath);
+	}
+
+	// Lossless filter must round trip exactly, octahedral within 16bit snorm error.
+	static void testFilter()
+	{
+		const auto savePath = std::filesystem::temp_directory_path() / "chord_test_asset_binary_filter.bin";
+		const uint64 schemaHash = assetbinary::buildSchemaHash({ { "positions", sizeof(math::vec3) }, { "indices", sizeof(uint32) }, { "normals", sizeof(math::vec3) }, { "tangents", sizeof(math::vec4) } });
+
+		std::mt19937 rng(1);
+		std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+		// Cross multiple chunks.
+		std::vector<math::vec3> positions(assetbinary::kChunkRawSize / 6 + 17);
+		std::vector<math::vec3> normals(positions.size());
+		std::vector<math::vec4> tangents(positions.size());
+		for (size_t i = 0; i < positions.size(); i++)
+		{
+			positions[i] = math::vec3(unit(rng), unit(rng), unit(rng)) * 100.0f;
+			normals[i] = math::normalize(math::vec3(unit(rng), unit(rng), unit(rng)) + math::vec3(0.0f, 0.0f, 1e-3f));
+			tangents[i] = math::vec4(math::normalize(math::vec3(unit(rng), unit(rng), unit(rng)) + math::vec3(1e-3f, 0.0f, 0.0f)), (i % 2) ? 1.0f : -1.0f);
+		}
+
+		std::vector<uint32> indices((assetbinary::kChunkRawSize / 4 + 100) * 3);
+		for (auto& index : indices)
+		{
+			index = rng() % uint32(positions.size());
+		}
+
+		{
+			// Lossy filter is opt-in.
+			AssetBinaryWriter writer;
+			writer.addSection(normals, EAssetBinaryFilter::Octahedral);
+			check(writer.write(savePath, schemaHash, ECompressionMode::Lz4, nullptr));
+
+			AssetBinaryReader reader;
+			check(reader.open(savePath, schemaHash));
+			check(reader.getSectionFilter(0) == EAssetBinaryFilter::ShuffleDelta);
+
+			std::vector<math::vec3> readNormals;
+			check(reader.copySection(0, readNormals));
+			check(memcmp(readNormals.data(), normals.data(), normals.size() * sizeof(normals[0])) == 0);
+		}
+
+		check(CVarSystem::get().setValueIfExistGeneric("r.asset.binary.filter.lossy", "1"));
+		{
+			AssetBinaryWriter writer;
+			writer.addSection(positions, EAssetBinaryFilter::MeshoptVertex);
+			writer.addSection(indices, EAssetBinaryFilter::MeshoptIndexSequence);
+			writer.addSection(normals, EAssetBinaryFilter::Octahedral);
+			writer.addSection(tangents, EAssetBinaryFilter::OctahedralTangent);
+			check(writer.write(savePath, schemaHash, ECompressionMode::Lz4, nullptr));
+		}
+		check(CVarSystem::get().setValueIfExistGeneric("r.asset.binary.filter.lossy", "0"));
+
+		AssetBinaryReader reader;
+		check(reader.open(savePath, schemaHash));
+		check(!reader.isSectionRaw(0));
+		check(reader.getSectionFilter(1) == EAssetBinaryFilter::MeshoptIndexSequence);
+		check(reader.getSectionFilter(2) == EAssetBinaryFilter::Octahedral);
+
+		std::vector<math::vec3> readPositions;
+		check(reader.copySection(0, readPositions));
+		check(memcmp(readPositions.data(), positions.data(), positions.size() * sizeof(positions[0])) == 0);
+
+		std::vector<uint32> readIndices;
+		check(reader.copySection(1, readIndices));
+		check(readIndices == indices);
+
+		// Partial read cross chunk boundary of filtered section.
+		const uint64 elementOffset = reader.getSectionElementCount(1) / 2 - 3;
+		check(reader.readSectionElements(1, elementOffset, 1000, readIndices));
+		check(std::equal(readIndices.begin(), readIndices.end(), indices.begin() + elementOffset));
+
+		std::vector<math::vec3> readNormals;
+		check(reader.copySection(2, readNormals));
+		for (size_t i = 0; i < normals.size(); i++)
+		{
+			check(math::dot(readNormals[i], normals[i]) > 0.9999f);
+		}
+
+		std::vector<math::vec4> readTangents;
+		check(reader.copySection(3, readTangents));
+		for (size_t i = 0; i < tangents.size(); i++)
+		{
+			check(math::dot(math::vec3(readTangents[i]), math::vec3(tangents[i])) > 0.9999f);
+			check(readTangents[i].w == tangents[i].w);
+		}
+
+		std::filesystem::remove(savePath);
+	}
+
+	void test()
+	{
+		jobsystem::init();
+
+		const auto savePath = std::filesystem::temp_directory_path() / "chord_test_asset_binary.bin";
+		const uint64 schemaHash = assetbinary::buildSchemaHash({ { "compressible", sizeof(uint32) }, { "random", sizeof(uint32) }, { "empty", sizeof(uint32) } });
+
+		std::mt19937 rng(0);
+
+		// Cross multiple chunks, and tail chunk is partial.
+		std::vector<uint32> compressible(assetbinary::kChunkRawSize + 12345);
+		for (size_t i = 0; i < compressible.size(); i++)
+		{
+			compressible[i] = uint32(i / 64);
+		}
+
+		std::vector<uint32> random(assetbinary::kChunkRawSize / 4 + 77);
+		for (auto& value : random)
+		{
+			value = rng();
+		}
+
+		std::vector<uint32> empty { };
+
+		{
+			AssetBinaryWriter writer;
+			writer.addSection(compressible);
+			writer.addSection(random);
+			writer.addSection(empty);
+			check(writer.write(savePath, schemaHash, ECompressionMode::Lz4));
+		}
+
+		{
+			AssetBinaryReader reader;
+			check(reader.open(savePath, schemaHash));
+			check(reader.getSectionCount() == 3);
+
+			// Random data can't compress, so it keep raw and can view directly.
+			check(!reader.isSectionRaw(0));
+			check(reader.isSectionRaw(1));
+			check(reader.getSectionSize(2) == 0);
+
+			std::vector<uint32> readBack;
+			check(reader.copySection(0, readBack));
+			check(readBack == compressible);
+
+			const auto randomView = reader.getSection<uint32>(1);
+			check(std::equal(randomView.begin(), randomView.end(), random.begin(), random.end()));
+
+			// Partial read cross chunk boundary.
+			const uint64 elementOffset = assetbinary::kChunkRawSize / sizeof(uint32) - 100;
+			check(reader.readSectionElements(0, elementOffset, 1000, readBack));
+			check(std::equal(readBack.begin(), readBack.end(), compressible.begin() + elementOffset));
+
+			check(reader.copySection(2, readBack));
+			check(readBack.empty());
+		}
+
+		{
+			// Stale schema must reject.
+			AssetBinaryReader reader;
+			check(!reader.open(savePath, schemaHash + 1));
+		}
+
+		{
+			// Write to temp file then rename, no temp file leave in folder.
+			for (const auto& entry : std::filesystem::directory_iterator(savePath.parent_path()))
+			{
+				check(!entry.path().filename().string().starts_with(savePath.filename().string() + "."));
+			}
+		}
+
+		{
+			// In memory container, used by legacy bin view.
+			AssetBinaryWriter writer;
+			writer.addSection(compressible);
+			writer.addSection(random);
+
+			std::string container;
+			check(writer.writeMemory(container, savePath, schemaHash));
+
+			AssetBinaryReader reader;
+			check(reader.openMemory(std::move(container), savePath, schemaHash));
+			check(reader.isSectionRaw(0) && reader.isSectionRaw(1));
+
+			std::vector<uint32> readBack;
+			check(reader.copySection(0, readBack));
+			check(readBack == compressible);
+		}
+
+		{
+			// Forged chunk table must reject, read chunk trust it for decode capacity and crc range.
+			AssetBinaryWriter writer;
+			writer.addSection(compressible);
+
+			std::string container;
+			check(writer.writeMemory(container, savePath, schemaHash));
+
+			const auto forge = [&](auto&& modify)
+			{
+				std::string forged = container;
+				auto* chunks = (assetbinary::Chunk*)(forged.data() + sizeof(assetbinary::Header) + sizeof(assetbinary::Section));
+				modify(chunks[0]);
+
+				AssetBinaryReader reader;
+				return reader.openMemory(std::move(forged), savePath, schemaHash);
+			};
+
+			check( forge([](assetbinary::Chunk&) { }));
+			check(!forge([](assetbinary::Chunk& chunk) { chunk.filteredSize += 4; }));
+			check(!forge([](assetbinary::Chunk& chunk) { chunk.storedSize -= 4; }));
+			check(!forge([](assetbinary::Chunk& chunk) { chunk.storedSize += 4; chunk.filteredSize += 4; chunk.rawSize += 4; }));
+			check(!forge([](assetbinary::Chunk& chunk) { chunk.compression = (uint32)ECompressionMode::MAX; }));
+			check(!forge([](assetbinary::Chunk& chunk) { chunk.rawSize -= 4; chunk.filteredSize -= 4; chunk.storedSize -= 4; }));
+		}
+
+		std::filesystem::remove(savePath);
+
+		testFilter();
+		LOG_TRACE("Asset binary test pass.");
+
+		benchmark();
+		filterBenchmark();
+		jobsystem::release(EBusyWaitType::All);
+	}
+}
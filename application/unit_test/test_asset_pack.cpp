@@ -0,0 +1,248 @@
+#include "test.h"
+
+#include <asset/asset_pack.h>
+#include <utils/job_system.h>
+
+namespace chord::test::asset_pack
+{
+	// Synthetic cooked project, small metas and larger bins like a real scene.
+	constexpr uint32 kMetaCount = 10000;
+	constexpr uint32 kMetaSize = 1024;
+	constexpr uint32 kBinCount = 1000;
+	constexpr uint32 kBinSize = 64 * 1024;
+
+	// Scene open touch first part of metas and bins.
+	constexpr uint32 kSceneMetaCount = 2000;
+	constexpr uint32 kSceneBinCount = 200;
+
+	static std::string buildContent(uint32 id, uint32 size)
+	{
+		std::string content(size, '\0');
+		for (uint32 i = 0; i < size; i++)
+		{
+			// Half repeat pattern, so compression can save some size.
+			content[i] = (i % 2 == 0) ? char(id * 31 + i) : char(i % 7);
+		}
+		return content;
+	}
+
+	static void writeFile(const std::filesystem::path& path, const std::string& content)
+	{
+		std::ofstream os(path, std::ios::binary | std::ios::trunc);
+		os.write(content.data(), content.size());
+	}
+
+	static std::string readLooseFile(const std::filesystem::path& path)
+	{
+		std::ifstream is(path, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+	}
+
+	static std::string getMetaKey(uint32 id)
+	{
+		return std::format("asset/folder_{}/asset_{}.assettexture", id / 100, id);
+	}
+
+	static std::string getBinKey(uint32 id)
+	{
+		return std::format("cache/{}_bin", id);
+	}
+
+	void test()
+	{
+		jobsystem::init();
+
+		const auto projectFolder = std::filesystem::temp_directory_path() / "chord_test_asset_pack";
+		const auto packPath = projectFolder / "test.chpk";
+		const auto compressedPackPath = projectFolder / "test_compressed.chpk";
+
+		std::filesystem::remove_all(projectFolder);
+		std::filesystem::create_directories(projectFolder / "cache");
+		for (uint32 id = 0; id < kMetaCount; id++)
+		{
+			const auto path = projectFolder / getMetaKey(id);
+			std::filesystem::create_directories(path.parent_path());
+			writeFile(path, buildContent(id, kMetaSize));
+		}
+		for (uint32 id = 0; id < kBinCount; id++)
+		{
+			writeFile(projectFolder / getBinKey(id), buildContent(id, kBinSize));
+		}
+
+		// Load order layout, scene files first.
+		auto buildPack = [&](const std::filesystem::path& path, bool bCompress)
+		{
+			AssetPackWriter writer;
+			for (uint32 id = 0; id < kMetaCount; id++)
+			{
+				writer.addFile(getMetaKey(id), projectFolder / getMetaKey(id), bCompress);
+				if (id < kBinCount)
+				{
+					writer.addFile(getBinKey(id), projectFolder / getBinKey(id), false);
+				}
+			}
+
+			// Duplicate key keep first.
+			writer.addFile(getMetaKey(0), projectFolder / getBinKey(0), bCompress);
+			check(writer.getFileCount() == kMetaCount + kBinCount);
+			check(writer.write(path));
+		};
+		buildPack(packPath, false);
+		buildPack(compressedPackPath, true);
+
+		// Startup, validate header of every meta.
+		uint64 looseChecksum = 0, packedChecksum = 0;
+		const double looseStartupSeconds = timeIt([&]()
+		{
+			for (uint32 id = 0; id < kMetaCount; id++)
+			{
+				std::ifstream is(projectFolder / getMetaKey(id), std::ios::binary);
+
+				uint32 header = 0;
+				is.read((char*)&header, sizeof(header));
+				looseChecksum += header;
+			}
+		});
+
+		AssetPack pack;
+		const double packedStartupSeconds = timeIt([&]()
+		{
+			check(pack.open(packPath));
+			for (uint32 i = 0; i < pack.getEntryCount(); i++)
+			{
+				const auto& entry = pack.getEntry(i);
+				if (pack.getEntryPath(entry).ends_with(".assettexture"))
+				{
+					packedChecksum += *(const uint32*)pack.view(entry).data();
+				}
+			}
+		});
+		check(looseChecksum == packedChecksum);
+
+		// Scene open, read whole metas and bins.
+		const double looseSceneSeconds = timeIt([&]()
+		{
+			for (uint32 id = 0; id < kSceneMetaCount; id++)
+			{
+				check(readLooseFile(projectFolder / getMetaKey(id)).size() == kMetaSize);
+				if (id < kSceneBinCount)
+				{
+					check(readLooseFile(projectFolder / getBinKey(id)).size() == kBinSize);
+				}
+			}
+		});
+
+		const double packedSceneSeconds = timeIt([&]()
+		{
+			std::string data;
+			for (uint32 id = 0; id < kSceneMetaCount; id++)
+			{
+				check(pack.read(*pack.find(getMetaKey(id)), data) && data.size() == kMetaSize);
+				if (id < kSceneBinCount)
+				{
+					// Bin view in place like asset binary reader.
+					check(pack.view(*pack.find(getBinKey(id))).size() == kBinSize);
+				}
+			}
+		});
+
+		// Content match loose file, compressed pack too.
+		AssetPack compressedPack;
+		check(compressedPack.open(compressedPackPath));
+		check(std::filesystem::file_size(compressedPackPath) < std::filesystem::file_size(packPath));
+		for (uint32 id = 0; id < kMetaCount; id += 97)
+		{
+			const auto expected = buildContent(id, kMetaSize);
+
+			std::string data;
+			check(pack.read(*pack.find(getMetaKey(id)), data) && data == expected);
+
+			const auto* entry = compressedPack.find(getMetaKey(id));
+			check(entry->compression == (uint32)ECompressionMode::Lz4);
+			check(compressedPack.read(*entry, data) && data == expected);
+		}
+
+		// Scene open of compressed pack, time until all scene metas constructed with prefetch on and off.
+		// Prefetch jobs decode entries in load order ahead, requester take decoded data from pack.
+		auto openCompressedScene = [&](bool bPrefetch)
+		{
+			compressedPack.clearPrefetched();
+
+			std::atomic<uint32> nextIndex = 0;
+			std::atomic<bool> bFinish = false;
+			FutureCollection futures { };
+
+			const double seconds = timeIt([&]()
+			{
+				if (bPrefetch)
+				{
+					for (uint32 i = 0; i < 4; i++)
+					{
+						futures.add(jobsystem::launch("AssetPackPrefetch", EJobFlags::None, [&]()
+						{
+							for (uint32 id = nextIndex++; id < kSceneMetaCount && !bFinish; id = nextIndex++)
+							{
+								compressedPack.prefetch(*compressedPack.find(getMetaKey(id)));
+							}
+						}));
+					}
+				}
+
+				std::string data;
+				for (uint32 id = 0; id < kSceneMetaCount; id++)
+				{
+					check(compressedPack.read(*compressedPack.find(getMetaKey(id)), data));
+					check(data == buildContent(id, kMetaSize));
+				}
+			});
+
+			bFinish = true;
+			futures.wait(EBusyWaitType::All);
+			compressedPack.clearPrefetched();
+
+			return seconds;
+		};
+		const double compressedSceneSeconds = openCompressedScene(false);
+		const double prefetchSceneSeconds = openCompressedScene(true);
+
+		// Data aligned for zero copy view.
+		for (uint32 id = 0; id < kBinCount; id++)
+		{
+			check(pack.find(getBinKey(id))->fileOffset % assetpack::kEntryAlignment == 0);
+		}
+		check(pack.find("asset/miss.assettexture") == nullptr);
+
+		// Broken pack must not mount.
+		{
+			writeFile(projectFolder / "broken.chpk", readLooseFile(packPath).substr(0, 4096));
+
+			AssetPack brokenPack;
+			check(!brokenPack.open(projectFolder / "broken.chpk"));
+		}
+
+		// Forged lz4 raw size must not mount, read would resize to it.
+		{
+			std::string forged = readLooseFile(compressedPackPath);
+			const auto* header = (const assetpack::Header*)forged.data();
+			auto* entries = (assetpack::Entry*)(forged.data() + header->indexOffset);
+
+			auto* entry = std::find_if(entries, entries + header->entryCount, [](const assetpack::Entry& e) { return e.compression == (uint32)ECompressionMode::Lz4; });
+			check(entry != entries + header->entryCount);
+			entry->rawSize = entry->storedSize * 256;
+			writeFile(projectFolder / "forged.chpk", forged);
+
+			AssetPack forgedPack;
+			check(!forgedPack.open(projectFolder / "forged.chpk"));
+		}
+
+		LOG_INFO("Asset pack benchmark, {} metas and {} bins, startup loose {:.3f} s packed {:.3f} s, scene open loose {:.3f} s packed {:.3f} s.",
+			kMetaCount, kBinCount, looseStartupSeconds, packedStartupSeconds, looseSceneSeconds, packedSceneSeconds);
+		LOG_INFO("Asset pack prefetch benchmark, {} compressed metas, scene open prefetch off {:.3f} s on {:.3f} s.",
+			kSceneMetaCount, compressedSceneSeconds, prefetchSceneSeconds);
+
+		std::filesystem::remove_all(projectFolder);
+		LOG_TRACE("Asset pack test pass.");
+
+		jobsystem::release(EBusyWaitType::All);
+	}
+}
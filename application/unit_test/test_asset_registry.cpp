@@ -0,0 +1,154 @@
+#include "test.h"
+
+#include <asset/asset_registry.h>
+#include <utils/job_system.h>
+
+namespace chord::test::asset_registry
+{
+	// Synthetic project, 500 folders and 100 meta per folder.
+	constexpr uint32 kFolderCount = 500;
+	constexpr uint32 kAssetPerFolder = 100;
+
+	static bool validateMeta(const std::filesystem::path& path)
+	{
+		std::ifstream is(path, std::ios::binary);
+
+		uint32 magic = 0;
+		is.read((char*)&magic, sizeof(magic));
+		return is.good() && magic == 0x41534554;
+	}
+
+	static void writeMeta(const std::filesystem::path& path, uint32 id)
+	{
+		std::ofstream os(path, std::ios::binary | std::ios::trunc);
+
+		const uint32 magic = 0x41534554;
+		os.write((const char*)&magic, sizeof(magic));
+		os.write((const char*)&id, sizeof(id));
+	}
+
+	void test()
+	{
+		jobsystem::init();
+
+		const auto projectFolder = std::filesystem::temp_directory_path() / "chord_test_asset_registry";
+		const auto assetFolder = projectFolder / "asset";
+		const auto registryPath = projectFolder / "AssetRegistry.bin";
+
+		std::filesystem::remove_all(projectFolder);
+		for (uint32 folderId = 0; folderId < kFolderCount; folderId++)
+		{
+			// Two level folder tree.
+			const auto folder = assetFolder / std::format("group_{}", folderId / 50) / std::format("folder_{}", folderId);
+			std::filesystem::create_directories(folder);
+
+			for (uint32 assetId = 0; assetId < kAssetPerFolder; assetId++)
+			{
+				writeMeta(folder / std::format("asset_{}.assettexture", assetId), folderId * kAssetPerFolder + assetId);
+			}
+
+			// Non meta file must skip.
+			writeMeta(folder / "raw.png", 0);
+		}
+		const uint32 kAssetCount = kFolderCount * kAssetPerFolder;
+
+		auto timeScan = [&](AssetRegistry::ScanStatistics& statistics)
+		{
+			const auto begin = std::chrono::high_resolution_clock::now();
+
+			AssetRegistry registry;
+			registry.load(registryPath);
+			statistics = registry.scan(assetFolder, validateMeta);
+			check(registry.save(registryPath));
+
+			return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+		};
+
+		AssetRegistry::ScanStatistics statistics { };
+
+		// Cold start, all meta validate.
+		const double coldSeconds = timeScan(statistics);
+		check(statistics.entryCount == kAssetCount);
+		check(statistics.validateCount == kAssetCount);
+
+		// Warm start, all entry reuse.
+		const double warmSeconds = timeScan(statistics);
+		check(statistics.entryCount == kAssetCount);
+		check(statistics.reuseCount == kAssetCount);
+		check(statistics.validateCount == 0);
+
+		// Incremental, one changed, one broken and one removed.
+		const auto folder0 = assetFolder / "group_0" / "folder_0";
+		{
+			std::ofstream os(folder0 / "asset_0.assettexture", std::ios::binary | std::ios::app);
+			os << "changed";
+		}
+		{
+			std::ofstream os(folder0 / "asset_1.assettexture", std::ios::binary | std::ios::trunc);
+			os << "broken";
+		}
+		std::filesystem::remove(folder0 / "asset_2.assettexture");
+
+		timeScan(statistics);
+		check(statistics.entryCount == kAssetCount - 2);
+		check(statistics.validateCount == 2);
+		check(statistics.invalidCount == 1);
+
+		{
+			AssetRegistry registry;
+			check(registry.load(registryPath));
+			check(registry.find("group_0/folder_0/asset_0.assettexture") != nullptr);
+			check(registry.find("group_0/folder_0/asset_1.assettexture") == nullptr);
+			check(registry.find("group_0/folder_0/raw.png") == nullptr);
+
+			// Classify by meta extension.
+			check(registry.getClassifiedEntries(".assettexture").size() == kAssetCount - 2);
+			check(registry.getClassifiedEntries(".assetgltf").empty());
+
+			check(registry.merge({ "packed/asset_0.assetgltf" }) == 1);
+			check(registry.getClassifiedEntries(".assetgltf").size() == 1);
+		}
+
+		// Forged count and path size must fail before allocate.
+		{
+			std::string content;
+			{
+				std::ifstream is(registryPath, std::ios::binary);
+				content.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+			}
+
+			const auto forgedPath = projectFolder / "Forged.bin";
+			auto loadForged = [&](uint64 offset)
+			{
+				std::string forged = content;
+				const uint32 value = ~0U;
+				memcpy(forged.data() + offset, &value, sizeof(value));
+				{
+					std::ofstream os(forgedPath, std::ios::binary | std::ios::trunc);
+					os.write(forged.data(), forged.size());
+				}
+
+				AssetRegistry registry;
+				return registry.load(forgedPath);
+			};
+
+			// Header is magic, version and count, then first entry path size.
+			check(!loadForged(sizeof(uint32) * 2));
+			check(!loadForged(sizeof(uint32) * 3));
+			std::filesystem::remove(forgedPath);
+		}
+
+		// Save through temp file, no temp file leave in folder.
+		for (const auto& entry : std::filesystem::directory_iterator(projectFolder))
+		{
+			check(!entry.path().filename().string().ends_with(".tmp"));
+		}
+
+		LOG_INFO("Asset registry benchmark, {} assets, cold start {:.3f} s, warm start {:.3f} s.", kAssetCount, coldSeconds, warmSeconds);
+
+		std::filesystem::remove_all(projectFolder);
+		LOG_TRACE("Asset registry test pass.");
+
+		jobsystem::release(EBusyWaitType::All);
+	}
+}
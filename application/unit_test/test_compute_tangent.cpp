@@ -0,0 +1,130 @@
+#include "test.h"
+
+#include <asset/compute_tangent.h>
+#include <utils/job_system.h>
+
+namespace chord::test::compute_tangent
+{
+	// 2 * kGridSize^2 triangles.
+	constexpr uint32 kGridSize = 1200;
+
+	// Wavy grid with mirrored uv on right half, uv seam column and collapsed uv cells.
+	static void buildMesh(uint32 gridSize, std::vector<uint32>& outIndices, std::vector<nanite::Vertex>& outVertices)
+	{
+		const uint32 rowSize = gridSize + 1;
+		outVertices.resize(rowSize * rowSize);
+		for (uint32 y = 0; y <= gridSize; y++)
+		{
+			for (uint32 x = 0; x <= gridSize; x++)
+			{
+				const float u = float(x) / float(gridSize);
+				const float v = float(y) / float(gridSize);
+				const float h = 0.05f * math::sin(u * 37.0f) * math::cos(v * 23.0f);
+
+				nanite::Vertex vertex { };
+				vertex.position = float3(u, h, v);
+				vertex.normal = math::normalize(float3(-1.85f * math::cos(u * 37.0f) * math::cos(v * 23.0f), 1.0f, 1.15f * math::sin(u * 37.0f) * math::sin(v * 23.0f)));
+				vertex.uv0 = float2(u < 0.5f ? u : 1.0f - u, v);
+				if ((x * 7 + y * 13) % 61 == 0)
+				{
+					vertex.uv0 = float2(0.25f);
+				}
+				vertex.tangent = float4(0.0f);
+
+				outVertices[y * rowSize + x] = vertex;
+			}
+		}
+
+		outIndices.clear();
+		outIndices.reserve(gridSize * gridSize * 6);
+		for (uint32 y = 0; y < gridSize; y++)
+		{
+			for (uint32 x = 0; x < gridSize; x++)
+			{
+				const uint32 i0 = y * rowSize + x;
+				const uint32 i1 = i0 + 1;
+				const uint32 i2 = i0 + rowSize;
+				const uint32 i3 = i2 + 1;
+
+				outIndices.insert(outIndices.end(), { i0, i2, i1, i1, i2, i3 });
+			}
+		}
+
+		// Seam, split column of vertices with shifted uv.
+		const uint32 seamX = gridSize / 3;
+		for (uint32 y = 0; y < gridSize; y++)
+		{
+			for (uint32 corner = 0; corner < 6; corner++)
+			{
+				uint32& index = outIndices[(y * gridSize + seamX) * 6 + corner];
+				if (index % rowSize == seamX)
+				{
+					nanite::Vertex vertex = outVertices[index];
+					vertex.uv0.x += 0.5f;
+					index = (uint32)outVertices.size();
+					outVertices.push_back(vertex);
+				}
+			}
+		}
+	}
+
+	static bool isSameTangent(const std::vector<nanite::Vertex>& a, const std::vector<nanite::Vertex>& b)
+	{
+		for (uint64 i = 0; i < a.size(); i++)
+		{
+			if (std::memcmp(&a[i].tangent, &b[i].tangent, sizeof(a[i].tangent)) != 0)
+			{
+				return false;
+			}
+		}
+		return a.size() == b.size();
+	}
+
+	void test()
+	{
+		jobsystem::init();
+
+		// Small mesh with degenerate and non manifold triangles, reference search degenerate corners in O(n^2).
+		{
+			std::vector<uint32> indices;
+			std::vector<nanite::Vertex> vertices;
+			buildMesh(64, indices, vertices);
+
+			const uint32 triangleCount = uint32(indices.size() / 3);
+			for (uint32 t = 0; t < triangleCount; t += 97)
+			{
+				const uint32 i0 = indices[t * 3 + 0];
+				const uint32 i1 = indices[t * 3 + 1];
+				const uint32 i2 = indices[t * 3 + 2];
+				indices.insert(indices.end(), { i0, i0, i1 });
+				indices.insert(indices.end(), { i2, i1, i0 });
+			}
+
+			auto referenceVertices = vertices;
+			check(computeTangent(vertices, indices));
+			check(computeTangentReference(referenceVertices, indices));
+			check(isSameTangent(vertices, referenceVertices));
+		}
+
+		std::vector<uint32> indices;
+		std::vector<nanite::Vertex> vertices;
+		buildMesh(kGridSize, indices, vertices);
+
+		auto referenceVertices = vertices;
+		const auto referenceBegin = std::chrono::high_resolution_clock::now();
+		check(computeTangentReference(referenceVertices, indices));
+		const double referenceSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - referenceBegin).count();
+
+		const auto begin = std::chrono::high_resolution_clock::now();
+		check(computeTangent(vertices, indices));
+		const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+
+		check(isSameTangent(vertices, referenceVertices));
+
+		LOG_INFO("Tangent benchmark, {} triangles, worker count {}, reference {:.3f} s parallel {:.3f} s.",
+			indices.size() / 3, jobsystem::getUsableWorkerCount(true), referenceSeconds, seconds);
+		LOG_TRACE("Compute tangent test pass.");
+
+		jobsystem::release(EBusyWaitType::All);
+	}
+}
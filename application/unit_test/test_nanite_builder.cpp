@@ -0,0 +1,479 @@
+#include "test.h"
+
+#include <asset/nanite_builder.h>
+#include <asset/gltf/gltf_compact.h>
+#include <asset/nanite_page.h>
+#include <utils/job_system.h>
+#include <utils/cvar.h>
+
+namespace chord::test::nanite_builder
+{
+	// Height field like a scanned surface, 2 * kGridSize^2 triangles.
+	constexpr uint32 kGridSize = 512;
+
+	static void buildScanMesh(std::vector<uint32>& outIndices, std::vector<nanite::Vertex>& outVertices)
+	{
+		outVertices.resize((kGridSize + 1) * (kGridSize + 1));
+		for (uint32 y = 0; y <= kGridSize; y++)
+		{
+			for (uint32 x = 0; x <= kGridSize; x++)
+			{
+				const float u = float(x) / float(kGridSize);
+				const float v = float(y) / float(kGridSize);
+
+				nanite::Vertex vertex { };
+				vertex.position = float3(u, 0.05f * math::sin(u * 37.0f) * math::cos(v * 23.0f), v);
+				vertex.uv0 = float2(u, v);
+				vertex.normal = float3(0.0f, 1.0f, 0.0f);
+				vertex.tangent = float4(1.0f, 0.0f, 0.0f, 1.0f);
+				vertex.smoothNormal = vertex.normal;
+				vertex.color0 = float4(1.0f);
+
+				outVertices[y * (kGridSize + 1) + x] = vertex;
+			}
+		}
+
+		outIndices.reserve(kGridSize * kGridSize * 6);
+		for (uint32 y = 0; y < kGridSize; y++)
+		{
+			for (uint32 x = 0; x < kGridSize; x++)
+			{
+				const uint32 i0 = y * (kGridSize + 1) + x;
+				const uint32 i1 = i0 + 1;
+				const uint32 i2 = i0 + kGridSize + 1;
+				const uint32 i3 = i2 + 1;
+
+				outIndices.insert(outIndices.end(), { i0, i2, i1, i1, i2, i3 });
+			}
+		}
+	}
+
+	static bool isSame(const nanite::MeshletContainer& a, const nanite::MeshletContainer& b)
+	{
+		return a.triangles == b.triangles
+			&& a.vertices == b.vertices
+			&& a.meshletGroupIndices == b.meshletGroupIndices
+			&& a.meshlets.size() == b.meshlets.size()
+			&& a.meshletGroups.size() == b.meshletGroups.size()
+			&& a.bvhNodes.size() == b.bvhNodes.size()
+			&& std::memcmp(a.meshlets.data(), b.meshlets.data(), a.meshlets.size() * sizeof(a.meshlets[0])) == 0;
+	}
+
+	// Lod error distribution of build stats must cover every output meshlet.
+	static void logLodErrors(const char* name, const nanite::NaniteBuildStats& stats, const nanite::MeshletContainer& ctx)
+	{
+		uint32 meshletCount = 0;
+		for (uint32 lod = 0; lod < stats.lodErrors.size(); lod++)
+		{
+			const auto& lodError = stats.lodErrors[lod];
+			meshletCount += lodError.meshletCount;
+			check(lodError.meanError <= lodError.maxError);
+
+			if (lodError.meshletCount > 0)
+			{
+				LOG_INFO("  {} lod {}: {} meshlets, error mean {:.6f} max {:.6f}.", name, lod, lodError.meshletCount, lodError.meanError, lodError.maxError);
+			}
+		}
+		check(meshletCount == ctx.meshlets.size());
+	}
+
+	// Every group reachable from one leaf, every meshlet in one group.
+	static bool isBVHComplete(const nanite::MeshletContainer& ctx)
+	{
+		uint32 leafGroupCount = 0;
+		for (const auto& node : ctx.bvhNodes)
+		{
+			leafGroupCount += node.leafMeshletGroupCount;
+		}
+		return leafGroupCount == ctx.meshletGroups.size() && ctx.meshletGroupIndices.size() == ctx.meshlets.size();
+	}
+
+	static uint32 countRootMeshlets(const nanite::MeshletContainer& ctx)
+	{
+		uint32 count = 0;
+		for (const auto& meshlet : ctx.meshlets)
+		{
+			count += meshlet.isParentSet() ? 0 : 1;
+		}
+		return count;
+	}
+
+	// Same layout as gltf import, single primitive.
+	static void buildPrimitiveDatas(const nanite::MeshletContainer& ctx, const std::vector<nanite::Vertex>& vertices, GLTFMesh& outMesh, GLTFBinary::PrimitiveDatas& out)
+	{
+		GLTFPrimitive primitive { };
+		primitive.vertexCount = (uint32)vertices.size();
+		primitive.posMin = float3( FLT_MAX);
+		primitive.posMax = float3(-FLT_MAX);
+		for (const auto& vertex : vertices)
+		{
+			primitive.posMin = math::min(primitive.posMin, vertex.position);
+			primitive.posMax = math::max(primitive.posMax, vertex.position);
+
+			out.positions.push_back(vertex.position);
+			out.normals.push_back(vertex.normal);
+			out.tangents.push_back(vertex.tangent);
+			out.texcoords0.push_back(vertex.uv0);
+		}
+		outMesh.primitives.push_back(primitive);
+
+		for (const auto& meshlet : ctx.meshlets)
+		{
+			out.meshlets.push_back(meshlet.getGLTFMeshlet((uint32)out.meshletDatas.size()));
+			for (uint32 j = 0; j < meshlet.info.vertex_count; j++)
+			{
+				out.meshletDatas.push_back(ctx.vertices[meshlet.info.vertex_offset + j]);
+			}
+			for (uint32 j = 0; j < meshlet.info.triangle_count; j++)
+			{
+				const uint8* triangle = &ctx.triangles[meshlet.info.triangle_offset + j * 3];
+				out.meshletDatas.push_back(uint32(triangle[0]) | (uint32(triangle[1]) << 8) | (uint32(triangle[2]) << 16));
+			}
+		}
+	}
+
+	// 038: parallel group merge simplify split, output merge in group order so must be deterministic.
+	static nanite::MeshletContainer testParallelBuild(const nanite::NaniteBuilder& builder, nanite::NaniteBuildStats& outStats, double& outSeconds)
+	{
+		auto* parallelCVar = CVarSystem::get().getCVarCheck<uint32>("r.nanite.build.parallel");
+
+		nanite::MeshletContainer serialCtx;
+		parallelCVar->set(0);
+		const double serialSeconds = timeIt([&]() { serialCtx = builder.build(&outStats); });
+
+		nanite::MeshletContainer parallelCtx;
+		parallelCVar->set(1);
+		outSeconds = timeIt([&]() { parallelCtx = builder.build(); });
+
+		check(!serialCtx.meshlets.empty());
+		check(isSame(serialCtx, parallelCtx));
+
+		LOG_INFO("Nanite builder benchmark, {} triangles {} meshlets, serial {:.3f} s parallel {:.3f} s.",
+			kGridSize * kGridSize * 2, serialCtx.meshlets.size(), serialSeconds, outSeconds);
+		return parallelCtx;
+	}
+
+	// 039: sort and hash map adjacency must build same graph on same meshlets, only neighbor order inside row differ.
+	static void testClusterAdjacency(const nanite::NaniteBuilder& builder, const nanite::MeshletContainer& ctx)
+	{
+		constexpr float kPosFuseThreshold = 1e-4f;
+		auto* sortAdjacencyCVar = CVarSystem::get().getCVarCheck<uint32>("r.nanite.build.adjacency.sort");
+
+		nanite::ClusterAdjacency hashMapAdjacency;
+		sortAdjacencyCVar->set(0);
+		nanite::buildClusterAdjacency(ctx, builder.getVertices(), kPosFuseThreshold, hashMapAdjacency);
+
+		// Legacy hash map adjacency, neighbor order differ so METIS partition may differ too.
+		nanite::MeshletContainer hashMapCtx;
+		const double hashMapSeconds = timeIt([&]() { hashMapCtx = builder.build(); });
+		check(!hashMapCtx.meshlets.empty());
+
+		nanite::ClusterAdjacency sortAdjacency;
+		sortAdjacencyCVar->set(1);
+		nanite::buildClusterAdjacency(ctx, builder.getVertices(), kPosFuseThreshold, sortAdjacency);
+
+		check(!sortAdjacency.edgeAdjacency.empty());
+		check(sortAdjacency.xadjacency.size() == ctx.meshlets.size() + 1);
+		check(sortAdjacency.xadjacency == hashMapAdjacency.xadjacency);
+		check(sortAdjacency.edgeAdjacency.size() == hashMapAdjacency.edgeAdjacency.size());
+		check(sortAdjacency.edgeWeights.size() == hashMapAdjacency.edgeWeights.size());
+
+		auto getSortedRow = [](const nanite::ClusterAdjacency& adjacency, size_t row)
+		{
+			std::vector<std::pair<idx_t, idx_t>> result;
+			for (idx_t e = adjacency.xadjacency[row]; e < adjacency.xadjacency[row + 1]; e++)
+			{
+				result.push_back({ adjacency.edgeAdjacency[e], adjacency.edgeWeights[e] });
+			}
+			std::sort(result.begin(), result.end());
+			return result;
+		};
+
+		for (size_t row = 0; row < ctx.meshlets.size(); row++)
+		{
+			check(getSortedRow(sortAdjacency, row) == getSortedRow(hashMapAdjacency, row));
+		}
+
+		LOG_INFO("Nanite cluster adjacency, {} edges, hash map adjacency build {:.3f} s.", sortAdjacency.edgeAdjacency.size(), hashMapSeconds);
+	}
+
+	// 040: spatial partitioner compare with METIS, grouping must still reduce to coarse lods.
+	static void testSpatialPartitioner(
+		const std::vector<uint32>& indices,
+		const std::vector<nanite::Vertex>& vertices,
+		const nanite::MeshletContainer& metisCtx,
+		const nanite::NaniteBuildStats& metisStats,
+		double metisSeconds)
+	{
+		nanite::NaniteBuilder spatialBuilder(std::vector<uint32>(indices), std::vector<nanite::Vertex>(vertices), false, false, 0.0f, EMeshletPartitioner::Spatial);
+		nanite::NaniteBuildStats spatialStats;
+		const nanite::MeshletContainer spatialCtx = spatialBuilder.build(&spatialStats);
+
+		check(spatialStats.lodCount > 1);
+		check(isSame(spatialCtx, spatialBuilder.build()));
+
+		LOG_INFO("Nanite partitioner compare, Metis {:.3f} s {} lods {} boundary edges, Spatial {:.3f} s {} lods {} boundary edges.",
+			metisSeconds, metisStats.lodCount, metisStats.boundaryEdgeCount, spatialStats.seconds, spatialStats.lodCount, spatialStats.boundaryEdgeCount);
+		logLodErrors("Metis", metisStats, metisCtx);
+		logLodErrors("Spatial", spatialStats, spatialCtx);
+	}
+
+	// 041: bvh builders compare, output differ only in bvh.
+	static void testBVH(const nanite::NaniteBuilder& builder, const nanite::MeshletContainer& referenceCtx)
+	{
+		auto* bvhSAHCVar = CVarSystem::get().getCVarCheck<uint32>("r.nanite.bvh.sah");
+		auto* bvhWidthCVar = CVarSystem::get().getCVarCheck<uint32>("r.nanite.bvh.width");
+
+		std::array<nanite::NaniteBuildStats, 3> bvhStats { };
+		const char* bvhNames[] = { "median 8-wide", "SAH 8-wide", "SAH 4-wide" };
+		for (uint32 i = 0; i < bvhStats.size(); i++)
+		{
+			bvhSAHCVar->set(i == 0 ? 0 : 1);
+			bvhWidthCVar->set(i == 2 ? 4 : 8);
+
+			const auto ctx = builder.build(&bvhStats[i]);
+			check(isBVHComplete(ctx));
+			check(ctx.meshlets.size() == referenceCtx.meshlets.size());
+
+			LOG_INFO("Nanite bvh {}: {} nodes, traversal cost {:.2f}, build {:.3f} s.",
+				bvhNames[i], bvhStats[i].bvhNodeCount, bvhStats[i].bvhTraversalCost, bvhStats[i].bvhSeconds);
+		}
+		bvhSAHCVar->set(1);
+		bvhWidthCVar->set(8);
+	}
+
+	// 042: streaming build with small bricks, seams stitch at coarse lods.
+	static void testStreamingBuild(const std::vector<uint32>& indices, const std::vector<nanite::Vertex>& vertices, const nanite::MeshletContainer& inMemoryCtx)
+	{
+		auto* brickCVar = CVarSystem::get().getCVarCheck<uint32>("r.nanite.streaming.brick");
+		brickCVar->set(kGridSize * kGridSize / 4);
+
+		float3 posMin = float3( FLT_MAX);
+		float3 posMax = float3(-FLT_MAX);
+		for (const auto& vertex : vertices)
+		{
+			posMin = math::min(posMin, vertex.position);
+			posMax = math::max(posMax, vertex.position);
+		}
+
+		const auto workFolder = std::filesystem::temp_directory_path() / "chord_test_nanite_streaming";
+		nanite::NaniteStreamingBuilder streamingBuilder(workFolder, posMin, posMax, indices.size() / 3, false, false, 0.0f);
+		check(streamingBuilder.getBrickCount() > 1);
+
+		// Feed in two chunks like a streaming source.
+		const size_t halfIndexCount = (indices.size() / 6) * 3;
+		check(streamingBuilder.addTriangles(std::vector<uint32>(indices.begin(), indices.begin() + halfIndexCount), vertices));
+		check(streamingBuilder.addTriangles(std::vector<uint32>(indices.begin() + halfIndexCount, indices.end()), vertices));
+
+		nanite::MeshletContainer streamingCtx;
+		std::vector<nanite::Vertex> streamingVertices;
+		std::vector<uint32> streamingIndices;
+		nanite::NaniteBuildStats streamingStats;
+		check(streamingBuilder.build(streamingCtx, streamingVertices, streamingIndices, &streamingStats));
+		brickCVar->reset();
+
+		uint32 lod0TriangleCount = 0;
+		for (const auto& meshlet : streamingCtx.meshlets)
+		{
+			lod0TriangleCount += (meshlet.lod == 0) ? meshlet.info.triangle_count : 0;
+		}
+		check(lod0TriangleCount == indices.size() / 3);
+		check(streamingIndices.size() == indices.size());
+		check(isBVHComplete(streamingCtx));
+		check(streamingStats.lodCount > 1);
+
+		LOG_INFO("Nanite streaming build, {} bricks, {} meshlets {} roots in {:.3f} s, in memory {} meshlets {} roots.",
+			streamingBuilder.getBrickCount(), streamingCtx.meshlets.size(), countRootMeshlets(streamingCtx), streamingStats.seconds,
+			inMemoryCtx.meshlets.size(), countRootMeshlets(inMemoryCtx));
+		logLodErrors("Streaming", streamingStats, streamingCtx);
+	}
+
+	// 043: compact encoding round trip, meshlet datas lossless and attributes within quantization bound.
+	static void testCompactEncoding(const nanite::NaniteBuilder& builder, const nanite::MeshletContainer& ctx)
+	{
+		std::vector<GLTFMesh> meshes(1);
+		GLTFBinary::PrimitiveDatas source;
+		buildPrimitiveDatas(ctx, builder.getVertices(), meshes[0], source);
+
+		gltfcompact::PrimitiveDatas compact;
+		gltfcompact::encode(meshes, source, compact);
+
+		GLTFBinary::PrimitiveDatas decoded;
+		check(gltfcompact::decode(meshes, source.meshlets, compact, decoded));
+
+		const auto error = gltfcompact::measureError(source, decoded);
+		check(error.bMeshletDatasMatch);
+		check(error.position <= gltfcompact::getPositionErrorBound(meshes[0].primitives[0]) * 1.01f);
+		check(error.normal < 0.01f && error.tangent < 0.01f);
+		check(error.uv0 <= 1.0f / 2048.0f);
+
+		const uint64 rawSize = source.positions.size() * (sizeof(float) * 12) + source.meshletDatas.size() * sizeof(uint32);
+		check(compact.size() < rawSize);
+
+		LOG_INFO("Nanite compact encoding, {} KB -> {} KB, max error position {:.6f} normal {:.4f} deg uv0 {:.6f}.",
+			rawSize / 1024, compact.size() / 1024, error.position, error.normal, error.uv0);
+
+		// Compact storage, view decode same datas as in memory round trip.
+		const auto savePath = std::filesystem::temp_directory_path() / "chord_test_gltf_compact.bin";
+		{
+			GLTFBinary bin;
+			bin.primitiveData = source;
+			check(bin.saveCompact(savePath, meshes));
+
+			GLTFBinaryView view;
+			check(view.load(savePath, meshes));
+
+			const auto& in = view.primitiveData;
+			GLTFBinary::PrimitiveDatas loaded;
+			check(in.positions.read(0, in.positions.size(), loaded.positions));
+			check(in.tangents.read(0, in.tangents.size(), loaded.tangents));
+			check(in.meshletDatas.read(0, in.meshletDatas.size(), loaded.meshletDatas));
+			check(in.meshlets.size() == source.meshlets.size());
+
+			check(loaded.positions == decoded.positions);
+			check(loaded.tangents == decoded.tangents);
+			check(loaded.meshletDatas == source.meshletDatas);
+		}
+		std::filesystem::remove(savePath);
+	}
+
+	// 044: cluster pages residency along camera path over a grid of instances, no GPU.
+	static void testClusterPages(const nanite::MeshletContainer& ctx)
+	{
+		nanite::ClusterPages clusterPages;
+		check(nanite::buildClusterPages(ctx, clusterPages));
+		check(clusterPages.pages.size() > 1);
+
+		uint32 pagedGroupCount = 0;
+		uint64 totalBytes = 0;
+		for (uint32 i = 0; i < (uint32)clusterPages.pages.size(); i++)
+		{
+			const auto& page = clusterPages.pages[i];
+			pagedGroupCount += page.groupCount;
+			totalBytes += page.byteSize;
+
+			// Parent pages order before child.
+			for (uint32 j = 0; j < page.dependencyCount; j++)
+			{
+				check(clusterPages.pageDependencies[page.dependencyOffset + j] < i);
+			}
+		}
+		check(pagedGroupCount == ctx.meshletGroups.size());
+
+		constexpr uint32 kInstanceDim = 4;
+		const uint64 budgetBytes = totalBytes * 2;
+		nanite::ClusterPageResidency residency(budgetBytes, 32);
+		for (uint32 i = 0; i < kInstanceDim * kInstanceDim; i++)
+		{
+			const float3 offset = float3(float(i % kInstanceDim) * 1.5f, 0.0f, float(i / kInstanceDim) * 1.5f);
+			check(residency.addPrimitive(clusterPages.pages, clusterPages.pageDependencies, math::translate(math::mat4(1.0f), offset)) != nanite::ClusterPageResidency::kInvalidPage);
+		}
+		check(residency.isValid());
+
+		// Fly low over instances and back, 1080p with 60 degree fov.
+		nanite::ClusterPageView view { };
+		view.projectScale = 1080.0f / (2.0f * std::tan(math::radians(30.0f)));
+
+		constexpr uint32 kFrameCount = 240;
+		uint64 loadCount = 0, evictCount = 0, missingFrameCount = 0;
+		for (uint32 frame = 0; frame < kFrameCount; frame++)
+		{
+			const float t = float(frame) / float(kFrameCount - 1);
+			const float s = t < 0.5f ? t * 2.0f : (1.0f - t) * 2.0f;
+			view.position = float3(s * 6.0f, 0.2f, s * 6.0f);
+
+			const auto stats = residency.update(view);
+			check(residency.isValid());
+			check(stats.residentBytes <= budgetBytes);
+
+			loadCount += stats.loadCount;
+			evictCount += stats.evictCount;
+			missingFrameCount += stats.missingCount > 0 ? 1 : 0;
+		}
+		check(loadCount > 0);
+
+		LOG_INFO("Nanite cluster pages, {} pages {} KB per instance, {} instances budget {} KB, {} loads {} evicts, {} of {} frames miss pages.",
+			clusterPages.pages.size(), totalBytes / 1024, kInstanceDim * kInstanceDim, budgetBytes / 1024, loadCount, evictCount, missingFrameCount, kFrameCount);
+	}
+
+	// 046: fuse and smooth normal passes compare with legacy serial paths, on per corner unwelded mesh.
+	static void testFuseAndSmoothNormal(const std::vector<uint32>& indices, const std::vector<nanite::Vertex>& vertices)
+	{
+		std::vector<nanite::Vertex> cornerVertices(indices.size());
+		std::vector<uint32> cornerIndices(indices.size());
+		for (uint32 i = 0; i < (uint32)indices.size(); i++)
+		{
+			cornerVertices[i] = vertices[indices[i]];
+			cornerVertices[i].uv1 = float2((i % 7 == 0) ? 1.0f : 0.0f);
+			cornerIndices[i] = (uint32)indices.size() - 1 - i;
+		}
+
+		auto* fuseSortCVar = CVarSystem::get().getCVarCheck<uint32>("r.nanite.fuse.sort");
+
+		auto hashMapIndices = cornerIndices;
+		auto hashMapVertices = cornerVertices;
+		fuseSortCVar->set(0);
+		const double hashMapFuseSeconds = timeIt([&]() { nanite::fuseVertices(hashMapIndices, hashMapVertices, false); });
+
+		auto sortIndices = cornerIndices;
+		auto sortVertices = cornerVertices;
+		fuseSortCVar->set(1);
+		const double sortFuseSeconds = timeIt([&]() { nanite::fuseVertices(sortIndices, sortVertices, false); });
+
+		check(sortVertices.size() < cornerVertices.size());
+		check(sortIndices == hashMapIndices);
+		check(sortVertices.size() == hashMapVertices.size());
+		check(std::memcmp(sortVertices.data(), hashMapVertices.data(), sortVertices.size() * sizeof(nanite::Vertex)) == 0);
+
+		// Serial per corner accumulate reference.
+		std::vector<float3> referenceNormals(sortVertices.size(), float3(0.0f));
+		const double referenceSmoothSeconds = timeIt([&]()
+		{
+			for (uint32 index : sortIndices)
+			{
+				referenceNormals[index] += sortVertices[index].normal;
+			}
+			for (auto& normal : referenceNormals)
+			{
+				normal = math::normalize(normal);
+			}
+		});
+
+		const double smoothSeconds = timeIt([&]() { nanite::computeSmoothNormals(sortIndices, sortVertices); });
+		for (uint32 i = 0; i < (uint32)sortVertices.size(); i++)
+		{
+			check(std::memcmp(&sortVertices[i].smoothNormal, &referenceNormals[i], sizeof(float3)) == 0);
+		}
+
+		LOG_INFO("Nanite fuse {} -> {} vertices, hash map {:.3f} s sort {:.3f} s, smooth normal serial {:.3f} s parallel {:.3f} s.",
+			cornerVertices.size(), sortVertices.size(), hashMapFuseSeconds, sortFuseSeconds, referenceSmoothSeconds, smoothSeconds);
+	}
+
+	void test()
+	{
+		jobsystem::init();
+
+		std::vector<uint32> indices;
+		std::vector<nanite::Vertex> vertices;
+		buildScanMesh(indices, vertices);
+
+		const nanite::NaniteBuilder builder(std::vector<uint32>(indices), std::vector<nanite::Vertex>(vertices), false, false, 0.0f);
+
+		// METIS build shared as reference by other cases.
+		nanite::NaniteBuildStats metisStats;
+		double metisSeconds = 0.0;
+		const nanite::MeshletContainer ctx = testParallelBuild(builder, metisStats, metisSeconds);
+
+		testClusterAdjacency(builder, ctx);
+		testSpatialPartitioner(indices, vertices, ctx, metisStats, metisSeconds);
+		testBVH(builder, ctx);
+		testStreamingBuild(indices, vertices, ctx);
+		testCompactEncoding(builder, ctx);
+		testClusterPages(ctx);
+		testFuseAndSmoothNormal(indices, vertices);
+
+		LOG_TRACE("Nanite builder test pass.");
+
+		jobsystem::release(EBusyWaitType::All);
+	}
+}
@@ -0,0 +1,177 @@
+#include "test.h"
+
+#include <utils/sharded_map.h>
+
+namespace chord::test::sharded_map
+{
+	using ValueRef = std::shared_ptr<uint64>;
+
+	// Simulate meta disk io and deserialize.
+	static ValueRef load(uint64 key)
+	{
+		std::this_thread::sleep_for(std::chrono::microseconds(200));
+		return std::make_shared<uint64>(key);
+	}
+
+	// Old asset manager behavior, one mutex and load under lock.
+	class GlobalLockMap
+	{
+	public:
+		ValueRef getOrLoad(uint64 key)
+		{
+			std::lock_guard lock(m_mutex);
+			auto& value = m_map[key];
+			if (!value)
+			{
+				value = load(key);
+			}
+			return value;
+		}
+
+	private:
+		std::mutex m_mutex;
+		std::unordered_map<uint64, ValueRef> m_map;
+	};
+
+	// Every thread request all keys from different start, later requests hit keys loaded by others.
+	template<typename Func>
+	static double runThreads(uint32 threadCount, uint32 keyCount, Func&& func)
+	{
+		const auto begin = std::chrono::high_resolution_clock::now();
+
+		std::vector<std::future<void>> futures;
+		for (uint32 threadId = 0; threadId < threadCount; threadId++)
+		{
+			futures.push_back(std::async(std::launch::async, [&, threadId]()
+			{
+				for (uint32 i = 0; i < keyCount; i++)
+				{
+					const uint64 key = (i + threadId * (keyCount / threadCount)) % keyCount;
+					func(key);
+				}
+			}));
+		}
+
+		for (auto& future : futures)
+		{
+			future.wait();
+		}
+
+		return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+	}
+
+	void test()
+	{
+		// Waiter of in-flight key busy wait on job system.
+		jobsystem::init();
+
+		constexpr uint32 kThreadCount = 16;
+		constexpr uint32 kKeyCount = 4096;
+
+		// Same key must only load once.
+		std::atomic<uint32> loadCount = 0;
+		ShardedMap<uint64, ValueRef> shardedMap;
+		const double shardedSeconds = runThreads(kThreadCount, kKeyCount, [&](uint64 key)
+		{
+			bool bLoaded = false;
+			auto value = shardedMap.getOrLoad(key, [&]()
+			{
+				loadCount ++;
+				return load(key);
+			}, bLoaded);
+
+			check(value && *value == key);
+		});
+		check(loadCount == kKeyCount);
+		check(shardedMap.size() == kKeyCount);
+
+		// Failed load never insert.
+		{
+			bool bLoaded = true;
+			check(shardedMap.getOrLoad(kKeyCount, []() { return ValueRef(nullptr); }, bLoaded) == nullptr);
+			check(!bLoaded && !shardedMap.contains(kKeyCount));
+		}
+
+		// Throwing load must unblock waiters of same key, and next request can retry.
+		{
+			const uint64 key = kKeyCount + 1;
+			std::atomic<bool> bLoaderEnter = false;
+			std::atomic<bool> bWaiterEnter = false;
+
+			auto loaderFuture = std::async(std::launch::async, [&]()
+			{
+				bool bLoaded = false;
+				try
+				{
+					shardedMap.getOrLoad(key, [&]() -> ValueRef
+					{
+						bLoaderEnter = true;
+						while (!bWaiterEnter)
+						{
+							std::this_thread::yield();
+						}
+
+						// Give waiter time to block on in-flight future.
+						std::this_thread::sleep_for(std::chrono::milliseconds(20));
+						throw std::runtime_error("load fail");
+					}, bLoaded);
+				}
+				catch (const std::runtime_error&)
+				{
+					return true;
+				}
+				return false;
+			});
+
+			while (!bLoaderEnter)
+			{
+				std::this_thread::yield();
+			}
+
+			auto waiterFuture = std::async(std::launch::async, [&]()
+			{
+				bWaiterEnter = true;
+
+				bool bLoaded = false;
+				try
+				{
+					shardedMap.getOrLoad(key, [&]() { return load(key); }, bLoaded);
+				}
+				catch (const std::runtime_error&)
+				{
+					return true;
+				}
+
+				// Waiter may arrive after failed load finish, then it load by itself.
+				return bLoaded;
+			});
+
+			check(waiterFuture.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+			check(loaderFuture.get());
+			check(waiterFuture.get());
+
+			bool bLoaded = false;
+			check(*shardedMap.getOrLoad(key, [&]() { return load(key); }, bLoaded) == key);
+			check(shardedMap.erase(key) != nullptr);
+		}
+
+		check(!shardedMap.insert(0, std::make_shared<uint64>(0)));
+		check(shardedMap.erase(0) != nullptr);
+		check(shardedMap.find(0) == nullptr);
+
+		GlobalLockMap globalLockMap;
+		const double globalLockSeconds = runThreads(kThreadCount, kKeyCount, [&](uint64 key)
+		{
+			check(*globalLockMap.getOrLoad(key) == key);
+		});
+
+		const double requestCount = double(kThreadCount) * kKeyCount;
+		LOG_INFO("Parallel getOrLoad benchmark, {} threads, {} keys.", kThreadCount, kKeyCount);
+		LOG_INFO("| Map         | Requests/s  |");
+		LOG_INFO("| Global lock | {:>11.0f} |", requestCount / globalLockSeconds);
+		LOG_INFO("| Sharded     | {:>11.0f} |", requestCount / shardedSeconds);
+
+		LOG_TRACE("Sharded map test pass.");
+		jobsystem::release(EBusyWaitType::All);
+	}
+}
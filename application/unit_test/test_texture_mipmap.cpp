@@ -0,0 +1,133 @@
+#include "test.h"
+
+#include <asset/texture/texture_mipmap.h>
+#include <utils/job_system.h>
+
+namespace chord::test::texture_mipmap
+{
+	// Source width and height of benchmark, rgba8 srgb.
+	constexpr uint32 kBenchmarkSize = 4096;
+
+	// Float bits checked around each encode threshold.
+	constexpr uint32 kThresholdWindow = 4096;
+
+	static uint32 getMipmapCount(uint32 width, uint32 height)
+	{
+		return uint32(std::floor(std::log2(std::max(width, height)))) + 1;
+	}
+
+	// Noise with flat tiles of black and white, so both random and constant region downsample.
+	template<typename T>
+	static std::vector<T> buildImage(uint32 width, uint32 height, uint32 seed)
+	{
+		std::mt19937 rng(seed);
+		std::uniform_int_distribution<uint32> distribution(0, std::numeric_limits<T>::max());
+
+		std::vector<T> pixels(uint64(width) * height * 4);
+		for (uint32 y = 0; y < height; y++)
+		{
+			for (uint32 x = 0; x < width; x++)
+			{
+				const uint32 tile = ((x / 16) + (y / 16) * 3) % 5;
+				for (uint32 c = 0; c < 4; c++)
+				{
+					T value = T(distribution(rng));
+					if (tile == 0) { value = 0; }
+					if (tile == 1) { value = std::numeric_limits<T>::max(); }
+
+					pixels[(uint64(y) * width + x) * 4 + c] = value;
+				}
+			}
+		}
+		return pixels;
+	}
+
+	template<typename T>
+	static void checkSame(uint32 channelCount, uint32 pixelOffset, uint32 width, uint32 height, bool bSRGB)
+	{
+		const auto pixels = buildImage<T>(width, height, width * 31 + height * 7 + channelCount + pixelOffset);
+		const uint32 mipmapCount = getMipmapCount(width, height);
+
+		std::vector<std::vector<uint8>> mipmaps;
+		std::vector<std::vector<uint8>> referenceMipmaps;
+		buildMipmap<T>(channelCount, pixelOffset, pixels.data(), mipmapCount, width, height, bSRGB, mipmaps);
+		buildMipmapReference<T>(channelCount, pixelOffset, pixels.data(), mipmapCount, width, height, bSRGB, referenceMipmaps);
+
+		check(mipmaps == referenceMipmaps);
+	}
+
+	// Full [0, 1] float sweep pass offline but take too long here, check neighbor bits of each threshold and a sparse sweep.
+	static void checkEncode()
+	{
+		// Encode threshold of each level close to its decoded value.
+		std::vector<uint32> probeBits;
+		for (uint32 level = 1; level < 256; level++)
+		{
+			const float linear = srgbDecode(uint8(level));
+			const uint32 bits = std::bit_cast<uint32>(linear);
+			for (uint32 i = bits - math::min(bits, kThresholdWindow); i <= bits + kThresholdWindow; i++)
+			{
+				probeBits.push_back(i);
+			}
+		}
+
+		const uint32 maxBits = std::bit_cast<uint32>(1.0f);
+		for (uint32 bits = 0; bits <= maxBits + 16; bits += 997)
+		{
+			probeBits.push_back(bits);
+		}
+
+		std::atomic<uint32> mismatchCount = 0;
+		jobsystem::parallelFor("SRGBEncodeCheck", EBusyWaitType::All, uint32(probeBits.size()), EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+		{
+			for (uint32 i = loopStart; i < loopEnd; i++)
+			{
+				const float linear = std::bit_cast<float>(probeBits[i]);
+				if (srgbEncode(linear) != srgbEncodeReference(linear))
+				{
+					mismatchCount++;
+				}
+			}
+		});
+		check(mismatchCount == 0);
+	}
+
+	void test()
+	{
+		jobsystem::init();
+
+		checkEncode();
+
+		checkSame<uint8>(4, 0, 256, 256, true);
+		checkSame<uint8>(4, 0, 512, 64, true);
+		checkSame<uint8>(4, 0, 1, 128, true);
+		checkSame<uint8>(2, 0, 128, 256, true);
+		checkSame<uint8>(1, 3, 256, 256, true);
+		checkSame<uint8>(1, 1, 256, 256, false);
+		checkSame<uint8>(4, 0, 200, 120, false);
+		checkSame<uint16>(4, 0, 256, 256, false);
+		checkSame<uint16>(1, 0, 512, 32, false);
+
+		const auto pixels = buildImage<uint8>(kBenchmarkSize, kBenchmarkSize, 0);
+		const uint32 mipmapCount = getMipmapCount(kBenchmarkSize, kBenchmarkSize);
+		const double megaPixels = double(kBenchmarkSize) * kBenchmarkSize / 1e6;
+
+		std::vector<std::vector<uint8>> referenceMipmaps;
+		const auto referenceBegin = std::chrono::high_resolution_clock::now();
+		buildMipmapReference<uint8>(4, 0, pixels.data(), mipmapCount, kBenchmarkSize, kBenchmarkSize, true, referenceMipmaps);
+		const double referenceSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - referenceBegin).count();
+
+		std::vector<std::vector<uint8>> mipmaps;
+		const auto begin = std::chrono::high_resolution_clock::now();
+		buildMipmap<uint8>(4, 0, pixels.data(), mipmapCount, kBenchmarkSize, kBenchmarkSize, true, mipmaps);
+		const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - begin).count();
+
+		check(mipmaps == referenceMipmaps);
+
+		LOG_INFO("Mipmap benchmark, {0}x{0} rgba8 srgb, worker count {1}, reference {2:.1f} MP/s parallel {3:.1f} MP/s.",
+			kBenchmarkSize, jobsystem::getUsableWorkerCount(true), megaPixels / referenceSeconds, megaPixels / seconds);
+		LOG_TRACE("Texture mipmap test pass.");
+
+		jobsystem::release(EBusyWaitType::All);
+	}
+}
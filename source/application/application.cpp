@@ -214,6 +214,30 @@ namespace chord
         return m_bInit;
     }
 
+    bool Application::initHeadless(const std::string& appName)
+    {
+        check(!m_bInit);
+        m_runtimePeriod = ERuntimePeriod::Initing;
+        m_bHeadless = true;
+
+        MainThread::get().init();
+
+        m_name = appName;
+        setConsoleUtf8();
+
+        // No render thread, only leave one core for main thread which busy wait jobs.
+        jobsystem::init();
+
+        m_assetManager = std::make_unique<AssetManager>();
+        m_timer.init();
+
+        m_bInit = true;
+
+        // No tick loop, headless application is always ticking after init.
+        m_runtimePeriod = ERuntimePeriod::Ticking;
+        return m_bInit;
+    }
+
     void Application::loop()
     {
         m_runtimePeriod = ERuntimePeriod::Ticking;
@@ -275,13 +299,31 @@ namespace chord
 
     void Application::release()
     {
+        if (m_bHeadless)
+        {
+            m_runtimePeriod = ERuntimePeriod::BeforeReleasing;
 
+            waitAllAssetAsyncSave();
+            MainThread::get().beforeRelease();
+
+            m_runtimePeriod = ERuntimePeriod::Releasing;
+            onRelease.broadcast();
+
+            m_assetManager.reset();
+            MainThread::get().release();
+
+            jobsystem::release(EBusyWaitType::All);
+            return;
+        }
 
         m_runtimePeriod = ERuntimePeriod::BeforeReleasing;
 
         m_engine->beforeRelease();
         m_context.beforeRelease();
 
+        // Async save may still writing, wait it finish and flush saved events.
+        waitAllAssetAsyncSave();
+
         // Flush sync event in main thread.
         MainThread::get().beforeRelease();
 
@@ -66,6 +66,9 @@ namespace chord
 		// Application init or not.
 		bool m_bInit = false;
 
+		// Application run without window and graphics context.
+		bool m_bHeadless = false;
+
 		// Application infos.
 		std::string m_name = { };
 		std::unique_ptr<ImageLdr2D> m_icon = nullptr;
@@ -91,6 +94,11 @@ namespace chord
 			return m_bInit; 
 		}
 
+		inline bool isHeadless() const
+		{
+			return m_bHeadless;
+		}
+
 		const auto getRuntimePeriod() const
 		{
 			return m_runtimePeriod;
@@ -131,6 +139,10 @@ namespace chord
 			GraphicsInitConfig graphicsConfig;
 		};
 		CHORD_NODISCARD bool init(const InitConfig& config);
+
+		// Init without window, graphics context, engine and gpu scene, only asset manager is valid.
+		// Used by offline tools such as asset cooker, call release() as usual when finish.
+		CHORD_NODISCARD bool initHeadless(const std::string& appName);
 		
 		// Application ticking loop.
 		void loop();
@@ -3,9 +3,21 @@
 #include <asset/texture/asset_texture.h>
 #include <asset/serialize.h>
 #include <asset/gltf/asset_gltf.h>
+#include <asset/asset_prefetch.h>
+#include <utils/job_system.h>
+#include <utils/profiler.h>
+#include <utils/cvar.h>
 
 namespace chord
 {
+	// Packed file override loose file, so editor keep it off and only cooked runtime enable it.
+	static uint32 sAssetPackEnable = 0;
+	static AutoCVarRef cVarAssetPackEnable(
+		"r.asset.pack",
+		sAssetPackEnable,
+		"Mount project asset pack when setup project or not, packed file override loose file so only enable in cooked runtime."
+	);
+
 	ChordEvent<AssetRef> chord::onAssetMarkDirtyEvents;
 	ChordEvent<AssetRef> chord::onAssetSavedEvents;
 	ChordEvent<AssetRef> chord::onAssetNewlySaveToDiskEvents;
@@ -32,6 +44,13 @@ namespace chord
 			return false;
 		}
 
+		// Wait in-flight async write, avoid older snapshot overwrite this save.
+		jobsystem::busyWaitUntil([this]()
+		{
+			std::lock_guard lock(m_asyncSaveState->mutex);
+			return !m_asyncSaveState->bWriting;
+		}, EBusyWaitType::All);
+
 		const bool bNewlySaveToDisk = !m_saveInfo.alreadyInDisk();
 
 		bool bSaveResult = onSave();
@@ -49,8 +68,119 @@ namespace chord
 		return bSaveResult;
 	}
 
+	// In-flight async save write job count.
+	static std::atomic<uint32> sAsyncSaveJobCount = 0;
+
+	bool IAsset::onSaveSnapshot(AsyncSaveSnapshot& out)
+	{
+		std::shared_ptr<IAsset> asset = shared_from_this();
+		out.data = serializeAsset(asset);
+		return true;
+	}
+
+	bool IAsset::saveAsync()
+	{
+		if (!isDirty())
+		{
+			return false;
+		}
+
+		if (m_saveInfo.empty())
+		{
+			LOG_ERROR("You must config save info before save an asset!");
+			return false;
+		}
+
+		AsyncSaveSnapshot snapshot { };
+		snapshot.path = m_saveInfo.path();
+		snapshot.editVersion = m_editVersion;
+		if (!onSaveSnapshot(snapshot))
+		{
+			return false;
+		}
+
+		bool bLaunchJob = false;
+		{
+			std::lock_guard lock(m_asyncSaveState->mutex);
+
+			// Replace older pending snapshot, running job pick the latest one.
+			m_asyncSaveState->pending = std::move(snapshot);
+			if (!m_asyncSaveState->bWriting)
+			{
+				m_asyncSaveState->bWriting = true;
+				bLaunchJob = true;
+			}
+		}
+
+		if (bLaunchJob)
+		{
+			sAsyncSaveJobCount ++;
+			jobsystem::launchSilently("AssetAsyncSave", EJobFlags::None, [asset = shared_from_this()]()
+			{
+				asyncSaveJob(asset);
+			});
+		}
+		return true;
+	}
+
+	void IAsset::asyncSaveJob(AssetRef asset)
+	{
+		ZoneScopedN("IAsset::asyncSaveJob");
+		auto& state = *asset->m_asyncSaveState;
+
+		while (true)
+		{
+			AsyncSaveSnapshot snapshot;
+			{
+				std::lock_guard lock(state.mutex);
+				if (!state.pending.has_value())
+				{
+					state.bWriting = false;
+					break;
+				}
+
+				snapshot = std::move(*state.pending);
+				state.pending.reset();
+			}
+
+			const bool bNewlySaveToDisk = !std::filesystem::exists(snapshot.path);
+			const bool bSaveResult = (!snapshot.onWrite || snapshot.onWrite())
+				&& writeAsset(std::move(snapshot.data), ECompressionMode::Lz4, snapshot.path);
+
+			// Asset keep dirty until here, so fail write or main command not run (e.g. shutdown) never lose edit.
+			ENQUEUE_MAIN_COMMAND([asset, bSaveResult, bNewlySaveToDisk, editVersion = snapshot.editVersion]()
+			{
+				if (!bSaveResult)
+				{
+					LOG_ERROR("Fail to save asset {}.", utf8::utf16to8(asset->getSaveInfo().path().u16string()));
+					return;
+				}
+
+				if (bNewlySaveToDisk)
+				{
+					onAssetNewlySaveToDiskEvents.broadcast(asset);
+				}
+
+				// Edit after snapshot still need save, keep dirty.
+				if (asset->m_editVersion == editVersion)
+				{
+					asset->m_bDirty = false;
+					onAssetSavedEvents.broadcast(asset);
+				}
+			});
+		}
+
+		sAsyncSaveJobCount --;
+	}
+
+	void waitAllAssetAsyncSave()
+	{
+		jobsystem::busyWaitUntil([]() { return sAsyncSaveJobCount.load() == 0; }, EBusyWaitType::All);
+	}
+
 	bool IAsset::markDirty()
 	{
+		m_editVersion ++;
 		if (m_bDirty)
 		{
 			return false;
@@ -86,61 +216,105 @@ namespace chord
 		registerAsset(GLTFMaterialAsset::kAssetTypeMeta);
 	}
 
+	// Only validate compressed meta header, full meta deserialize delay to first touch.
+	static bool isAssetMetaValid(const std::filesystem::path& path)
+	{
+		std::error_code ec;
+		const uint64 fileSize = std::filesystem::file_size(path, ec);
+
+		std::ifstream is(path, std::ios::binary);
+		if (ec || !is.is_open())
+		{
+			return false;
+		}
+
+		AssetCompressedMeta meta { };
+		try
+		{
+			cereal::BinaryInputArchive archive(is);
+			archive(meta);
+		}
+		catch (...)
+		{
+			return false;
+		}
+
+		return uint32(meta.compressionMode) < uint32(ECompressionMode::MAX)
+			&& meta.rawSize >= 0
+			&& meta.compressionSize >= 0
+			&& uint64(meta.compressionSize) <= fileSize;
+	}
+
 	void AssetManager::setupProject()
 	{
 		check(Project::get().isSetup());
+		ZoneScoped;
 
 		release();
-		
-		// Build from asset path recursive.
-		setupProjectRecursive(Project::get().getPath().assetPath.u16());
-	}
 
-	void AssetManager::setupProjectRecursive(const std::filesystem::path& path)
-	{
-		const bool bFolder = std::filesystem::is_directory(path);
-		if (bFolder)
+		const auto startTime = std::chrono::high_resolution_clock::now();
+		const std::filesystem::path registryPath = std::filesystem::path(Project::get().getPath().cachePath.u16()) / "AssetRegistry.bin";
+
+		// Warm start reuse registry, cold start validate all meta.
+		const bool bWarmStart = m_registry.load(registryPath);
+		const auto statistics = m_registry.scan(Project::get().getPath().assetPath.u16(), isAssetMetaValid);
+		m_registry.save(registryPath);
+
+		// Packed meta never scan from disk, only keep in memory registry.
+		uint32 packedCount = 0;
+		const auto packPath = assetpack::getProjectPackPath();
+		if (sAssetPackEnable && std::filesystem::exists(packPath) && assetpack::mount(packPath))
 		{
-			for (const auto& entry : std::filesystem::directory_iterator(path))
-			{
-				setupProjectRecursive(entry);
-			}
+			packedCount = m_registry.merge(assetpack::collectAssetMetaPaths());
 		}
-		else
+
+		const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count();
+		LOG_INFO("Asset registry {} start with {} assets in {} folders, reuse {}, validate {}, broken {}, packed {}, cost {:.3f} s.",
+			bWarmStart ? "warm" : "cold",
+			statistics.entryCount,
+			statistics.folderCount,
+			statistics.reuseCount,
+			statistics.validateCount,
+			statistics.invalidCount,
+			packedCount,
+			seconds);
+	}
+
+	std::vector<std::filesystem::path> AssetManager::getClassifiedAssetPaths(const std::string& suffix) const
+	{
+		const std::filesystem::path assetFolder = Project::get().getPath().assetPath.u16();
+		const auto& indices = m_registry.getClassifiedEntries(suffix);
+
+		std::vector<std::filesystem::path> result;
+		result.reserve(indices.size());
+		for (const uint32 index : indices)
 		{
-			const auto extension = path.extension().string();
-			// All asset extension start with .asset.
-			if (extension.starts_with(".asset"))
-			{
-				// When setup project, don't care thread safe.
-				tryLoadAsset(path, false);
-			}
+			result.push_back(assetFolder / utf8::utf8to16(m_registry.getEntries()[index].relativePath));
 		}
+		return result;
 	}
 
-	AssetRef AssetManager::tryLoadAsset(const std::filesystem::path& savePath, bool bThreadSafe)
+	AssetRef AssetManager::tryLoadAsset(const std::filesystem::path& savePath)
 	{
 		const auto saveInfo = AssetSaveInfo::buildRelativeAsset(savePath);
 		check(saveInfo.alreadyInDisk());
 
-		AssetRef result = nullptr;
-		const uint64 hash = saveInfo.hash();
-		{
-			auto lockScope = bThreadSafe 
-				? std::unique_lock<std::mutex>(m_assetsMapMutex) 
-				: std::unique_lock<std::mutex>();
+		assetprefetch::recordAccess(savePath);
 
-			if (m_assets[hash])
-			{
-				result = m_assets[hash];
-			}
-			else
-			{
-				// Load asset from disk.
-				check(chord::loadAsset(result, savePath));
+		// Concurrent load of same asset wait on in-flight one, different assets load in parallel.
+		bool bLoaded = false;
+		AssetRef result = m_assets.getOrLoad(saveInfo.hash(), [&]() -> AssetRef
+		{
+			// Callers dereference result directly, meta on disk must load.
+			AssetRef asset = nullptr;
+			const bool bLoadResult = chord::loadAsset(asset, savePath);
+			checkMsgf(bLoadResult, "Fail to load asset {}.", utf8::utf16to8(savePath.u16string()));
+			return asset;
+		}, bLoaded);
 
-				insertAsset(hash, result);
-			}
+		if (bLoaded)
+		{
+			onAssetInserted(result);
 		}
 		return result;
 	}
@@ -153,14 +327,16 @@ namespace chord
 
 	AssetRef AssetManager::removeAsset(uint64 id)
 	{
-		if (m_assets.contains(id))
+		if (auto asset = m_assets.find(id))
 		{
-			auto asset = m_assets[id];
 			onAssetRemoveEvents.broadcast(asset);
 
 			auto savePath = asset->getSaveInfo().path();
 			m_assets.erase(id);
-			m_classifiedAssets[savePath.extension().string()].erase(id);
+			{
+				std::lock_guard lock(m_classifiedAssetsMutex);
+				m_classifiedAssets[savePath.extension().string()].erase(id);
+			}
 
 			return asset;
 		}
@@ -170,12 +346,38 @@ namespace chord
 
 	void AssetManager::insertAsset(uint64 id, AssetRef asset)
 	{
-		auto savePath = asset->getSaveInfo().path();
+		// Exist check and insert happen under same shard lock.
+		const bool bInserted = m_assets.insert(id, asset);
+		checkMsgf(bInserted, "Asset {} already exist or is loading.", utf8::utf16to8(asset->getSaveInfo().path().u16string()));
+
+		onAssetInserted(asset);
+	}
 
-		m_assets[id] = asset;
-		m_classifiedAssets[savePath.extension().string()].insert(id);
+	void AssetManager::onAssetInserted(AssetRef asset)
+	{
+		auto savePath = asset->getSaveInfo().path();
+		const uint64 hash = asset->getSaveInfo().hash();
+		{
+			std::lock_guard lock(m_classifiedAssetsMutex);
+			m_classifiedAssets[savePath.extension().string()].insert(hash);
+		}
 
-		onAssetInsertEvents.broadcast(asset);
+		// Insert event handlers are main thread only, load on job thread defer broadcast to next main tick.
+		if (isInMainThread())
+		{
+			onAssetInsertEvents.broadcast(asset);
+		}
+		else
+		{
+			ENQUEUE_MAIN_COMMAND([this, asset, hash]()
+			{
+				// Skip if asset removed or replaced before main tick.
+				if (m_assets.find(hash) == asset)
+				{
+					onAssetInsertEvents.broadcast(asset);
+				}
+			});
+		}
 	}
 
 	bool AssetManager::changeSaveInfo(const AssetSaveInfo& newInfo, AssetRef asset)
@@ -185,7 +387,7 @@ namespace chord
 			return false;
 		}
 
-		check(m_assets.at(asset->getSaveInfo().hash()));
+		check(m_assets.contains(asset->getSaveInfo().hash()));
 		check(!m_assets.contains(newInfo.hash()));
 
 		removeAsset(asset->getSaveInfo().hash());
@@ -199,8 +401,16 @@ namespace chord
 
 	void AssetManager::release()
 	{
+		// Prefetch job may still map project files, stop them before unmount pack.
+		assetprefetch::cancel();
+		assetprefetch::waitAll();
+
 		// Clear all cache assets before setup project.
 		m_assets.clear();
+		m_registry.clear();
+		assetpack::unmountAll();
+
+		std::lock_guard lock(m_classifiedAssetsMutex);
 		m_classifiedAssets.clear();
 	}
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include <utils/utils.h>
 #include <asset/asset_common.h>
+#include <asset/asset_registry.h>
+#include <utils/sharded_map.h>
 #include <graphics/graphics.h>
 #include <utils/thread.h>
 #include <graphics/resource.h>
@@ -10,6 +12,7 @@
 namespace chord
 {
 	class IAsset;
+	using AssetRef = std::shared_ptr<IAsset>;
 
 	template<typename T>
 	void checkAssetDerivedType()
@@ -40,6 +43,22 @@ namespace chord
 		// ~IAsset virtual function.
 		virtual bool onSave() = 0;
 		virtual void onUnload() = 0;
+
+		struct AsyncSaveSnapshot
+		{
+			std::string data;
+			std::filesystem::path path;
+
+			// Type work run on write job before write meta, must not touch asset state, e.g. legacy bin upgrade.
+			std::function<bool()> onWrite = nullptr;
+
+			// Edit version when capture, fill by saveAsync.
+			uint64 editVersion = 0;
+		};
+
+		// Capture asset state for saveAsync on calling thread, default archive whole asset by cereal.
+		// Override to add type work of onSave into snapshot onWrite, compression and write always on job thread.
+		virtual bool onSaveSnapshot(AsyncSaveSnapshot& out);
 		// ~IAsset virtual function.
 
 	public:
@@ -60,6 +79,11 @@ namespace chord
 		// Save asset.
 		bool save();
 
+		// Snapshot asset state on calling thread, type save work, compress and write on job thread.
+		// Save again before previous write finish coalesce into one write of the latest snapshot.
+		// Asset keep dirty until write job success and no edit after snapshot, saved events broadcast in main thread.
+		bool saveAsync();
+
 	protected:
 		// ~IAsset virtual function.
 
@@ -110,9 +134,28 @@ namespace chord
 		std::filesystem::path getBinPath() const;
 
 	private:
+		// Shared with in-flight write job.
+		struct AsyncSaveState
+		{
+			std::mutex mutex;
+
+			// Write job is running.
+			bool bWriting = false;
+
+			// Latest snapshot wait for write.
+			std::optional<AsyncSaveSnapshot> pending;
+		};
+
+		static void asyncSaveJob(AssetRef asset);
+
 		// Asset is dirty or not.
 		bool m_bDirty = false;
 
+		// Increase when mark dirty, async save only clear dirty when no edit after its snapshot.
+		uint64 m_editVersion = 0;
+
+		std::shared_ptr<AsyncSaveState> m_asyncSaveState = std::make_shared<AsyncSaveState>();
+
 		// Snapshot texture weak object pointer.
 		graphics::GPUTextureAssetWeak m_snapshotWeakPtr { };
 
@@ -126,7 +169,9 @@ namespace chord
 		// Snapshot dimension.
 		math::uvec2 m_snapshotDimension { 0, 0 };
 	};
-	using AssetRef = std::shared_ptr<IAsset>;
+
+	// Busy wait until all in-flight async save write finish.
+	extern void waitAllAssetAsyncSave();
 
 	// Global events when asset mark dirty.
 	extern ChordEvent<AssetRef> onAssetMarkDirtyEvents;
@@ -145,11 +190,13 @@ namespace chord
 
 		void setupProject();
 
-	private:
-		void setupProjectRecursive(const std::filesystem::path& path);
+		// All project asset meta path of type (asset suffix) from registry, include asset not loaded yet.
+		// Registry is a snapshot when setup project, asset create after that not include.
+		std::vector<std::filesystem::path> getClassifiedAssetPaths(const std::string& suffix) const;
 
-		// Try load asset from path which store in disk.
-		AssetRef tryLoadAsset(const std::filesystem::path& savePath, bool bThreadSafe);
+	private:
+		// Try load asset from path which store in disk, disk io never hold map lock.
+		AssetRef tryLoadAsset(const std::filesystem::path& savePath);
 
 		// Register asset type.
 		void registerAsset(const AssetTypeMeta& type);
@@ -160,12 +207,16 @@ namespace chord
 		// Insert asset to map.
 		void insertAsset(uint64 id, AssetRef asset);
 
+		// Update classify and broadcast after asset insert into map.
+		void onAssetInserted(AssetRef asset);
+
 	public:
+		// Asset map is thread safe, load from any thread. Asset meta must exist on disk or in pack, fatal when load fail.
 		template<typename T>
-		std::shared_ptr<T> getOrLoadAsset(const std::filesystem::path& savePath, bool bThreadSafe)
+		std::shared_ptr<T> getOrLoadAsset(const std::filesystem::path& savePath)
 		{
 			checkAssetDerivedType<T>();
-			return std::dynamic_pointer_cast<T>(tryLoadAsset(savePath, bThreadSafe));
+			return std::dynamic_pointer_cast<T>(tryLoadAsset(savePath));
 		}
 
 		template<typename T>
@@ -179,21 +230,14 @@ namespace chord
 			checkAssetDerivedType<T>();
 			const uint64 hash = saveInfo.hash();
 
-			std::shared_ptr<T> newAsset = nullptr;
-			{
-				auto lockScope = bThreadSafe
-					? std::unique_lock<std::mutex>(m_assetsMapMutex)
-					: std::unique_lock<std::mutex>();
+			// NOTE: Don't create asset with same save info, insertAsset check it inside map lock.
+			std::shared_ptr<T> newAsset = std::make_shared<T>(saveInfo);
 
-				check(!m_assets[hash] && "Don't create asset with same save info.");
-				newAsset = std::make_shared<T>(saveInfo);
+			// Call post construct function.
+			newAsset->onPostConstruct();
 
-				// Call post construct function.
-				newAsset->onPostConstruct();
-
-				// Call insert asset first.
-				insertAsset(hash, newAsset);
-			}
+			// Call insert asset first.
+			insertAsset(hash, newAsset);
 
 			// Return result.
 			return newAsset;
@@ -205,10 +249,6 @@ namespace chord
 			checkAssetDerivedType<T>();
 			const uint64 hash = asset->getSaveInfo().hash();
 
-			auto lockScope = bThreadSafe
-				? std::unique_lock<std::mutex>(m_assetsMapMutex)
-				: std::unique_lock<std::mutex>();
-
 			// Unload all data of asset.
 			asset->onUnload();
 
@@ -224,7 +264,10 @@ namespace chord
 
 		AssetRef at(uint64 id) const
 		{
-			return m_assets.at(id);
+			auto asset = m_assets.find(id);
+			check(asset);
+
+			return asset;
 		}
 
 		bool changeSaveInfo(const AssetSaveInfo& newInfo, AssetRef asset);
@@ -235,17 +278,20 @@ namespace chord
 		// Static const registered meta infos.
 		std::unordered_map<std::string, const AssetTypeMeta*> m_registeredAssetType;
 
-		// Map store all engine assetes.
-		mutable std::mutex m_assetsMapMutex;
-
-		// All meta asset cache.
-		std::map<uint64, AssetRef> m_assets;
+		// All loaded meta asset cache, sharded by asset hash.
+		ShardedMap<uint64, AssetRef> m_assets;
 
 		// Classify by save info extension.
+		std::mutex m_classifiedAssetsMutex;
 		std::map<std::string, std::set<uint64>> m_classifiedAssets; 
+
+		// Index of all meta file in project.
+		AssetRegistry m_registry;
 	};
 
 	extern ChordEvent<AssetRef> onAssetRemoveEvents;
+
+	// Always broadcast in main thread, insert from job thread (prefetch, import) defer to next main tick.
 	extern ChordEvent<AssetRef> onAssetInsertEvents;
 }
 
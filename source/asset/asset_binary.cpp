@@ -0,0 +1,876 @@
+#include <asset/asset_binary.h>
+#include <asset/asset_pack.h>
+#include <asset/asset_prefetch.h>
+#include <asset/cook_stats.h>
+#include <utils/cityhash.h>
+#include <utils/crc.h>
+#include <utils/cvar.h>
+#include <utils/job_system.h>
+#include <project.h>
+
+#include <lz4hc.h>
+
+namespace chord
+{
+	static uint32 sAssetBinaryCompression = 1;
+	static AutoCVarRef cVarAssetBinaryCompression(
+		"r.asset.binary.compression",
+		sAssetBinaryCompression,
+		"Asset binary compression mode, 0 is none, 1 is lz4, 2 is lz4hc."
+	);
+
+	static uint32 sAssetBinaryLz4HCLevel = LZ4HC_CLEVEL_DEFAULT;
+	static AutoCVarRef cVarAssetBinaryLz4HCLevel(
+		"r.asset.binary.lz4hc.level",
+		sAssetBinaryLz4HCLevel,
+		"Asset binary lz4hc compression level, range [3, 12]."
+	);
+
+	static uint32 sAssetBinaryDictionary = 0;
+	static AutoCVarRef cVarAssetBinaryDictionary(
+		"r.asset.binary.dictionary",
+		sAssetBinaryDictionary,
+		"Compress asset binary with per asset type dictionary or not, default off until we have a real dictionary trainer."
+	);
+
+	uint64 assetbinary::buildSchemaHash(const std::vector<SchemaField>& fields)
+	{
+		uint64 hash = hashCombine(kVersion, kAssetVersion);
+		for (const auto& field : fields)
+		{
+			hash = hashCombine(hash, cityhash::cityhash64(field.name, strlen(field.name)));
+			hash = hashCombine(hash, field.stride);
+		}
+		return hash;
+	}
+
+	bool assetbinary::isAssetBinaryFile(const std::filesystem::path& path)
+	{
+		assetpack::FileView packed { };
+		if (assetpack::findFile(path, packed))
+		{
+			// Asset binary always pack without compression.
+			if (packed.entry->compression != (uint32)ECompressionMode::None || packed.entry->rawSize < sizeof(uint32))
+			{
+				return false;
+			}
+			return *(const uint32*)packed.pack->view(*packed.entry).data() == kMagic;
+		}
+
+		std::ifstream is(path, std::ios::binary);
+		if (!is.is_open())
+		{
+			return false;
+		}
+
+		uint32 magic = 0;
+		is.read((char*)&magic, sizeof(magic));
+		return is.good() && (magic == kMagic);
+	}
+
+	ECompressionMode assetbinary::getConfigCompressionMode()
+	{
+		return ECompressionMode(math::min(sAssetBinaryCompression, uint32(ECompressionMode::MAX) - 1));
+	}
+
+	namespace assetbinary
+	{
+		static std::mutex sDictionaryMutex;
+		static std::unordered_map<uint64, DictionaryRef> sDictionaryByHash;
+		static std::unordered_map<std::string, DictionaryRef> sDictionaryByType;
+
+		static std::filesystem::path getDictionaryPath(uint64 hash)
+		{
+			return getDictionaryFolder() / std::format("{:016x}.dict", hash);
+		}
+
+		static std::filesystem::path getDictionaryTypePath(const std::string& assetType)
+		{
+			return getDictionaryFolder() / (assetType + ".dictref");
+		}
+
+		static DictionaryRef loadDictionaryNoLock(uint64 hash)
+		{
+			if (auto iter = sDictionaryByHash.find(hash); iter != sDictionaryByHash.end())
+			{
+				return iter->second;
+			}
+
+			if (!Project::get().isSetup())
+			{
+				return nullptr;
+			}
+
+			auto dictionary = std::make_shared<Dictionary>();
+			dictionary->hash = hash;
+
+			std::string packedData;
+			if (assetpack::readPackedFile(getDictionaryPath(hash), packedData))
+			{
+				dictionary->data.assign(packedData.begin(), packedData.end());
+			}
+			else
+			{
+				std::ifstream is(getDictionaryPath(hash), std::ios::binary);
+				if (!is.is_open())
+				{
+					return nullptr;
+				}
+				dictionary->data.assign(std::istreambuf_iterator<char>(is), std::istreambuf_iterator<char>());
+			}
+
+			if (cityhash::cityhash64(dictionary->data.data(), dictionary->data.size()) != hash)
+			{
+				LOG_ERROR("Asset binary dictionary {:016x} is broken.", hash);
+				return nullptr;
+			}
+
+			sDictionaryByHash[hash] = dictionary;
+			return dictionary;
+		}
+	}
+
+	std::filesystem::path assetbinary::getDictionaryFolder()
+	{
+		return std::filesystem::path(Project::get().getPath().configPath.u16()) / "Dictionary";
+	}
+
+	assetbinary::DictionaryRef assetbinary::buildDictionary(const std::vector<std::span<const char>>& samples)
+	{
+		if (samples.empty())
+		{
+			return nullptr;
+		}
+
+		// Evenly pick head bytes of each sample, LZ4 match against dictionary so common header pattern matter most.
+		const size_t perSampleSize = math::max<size_t>(kDictionaryMaxSize / samples.size(), 64);
+
+		auto dictionary = std::make_shared<Dictionary>();
+		for (const auto& sample : samples)
+		{
+			const size_t copySize = math::min(math::min(perSampleSize, sample.size()), kDictionaryMaxSize - dictionary->data.size());
+			dictionary->data.insert(dictionary->data.end(), sample.data(), sample.data() + copySize);
+
+			if (dictionary->data.size() >= kDictionaryMaxSize)
+			{
+				break;
+			}
+		}
+
+		if (dictionary->data.empty())
+		{
+			return nullptr;
+		}
+
+		dictionary->hash = cityhash::cityhash64(dictionary->data.data(), dictionary->data.size());
+
+		// Register in memory, so reader can decode before dictionary saved.
+		{
+			std::lock_guard lock(sDictionaryMutex);
+			sDictionaryByHash[dictionary->hash] = dictionary;
+		}
+		return dictionary;
+	}
+
+	assetbinary::DictionaryRef assetbinary::findDictionary(const std::string& assetType)
+	{
+		if (!sAssetBinaryDictionary || !Project::get().isSetup())
+		{
+			return nullptr;
+		}
+
+		std::lock_guard lock(sDictionaryMutex);
+		if (auto iter = sDictionaryByType.find(assetType); iter != sDictionaryByType.end())
+		{
+			return iter->second;
+		}
+
+		uint64 hash = 0;
+		{
+			std::ifstream is(getDictionaryTypePath(assetType));
+			if (!is.is_open() || !(is >> std::hex >> hash))
+			{
+				return nullptr;
+			}
+		}
+
+		auto dictionary = loadDictionaryNoLock(hash);
+		if (dictionary)
+		{
+			sDictionaryByType[assetType] = dictionary;
+		}
+		return dictionary;
+	}
+
+	bool assetbinary::saveDictionary(const std::string& assetType, DictionaryRef dictionary)
+	{
+		if (!Project::get().isSetup())
+		{
+			return false;
+		}
+
+		std::lock_guard lock(sDictionaryMutex);
+
+		std::error_code ec;
+		std::filesystem::create_directories(getDictionaryFolder(), ec);
+
+		// Dictionary file never overwrite, old bins keep decodable after retrain.
+		const auto dictionaryPath = getDictionaryPath(dictionary->hash);
+		if (!std::filesystem::exists(dictionaryPath))
+		{
+			std::ofstream os(dictionaryPath, std::ios::binary);
+			os.write(dictionary->data.data(), dictionary->data.size());
+			if (!os.good())
+			{
+				LOG_ERROR("Fail to save asset binary dictionary {}.", utf8::utf16to8(dictionaryPath.u16string()));
+				return false;
+			}
+		}
+
+		{
+			std::ofstream os(getDictionaryTypePath(assetType));
+			os << std::format("{:016x}", dictionary->hash);
+		}
+
+		sDictionaryByHash[dictionary->hash] = dictionary;
+		sDictionaryByType[assetType] = dictionary;
+		return true;
+	}
+
+	assetbinary::DictionaryRef assetbinary::loadDictionary(uint64 hash)
+	{
+		std::lock_guard lock(sDictionaryMutex);
+		return loadDictionaryNoLock(hash);
+	}
+
+
+	namespace assetbinary
+	{
+		// Chunk raw size must hold whole elements, so filter can decode chunk independently.
+		static uint32 getSectionChunkRawSize(uint32 stride, EAssetBinaryFilter filter)
+		{
+			const uint32 elementGroupSize = stride * getFilterGranularity(filter);
+			return math::max(kChunkRawSize / elementGroupSize, 1U) * elementGroupSize;
+		}
+	}
+
+	void AssetBinaryWriter::addSection(const void* data, uint64 size, uint32 stride, EAssetBinaryFilter filter)
+	{
+		check(stride > 0 && size % stride == 0);
+
+		filter = assetbinary::getConfigFilter(filter);
+		if (!assetbinary::isFilterSupported(filter, stride))
+		{
+			LOG_WARN("Asset binary filter {} don't support stride {}, fallback to none.", (uint32)filter, stride);
+			filter = EAssetBinaryFilter::None;
+		}
+
+		m_sections.push_back({ .data = data, .size = size, .stride = stride, .filter = filter });
+	}
+
+	bool AssetBinaryWriter::write(const std::filesystem::path& savePath, uint64 schemaHash, ECompressionMode compression) const
+	{
+		using namespace assetbinary;
+
+		DictionaryRef dictionary = nullptr;
+		if (compression != ECompressionMode::None && !m_dictionaryType.empty() && sAssetBinaryDictionary && Project::get().isSetup())
+		{
+			dictionary = findDictionary(m_dictionaryType);
+			if (!dictionary)
+			{
+				// First time save this asset type, train dictionary from current sections.
+				// Dictionary match against filtered stream, so sample after filter.
+				std::vector<std::vector<char>> filtered;
+				std::vector<std::span<const char>> samples;
+				for (const auto& pending : m_sections)
+				{
+					const uint32 chunkRawSize = getSectionChunkRawSize(pending.stride, pending.filter);
+					for (uint64 offset = 0; offset < pending.size; offset += chunkRawSize)
+					{
+						auto& sample = filtered.emplace_back();
+						if (encodeFilter(pending.filter, (const char*)pending.data + offset, math::min<uint64>(chunkRawSize, pending.size - offset), pending.stride, sample))
+						{
+							samples.push_back({ sample.data(), sample.size() });
+						}
+					}
+				}
+
+				dictionary = buildDictionary(samples);
+				if (dictionary && !saveDictionary(m_dictionaryType, dictionary))
+				{
+					dictionary = nullptr;
+				}
+			}
+		}
+
+		return write(savePath, schemaHash, compression, dictionary);
+	}
+
+	bool AssetBinaryWriter::writeStream(std::ostream& os, const std::filesystem::path& debugPath, uint64 schemaHash, ECompressionMode compression, assetbinary::DictionaryRef dictionary) const
+	{
+		using namespace assetbinary;
+		ZoneScopedN("AssetBinaryWriter::write");
+
+		std::vector<Section> sections(m_sections.size());
+		std::vector<Chunk> chunks;
+		std::vector<const char*> chunkSources;
+		std::vector<uint32> chunkSections;
+
+		for (size_t i = 0; i < sections.size(); i++)
+		{
+			const auto& pending = m_sections[i];
+
+			sections[i] = { };
+			sections[i].rawSize      = pending.size;
+			sections[i].stride       = pending.stride;
+			sections[i].filter       = (uint32)pending.filter;
+			sections[i].chunkRawSize = getSectionChunkRawSize(pending.stride, pending.filter);
+			sections[i].firstChunk   = (uint32)chunks.size();
+			sections[i].chunkCount   = (uint32)divideRoundingUp<uint64>(pending.size, sections[i].chunkRawSize);
+
+			for (uint32 chunkId = 0; chunkId < sections[i].chunkCount; chunkId++)
+			{
+				const uint64 rawOffset = uint64(chunkId) * sections[i].chunkRawSize;
+
+				Chunk chunk { };
+				chunk.rawSize     = (uint32)math::min<uint64>(sections[i].chunkRawSize, pending.size - rawOffset);
+				chunk.compression = (uint32)ECompressionMode::None;
+
+				chunks.push_back(chunk);
+				chunkSources.push_back((const char*)pending.data + rawOffset);
+				chunkSections.push_back((uint32)i);
+			}
+		}
+
+		// Filtered payload of each chunk, empty if no filter.
+		std::vector<std::vector<char>> filteredChunks(chunks.size());
+
+		// Stored payload of each chunk, empty if chunk keep filtered bytes.
+		std::vector<std::vector<char>> compressedChunks(chunks.size());
+
+		std::atomic<bool> bFilterResult = true;
+
+		// All chunks are independent, filter and compress in parallel.
+		auto compressChunks = [&](const uint32 loopStart, const uint32 loopEnd)
+		{
+			// Stream state is large, allocate once per job.
+			std::unique_ptr<LZ4_stream_t, decltype(&LZ4_freeStream)> stream(nullptr, &LZ4_freeStream);
+			std::unique_ptr<LZ4_streamHC_t, decltype(&LZ4_freeStreamHC)> streamHC(nullptr, &LZ4_freeStreamHC);
+
+			for (uint32 i = loopStart; i < loopEnd; i++)
+			{
+				auto& chunk = chunks[i];
+				const auto& pending = m_sections[chunkSections[i]];
+
+				const char* filteredData = chunkSources[i];
+				chunk.filteredSize = chunk.rawSize;
+				if (pending.filter != EAssetBinaryFilter::None)
+				{
+					auto& filtered = filteredChunks[i];
+					if (!encodeFilter(pending.filter, chunkSources[i], chunk.rawSize, pending.stride, filtered))
+					{
+						bFilterResult = false;
+						continue;
+					}
+
+					filteredData = filtered.data();
+					chunk.filteredSize = (uint32)filtered.size();
+				}
+
+				chunk.crc = crc::crc32(filteredData, chunk.filteredSize, 0);
+				chunk.storedSize = chunk.filteredSize;
+				if (compression == ECompressionMode::None)
+				{
+					continue;
+				}
+
+				auto& compressed = compressedChunks[i];
+				compressed.resize(LZ4_compressBound((int32)chunk.filteredSize));
+
+				int32 compressedSize = 0;
+				if (compression == ECompressionMode::Lz4)
+				{
+					if (!stream)
+					{
+						stream.reset(LZ4_createStream());
+					}
+					LZ4_resetStream_fast(stream.get());
+
+					if (dictionary)
+					{
+						LZ4_loadDict(stream.get(), dictionary->data.data(), (int32)dictionary->data.size());
+					}
+					compressedSize = LZ4_compress_fast_continue(stream.get(), filteredData, compressed.data(), (int32)chunk.filteredSize, (int32)compressed.size(), 1);
+				}
+				else if (compression == ECompressionMode::Lz4HC)
+				{
+					if (!streamHC)
+					{
+						streamHC.reset(LZ4_createStreamHC());
+					}
+					LZ4_resetStreamHC_fast(streamHC.get(), (int32)sAssetBinaryLz4HCLevel);
+
+					if (dictionary)
+					{
+						LZ4_loadDictHC(streamHC.get(), dictionary->data.data(), (int32)dictionary->data.size());
+					}
+					compressedSize = LZ4_compress_HC_continue(streamHC.get(), filteredData, compressed.data(), (int32)chunk.filteredSize, (int32)compressed.size());
+				}
+				else
+				{
+					checkEntry();
+				}
+
+				// Keep uncompressed if compression can't save size, raw chunk is zero copy when load.
+				if (compressedSize > 0 && uint32(compressedSize) < chunk.filteredSize)
+				{
+					compressed.resize(compressedSize);
+					chunk.storedSize  = (uint32)compressedSize;
+					chunk.compression = (uint32)compression;
+				}
+				else
+				{
+					compressed.clear();
+				}
+			}
+		};
+
+		{
+			cookstats::ScopedStage stage("binary.compress", m_report);
+
+			uint64 rawSize = 0;
+			for (const auto& section : sections)
+			{
+				rawSize += section.rawSize;
+			}
+			stage.setBytes(rawSize);
+
+			if (chunks.size() > 1)
+			{
+				jobsystem::parallelFor("AssetBinaryCompress", EBusyWaitType::All, (uint32)chunks.size(), EJobFlags::Foreground, compressChunks);
+			}
+			else
+			{
+				compressChunks(0, (uint32)chunks.size());
+			}
+		}
+
+		if (!bFilterResult)
+		{
+			LOG_ERROR("Fail to filter asset binary {}.", utf8::utf16to8(debugPath.u16string()));
+			return false;
+		}
+
+		bool bAnyCompressed = false;
+		for (const auto& chunk : chunks)
+		{
+			bAnyCompressed |= (chunk.compression != (uint32)ECompressionMode::None);
+		}
+
+		// Layout all chunks, only first chunk of section align so raw section keep contiguous.
+		uint64 offset = sizeof(Header) + sizeof(Section) * sections.size() + sizeof(Chunk) * chunks.size();
+		for (const auto& section : sections)
+		{
+			if (section.chunkCount > 0)
+			{
+				offset = alignRoundingUp(offset, kChunkAlignment);
+			}
+
+			for (uint32 i = 0; i < section.chunkCount; i++)
+			{
+				auto& chunk = chunks[section.firstChunk + i];
+				chunk.fileOffset = offset;
+				offset += chunk.storedSize;
+			}
+		}
+
+		Header header { };
+		header.magic          = kMagic;
+		header.version        = kVersion;
+		header.schemaHash     = schemaHash;
+		header.sectionCount   = (uint32)sections.size();
+		header.chunkCount     = (uint32)chunks.size();
+		header.fileSize       = offset;
+		header.dictionaryHash = (dictionary && bAnyCompressed) ? dictionary->hash : 0;
+
+		cookstats::ScopedStage stage("binary.write", m_report);
+		stage.setBytes(header.fileSize);
+
+		os.write((const char*)&header, sizeof(header));
+		os.write((const char*)sections.data(), sizeof(Section) * sections.size());
+		os.write((const char*)chunks.data(), sizeof(Chunk) * chunks.size());
+
+		static const char kPadding[kChunkAlignment] = { };
+		for (size_t i = 0; i < chunks.size(); i++)
+		{
+			const uint64 padSize = chunks[i].fileOffset - (uint64)os.tellp();
+			check(padSize < kChunkAlignment);
+			os.write(kPadding, padSize);
+
+			const char* stored =
+				!compressedChunks[i].empty() ? compressedChunks[i].data() :
+				!filteredChunks[i].empty()   ? filteredChunks[i].data()   : chunkSources[i];
+			os.write(stored, chunks[i].storedSize);
+		}
+
+		check((uint64)os.tellp() == header.fileSize);
+		if (!os.good())
+		{
+			LOG_ERROR("Fail to write asset binary {}.", utf8::utf16to8(debugPath.u16string()));
+			return false;
+		}
+		return true;
+	}
+
+	bool AssetBinaryWriter::write(const std::filesystem::path& savePath, uint64 schemaHash, ECompressionMode compression, assetbinary::DictionaryRef dictionary) const
+	{
+		// Write to temp file then rename, mapped reader never see half write bin.
+		const auto tempPath = std::filesystem::path(savePath).concat(std::format(".{}.tmp", std::hash<std::thread::id>{ }(std::this_thread::get_id())));
+		{
+			std::ofstream os(tempPath, std::ios::binary | std::ios::trunc);
+			if (!os.is_open())
+			{
+				LOG_ERROR("Fail to open asset binary {} to write.", utf8::utf16to8(tempPath.u16string()));
+				return false;
+			}
+
+			if (!writeStream(os, savePath, schemaHash, compression, dictionary))
+			{
+				os.close();
+
+				std::error_code ec;
+				std::filesystem::remove(tempPath, ec);
+				return false;
+			}
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, savePath, ec);
+		if (ec)
+		{
+			LOG_ERROR("Fail to replace asset binary {}: {}.", utf8::utf16to8(savePath.u16string()), ec.message());
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+		return true;
+	}
+
+	bool AssetBinaryWriter::writeMemory(std::string& out, const std::filesystem::path& debugPath, uint64 schemaHash) const
+	{
+		std::ostringstream os(std::ios::binary);
+		if (!writeStream(os, debugPath, schemaHash, ECompressionMode::None, nullptr))
+		{
+			return false;
+		}
+
+		out = std::move(os).str();
+		return true;
+	}
+
+	void AssetBinaryReader::reset()
+	{
+		m_file.close();
+		m_packOwner = nullptr;
+		m_packEntryData.clear();
+
+		m_data = nullptr;
+		m_size = 0;
+	}
+
+	bool AssetBinaryReader::open(const std::filesystem::path& path, uint64 schemaHash)
+	{
+		return open(path, std::span<const uint64>(&schemaHash, 1));
+	}
+
+	bool AssetBinaryReader::open(const std::filesystem::path& path, std::span<const uint64> schemaHashes)
+	{
+		using namespace assetbinary;
+
+		m_header     = nullptr;
+		m_sections   = nullptr;
+		m_chunks     = nullptr;
+		m_dictionary = nullptr;
+		m_path       = path;
+		reset();
+
+		assetprefetch::recordAccess(path);
+
+		assetpack::FileView packed { };
+		if (assetpack::findFile(path, packed))
+		{
+			if (packed.entry->compression == (uint32)ECompressionMode::None)
+			{
+				const auto view = packed.pack->view(*packed.entry);
+				m_data = view.data();
+				m_size = view.size();
+			}
+			else if (packed.pack->read(*packed.entry, m_packEntryData))
+			{
+				m_data = (const uint8*)m_packEntryData.data();
+				m_size = m_packEntryData.size();
+			}
+			m_packOwner = packed.pack;
+		}
+		else if (m_file.open(path))
+		{
+			m_data = m_file.data();
+			m_size = m_file.size();
+		}
+
+		return validate(schemaHashes);
+	}
+
+	bool AssetBinaryReader::openMemory(std::string&& data, const std::filesystem::path& path, uint64 schemaHash)
+	{
+		m_header     = nullptr;
+		m_sections   = nullptr;
+		m_chunks     = nullptr;
+		m_dictionary = nullptr;
+		m_path       = path;
+		reset();
+
+		m_packEntryData = std::move(data);
+		m_data = (const uint8*)m_packEntryData.data();
+		m_size = m_packEntryData.size();
+
+		return validate(std::span<const uint64>(&schemaHash, 1));
+	}
+
+	bool AssetBinaryReader::validate(std::span<const uint64> schemaHashes)
+	{
+		using namespace assetbinary;
+		const auto& path = m_path;
+
+		if (m_size < sizeof(Header))
+		{
+			reset();
+			return false;
+		}
+
+		const auto* header = (const Header*)m_data;
+		if (header->magic != kMagic)
+		{
+			// Not container format.
+			reset();
+			return false;
+		}
+
+		if (header->version != kVersion || std::ranges::find(schemaHashes, header->schemaHash) == schemaHashes.end())
+		{
+			LOG_WARN("Asset binary {} schema is stale, need to rebuild.", utf8::utf16to8(path.u16string()));
+			reset();
+			return false;
+		}
+
+		const uint64 tableEnd = sizeof(Header) + sizeof(Section) * header->sectionCount + sizeof(Chunk) * header->chunkCount;
+		if (header->fileSize != m_size || tableEnd > m_size)
+		{
+			LOG_ERROR("Asset binary {} is broken.", utf8::utf16to8(path.u16string()));
+			reset();
+			return false;
+		}
+
+		const auto* sections = (const Section*)(m_data + sizeof(Header));
+		const auto* chunks = (const Chunk*)(m_data + sizeof(Header) + sizeof(Section) * header->sectionCount);
+
+		bool bValid = true;
+		for (uint32 i = 0; i < header->sectionCount && bValid; i++)
+		{
+			const auto& section = sections[i];
+
+			bValid &= (uint64(section.firstChunk) + section.chunkCount <= header->chunkCount);
+			bValid &= (section.stride > 0) && (section.chunkRawSize > 0) && (section.chunkRawSize % section.stride == 0);
+			bValid &= (section.filter < (uint32)EAssetBinaryFilter::MAX);
+			if (!bValid)
+			{
+				break;
+			}
+
+			uint64 sectionRawSize = 0;
+			for (uint32 j = 0; j < section.chunkCount; j++)
+			{
+				const auto& chunk = chunks[section.firstChunk + j];
+				const bool bLastChunk = (j + 1 == section.chunkCount);
+
+				bValid &= (chunk.fileOffset <= m_size) && (chunk.storedSize <= m_size - chunk.fileOffset);
+				bValid &= bLastChunk ? (chunk.rawSize <= section.chunkRawSize) : (chunk.rawSize == section.chunkRawSize);
+				bValid &= (chunk.compression < (uint32)ECompressionMode::MAX);
+
+				// Read chunk decode into dest sized by raw size when no filter, and crc filtered bytes in place when no compression.
+				bValid &= (section.filter != (uint32)EAssetBinaryFilter::None) || (chunk.filteredSize == chunk.rawSize);
+				bValid &= (chunk.compression != (uint32)ECompressionMode::None) || (chunk.storedSize == chunk.filteredSize);
+
+				sectionRawSize += chunk.rawSize;
+			}
+			bValid &= (sectionRawSize == section.rawSize);
+		}
+
+		if (!bValid)
+		{
+			LOG_ERROR("Asset binary {} table out of range.", utf8::utf16to8(path.u16string()));
+			reset();
+			return false;
+		}
+
+		if (header->dictionaryHash != 0)
+		{
+			m_dictionary = loadDictionary(header->dictionaryHash);
+			if (!m_dictionary)
+			{
+				LOG_ERROR("Asset binary {} dictionary {:016x} miss.", utf8::utf16to8(path.u16string()), header->dictionaryHash);
+				reset();
+				return false;
+			}
+		}
+
+		// Pointer fix-up.
+		m_header   = header;
+		m_sections = sections;
+		m_chunks   = chunks;
+
+		return true;
+	}
+
+	bool AssetBinaryReader::isSectionRaw(uint32 index) const
+	{
+		const auto& section = m_sections[index];
+		if (section.filter != (uint32)EAssetBinaryFilter::None)
+		{
+			return false;
+		}
+
+		for (uint32 i = 0; i < section.chunkCount; i++)
+		{
+			if (m_chunks[section.firstChunk + i].compression != (uint32)ECompressionMode::None)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool AssetBinaryReader::readChunk(const assetbinary::Section& section, uint32 chunkIndex, void* dest) const
+	{
+		const auto& chunk = m_chunks[chunkIndex];
+		const char* stored = (const char*)m_data + chunk.fileOffset;
+		const EAssetBinaryFilter filter = EAssetBinaryFilter(section.filter);
+
+		// Filtered bytes decode into dest directly when no filter, else decode into scratch first.
+		thread_local std::vector<char> filteredBuffer;
+		const char* filtered = stored;
+
+		if (chunk.compression == (uint32)ECompressionMode::Lz4 || chunk.compression == (uint32)ECompressionMode::Lz4HC)
+		{
+			char* decompressDest = (char*)dest;
+			if (filter != EAssetBinaryFilter::None)
+			{
+				filteredBuffer.resize(chunk.filteredSize);
+				decompressDest = filteredBuffer.data();
+			}
+
+			// Lz4HC share same block format with Lz4.
+			const int32 filteredSize = m_dictionary
+				? LZ4_decompress_safe_usingDict(stored, decompressDest, (int32)chunk.storedSize, (int32)chunk.filteredSize, m_dictionary->data.data(), (int32)m_dictionary->data.size())
+				: LZ4_decompress_safe(stored, decompressDest, (int32)chunk.storedSize, (int32)chunk.filteredSize);
+
+			if (filteredSize != (int32)chunk.filteredSize)
+			{
+				LOG_ERROR("Asset binary {} chunk #{} decompress fail.", utf8::utf16to8(m_path.u16string()), chunkIndex);
+				return false;
+			}
+			filtered = decompressDest;
+		}
+		else if (chunk.compression != (uint32)ECompressionMode::None)
+		{
+			checkEntry();
+		}
+
+		if (crc::crc32(filtered, chunk.filteredSize, 0) != chunk.crc)
+		{
+			LOG_ERROR("Asset binary {} chunk #{} checksum un-match.", utf8::utf16to8(m_path.u16string()), chunkIndex);
+			return false;
+		}
+
+		if (filtered == dest)
+		{
+			return true;
+		}
+
+		if (!assetbinary::decodeFilter(filter, filtered, chunk.filteredSize, section.stride, dest, chunk.rawSize))
+		{
+			LOG_ERROR("Asset binary {} chunk #{} filter decode fail.", utf8::utf16to8(m_path.u16string()), chunkIndex);
+			return false;
+		}
+
+		return true;
+	}
+
+	bool AssetBinaryReader::readSectionRange(uint32 index, uint64 byteOffset, uint64 byteSize, void* dest) const
+	{
+		const auto& section = m_sections[index];
+		checkMsgf(byteOffset + byteSize <= section.rawSize, "Asset binary section #{} read out of range!", index);
+
+		if (byteSize == 0)
+		{
+			return true;
+		}
+
+		const uint32 beginChunk = uint32(byteOffset / section.chunkRawSize);
+		const uint32 endChunk   = uint32((byteOffset + byteSize - 1) / section.chunkRawSize);
+
+		std::atomic<bool> bResult = true;
+		auto readChunks = [&](const uint32 loopStart, const uint32 loopEnd)
+		{
+			std::vector<uint8> chunkBuffer;
+			for (uint32 chunkId = beginChunk + loopStart; chunkId < beginChunk + loopEnd; chunkId++)
+			{
+				// Other job already fail, no need to decode more.
+				if (!bResult)
+				{
+					return;
+				}
+
+				const uint32 chunkIndex = section.firstChunk + chunkId;
+				const auto& chunk = m_chunks[chunkIndex];
+
+				// Overlap range of current chunk.
+				const uint64 chunkRawOffset = uint64(chunkId) * section.chunkRawSize;
+				const uint64 copyBegin = math::max(byteOffset, chunkRawOffset);
+				const uint64 copyEnd   = math::min(byteOffset + byteSize, chunkRawOffset + chunk.rawSize);
+
+				uint8* copyDest = (uint8*)dest + (copyBegin - byteOffset);
+				if (copyBegin == chunkRawOffset && copyEnd == chunkRawOffset + chunk.rawSize)
+				{
+					// Whole chunk, decode into dest directly.
+					if (!readChunk(section, chunkIndex, copyDest))
+					{
+						bResult = false;
+						return;
+					}
+				}
+				else
+				{
+					chunkBuffer.resize(chunk.rawSize);
+					if (!readChunk(section, chunkIndex, chunkBuffer.data()))
+					{
+						bResult = false;
+						return;
+					}
+					memcpy(copyDest, chunkBuffer.data() + (copyBegin - chunkRawOffset), copyEnd - copyBegin);
+				}
+			}
+		};
+
+		const uint32 chunkCount = endChunk - beginChunk + 1;
+		if (chunkCount > 1)
+		{
+			jobsystem::parallelFor("AssetBinaryDecompress", EBusyWaitType::All, chunkCount, EJobFlags::Foreground, readChunks);
+		}
+		else
+		{
+			readChunks(0, chunkCount);
+		}
+
+		return bResult;
+	}
+}
@@ -0,0 +1,339 @@
+#pragma once
+
+#include <utils/utils.h>
+#include <utils/log.h>
+#include <utils/mapped_file.h>
+#include <asset/asset_binary_filter.h>
+#include <asset/cook_stats.h>
+
+namespace chord
+{
+	enum class ECompressionMode
+	{
+		None,
+		Lz4,
+
+		// Slow compression but same decompression speed, used for cooked build.
+		Lz4HC,
+
+		MAX
+	};
+
+	// Relocatable chunked binary container for POD-heavy asset bin.
+	//   [Header][Section table][Chunk table][Section 0 chunks][Section 1 chunks]...
+	// Each section split into element aligned chunks, every chunk filter and compress independently and hold own crc32,
+	// so a sub range of section (one mip, one primitive) only need to read and decompress overlapped chunks.
+	// Independent chunks also compress and decompress in parallel on job system.
+	// Section data start with kChunkAlignment and its chunks are contiguous, raw section can upload straight from mapping.
+	namespace assetbinary
+	{
+		constexpr uint32 kMagic = 0x4E424843; // "CHBN"
+		constexpr uint32 kVersion = 4;
+		constexpr uint64 kChunkAlignment = 64;
+		constexpr uint32 kChunkRawSize = 256 * 1024;
+		static_assert(kChunkRawSize % kChunkAlignment == 0);
+
+		struct Header
+		{
+			uint32 magic;
+			uint32 version;
+
+			// Layout hash of stored sections, mismatch meaning file is stale.
+			uint64 schemaHash;
+
+			uint32 sectionCount;
+			uint32 chunkCount;
+
+			uint64 fileSize;
+
+			// Hash of dictionary used by compressed chunks, zero if no dictionary.
+			uint64 dictionaryHash;
+		};
+		static_assert(sizeof(Header) == 40);
+
+		struct Section
+		{
+			// Uncompressed section size.
+			uint64 rawSize;
+
+			// Element stride in bytes.
+			uint32 stride;
+
+			// Chunk range in chunk table.
+			uint32 firstChunk;
+			uint32 chunkCount;
+
+			// EAssetBinaryFilter.
+			uint32 filter;
+
+			// Raw size of each chunk except last one, multiple of stride.
+			uint32 chunkRawSize;
+
+			uint64 pad0;
+		};
+		static_assert(sizeof(Section) == 40);
+
+		struct Chunk
+		{
+			// Offset relative to file start.
+			uint64 fileOffset;
+
+			uint32 rawSize;
+			uint32 filteredSize;
+			uint32 storedSize;
+
+			// crc32 of filtered data before compression.
+			uint32 crc;
+
+			// ECompressionMode.
+			uint32 compression;
+
+			uint32 pad0;
+		};
+		static_assert(sizeof(Chunk) == 32);
+
+		// Schema field describe one section, build hash from name and element stride.
+		struct SchemaField
+		{
+			const char* name;
+			uint32 stride;
+		};
+
+		extern uint64 buildSchemaHash(const std::vector<SchemaField>& fields);
+
+		// Check file magic, used to distinguish legacy cereal bin.
+		extern bool isAssetBinaryFile(const std::filesystem::path& path);
+
+		// Compression mode config by r.asset.binary.compression.
+		extern ECompressionMode getConfigCompressionMode();
+
+		// LZ4 dictionary shared by all bins of one asset type, stored in Config/Dictionary so it ship with project and pack,
+		// cache clean never drop dictionary which cooked bins still reference.
+		// NOTE: LZ4 no trainer, dictionary only concat head bytes of first saved asset chunks, gain is tiny so default off.
+		struct Dictionary
+		{
+			uint64 hash;
+			std::vector<char> data;
+		};
+		using DictionaryRef = std::shared_ptr<const Dictionary>;
+
+		// LZ4 only use last 64KB as dictionary.
+		constexpr uint32 kDictionaryMaxSize = 64 * 1024;
+
+		// Project folder which hold all dictionaries.
+		extern std::filesystem::path getDictionaryFolder();
+
+		// Build dictionary from samples.
+		extern DictionaryRef buildDictionary(const std::vector<std::span<const char>>& samples);
+
+		// Find dictionary of asset type, return nullptr if not exist or dictionary disable.
+		extern DictionaryRef findDictionary(const std::string& assetType);
+
+		// Save dictionary as current dictionary of asset type.
+		extern bool saveDictionary(const std::string& assetType, DictionaryRef dictionary);
+
+		// Load dictionary by hash, reader use it to decode.
+		extern DictionaryRef loadDictionary(uint64 hash);
+	}
+
+	class AssetBinaryWriter : NonCopyable
+	{
+	public:
+		// NOTE: Writer don't copy data, input data must keep alive until write finish.
+		//       Filter fallback to none if it not support the stride.
+		void addSection(const void* data, uint64 size, uint32 stride, EAssetBinaryFilter filter = EAssetBinaryFilter::None);
+
+		template<typename T>
+		void addSection(const std::vector<T>& data, EAssetBinaryFilter filter = EAssetBinaryFilter::None)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "Asset binary section only support POD type.");
+			addSection(data.data(), data.size() * sizeof(T), sizeof(T), filter);
+		}
+
+		// Compress with dictionary of asset type, dictionary will train from this writer if no exist.
+		void setDictionaryType(const std::string& assetType)
+		{
+			m_dictionaryType = assetType;
+		}
+
+		// Compress and write stages also record into import report.
+		void setReport(cookstats::Report* report)
+		{
+			m_report = report;
+		}
+
+		// Write all sections to disk, chunk fallback to uncompressed if compression can't save size.
+		bool write(const std::filesystem::path& savePath, uint64 schemaHash, ECompressionMode compression = ECompressionMode::Lz4) const;
+
+		// Write with explicit dictionary, used by benchmark and cook.
+		bool write(const std::filesystem::path& savePath, uint64 schemaHash, ECompressionMode compression, assetbinary::DictionaryRef dictionary) const;
+
+		// Write uncompressed container into memory, used to view legacy bin without touching the file.
+		bool writeMemory(std::string& out, const std::filesystem::path& debugPath, uint64 schemaHash) const;
+
+	private:
+		bool writeStream(std::ostream& os, const std::filesystem::path& debugPath, uint64 schemaHash, ECompressionMode compression, assetbinary::DictionaryRef dictionary) const;
+
+	private:
+		std::string m_dictionaryType;
+		cookstats::Report* m_report = nullptr;
+
+		struct PendingSection
+		{
+			const void* data;
+			uint64 size;
+			uint32 stride;
+			EAssetBinaryFilter filter;
+		};
+		std::vector<PendingSection> m_sections;
+	};
+
+	class AssetBinaryReader : NonCopyable
+	{
+	public:
+		// Map file and validate header, return false if file miss, broken or stale.
+		// File in mounted asset pack view from pack mapping directly.
+		bool open(const std::filesystem::path& path, uint64 schemaHash);
+
+		// Accept any of schema hashes, used when asset bin has more than one layout.
+		bool open(const std::filesystem::path& path, std::span<const uint64> schemaHashes);
+
+		// Take ownership of in memory container, path only used for log.
+		bool openMemory(std::string&& data, const std::filesystem::path& path, uint64 schemaHash);
+
+		// Schema hash of opened container.
+		uint64 getSchemaHash() const
+		{
+			return m_header ? m_header->schemaHash : 0;
+		}
+
+		uint32 getSectionCount() const
+		{
+			return m_header ? m_header->sectionCount : 0;
+		}
+
+		// Uncompressed section size.
+		uint64 getSectionSize(uint32 index) const
+		{
+			return m_sections[index].rawSize;
+		}
+
+		uint32 getSectionStride(uint32 index) const
+		{
+			return m_sections[index].stride;
+		}
+
+		EAssetBinaryFilter getSectionFilter(uint32 index) const
+		{
+			return EAssetBinaryFilter(m_sections[index].filter);
+		}
+
+		uint64 getSectionElementCount(uint32 index) const
+		{
+			return m_sections[index].rawSize / m_sections[index].stride;
+		}
+
+		// Section no filter and all chunks stored without compression, can view directly.
+		bool isSectionRaw(uint32 index) const;
+
+		// Zero copy view, only valid when section is raw.
+		template<typename T>
+		std::span<const T> getSection(uint32 index) const
+		{
+			static_assert(std::is_trivially_copyable_v<T>);
+			checkMsgf(m_sections[index].stride == sizeof(T), "Asset binary section #{} stride un-match!", index);
+			checkMsgf(isSectionRaw(index), "Asset binary section #{} is compressed, use readSection instead.", index);
+
+			if (m_sections[index].chunkCount == 0)
+			{
+				return { };
+			}
+
+			const uint8* data = m_data + m_chunks[m_sections[index].firstChunk].fileOffset;
+			return std::span<const T>((const T*)data, getSectionSize(index) / sizeof(T));
+		}
+
+		// Decompress whole section into dest, dest size must >= section size.
+		bool readSection(uint32 index, void* dest) const
+		{
+			return readSectionRange(index, 0, getSectionSize(index), dest);
+		}
+
+		// Only read and decompress chunks which overlap with [byteOffset, byteOffset + byteSize).
+		bool readSectionRange(uint32 index, uint64 byteOffset, uint64 byteSize, void* dest) const;
+
+		template<typename T>
+		bool readSectionElements(uint32 index, uint64 elementOffset, uint64 elementCount, std::vector<T>& out) const
+		{
+			checkMsgf(m_sections[index].stride == sizeof(T), "Asset binary section #{} stride un-match!", index);
+
+			out.resize(elementCount);
+			return readSectionRange(index, elementOffset * sizeof(T), elementCount * sizeof(T), out.data());
+		}
+
+		template<typename T>
+		bool copySection(uint32 index, std::vector<T>& out) const
+		{
+			return readSectionElements(index, 0, getSectionElementCount(index), out);
+		}
+
+	private:
+		// Validate header and tables of current backing storage.
+		bool validate(std::span<const uint64> schemaHashes);
+
+		bool readChunk(const assetbinary::Section& section, uint32 chunkIndex, void* dest) const;
+
+		void reset();
+
+	private:
+		// Backing storage, loose file mapping or mounted pack (pack keep mapping alive) or decompressed pack entry or in memory container.
+		MappedFile m_file;
+		std::shared_ptr<const void> m_packOwner = nullptr;
+		std::string m_packEntryData;
+
+		const uint8* m_data = nullptr;
+		uint64 m_size = 0;
+
+		std::filesystem::path m_path;
+		assetbinary::DictionaryRef m_dictionary = nullptr;
+
+		const assetbinary::Header*  m_header   = nullptr;
+		const assetbinary::Section* m_sections = nullptr;
+		const assetbinary::Chunk*   m_chunks   = nullptr;
+	};
+
+	// Typed section handle of reader, used by asset bin view.
+	template<typename T>
+	struct AssetBinarySection
+	{
+		using value_type = T;
+
+		const AssetBinaryReader* reader = nullptr;
+		uint32 index = ~0U;
+
+		size_t size() const
+		{
+			return reader ? (size_t)reader->getSectionElementCount(index) : 0;
+		}
+
+		bool empty() const
+		{
+			return size() == 0;
+		}
+
+		static constexpr uint32 stride()
+		{
+			return (uint32)sizeof(T);
+		}
+
+		bool read(void* dest) const
+		{
+			return reader->readSection(index, dest);
+		}
+
+		bool read(uint64 elementOffset, uint64 elementCount, std::vector<T>& out) const
+		{
+			return reader->readSectionElements(index, elementOffset, elementCount, out);
+		}
+	};
+}
@@ -0,0 +1,241 @@
+#include <asset/asset_binary_filter.h>
+#include <asset/meshoptimizer/meshoptimizer.h>
+#include <utils/log.h>
+#include <utils/cvar.h>
+
+namespace chord
+{
+	// Opt-in, octahedral 16bit snorm change runtime normal and tangent data (about 1e-4 angular error)
+	// once asset binary saved, disable keep vertex data bit exact with lossless shuffle delta.
+	static uint32 sAssetBinaryFilterLossy = 0;
+	static AutoCVarRef cVarAssetBinaryFilterLossy(
+		"r.asset.binary.filter.lossy",
+		sAssetBinaryFilterLossy,
+		"Allow lossy filter (octahedral 16bit normal, about 1e-4 angular error) when save asset binary or not, default off keep vertex data bit exact."
+	);
+
+	namespace assetbinary
+	{
+		static uint32 getMaxIndex(const uint32* indices, uint64 count)
+		{
+			uint32 maxIndex = 0;
+			for (uint64 i = 0; i < count; i++)
+			{
+				maxIndex = math::max(maxIndex, indices[i]);
+			}
+			return maxIndex;
+		}
+	}
+
+	uint32 assetbinary::getFilterGranularity(EAssetBinaryFilter filter)
+	{
+		return filter == EAssetBinaryFilter::MeshoptIndexTriangle ? 3 : 1;
+	}
+
+	EAssetBinaryFilter assetbinary::getConfigFilter(EAssetBinaryFilter filter)
+	{
+		const bool bLossy = (filter == EAssetBinaryFilter::Octahedral) || (filter == EAssetBinaryFilter::OctahedralTangent);
+		return (bLossy && !sAssetBinaryFilterLossy) ? EAssetBinaryFilter::ShuffleDelta : filter;
+	}
+
+	bool assetbinary::isFilterSupported(EAssetBinaryFilter filter, uint32 stride)
+	{
+		switch (filter)
+		{
+		case EAssetBinaryFilter::None:
+		case EAssetBinaryFilter::ShuffleDelta:
+			return true;
+		case EAssetBinaryFilter::MeshoptVertex:
+			return (stride % 4 == 0) && (stride <= 256);
+		case EAssetBinaryFilter::MeshoptIndexTriangle:
+		case EAssetBinaryFilter::MeshoptIndexSequence:
+			return stride == sizeof(uint32);
+		case EAssetBinaryFilter::Octahedral:
+			return stride == sizeof(float) * 3;
+		case EAssetBinaryFilter::OctahedralTangent:
+			return stride == sizeof(float) * 4;
+		default:
+			return false;
+		}
+	}
+
+	bool assetbinary::encodeFilter(EAssetBinaryFilter filter, const void* src, uint64 srcSize, uint32 stride, std::vector<char>& out)
+	{
+		const uint64 count = srcSize / stride;
+		check(isFilterSupported(filter, stride) && count * stride == srcSize);
+
+		switch (filter)
+		{
+		case EAssetBinaryFilter::None:
+		{
+			out.assign((const char*)src, (const char*)src + srcSize);
+			return true;
+		}
+		case EAssetBinaryFilter::MeshoptVertex:
+		{
+			out.resize(meshopt_encodeVertexBufferBound(count, stride));
+			const size_t size = meshopt_encodeVertexBuffer((unsigned char*)out.data(), out.size(), src, count, stride);
+			out.resize(size);
+			return size > 0;
+		}
+		case EAssetBinaryFilter::MeshoptIndexTriangle:
+		case EAssetBinaryFilter::MeshoptIndexSequence:
+		{
+			const uint32* indices = (const uint32*)src;
+			const size_t vertexCount = size_t(getMaxIndex(indices, count)) + 1;
+
+			size_t size = 0;
+			if (filter == EAssetBinaryFilter::MeshoptIndexTriangle)
+			{
+				check(count % 3 == 0);
+				out.resize(meshopt_encodeIndexBufferBound(count, vertexCount));
+				size = meshopt_encodeIndexBuffer((unsigned char*)out.data(), out.size(), indices, count);
+			}
+			else
+			{
+				out.resize(meshopt_encodeIndexSequenceBound(count, vertexCount));
+				size = meshopt_encodeIndexSequence((unsigned char*)out.data(), out.size(), indices, count);
+			}
+			out.resize(size);
+			return size > 0;
+		}
+		case EAssetBinaryFilter::ShuffleDelta:
+		{
+			out.resize(srcSize);
+
+			const uint8* srcBytes = (const uint8*)src;
+			uint8* outBytes = (uint8*)out.data();
+			for (uint32 b = 0; b < stride; b++)
+			{
+				uint8* plane = outBytes + b * count;
+
+				uint8 prev = 0;
+				for (uint64 i = 0; i < count; i++)
+				{
+					const uint8 v = srcBytes[i * stride + b];
+					plane[i] = uint8(v - prev);
+					prev = v;
+				}
+			}
+			return true;
+		}
+		case EAssetBinaryFilter::Octahedral:
+		{
+			out.resize(count * sizeof(int16) * 2);
+
+			const float* normals = (const float*)src;
+			int16* encoded = (int16*)out.data();
+			for (uint64 i = 0; i < count; i++)
+			{
+				encodeOctahedral(normals + i * 3, encoded + i * 2);
+			}
+			return true;
+		}
+		case EAssetBinaryFilter::OctahedralTangent:
+		{
+			out.resize(count * sizeof(int16) * 4);
+
+			const float* tangents = (const float*)src;
+			int16* encoded = (int16*)out.data();
+			for (uint64 i = 0; i < count; i++)
+			{
+				encodeOctahedral(tangents + i * 4, encoded + i * 4);
+				encoded[i * 4 + 2] = encodeSnorm16(tangents[i * 4 + 3]);
+				encoded[i * 4 + 3] = 0;
+			}
+			return true;
+		}
+		default: checkEntry();
+		}
+
+		return false;
+	}
+
+	bool assetbinary::decodeFilter(EAssetBinaryFilter filter, const void* src, uint64 srcSize, uint32 stride, void* dest, uint64 destSize)
+	{
+		const uint64 count = destSize / stride;
+
+		switch (filter)
+		{
+		case EAssetBinaryFilter::None:
+		{
+			if (srcSize != destSize)
+			{
+				return false;
+			}
+
+			memcpy(dest, src, destSize);
+			return true;
+		}
+		case EAssetBinaryFilter::MeshoptVertex:
+		{
+			// Decoder use SIMD when available.
+			return meshopt_decodeVertexBuffer(dest, count, stride, (const unsigned char*)src, srcSize) == 0;
+		}
+		case EAssetBinaryFilter::MeshoptIndexTriangle:
+		{
+			return meshopt_decodeIndexBuffer(dest, count, sizeof(uint32), (const unsigned char*)src, srcSize) == 0;
+		}
+		case EAssetBinaryFilter::MeshoptIndexSequence:
+		{
+			return meshopt_decodeIndexSequence(dest, count, sizeof(uint32), (const unsigned char*)src, srcSize) == 0;
+		}
+		case EAssetBinaryFilter::ShuffleDelta:
+		{
+			if (srcSize != destSize)
+			{
+				return false;
+			}
+
+			const uint8* srcBytes = (const uint8*)src;
+			uint8* destBytes = (uint8*)dest;
+			for (uint32 b = 0; b < stride; b++)
+			{
+				const uint8* plane = srcBytes + b * count;
+
+				uint8 acc = 0;
+				for (uint64 i = 0; i < count; i++)
+				{
+					acc = uint8(acc + plane[i]);
+					destBytes[i * stride + b] = acc;
+				}
+			}
+			return true;
+		}
+		case EAssetBinaryFilter::Octahedral:
+		{
+			if (srcSize != count * sizeof(int16) * 2)
+			{
+				return false;
+			}
+
+			const int16* encoded = (const int16*)src;
+			float* normals = (float*)dest;
+			for (uint64 i = 0; i < count; i++)
+			{
+				decodeOctahedral(encoded + i * 2, normals + i * 3);
+			}
+			return true;
+		}
+		case EAssetBinaryFilter::OctahedralTangent:
+		{
+			if (srcSize != count * sizeof(int16) * 4)
+			{
+				return false;
+			}
+
+			const int16* encoded = (const int16*)src;
+			float* tangents = (float*)dest;
+			for (uint64 i = 0; i < count; i++)
+			{
+				decodeOctahedral(encoded + i * 4, tangents + i * 4);
+				tangents[i * 4 + 3] = encoded[i * 4 + 2] >= 0 ? 1.0f : -1.0f;
+			}
+			return true;
+		}
+		default: checkEntry();
+		}
+
+		return false;
+	}
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <utils/utils.h>
+
+namespace chord
+{
+	// Data specific transform apply on section before compression, make stream more friendly to LZ4.
+	enum class EAssetBinaryFilter : uint32
+	{
+		None,
+
+		// Meshopt vertex codec, any struct which stride is multiple of 4 and <= 256.
+		MeshoptVertex,
+
+		// Meshopt triangle index codec, uint32 triangle list.
+		// NOTE: Codec may rotate vertices in a triangle, winding keep same.
+		MeshoptIndexTriangle,
+
+		// Meshopt index sequence codec, any uint32 sequence.
+		MeshoptIndexSequence,
+
+		// Byte plane shuffle plus delta, generic float arrays.
+		ShuffleDelta,
+
+		// Lossy octahedral 16bit snorm, vec3 unit vector.
+		Octahedral,
+
+		// Lossy octahedral 16bit snorm, vec4 tangent with w sign.
+		OctahedralTangent,
+
+		MAX
+	};
+
+	namespace assetbinary
+	{
+		// Chunk must hold multiple of granularity elements.
+		extern uint32 getFilterGranularity(EAssetBinaryFilter filter);
+
+		// Lossy filter fallback to lossless one when r.asset.binary.filter.lossy disable.
+		extern EAssetBinaryFilter getConfigFilter(EAssetBinaryFilter filter);
+
+		// Filter support this element stride or not.
+		extern bool isFilterSupported(EAssetBinaryFilter filter, uint32 stride);
+
+		// Encode elements into filtered bytes.
+		extern bool encodeFilter(EAssetBinaryFilter filter, const void* src, uint64 srcSize, uint32 stride, std::vector<char>& out);
+
+		// Decode filtered bytes into dest, dest size is raw elements size.
+		extern bool decodeFilter(EAssetBinaryFilter filter, const void* src, uint64 srcSize, uint32 stride, void* dest, uint64 destSize);
+
+		// Octahedral helpers, also used by gltf compact vertex.
+		inline int16 encodeSnorm16(float v)
+		{
+			return int16(std::round(math::clamp(v, -1.0f, 1.0f) * 32767.0f));
+		}
+
+		inline void encodeOctahedral(const float* n, int16* out)
+		{
+			const float l1 = std::abs(n[0]) + std::abs(n[1]) + std::abs(n[2]);
+			const float invL1 = l1 > 0.0f ? 1.0f / l1 : 0.0f;
+
+			float x = n[0] * invL1;
+			float y = n[1] * invL1;
+			if (n[2] < 0.0f)
+			{
+				const float fx = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+				const float fy = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+				x = fx;
+				y = fy;
+			}
+
+			out[0] = encodeSnorm16(x);
+			out[1] = encodeSnorm16(y);
+		}
+
+		// Branchless so compiler can vectorize decode loop.
+		inline void decodeOctahedral(const int16* in, float* n)
+		{
+			float x = float(in[0]) * (1.0f / 32767.0f);
+			float y = float(in[1]) * (1.0f / 32767.0f);
+			const float z = 1.0f - std::abs(x) - std::abs(y);
+			const float t = math::max(-z, 0.0f);
+
+			x -= std::copysign(t, x);
+			y -= std::copysign(t, y);
+
+			const float invLength = 1.0f / std::sqrt(x * x + y * y + z * z);
+			n[0] = x * invLength;
+			n[1] = y * invLength;
+			n[2] = z * invLength;
+		}
+	}
+}
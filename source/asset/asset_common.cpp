@@ -1,4 +1,5 @@
 #include <asset/asset_common.h>
+#include <asset/asset_pack.h>
 #include <utils/cvar.h>
 #include <project.h>
 
@@ -103,6 +104,15 @@ namespace chord
 		return std::to_string(hashID) + suffix;
 	}
 
+	std::string AssetSaveInfo::getLoadOrderCachePath() const
+	{
+		check(!isTemp());
+		const auto suffix = "_loadorder";
+
+		const auto hashID = std::hash<UUID>{}(utf8::utf16to8(relativeAssetStorePath().u16string()) + suffix);
+		return std::to_string(hashID) + suffix;
+	}
+
 	const std::filesystem::path AssetSaveInfo::path() const
 	{
 		std::filesystem::path path = Project::get().getPath().assetPath.u16();
@@ -111,7 +121,7 @@ namespace chord
 
 	bool AssetSaveInfo::alreadyInDisk() const
 	{
-		return std::filesystem::exists(path());
+		return assetpack::exists(path());
 	}
 
 }
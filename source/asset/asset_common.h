@@ -2,6 +2,7 @@
 
 #include <utils/utils.h>
 #include <utils/log.h>
+#include <asset/cook_stats.h>
 #include <project.h>
 
 namespace chord
@@ -78,6 +79,9 @@ namespace chord
 		// Bin file cache path hash name, not for temp.
 		std::string getBinCachePath() const;
 
+		// Recorded load order sidecar cache path hash name, not for temp.
+		std::string getLoadOrderCachePath() const;
+
 	private:
 		u16str m_name; // Asset name only, std::filesystem::path.filename.
 		u16str m_storeFolder; // Asset store folder relative to project asset folder.
@@ -95,6 +99,8 @@ namespace chord
 		std::filesystem::path importFilePath;
 		std::filesystem::path storeFilePath;
 
+		// Report of outer import, nested import (texture of gltf) stages also roll up into it.
+		cookstats::Report* parentReport = nullptr;
 
 		// Create asset texture.
 		AssetSaveInfo getSaveInfo(const std::string& suffix) const
@@ -0,0 +1,568 @@
+#include <asset/asset_pack.h>
+#include <asset/asset_common.h>
+#include <asset/asset_binary.h>
+#include <utils/cityhash.h>
+#include <utils/crc.h>
+#include <utils/job_system.h>
+#include <utils/cvar.h>
+#include <project.h>
+
+namespace chord
+{
+	namespace assetpack
+	{
+		// Only compress entry when lz4 save more than 1/8 size.
+		constexpr double kCompressMinRatio = 0.875;
+
+		// Lz4 worst case expand ratio, used to reject forged raw size.
+		constexpr uint64 kLz4MaxRatio = 255;
+
+		static uint32 sPrefetchBudget = 256;
+		static AutoCVarRef cVarPrefetchBudget(
+			"r.asset.pack.prefetch.budget",
+			sPrefetchBudget,
+			"Max MB of compressed pack entries decoded ahead by scene prefetch per pack."
+		);
+
+		static std::shared_mutex sMountMutex;
+		static std::vector<AssetPackRef> sMountedPacks;
+
+		static uint64 hashKey(std::string_view key)
+		{
+			return cityhash::cityhash64(key.data(), key.size());
+		}
+
+		static uint32 computeCrc(const void* data, uint64 size)
+		{
+			// crc32 length is 32 bit, feed large entry in pieces.
+			constexpr uint64 kMaxPieceSize = 1ULL << 30;
+
+			uint32 crc = 0;
+			for (uint64 offset = 0; offset < size; offset += kMaxPieceSize)
+			{
+				crc = crc::crc32((const uint8*)data + offset, (uint32)math::min(kMaxPieceSize, size - offset), crc);
+			}
+			return crc;
+		}
+	}
+
+	bool AssetPack::open(const std::filesystem::path& path)
+	{
+		using namespace assetpack;
+
+		m_header  = nullptr;
+		m_entries = nullptr;
+		m_path    = path;
+
+		if (!m_file.open(path))
+		{
+			return false;
+		}
+
+		const auto* header = (const Header*)m_file.data();
+		if (m_file.size() < sizeof(Header) || header->magic != kMagic)
+		{
+			LOG_ERROR("Asset pack {} is not a pack file.", utf8::utf16to8(path.u16string()));
+			m_file.close();
+			return false;
+		}
+
+		if (header->version != kVersion)
+		{
+			LOG_WARN("Asset pack {} version is stale, need to rebuild.", utf8::utf16to8(path.u16string()));
+			m_file.close();
+			return false;
+		}
+
+		const uint64 indexEnd = header->indexOffset + sizeof(Entry) * header->entryCount;
+		bool bValid = (header->fileSize == m_file.size())
+			&& (header->indexOffset % alignof(Entry) == 0)
+			&& (indexEnd <= header->stringOffset)
+			&& (header->stringOffset + header->stringSize <= m_file.size());
+
+		const auto* entries = (const Entry*)(m_file.data() + header->indexOffset);
+		for (uint32 i = 0; i < header->entryCount && bValid; i++)
+		{
+			const auto& entry = entries[i];
+
+			bValid &= (entry.storedSize <= header->indexOffset) && (entry.fileOffset <= header->indexOffset - entry.storedSize);
+			bValid &= (uint64(entry.pathOffset) + entry.pathSize <= header->stringSize);
+			bValid &= (entry.compression < (uint32)ECompressionMode::MAX);
+			bValid &= (entry.compression != (uint32)ECompressionMode::None) || (entry.storedSize == entry.rawSize);
+
+			// Lz4 can't expand more than 255x, and its size is int32, bound raw size before read resize it.
+			bValid &= (entry.compression == (uint32)ECompressionMode::None)
+				|| (entry.rawSize <= (uint64)LZ4_MAX_INPUT_SIZE && entry.rawSize <= entry.storedSize * kLz4MaxRatio);
+			bValid &= (i == 0) || (entries[i - 1].pathHash <= entry.pathHash);
+		}
+
+		if (!bValid)
+		{
+			LOG_ERROR("Asset pack {} is broken.", utf8::utf16to8(path.u16string()));
+			m_file.close();
+			return false;
+		}
+
+		// Pointer fix-up.
+		m_header  = header;
+		m_entries = entries;
+
+		return true;
+	}
+
+	const assetpack::Entry* AssetPack::find(std::string_view key) const
+	{
+		if (!m_header)
+		{
+			return nullptr;
+		}
+
+		const uint64 hash = assetpack::hashKey(key);
+		const auto* end = m_entries + m_header->entryCount;
+
+		// Compare key too, hash collision is rare but possible.
+		for (const auto* entry = std::lower_bound(m_entries, end, hash, [](const assetpack::Entry& e, uint64 h) { return e.pathHash < h; });
+			entry != end && entry->pathHash == hash; entry++)
+		{
+			if (getEntryPath(*entry) == key)
+			{
+				return entry;
+			}
+		}
+		return nullptr;
+	}
+
+	bool AssetPack::read(const assetpack::Entry& entry, std::string& out) const
+	{
+		if (entry.compression != (uint32)ECompressionMode::None)
+		{
+			std::lock_guard lock(m_decodedMutex);
+			if (auto iter = m_decoded.find(&entry); iter != m_decoded.end())
+			{
+				m_decodedSize -= iter->second.size();
+				out = std::move(iter->second);
+				m_decoded.erase(iter);
+				return true;
+			}
+		}
+
+		return decode(entry, out);
+	}
+
+	void AssetPack::prefetch(const assetpack::Entry& entry) const
+	{
+		if (entry.compression == (uint32)ECompressionMode::None)
+		{
+			return;
+		}
+
+		const uint64 budget = uint64(assetpack::sPrefetchBudget) * 1024 * 1024;
+		{
+			std::lock_guard lock(m_decodedMutex);
+			if (m_decoded.contains(&entry) || m_decodedSize + entry.rawSize > budget)
+			{
+				return;
+			}
+		}
+
+		std::string decoded;
+		if (!decode(entry, decoded))
+		{
+			// Requester decode again and report the error.
+			return;
+		}
+
+		std::lock_guard lock(m_decodedMutex);
+		if (m_decodedSize + decoded.size() <= budget && m_decoded.emplace(&entry, std::move(decoded)).second)
+		{
+			m_decodedSize += entry.rawSize;
+		}
+	}
+
+	void AssetPack::clearPrefetched() const
+	{
+		std::lock_guard lock(m_decodedMutex);
+		m_decoded.clear();
+		m_decodedSize = 0;
+	}
+
+	bool AssetPack::decode(const assetpack::Entry& entry, std::string& out) const
+	{
+		const char* stored = (const char*)m_file.data() + entry.fileOffset;
+
+		out.resize(entry.rawSize);
+		if (entry.compression == (uint32)ECompressionMode::None)
+		{
+			memcpy(out.data(), stored, entry.rawSize);
+		}
+		else
+		{
+			const int32 rawSize = LZ4_decompress_safe(stored, out.data(), (int32)entry.storedSize, (int32)entry.rawSize);
+			if (rawSize != (int32)entry.rawSize)
+			{
+				LOG_ERROR("Asset pack {} entry {} decompress fail.", utf8::utf16to8(m_path.u16string()), getEntryPath(entry));
+				return false;
+			}
+		}
+
+		if (assetpack::computeCrc(out.data(), out.size()) != entry.crc)
+		{
+			LOG_ERROR("Asset pack {} entry {} crc un-match.", utf8::utf16to8(m_path.u16string()), getEntryPath(entry));
+			return false;
+		}
+		return true;
+	}
+
+	void AssetPackWriter::addFile(const std::string& key, const std::filesystem::path& srcPath, bool bCompress)
+	{
+		if (m_keys.insert(key).second)
+		{
+			m_files.push_back({ key, srcPath, bCompress });
+		}
+	}
+
+	bool AssetPackWriter::write(const std::filesystem::path& savePath) const
+	{
+		using namespace assetpack;
+
+		const uint32 fileCount = (uint32)m_files.size();
+
+		// Load and compress all sources in parallel.
+		std::vector<std::string> storedDatas(fileCount);
+		std::vector<Entry> entries(fileCount);
+		std::atomic<bool> bAllLoaded = true;
+		jobsystem::parallelFor("AssetPackLoad", EBusyWaitType::All, fileCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+		{
+			for (uint32 i = loopStart; i < loopEnd; i++)
+			{
+				const auto& file = m_files[i];
+
+				MappedFile source;
+				std::error_code ec;
+				if (!source.open(file.srcPath) && std::filesystem::file_size(file.srcPath, ec) != 0)
+				{
+					LOG_ERROR("Fail to read {} for asset pack.", utf8::utf16to8(file.srcPath.u16string()));
+					bAllLoaded = false;
+					continue;
+				}
+
+				auto& entry = entries[i];
+				entry.pathHash    = hashKey(file.key);
+				entry.rawSize     = source.size();
+				entry.crc         = computeCrc(source.data(), source.size());
+				entry.compression = (uint32)ECompressionMode::None;
+
+				auto& stored = storedDatas[i];
+				if (file.bCompress && source.size() > 0 && source.size() < (uint64)LZ4_MAX_INPUT_SIZE)
+				{
+					stored.resize(LZ4_compressBound((int32)source.size()));
+					const int32 compressedSize = LZ4_compress_default((const char*)source.data(), stored.data(), (int32)source.size(), (int32)stored.size());
+					if (compressedSize > 0 && compressedSize < int32(double(source.size()) * kCompressMinRatio))
+					{
+						stored.resize(compressedSize);
+						entry.compression = (uint32)ECompressionMode::Lz4;
+					}
+				}
+
+				if (entry.compression == (uint32)ECompressionMode::None)
+				{
+					stored.assign((const char*)source.data(), source.size());
+				}
+				entry.storedSize = stored.size();
+			}
+		});
+
+		if (!bAllLoaded)
+		{
+			return false;
+		}
+
+		// Data layout in add order.
+		Header header { };
+		header.magic      = kMagic;
+		header.version    = kVersion;
+		header.entryCount = fileCount;
+
+		std::string strings;
+		uint64 offset = sizeof(Header);
+		for (uint32 i = 0; i < fileCount; i++)
+		{
+			offset = alignRoundingUp(offset, kEntryAlignment);
+			entries[i].fileOffset = offset;
+			entries[i].pathOffset = (uint32)strings.size();
+			entries[i].pathSize   = (uint32)m_files[i].key.size();
+
+			offset += entries[i].storedSize;
+			strings += m_files[i].key;
+		}
+
+		header.indexOffset  = alignRoundingUp(offset, kEntryAlignment);
+		header.stringOffset = header.indexOffset + sizeof(Entry) * fileCount;
+		header.stringSize   = strings.size();
+		header.fileSize     = header.stringOffset + header.stringSize;
+
+		// Index sort by hash, data offset already fixed.
+		std::vector<Entry> sortedEntries = entries;
+		std::stable_sort(sortedEntries.begin(), sortedEntries.end(), [](const Entry& a, const Entry& b) { return a.pathHash < b.pathHash; });
+
+		std::error_code ec;
+		const auto tempPath = std::filesystem::path(savePath).concat(std::format(".{}.tmp", std::hash<std::thread::id>{ }(std::this_thread::get_id())));
+		{
+			std::ofstream os(tempPath, std::ios::binary | std::ios::trunc);
+			if (!os.is_open())
+			{
+				LOG_ERROR("Fail to open {} for write.", utf8::utf16to8(tempPath.u16string()));
+				return false;
+			}
+
+			const char zeros[kEntryAlignment] = { };
+			auto pad = [&](uint64 target)
+			{
+				const uint64 current = (uint64)os.tellp();
+				check(target >= current && target - current < kEntryAlignment);
+				os.write(zeros, std::streamsize(target - current));
+			};
+
+			os.write((const char*)&header, sizeof(header));
+			for (uint32 i = 0; i < fileCount; i++)
+			{
+				pad(entries[i].fileOffset);
+				os.write(storedDatas[i].data(), storedDatas[i].size());
+			}
+
+			pad(header.indexOffset);
+			os.write((const char*)sortedEntries.data(), sizeof(Entry) * fileCount);
+			os.write(strings.data(), strings.size());
+
+			check((uint64)os.tellp() == header.fileSize);
+			if (!os.good())
+			{
+				os.close();
+				std::filesystem::remove(tempPath, ec);
+				return false;
+			}
+		}
+
+		std::filesystem::rename(tempPath, savePath, ec);
+		if (ec)
+		{
+			LOG_ERROR("Fail to replace asset pack {}: {}.", utf8::utf16to8(savePath.u16string()), ec.message());
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+		return true;
+	}
+
+	std::string assetpack::getProjectKey(const std::filesystem::path& path)
+	{
+		const std::filesystem::path root = Project::get().getPath().rootPath.u16();
+
+		// Lexical only, never touch file system.
+		const auto relative = path.lexically_normal().lexically_relative(root);
+		if (relative.empty() || *relative.begin() == "..")
+		{
+			return { };
+		}
+		return utf8::utf16to8(relative.generic_u16string());
+	}
+
+	std::filesystem::path assetpack::getProjectPackPath()
+	{
+		const auto& projectPath = Project::get().getPath();
+		return std::filesystem::path(projectPath.rootPath.u16()) / (projectPath.projectName.u8() + kExtension);
+	}
+
+	bool assetpack::mount(const std::filesystem::path& packPath)
+	{
+		auto pack = std::make_shared<AssetPack>();
+		if (!pack->open(packPath))
+		{
+			return false;
+		}
+
+		LOG_INFO("Mount asset pack {} with {} entries.", utf8::utf16to8(packPath.u16string()), pack->getEntryCount());
+
+		std::unique_lock lock(sMountMutex);
+		sMountedPacks.push_back(pack);
+		return true;
+	}
+
+	void assetpack::unmountAll()
+	{
+		// Reader hold pack reference, mapping release after last reader close.
+		std::unique_lock lock(sMountMutex);
+		sMountedPacks.clear();
+	}
+
+	uint32 assetpack::getMountedCount()
+	{
+		std::shared_lock lock(sMountMutex);
+		return (uint32)sMountedPacks.size();
+	}
+
+	bool assetpack::findFile(const std::filesystem::path& path, FileView& out)
+	{
+		std::shared_lock lock(sMountMutex);
+		if (sMountedPacks.empty())
+		{
+			return false;
+		}
+
+		const auto key = getProjectKey(path);
+		if (key.empty())
+		{
+			return false;
+		}
+
+		for (auto iter = sMountedPacks.rbegin(); iter != sMountedPacks.rend(); iter++)
+		{
+			if (const auto* entry = (*iter)->find(key))
+			{
+				out.pack  = *iter;
+				out.entry = entry;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	bool assetpack::readPackedFile(const std::filesystem::path& path, std::string& out)
+	{
+		FileView view { };
+		if (!findFile(path, view))
+		{
+			return false;
+		}
+		return view.pack->read(*view.entry, out);
+	}
+
+	void assetpack::clearPrefetched()
+	{
+		std::shared_lock lock(sMountMutex);
+		for (const auto& pack : sMountedPacks)
+		{
+			pack->clearPrefetched();
+		}
+	}
+
+	bool assetpack::exists(const std::filesystem::path& path)
+	{
+		FileView view { };
+		return findFile(path, view) || std::filesystem::exists(path);
+	}
+
+	std::vector<std::string> assetpack::collectAssetMetaPaths()
+	{
+		const std::string assetFolderKey = getProjectKey(Project::get().getPath().assetPath.u16()) + "/";
+
+		std::vector<std::string> result;
+		std::shared_lock lock(sMountMutex);
+		for (const auto& pack : sMountedPacks)
+		{
+			for (uint32 i = 0; i < pack->getEntryCount(); i++)
+			{
+				const auto key = pack->getEntryPath(pack->getEntry(i));
+				if (!key.starts_with(assetFolderKey))
+				{
+					continue;
+				}
+
+				// All asset extension start with .asset.
+				const auto extension = std::filesystem::path(key).extension().string();
+				if (extension.starts_with(".asset"))
+				{
+					result.emplace_back(key.substr(assetFolderKey.size()));
+				}
+			}
+		}
+
+		std::sort(result.begin(), result.end());
+		result.erase(std::unique(result.begin(), result.end()), result.end());
+		return result;
+	}
+
+	bool assetpack::buildProjectPack(const std::filesystem::path& packPath, const std::vector<std::string>& loadOrder, bool bCompress)
+	{
+		const auto& projectPath = Project::get().getPath();
+		const std::filesystem::path root = projectPath.rootPath.u16();
+		const std::filesystem::path assetFolder = projectPath.assetPath.u16();
+		const std::filesystem::path cacheFolder = projectPath.cachePath.u16();
+
+		AssetPackWriter writer;
+		auto addIfExist = [&](const std::filesystem::path& path, bool bAllowCompress)
+		{
+			std::error_code ec;
+			if (std::filesystem::is_regular_file(path, ec))
+			{
+				writer.addFile(getProjectKey(path), path, bCompress && bAllowCompress);
+			}
+		};
+
+		// Asset binary already compress per chunk and need zero copy view, never compress again.
+		auto isBinKey = [](const std::string& key)
+		{
+			return key.ends_with("_bin");
+		};
+
+		// Recorded load order first.
+		for (const auto& key : loadOrder)
+		{
+			addIfExist(root / utf8::utf8to16(key), !isBinKey(key));
+		}
+
+		// Then meta with its bin, scene open touch scene, gltf, material and texture in order.
+		const std::vector<std::string> typeOrder = { ".assetscene", ".assetgltf", ".assetgltfmaterial", ".assettexture" };
+		auto getTypeRank = [&](const std::filesystem::path& path)
+		{
+			const auto extension = path.extension().string();
+			return (uint32)std::distance(typeOrder.begin(), std::find(typeOrder.begin(), typeOrder.end(), extension));
+		};
+
+		std::vector<std::filesystem::path> metas;
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(assetFolder, ec))
+		{
+			if (entry.is_regular_file(ec) && entry.path().extension().string().starts_with(".asset"))
+			{
+				metas.push_back(entry.path());
+			}
+		}
+		std::stable_sort(metas.begin(), metas.end(), [&](const auto& a, const auto& b)
+		{
+			const uint32 rankA = getTypeRank(a);
+			const uint32 rankB = getTypeRank(b);
+			return rankA != rankB ? rankA < rankB : a < b;
+		});
+
+		for (const auto& meta : metas)
+		{
+			addIfExist(meta, true);
+			addIfExist(cacheFolder / AssetSaveInfo::buildRelativeAsset(meta).getBinCachePath(), false);
+		}
+
+		// Binary dictionaries.
+		for (const auto& entry : std::filesystem::directory_iterator(assetbinary::getDictionaryFolder(), ec))
+		{
+			addIfExist(entry.path(), true);
+		}
+
+		// Snapshots only used by editor content browser, put them at tail.
+		for (const auto& meta : metas)
+		{
+			addIfExist(cacheFolder / AssetSaveInfo::buildRelativeAsset(meta).getSnapshotCachePath(), true);
+		}
+
+		const auto startTime = std::chrono::high_resolution_clock::now();
+		if (!writer.write(packPath))
+		{
+			LOG_ERROR("Fail to write asset pack {}.", utf8::utf16to8(packPath.u16string()));
+			return false;
+		}
+
+		LOG_INFO("Asset pack {} build with {} files, cost {:.3f} s.",
+			utf8::utf16to8(packPath.u16string()),
+			writer.getFileCount(),
+			std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - startTime).count());
+		return true;
+	}
+}
@@ -0,0 +1,190 @@
+#pragma once
+
+#include <utils/utils.h>
+#include <utils/mapped_file.h>
+#include <asset/asset_binary.h>
+
+namespace chord
+{
+	// Read only archive of cooked project files, replace thousands of loose meta and bin files with one mapping.
+	//   [Header][Entry data 0][Entry data 1]...[Index][Path strings]
+	// Entry data store in add order, writer add files in load order so startup and scene open read sequentially.
+	// Entry data start with kEntryAlignment, raw entry (asset binary, already compressed meta) can view from mapping directly.
+	// Index sort by path hash, lookup is binary search without touch file system.
+	namespace assetpack
+	{
+		constexpr uint32 kMagic = 0x4B504843; // "CHPK"
+		constexpr uint32 kVersion = 1;
+		constexpr uint64 kEntryAlignment = 64;
+
+		// Pack file extension, project pack store in project root as <ProjectName>.chpk.
+		constexpr const char* kExtension = ".chpk";
+
+		struct Header
+		{
+			uint32 magic;
+			uint32 version;
+
+			uint32 entryCount;
+			uint32 pad0;
+
+			uint64 indexOffset;
+			uint64 stringOffset;
+			uint64 stringSize;
+			uint64 fileSize;
+		};
+		static_assert(sizeof(Header) == 48);
+
+		struct Entry
+		{
+			// cityhash64 of path key.
+			uint64 pathHash;
+
+			// Path key range in string block.
+			uint32 pathOffset;
+			uint32 pathSize;
+
+			// Offset relative to file start.
+			uint64 fileOffset;
+			uint64 storedSize;
+			uint64 rawSize;
+
+			// ECompressionMode.
+			uint32 compression;
+
+			// crc32 of raw data.
+			uint32 crc;
+		};
+		static_assert(sizeof(Entry) == 48);
+	}
+
+	class AssetPack : NonCopyable
+	{
+	public:
+		// Map pack and validate index, return false if file miss or broken.
+		bool open(const std::filesystem::path& path);
+
+		const std::filesystem::path& getPath() const
+		{
+			return m_path;
+		}
+
+		uint32 getEntryCount() const
+		{
+			return m_header ? m_header->entryCount : 0;
+		}
+
+		const assetpack::Entry& getEntry(uint32 index) const
+		{
+			return m_entries[index];
+		}
+
+		std::string_view getEntryPath(const assetpack::Entry& entry) const
+		{
+			return std::string_view((const char*)m_file.data() + m_header->stringOffset + entry.pathOffset, entry.pathSize);
+		}
+
+		// Key is path relative to pack root with '/' separator, return nullptr if not found.
+		const assetpack::Entry* find(std::string_view key) const;
+
+		// Zero copy view, only valid when entry stored without compression.
+		std::span<const uint8> view(const assetpack::Entry& entry) const
+		{
+			checkMsgf(entry.compression == (uint32)ECompressionMode::None, "Pack entry {} is compressed, use read instead.", getEntryPath(entry));
+			return std::span<const uint8>(m_file.data() + entry.fileOffset, entry.rawSize);
+		}
+
+		// Copy or decompress entry into out and verify crc, take prefetched decoded data when exist.
+		bool read(const assetpack::Entry& entry, std::string& out) const;
+
+		// Decompress entry ahead into decoded cache on prefetch job, later read take it without decode again.
+		// Skip raw entry (warm by view) and when decoded cache reach r.asset.pack.prefetch.budget.
+		void prefetch(const assetpack::Entry& entry) const;
+
+		// Drop decoded data not consumed yet.
+		void clearPrefetched() const;
+
+	private:
+		bool decode(const assetpack::Entry& entry, std::string& out) const;
+
+	private:
+		MappedFile m_file;
+		std::filesystem::path m_path;
+
+		const assetpack::Header* m_header  = nullptr;
+		const assetpack::Entry*  m_entries = nullptr;
+
+		// Prefetched decoded entries, consume once by read.
+		mutable std::mutex m_decodedMutex;
+		mutable std::unordered_map<const assetpack::Entry*, std::string> m_decoded;
+		mutable uint64 m_decodedSize = 0;
+	};
+	using AssetPackRef = std::shared_ptr<AssetPack>;
+
+	class AssetPackWriter : NonCopyable
+	{
+	public:
+		// Entry data store in add order, add files in load order. Duplicate key keep the first one.
+		// Compress entry only when lz4 can save enough size, asset binary and meta already compressed so store raw.
+		void addFile(const std::string& key, const std::filesystem::path& srcPath, bool bCompress = false);
+
+		uint32 getFileCount() const
+		{
+			return (uint32)m_files.size();
+		}
+
+		// Load and compress sources in parallel, then write pack to temp file and rename.
+		bool write(const std::filesystem::path& savePath) const;
+
+	private:
+		struct PendingFile
+		{
+			std::string key;
+			std::filesystem::path srcPath;
+			bool bCompress;
+		};
+		std::vector<PendingFile> m_files;
+		std::unordered_set<std::string> m_keys;
+	};
+
+	// Project packs mount table, loose file in project folder still work when pack miss the file.
+	namespace assetpack
+	{
+		// Pack key of path, path relative to project root with '/' separator, empty if path outside project.
+		extern std::string getProjectKey(const std::filesystem::path& path);
+
+		// Project pack path, <ProjectRoot>/<ProjectName>.chpk.
+		extern std::filesystem::path getProjectPackPath();
+
+		// Mount pack of current project, later mounted pack override earlier one.
+		extern bool mount(const std::filesystem::path& packPath);
+
+		extern void unmountAll();
+
+		extern uint32 getMountedCount();
+
+		struct FileView
+		{
+			AssetPackRef pack = nullptr;
+			const Entry* entry = nullptr;
+		};
+
+		// Find file in mounted packs, never touch file system.
+		extern bool findFile(const std::filesystem::path& path, FileView& out);
+
+		// Read file from mounted packs, return false if no pack contain it.
+		extern bool readPackedFile(const std::filesystem::path& path, std::string& out);
+
+		// Drop prefetched decoded data of all mounted packs.
+		extern void clearPrefetched();
+
+		// File exist in mounted packs or on disk.
+		extern bool exists(const std::filesystem::path& path);
+
+		// Asset meta paths of mounted packs relative to asset folder, used to fill asset registry.
+		extern std::vector<std::string> collectAssetMetaPaths();
+
+		// Pack current project cooked files, keys in loadOrder layout first, then meta with its bin in folder order.
+		extern bool buildProjectPack(const std::filesystem::path& packPath, const std::vector<std::string>& loadOrder, bool bCompress);
+	}
+}
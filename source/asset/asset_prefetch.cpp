@@ -0,0 +1,352 @@
+#include <asset/asset_prefetch.h>
+#include <asset/asset_pack.h>
+#include <utils/mapped_file.h>
+#include <utils/cvar.h>
+#include <utils/job_system.h>
+#include <utils/profiler.h>
+#include <project.h>
+
+namespace chord
+{
+	static uint32 sScenePrefetch = 1;
+	static AutoCVarRef cVarScenePrefetch(
+		"r.scene.prefetch",
+		sScenePrefetch,
+		"Prefetch recorded assets of scene when open scene or not, scene open still record when disable."
+	);
+
+	static uint32 sScenePrefetchJobCount = 4;
+	static AutoCVarRef cVarScenePrefetchJobCount(
+		"r.scene.prefetch.jobs",
+		sScenePrefetchJobCount,
+		"Max parallel prefetch jobs of scene open."
+	);
+
+	namespace assetprefetch
+	{
+		constexpr uint32 kMagic = 0x4F4C4843; // "CHLO"
+		constexpr uint32 kVersion = 1;
+
+		// Touch one byte per page warm whole mapping.
+		constexpr uint64 kPageSize = 4096;
+
+		struct PrefetchState
+		{
+			std::vector<Record> records;
+			std::atomic<uint32> nextIndex = 0;
+			std::atomic<bool> bCancel = false;
+		};
+
+		struct RecordState
+		{
+			std::filesystem::path sidecarPath;
+			std::chrono::high_resolution_clock::time_point beginTime;
+
+			std::vector<Record> records;
+			std::unordered_set<std::string> recordedKeys;
+		};
+
+		static std::mutex sMutex;
+		static std::unique_ptr<RecordState> sRecordState = nullptr;
+		static std::shared_ptr<PrefetchState> sPrefetchState = nullptr;
+
+		// Fast path of recordAccess, avoid lock when no scene opening.
+		static std::atomic<bool> sbRecording = false;
+		static std::atomic<uint32> sPrefetchJobCount = 0;
+
+		// Access from prefetch job not record, else sequence only replay itself.
+		static thread_local bool tlbInPrefetchJob = false;
+
+		static std::filesystem::path getSidecarPath(const std::filesystem::path& scenePath)
+		{
+			const std::filesystem::path cacheFolder = Project::get().getPath().cachePath.u16();
+			return cacheFolder / AssetSaveInfo::buildRelativeAsset(scenePath).getLoadOrderCachePath();
+		}
+
+		static bool saveRecords(const std::filesystem::path& sidecarPath, const std::vector<Record>& records)
+		{
+			std::ofstream os(sidecarPath, std::ios::binary | std::ios::trunc);
+			if (!os.is_open())
+			{
+				LOG_ERROR("Fail to open load order {} to write.", utf8::utf16to8(sidecarPath.u16string()));
+				return false;
+			}
+
+			const uint32 count = (uint32)records.size();
+			os.write((const char*)&kMagic, sizeof(kMagic));
+			os.write((const char*)&kVersion, sizeof(kVersion));
+			os.write((const char*)&count, sizeof(count));
+			for (const auto& record : records)
+			{
+				const uint32 keySize = (uint32)record.key.size();
+				os.write((const char*)&keySize, sizeof(keySize));
+				os.write(record.key.data(), keySize);
+				os.write((const char*)&record.seconds, sizeof(record.seconds));
+			}
+
+			return os.good();
+		}
+
+		static void touchPages(const uint8* data, uint64 size)
+		{
+			uint8 sum = 0;
+			for (uint64 offset = 0; offset < size; offset += kPageSize)
+			{
+				sum += data[offset];
+			}
+
+			volatile uint8 sink = sum;
+			(void)sink;
+		}
+
+		static void prefetchRecord(const Record& record)
+		{
+			const auto path = std::filesystem::path(Project::get().getPath().rootPath.u16()) / utf8::utf8to16(record.key);
+			if (!assetpack::exists(path))
+			{
+				return;
+			}
+
+			// Compressed pack entry decode ahead into pack decoded cache, loadAsset and AssetBinaryReader::open take it.
+			// Raw entry and loose file only warm file pages, asset construct and insert event stay on main thread,
+			// meta deserialize there hit page cache. Bin chunk decompress straight into upload buffer.
+			assetpack::FileView packed { };
+			if (assetpack::findFile(path, packed))
+			{
+				if (packed.entry->compression == (uint32)ECompressionMode::None)
+				{
+					const auto view = packed.pack->view(*packed.entry);
+					touchPages(view.data(), view.size());
+				}
+				else
+				{
+					packed.pack->prefetch(*packed.entry);
+				}
+				return;
+			}
+
+			MappedFile file;
+			if (file.open(path))
+			{
+				touchPages(file.data(), file.size());
+			}
+		}
+
+		static void prefetchJob(std::shared_ptr<PrefetchState> state)
+		{
+			ZoneScopedN("assetprefetch::prefetchJob");
+			tlbInPrefetchJob = true;
+
+			// Jobs pull records in recorded order, earlier accessed asset ready first.
+			const uint32 recordCount = (uint32)state->records.size();
+			for (uint32 i = state->nextIndex++; i < recordCount && !state->bCancel; i = state->nextIndex++)
+			{
+				prefetchRecord(state->records[i]);
+			}
+
+			tlbInPrefetchJob = false;
+			sPrefetchJobCount --;
+		}
+	}
+
+	bool assetprefetch::loadRecords(const std::filesystem::path& sidecarPath, std::vector<Record>& outRecords)
+	{
+		outRecords.clear();
+
+		std::ifstream is(sidecarPath, std::ios::binary);
+		if (!is.is_open())
+		{
+			return false;
+		}
+
+		is.seekg(0, std::ios::end);
+		const uint64 fileSize = (uint64)is.tellg();
+		is.seekg(0, std::ios::beg);
+
+		uint32 magic = 0, version = 0, count = 0;
+		is.read((char*)&magic, sizeof(magic));
+		is.read((char*)&version, sizeof(version));
+		is.read((char*)&count, sizeof(count));
+		if (!is.good() || magic != kMagic || version != kVersion)
+		{
+			return false;
+		}
+
+		// Sidecar is untrusted, bound sizes by remaining bytes before allocate.
+		auto getRemainSize = [&]() { return fileSize - (uint64)is.tellg(); };
+
+		constexpr uint64 kMinRecordSize = sizeof(uint32) + sizeof(float);
+		if (uint64(count) * kMinRecordSize > getRemainSize())
+		{
+			LOG_WARN("Load order {} is broken.", utf8::utf16to8(sidecarPath.u16string()));
+			return false;
+		}
+
+		outRecords.resize(count);
+		for (auto& record : outRecords)
+		{
+			uint32 keySize = 0;
+			is.read((char*)&keySize, sizeof(keySize));
+			if (!is.good() || uint64(keySize) + sizeof(float) > getRemainSize())
+			{
+				LOG_WARN("Load order {} is broken.", utf8::utf16to8(sidecarPath.u16string()));
+				outRecords.clear();
+				return false;
+			}
+
+			record.key.resize(keySize);
+			is.read(record.key.data(), keySize);
+			is.read((char*)&record.seconds, sizeof(record.seconds));
+		}
+
+		if (!is.good())
+		{
+			outRecords.clear();
+			return false;
+		}
+
+		std::stable_sort(outRecords.begin(), outRecords.end(), [](const Record& a, const Record& b) { return a.seconds < b.seconds; });
+		return true;
+	}
+
+	uint32 assetprefetch::beginSceneOpen(const std::filesystem::path& scenePath)
+	{
+		cancel();
+
+		const auto sidecarPath = getSidecarPath(scenePath);
+
+		std::vector<Record> records;
+		if (sScenePrefetch)
+		{
+			loadRecords(sidecarPath, records);
+		}
+
+		std::lock_guard lock(sMutex);
+		sRecordState = std::make_unique<RecordState>();
+		sRecordState->sidecarPath = sidecarPath;
+		sRecordState->beginTime = std::chrono::high_resolution_clock::now();
+		sbRecording = true;
+
+		if (records.empty())
+		{
+			return 0;
+		}
+
+		sPrefetchState = std::make_shared<PrefetchState>();
+		sPrefetchState->records = std::move(records);
+
+		const uint32 jobCount = math::clamp(sScenePrefetchJobCount, 1U, (uint32)sPrefetchState->records.size());
+		for (uint32 i = 0; i < jobCount; i++)
+		{
+			sPrefetchJobCount ++;
+			jobsystem::launchSilently("AssetPrefetch", EJobFlags::None, [state = sPrefetchState]()
+			{
+				prefetchJob(state);
+			});
+		}
+
+		return (uint32)sPrefetchState->records.size();
+	}
+
+	bool assetprefetch::isSceneOpening()
+	{
+		return sbRecording;
+	}
+
+	void assetprefetch::recordAccess(const std::filesystem::path& path)
+	{
+		if (!sbRecording || tlbInPrefetchJob)
+		{
+			return;
+		}
+
+		auto key = assetpack::getProjectKey(path);
+		if (key.empty())
+		{
+			return;
+		}
+
+		std::lock_guard lock(sMutex);
+		if (sRecordState && sRecordState->recordedKeys.insert(key).second)
+		{
+			const float seconds = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - sRecordState->beginTime).count();
+			sRecordState->records.push_back({ std::move(key), seconds });
+		}
+	}
+
+	double assetprefetch::endSceneOpen()
+	{
+		std::unique_ptr<RecordState> state = nullptr;
+		{
+			std::lock_guard lock(sMutex);
+			state = std::move(sRecordState);
+			sbRecording = false;
+		}
+
+		if (!state)
+		{
+			return 0.0;
+		}
+
+		const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - state->beginTime).count();
+
+		// Scene open finish, decoded data not consumed yet never be used.
+		assetpack::clearPrefetched();
+		if (!state->records.empty())
+		{
+			saveRecords(state->sidecarPath, state->records);
+		}
+		return seconds;
+	}
+
+	void assetprefetch::cancel()
+	{
+		std::lock_guard lock(sMutex);
+		if (sPrefetchState)
+		{
+			sPrefetchState->bCancel = true;
+			sPrefetchState = nullptr;
+		}
+
+		sRecordState = nullptr;
+		sbRecording = false;
+
+		assetpack::clearPrefetched();
+	}
+
+	void assetprefetch::waitAll()
+	{
+		jobsystem::busyWaitUntil([]() { return sPrefetchJobCount.load() == 0; }, EBusyWaitType::All);
+	}
+
+	std::vector<std::string> assetprefetch::collectProjectLoadOrder()
+	{
+		std::vector<std::filesystem::path> sidecars;
+
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::directory_iterator(Project::get().getPath().cachePath.u16(), ec))
+		{
+			if (entry.is_regular_file(ec) && entry.path().filename().string().ends_with("_loadorder"))
+			{
+				sidecars.push_back(entry.path());
+			}
+		}
+
+		// Stable layout no depend on directory iterate order.
+		std::sort(sidecars.begin(), sidecars.end());
+
+		std::vector<std::string> result;
+		std::vector<Record> records;
+		for (const auto& sidecar : sidecars)
+		{
+			if (loadRecords(sidecar, records))
+			{
+				for (auto& record : records)
+				{
+					result.push_back(std::move(record.key));
+				}
+			}
+		}
+		return result;
+	}
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <asset/asset_common.h>
+
+namespace chord
+{
+	// Recorded load order of scene open, store in Cache as sidecar of scene asset.
+	// Scene open record every asset access with time until first full frame. Later open prefetch recorded assets
+	// on job system before scene traversal reach them, so disk read and decompression overlap with scene construction.
+	// Prefetch job decode compressed pack entries ahead and warm file pages of other recorded files,
+	// asset construct still happen on requester.
+	namespace assetprefetch
+	{
+		struct Record
+		{
+			// Pack key of accessed file, see assetpack::getProjectKey.
+			std::string key;
+
+			// First access time since scene open begin.
+			float seconds;
+		};
+
+		// Begin record scene open, and prefetch last recorded sequence when r.scene.prefetch enable.
+		// Return prefetch asset count.
+		extern uint32 beginSceneOpen(const std::filesystem::path& scenePath);
+
+		// Scene open is recording or not.
+		extern bool isSceneOpening();
+
+		// Record file access, skip when no scene opening or call from prefetch job.
+		extern void recordAccess(const std::filesystem::path& path);
+
+		// Stop record and save sidecar, call when first full frame of scene present. Return time since begin.
+		extern double endSceneOpen();
+
+		// Cancel in-flight prefetch and recording without save.
+		extern void cancel();
+
+		// Wait all in-flight prefetch jobs.
+		extern void waitAll();
+
+		// Load recorded sequence, sort by first access time.
+		extern bool loadRecords(const std::filesystem::path& sidecarPath, std::vector<Record>& outRecords);
+
+		// Recorded keys of all scenes in project, used by asset pack layout.
+		extern std::vector<std::string> collectProjectLoadOrder();
+	}
+}
@@ -0,0 +1,308 @@
+#include <asset/asset_registry.h>
+#include <utils/log.h>
+#include <utils/job_system.h>
+
+namespace chord
+{
+	namespace assetregistry
+	{
+		constexpr uint32 kMagic = 0x47524843; // "CHRG"
+		constexpr uint32 kVersion = 1;
+
+		struct FolderScanResult
+		{
+			std::vector<std::filesystem::path> subFolders;
+			std::vector<AssetRegistry::Entry> entries;
+		};
+
+		static void scanFolder(const std::filesystem::path& assetFolder, const std::filesystem::path& folder, FolderScanResult& result)
+		{
+			std::error_code ec;
+			for (const auto& entry : std::filesystem::directory_iterator(folder, ec))
+			{
+				// Directory entry cache file attributes when iterate, query them here avoid another stat call.
+				if (entry.is_directory(ec))
+				{
+					result.subFolders.push_back(entry.path());
+					continue;
+				}
+
+				// All asset extension start with .asset.
+				if (!entry.path().extension().string().starts_with(".asset"))
+				{
+					continue;
+				}
+
+				AssetRegistry::Entry registryEntry { };
+				registryEntry.relativePath  = utf8::utf16to8(entry.path().lexically_relative(assetFolder).generic_u16string());
+				registryEntry.fileSize      = entry.file_size(ec);
+				registryEntry.lastWriteTime = entry.last_write_time(ec).time_since_epoch().count();
+
+				result.entries.push_back(std::move(registryEntry));
+			}
+		}
+
+		// Extension of utf8 relative path, include period.
+		static std::string getExtension(const std::string& relativePath)
+		{
+			const size_t slash = relativePath.find_last_of('/');
+			const size_t period = relativePath.find_last_of('.');
+			if (period == std::string::npos || (slash != std::string::npos && period < slash))
+			{
+				return { };
+			}
+			return relativePath.substr(period);
+		}
+	}
+
+	bool AssetRegistry::load(const std::filesystem::path& registryPath)
+	{
+		using namespace assetregistry;
+		clear();
+
+		std::ifstream is(registryPath, std::ios::binary);
+		if (!is.is_open())
+		{
+			return false;
+		}
+
+		is.seekg(0, std::ios::end);
+		const uint64 fileSize = (uint64)is.tellg();
+		is.seekg(0, std::ios::beg);
+
+		uint32 magic = 0, version = 0, count = 0;
+		is.read((char*)&magic, sizeof(magic));
+		is.read((char*)&version, sizeof(version));
+		is.read((char*)&count, sizeof(count));
+		if (!is.good() || magic != kMagic || version != kVersion)
+		{
+			LOG_WARN("Asset registry {} is stale, rebuild.", utf8::utf16to8(registryPath.u16string()));
+			return false;
+		}
+
+		// Registry is untrusted, bound sizes by remaining bytes before allocate.
+		auto getRemainSize = [&]() { return fileSize - (uint64)is.tellg(); };
+
+		constexpr uint64 kEntryTailSize = sizeof(Entry::fileSize) + sizeof(Entry::lastWriteTime);
+		constexpr uint64 kMinEntrySize = sizeof(uint32) + kEntryTailSize;
+		if (uint64(count) * kMinEntrySize > getRemainSize())
+		{
+			LOG_ERROR("Asset registry {} is broken, rebuild.", utf8::utf16to8(registryPath.u16string()));
+			return false;
+		}
+
+		m_entries.resize(count);
+		for (auto& entry : m_entries)
+		{
+			uint32 pathSize = 0;
+			is.read((char*)&pathSize, sizeof(pathSize));
+			if (!is.good() || uint64(pathSize) + kEntryTailSize > getRemainSize())
+			{
+				LOG_ERROR("Asset registry {} is broken, rebuild.", utf8::utf16to8(registryPath.u16string()));
+				clear();
+				return false;
+			}
+
+			entry.relativePath.resize(pathSize);
+			is.read(entry.relativePath.data(), pathSize);
+			is.read((char*)&entry.fileSize, sizeof(entry.fileSize));
+			is.read((char*)&entry.lastWriteTime, sizeof(entry.lastWriteTime));
+		}
+
+		if (!is.good())
+		{
+			LOG_ERROR("Asset registry {} is broken, rebuild.", utf8::utf16to8(registryPath.u16string()));
+			clear();
+			return false;
+		}
+
+		rebuildLookup();
+		return true;
+	}
+
+	bool AssetRegistry::save(const std::filesystem::path& registryPath) const
+	{
+		using namespace assetregistry;
+
+		const auto tempPath = std::filesystem::path(registryPath).concat(std::format(".{}.tmp", std::hash<std::thread::id>{ }(std::this_thread::get_id())));
+		{
+			std::ofstream os(tempPath, std::ios::binary | std::ios::trunc);
+			if (!os.is_open())
+			{
+				LOG_ERROR("Fail to open asset registry {} to write.", utf8::utf16to8(tempPath.u16string()));
+				return false;
+			}
+
+			const uint32 count = (uint32)m_entries.size();
+			os.write((const char*)&kMagic, sizeof(kMagic));
+			os.write((const char*)&kVersion, sizeof(kVersion));
+			os.write((const char*)&count, sizeof(count));
+
+			for (const auto& entry : m_entries)
+			{
+				const uint32 pathSize = (uint32)entry.relativePath.size();
+				os.write((const char*)&pathSize, sizeof(pathSize));
+				os.write(entry.relativePath.data(), pathSize);
+				os.write((const char*)&entry.fileSize, sizeof(entry.fileSize));
+				os.write((const char*)&entry.lastWriteTime, sizeof(entry.lastWriteTime));
+			}
+
+			if (!os.good())
+			{
+				LOG_ERROR("Fail to write asset registry {}.", utf8::utf16to8(tempPath.u16string()));
+				os.close();
+
+				std::error_code ec;
+				std::filesystem::remove(tempPath, ec);
+				return false;
+			}
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, registryPath, ec);
+		if (ec)
+		{
+			LOG_ERROR("Fail to replace asset registry {}: {}.", utf8::utf16to8(registryPath.u16string()), ec.message());
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+		return true;
+	}
+
+	AssetRegistry::ScanStatistics AssetRegistry::scan(const std::filesystem::path& assetFolder, const MetaValidator& validator)
+	{
+		using namespace assetregistry;
+		ZoneScopedN("AssetRegistry::scan");
+
+		ScanStatistics statistics { };
+
+		// Walk folder tree level by level, all folders of one level scan in parallel.
+		std::vector<Entry> entries;
+		std::vector<std::filesystem::path> folders = { assetFolder };
+		while (!folders.empty())
+		{
+			statistics.folderCount += (uint32)folders.size();
+
+			std::vector<FolderScanResult> results(folders.size());
+			jobsystem::parallelFor("AssetRegistryScan", EBusyWaitType::All, (uint32)folders.size(), EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+			{
+				for (uint32 i = loopStart; i < loopEnd; i++)
+				{
+					scanFolder(assetFolder, folders[i], results[i]);
+				}
+			});
+
+			folders.clear();
+			for (auto& result : results)
+			{
+				folders.insert(folders.end(), std::make_move_iterator(result.subFolders.begin()), std::make_move_iterator(result.subFolders.end()));
+				entries.insert(entries.end(), std::make_move_iterator(result.entries.begin()), std::make_move_iterator(result.entries.end()));
+			}
+		}
+
+		// Unchanged entry reuse directly, other need validate.
+		std::vector<uint32> changedEntries;
+		for (uint32 i = 0; i < (uint32)entries.size(); i++)
+		{
+			const auto* cached = find(entries[i].relativePath);
+			if (cached && cached->fileSize == entries[i].fileSize && cached->lastWriteTime == entries[i].lastWriteTime)
+			{
+				statistics.reuseCount ++;
+			}
+			else
+			{
+				changedEntries.push_back(i);
+			}
+		}
+		statistics.validateCount = (uint32)changedEntries.size();
+
+		std::vector<uint8> validEntries(entries.size(), 1);
+		if (validator && !changedEntries.empty())
+		{
+			jobsystem::parallelFor("AssetRegistryValidate", EBusyWaitType::All, (uint32)changedEntries.size(), EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+			{
+				for (uint32 i = loopStart; i < loopEnd; i++)
+				{
+					const uint32 entryIndex = changedEntries[i];
+					const auto path = assetFolder / utf8::utf8to16(entries[entryIndex].relativePath);
+
+					validEntries[entryIndex] = validator(path) ? 1 : 0;
+				}
+			});
+		}
+
+		m_entries.clear();
+		m_entries.reserve(entries.size());
+		for (uint32 i = 0; i < (uint32)entries.size(); i++)
+		{
+			if (validEntries[i])
+			{
+				m_entries.push_back(std::move(entries[i]));
+			}
+			else
+			{
+				LOG_ERROR("Asset meta {} is broken, skip.", entries[i].relativePath);
+				statistics.invalidCount ++;
+			}
+		}
+		statistics.entryCount = (uint32)m_entries.size();
+
+		rebuildLookup();
+		return statistics;
+	}
+
+	const AssetRegistry::Entry* AssetRegistry::find(const std::string& relativePath) const
+	{
+		if (auto iter = m_lookup.find(relativePath); iter != m_lookup.end())
+		{
+			return &m_entries[iter->second];
+		}
+		return nullptr;
+	}
+
+	const std::vector<uint32>& AssetRegistry::getClassifiedEntries(const std::string& extension) const
+	{
+		static const std::vector<uint32> kEmpty { };
+		if (auto iter = m_classified.find(extension); iter != m_classified.end())
+		{
+			return iter->second;
+		}
+		return kEmpty;
+	}
+
+	uint32 AssetRegistry::merge(const std::vector<std::string>& relativePaths)
+	{
+		uint32 addedCount = 0;
+		for (const auto& relativePath : relativePaths)
+		{
+			if (find(relativePath) == nullptr)
+			{
+				const uint32 index = (uint32)m_entries.size();
+				m_lookup[relativePath] = index;
+				m_classified[assetregistry::getExtension(relativePath)].push_back(index);
+				m_entries.push_back({ relativePath, 0, 0 });
+				addedCount ++;
+			}
+		}
+		return addedCount;
+	}
+
+	void AssetRegistry::clear()
+	{
+		m_entries.clear();
+		m_lookup.clear();
+		m_classified.clear();
+	}
+
+	void AssetRegistry::rebuildLookup()
+	{
+		m_lookup.clear();
+		m_classified.clear();
+		m_lookup.reserve(m_entries.size());
+		for (uint32 i = 0; i < (uint32)m_entries.size(); i++)
+		{
+			m_lookup[m_entries[i].relativePath] = i;
+			m_classified[assetregistry::getExtension(m_entries[i].relativePath)].push_back(i);
+		}
+	}
+}
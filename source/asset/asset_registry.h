@@ -0,0 +1,72 @@
+#pragma once
+
+#include <utils/utils.h>
+
+namespace chord
+{
+	// Persistent index of project asset meta files, store in project cache folder.
+	// Entry key by path relative to asset folder, and validate incrementally by file size and last write time,
+	// so warm startup only walk folders and never touch unchanged meta file.
+	class AssetRegistry : NonCopyable
+	{
+	public:
+		struct Entry
+		{
+			// Meta file path relative to asset folder, utf8.
+			std::string relativePath;
+
+			uint64 fileSize;
+			int64  lastWriteTime;
+		};
+
+		struct ScanStatistics
+		{
+			uint32 folderCount   = 0;
+			uint32 entryCount    = 0;
+
+			// Entry unchanged since last scan.
+			uint32 reuseCount    = 0;
+
+			// Entry new or changed, validate by meta validator.
+			uint32 validateCount = 0;
+
+			// Entry fail to validate, not in registry.
+			uint32 invalidCount  = 0;
+		};
+
+		// Validate new or changed meta file, call from multiple job threads.
+		using MetaValidator = std::function<bool(const std::filesystem::path& path)>;
+
+		// Load registry from disk, return false if miss or stale.
+		bool load(const std::filesystem::path& registryPath);
+
+		// Write to temp file then rename, crash in middle never break old registry.
+		bool save(const std::filesystem::path& registryPath) const;
+
+		// Walk asset folder on job system, reuse unchanged entries and validate others.
+		ScanStatistics scan(const std::filesystem::path& assetFolder, const MetaValidator& validator);
+
+		const auto& getEntries() const
+		{
+			return m_entries;
+		}
+
+		const Entry* find(const std::string& relativePath) const;
+
+		// Entry indices classify by meta extension (e.g. ".assetgltf"), empty if no such type.
+		const std::vector<uint32>& getClassifiedEntries(const std::string& extension) const;
+
+		// Add entries not in registry yet, used by packed meta which not exist on disk. Return added count.
+		uint32 merge(const std::vector<std::string>& relativePaths);
+
+		void clear();
+
+	private:
+		void rebuildLookup();
+
+	private:
+		std::vector<Entry> m_entries;
+		std::unordered_map<std::string, uint32> m_lookup;
+		std::unordered_map<std::string, std::vector<uint32>> m_classified;
+	};
+}
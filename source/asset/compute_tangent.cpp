@@ -1,66 +1,794 @@
 #include <asset/compute_tangent.h>
 #include <asset/mikktspace.h>
+#include <utils/job_system.h>
+#include <utils/cityhash.h>
+#include <utils/log.h>
 
-bool chord::computeTangent(
-	std::vector<nanite::Vertex>& rawVertices, 
-	std::vector<uint32>& rawIndices)
+namespace chord
 {
-	// MikkTSpace context.
-	struct MikkTSpaceContext
+	namespace tangentspace
 	{
-		std::vector<nanite::Vertex>* rawVerticesPtr;
-		std::vector<uint32>* rawIndicesPtr;
-	} 
-	computeCtx
-	{
-		.rawVerticesPtr = &rawVertices,
-		.rawIndicesPtr = &rawIndices,
-	};
+		constexpr uint32 kInvalid = ~0U;
 
-	SMikkTSpaceContext ctx{};
-	SMikkTSpaceInterface ctxI{};
+		// Same meaning as mikktspace triangle flags.
+		constexpr uint32 kFlagDegenerate       = 0x1;
+		constexpr uint32 kFlagGroupWithAny     = 0x4;
+		constexpr uint32 kFlagOrientPreserving = 0x8;
 
-	ctx.m_pInterface = &ctxI;
-	ctx.m_pUserData  = &computeCtx;
+		// Weld bucket select by hash high bits.
+		constexpr uint32 kWeldBucketBits = 12;
 
-	ctx.m_pInterface->m_getNumFaces = [](const SMikkTSpaceContext* pContext) -> int { return ((MikkTSpaceContext*)pContext->m_pUserData)->rawIndicesPtr->size() / 3; };
-	ctx.m_pInterface->m_getNumVerticesOfFace = [](const SMikkTSpaceContext* pContext, const int iFace) -> int { return 3; };
-	ctx.m_pInterface->m_getPosition = [](const SMikkTSpaceContext* pContext, float fvPosOut[], const int iFace, const int iVert) -> void
-	{
-		auto* ctx = (MikkTSpaceContext*)pContext->m_pUserData;
-		uint32 id = ctx->rawIndicesPtr->at(iFace * 3 + iVert);
-
-		fvPosOut[0] = ctx->rawVerticesPtr->at(id).position.x;
-		fvPosOut[1] = ctx->rawVerticesPtr->at(id).position.y;
-		fvPosOut[2] = ctx->rawVerticesPtr->at(id).position.z;
-	};
-	ctx.m_pInterface->m_getNormal = [](const SMikkTSpaceContext* pContext, float fvNormOut[], const int iFace, const int iVert) -> void
-	{
-		auto* ctx = (MikkTSpaceContext*)pContext->m_pUserData;
-		uint32 id = ctx->rawIndicesPtr->at(iFace * 3 + iVert);
-
-		fvNormOut[0] = ctx->rawVerticesPtr->at(id).normal.x;
-		fvNormOut[1] = ctx->rawVerticesPtr->at(id).normal.x;
-		fvNormOut[2] = ctx->rawVerticesPtr->at(id).normal.x;
-	};
-	ctx.m_pInterface->m_getTexCoord = [](const SMikkTSpaceContext* pContext, float fvTexcOut[], const int iFace, const int iVert) -> void
+		// Vector math keep mikktspace operation order, result must match it bit by bit.
+		static inline float3 vadd(const float3& a, const float3& b) { return float3(a.x + b.x, a.y + b.y, a.z + b.z); }
+		static inline float3 vsub(const float3& a, const float3& b) { return float3(a.x - b.x, a.y - b.y, a.z - b.z); }
+		static inline float3 vscale(float s, const float3& v) { return float3(s * v.x, s * v.y, s * v.z); }
+		static inline float vdot(const float3& a, const float3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+		static inline float vlength(const float3& v) { return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z); }
+		static inline float3 vnormalize(const float3& v) { return vscale(1 / vlength(v), v); }
+		static inline bool veq(const float3& a, const float3& b) { return (a.x == b.x) && (a.y == b.y) && (a.z == b.z); }
+		static inline bool notZero(float x) { return std::fabs(x) > FLT_MIN; }
+		static inline bool vNotZero(const float3& v) { return notZero(v.x) || notZero(v.y) || notZero(v.z); }
+
+		// Project onto plane of normal n and normalize.
+		static inline float3 project(const float3& n, const float3& v)
+		{
+			float3 result = vsub(v, vscale(vdot(n, v), n));
+			if (vNotZero(result))
+			{
+				result = vnormalize(result);
+			}
+			return result;
+		}
+
+		struct Triangle
+		{
+			// Normalized first order derivatives.
+			float3 vOs;
+			float3 vOt;
+
+			// Neighbor triangle of edge i, which from corner i to corner i + 1.
+			uint32 neighbors[3];
+			uint32 flag;
+		};
+
+		struct TSpace
+		{
+			float3 vOs = float3(1.0f, 0.0f, 0.0f);
+			bool bOrient = false;
+		};
+
+		struct Context
+		{
+			const std::vector<nanite::Vertex>& vertices;
+			const std::vector<uint32>& indices;
+
+			uint32 vertexCount;
+			uint32 triangleCount;
+
+			// Welded vertex of each corner, vertices with same position, normal and uv0 share smallest index.
+			std::vector<uint32> corners;
+			std::vector<Triangle> triangles;
+
+			// Good triangle corners of each welded vertex, sorted.
+			std::vector<uint32> fanOffsets;
+			std::vector<uint32> fanCorners;
+
+			// Reference write tangent per corner, vertex keep the last one.
+			std::vector<uint32> lastCorners;
+
+			// Tangent space of first good corner, degenerate corners copy it.
+			std::vector<TSpace> firstTSpaces;
+
+			const uint32* getFan(uint32 vertex, uint32& outCount) const
+			{
+				outCount = fanOffsets[vertex + 1] - fanOffsets[vertex];
+				return fanCorners.data() + fanOffsets[vertex];
+			}
+		};
+
+		static inline bool isSameAttributes(const nanite::Vertex& a, const nanite::Vertex& b)
+		{
+			return veq(a.position, b.position) && veq(a.normal, b.normal) && (a.uv0.x == b.uv0.x) && (a.uv0.y == b.uv0.y);
+		}
+
+		static inline void atomicMax(uint32& dest, uint32 value)
+		{
+			std::atomic_ref<uint32> ref(dest);
+			uint32 current = ref.load(std::memory_order_relaxed);
+			while ((current == kInvalid || current < value) && !ref.compare_exchange_weak(current, value, std::memory_order_relaxed))
+			{
+			}
+		}
+
+		static void weldVertices(Context& ctx, std::vector<uint32>& outWelded)
+		{
+			const auto& vertices = ctx.vertices;
+			const uint32 vertexCount = ctx.vertexCount;
+
+			std::vector<uint64> hashes(vertexCount);
+			jobsystem::parallelFor("TangentWeldHash", EBusyWaitType::All, vertexCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+			{
+				for (uint32 i = loopStart; i < loopEnd; i++)
+				{
+					const auto& vertex = vertices[i];
+
+					// Add zero fold negative zero, float equal treat them same.
+					const float key[8] =
+					{
+						vertex.position.x + 0.0f, vertex.position.y + 0.0f, vertex.position.z + 0.0f,
+						vertex.normal.x + 0.0f, vertex.normal.y + 0.0f, vertex.normal.z + 0.0f,
+						vertex.uv0.x + 0.0f, vertex.uv0.y + 0.0f,
+					};
+					hashes[i] = cityhash::cityhash64((const char*)key, sizeof(key));
+				}
+			});
+
+			constexpr uint32 kBucketCount = 1U << kWeldBucketBits;
+			std::vector<uint32> bucketOffsets(kBucketCount + 1, 0);
+			for (uint32 i = 0; i < vertexCount; i++)
+			{
+				bucketOffsets[(hashes[i] >> (64 - kWeldBucketBits)) + 1]++;
+			}
+			for (uint32 i = 0; i < kBucketCount; i++)
+			{
+				bucketOffsets[i + 1] += bucketOffsets[i];
+			}
+
+			std::vector<uint32> bucketVertices(vertexCount);
+			{
+				std::vector<uint32> cursors(bucketOffsets.begin(), bucketOffsets.end() - 1);
+				for (uint32 i = 0; i < vertexCount; i++)
+				{
+					bucketVertices[cursors[hashes[i] >> (64 - kWeldBucketBits)]++] = i;
+				}
+			}
+
+			outWelded.resize(vertexCount);
+			jobsystem::parallelFor("TangentWeld", EBusyWaitType::All, kBucketCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+			{
+				for (uint32 bucket = loopStart; bucket < loopEnd; bucket++)
+				{
+					const auto begin = bucketVertices.begin() + bucketOffsets[bucket];
+					const auto end = bucketVertices.begin() + bucketOffsets[bucket + 1];
+					std::sort(begin, end, [&](uint32 a, uint32 b) { return hashes[a] != hashes[b] ? hashes[a] < hashes[b] : a < b; });
+
+					for (auto run = begin; run != end;)
+					{
+						auto runEnd = run;
+						while (runEnd != end && hashes[*runEnd] == hashes[*run])
+						{
+							++runEnd;
+						}
+
+						// Sorted by index inside run, first equal one is smallest.
+						for (auto it = run; it != runEnd; ++it)
+						{
+							outWelded[*it] = *it;
+							for (auto prev = run; prev != it; ++prev)
+							{
+								if (outWelded[*prev] == *prev && isSameAttributes(vertices[*it], vertices[*prev]))
+								{
+									outWelded[*it] = *prev;
+									break;
+								}
+							}
+						}
+						run = runEnd;
+					}
+				}
+			});
+		}
+
+		// Degenerate mark and first order derivatives, same as InitTriInfo of mikktspace.
+		static bool initTriangles(Context& ctx, const std::vector<uint32>& welded, uint32& outDegenerateCount)
+		{
+			const auto& vertices = ctx.vertices;
+			const auto& indices = ctx.indices;
+
+			std::atomic<uint32> degenerateCount = 0;
+			std::atomic<bool> bIndexValid = true;
+			jobsystem::parallelFor("TangentTriangles", EBusyWaitType::All, ctx.triangleCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+			{
+				uint32 localDegenerateCount = 0;
+				for (uint32 f = loopStart; f < loopEnd; f++)
+				{
+					Triangle& tri = ctx.triangles[f];
+					tri.neighbors[0] = tri.neighbors[1] = tri.neighbors[2] = kInvalid;
+					tri.vOs = float3(0.0f);
+					tri.vOt = float3(0.0f);
+					tri.flag = kFlagDegenerate;
+
+					const uint32 i0 = indices[f * 3 + 0];
+					const uint32 i1 = indices[f * 3 + 1];
+					const uint32 i2 = indices[f * 3 + 2];
+					if (i0 >= ctx.vertexCount || i1 >= ctx.vertexCount || i2 >= ctx.vertexCount)
+					{
+						bIndexValid = false;
+						continue;
+					}
+
+					ctx.corners[f * 3 + 0] = welded[i0];
+					ctx.corners[f * 3 + 1] = welded[i1];
+					ctx.corners[f * 3 + 2] = welded[i2];
+
+					const float3& v1 = vertices[i0].position;
+					const float3& v2 = vertices[i1].position;
+					const float3& v3 = vertices[i2].position;
+					if (veq(v1, v2) || veq(v1, v3) || veq(v2, v3))
+					{
+						localDegenerateCount++;
+						continue;
+					}
+
+					const float2& t1 = vertices[i0].uv0;
+					const float2& t2 = vertices[i1].uv0;
+					const float2& t3 = vertices[i2].uv0;
+
+					const float t21x = t2.x - t1.x;
+					const float t21y = t2.y - t1.y;
+					const float t31x = t3.x - t1.x;
+					const float t31y = t3.y - t1.y;
+					const float3 d1 = vsub(v2, v1);
+					const float3 d2 = vsub(v3, v1);
+
+					const float signedAreaSTx2 = t21x * t31y - t21y * t31x;
+					const float3 vOs = vsub(vscale(t31y, d1), vscale(t21y, d2));
+					const float3 vOt = vadd(vscale(-t31x, d1), vscale(t21x, d2));
+
+					// Assumed bad until derivatives valid.
+					tri.flag = kFlagGroupWithAny | (signedAreaSTx2 > 0 ? kFlagOrientPreserving : 0);
+					if (notZero(signedAreaSTx2))
+					{
+						const float absArea = std::fabs(signedAreaSTx2);
+						const float lenOs = vlength(vOs);
+						const float lenOt = vlength(vOt);
+						const float s = (tri.flag & kFlagOrientPreserving) == 0 ? (-1.0f) : 1.0f;
+						if (notZero(lenOs)) { tri.vOs = vscale(s / lenOs, vOs); }
+						if (notZero(lenOt)) { tri.vOt = vscale(s / lenOt, vOt); }
+
+						if (notZero(lenOs / absArea) && notZero(lenOt / absArea))
+						{
+							tri.flag &= ~kFlagGroupWithAny;
+						}
+					}
+				}
+				degenerateCount += localDegenerateCount;
+			});
+
+			outDegenerateCount = degenerateCount;
+			return bIndexValid;
+		}
+
+		static void buildFans(Context& ctx)
+		{
+			ctx.fanOffsets.assign(ctx.vertexCount + 1, 0);
+			jobsystem::parallelFor("TangentFanCount", EBusyWaitType::All, ctx.triangleCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+			{
+				for (uint32 f = loopStart; f < loopEnd; f++)
+				{
+					if ((ctx.triangles[f].flag & kFlagDegenerate) == 0)
+					{
+						for (uint32 i = 0; i < 3; i++)
+						{
+							std::atomic_ref<uint32>(ctx.fanOffsets[ctx.corners[f * 3 + i] + 1]).fetch_add(1, std::memory_order_relaxed);
+						}
+					}
+				}
+			});
+
+			for (uint32 i = 0; i < ctx.vertexCount; i++)
+			{
+				ctx.fanOffsets[i + 1] += ctx.fanOffsets[i];
+			}
+
+			ctx.fanCorners.resize(ctx.fanOffsets.back());
+			std::vector<uint32> cursors(ctx.fanOffsets.begin(), ctx.fanOffsets.end() - 1);
+			jobsystem::parallelFor("TangentFanFill", EBusyWaitType::All, ctx.triangleCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+			{
+				for (uint32 f = loopStart; f < loopEnd; f++)
+				{
+					if ((ctx.triangles[f].flag & kFlagDegenerate) == 0)
+					{
+						for (uint32 i = 0; i < 3; i++)
+						{
+							const uint32 slot = std::atomic_ref<uint32>(cursors[ctx.corners[f * 3 + i]]).fetch_add(1, std::memory_order_relaxed);
+							ctx.fanCorners[slot] = f * 3 + i;
+						}
+					}
+				}
+			});
+
+			jobsystem::parallelFor("TangentFanSort", EBusyWaitType::All, ctx.vertexCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+			{
+				for (uint32 v = loopStart; v < loopEnd; v++)
+				{
+					std::sort(ctx.fanCorners.begin() + ctx.fanOffsets[v], ctx.fanCorners.begin() + ctx.fanOffsets[v + 1]);
+				}
+			});
+		}
+
+		// Edge pairs handle by the smaller welded vertex, pair up in triangle order like BuildNeighborsFast:
+		// each unpaired edge take the first later unpaired edge with opposite direction.
+		static void buildNeighbors(Context& ctx)
+		{
+			struct FanEdge
+			{
+				uint32 other;
+				uint32 triangle;
+				uint32 edge;
+				bool bOutgoing;
+			};
+
+			jobsystem::parallelFor("TangentNeighbors", EBusyWaitType::All, ctx.vertexCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+			{
+				std::vector<FanEdge> edges;
+				for (uint32 v = loopStart; v < loopEnd; v++)
+				{
+					uint32 fanCount;
+					const uint32* fan = ctx.getFan(v, fanCount);
+
+					edges.clear();
+					for (uint32 k = 0; k < fanCount; k++)
+					{
+						const uint32 f = fan[k] / 3;
+						const uint32 i = fan[k] % 3;
+
+						const uint32 next = ctx.corners[f * 3 + (i < 2 ? (i + 1) : 0)];
+						const uint32 prev = ctx.corners[f * 3 + (i > 0 ? (i - 1) : 2)];
+						if (next > v) { edges.push_back({ next, f, i, true }); }
+						if (prev > v) { edges.push_back({ prev, f, (i > 0 ? (i - 1) : 2), false }); }
+					}
+
+					std::sort(edges.begin(), edges.end(), [](const FanEdge& a, const FanEdge& b)
+					{
+						return a.other != b.other ? a.other < b.other : a.triangle < b.triangle;
+					});
+
+					for (uint32 a = 0; a < edges.size(); a++)
+					{
+						const FanEdge& edgeA = edges[a];
+						if (ctx.triangles[edgeA.triangle].neighbors[edgeA.edge] != kInvalid)
+						{
+							continue;
+						}
+
+						for (uint32 b = a + 1; b < edges.size() && edges[b].other == edgeA.other; b++)
+						{
+							const FanEdge& edgeB = edges[b];
+							if (edgeB.bOutgoing != edgeA.bOutgoing && ctx.triangles[edgeB.triangle].neighbors[edgeB.edge] == kInvalid)
+							{
+								ctx.triangles[edgeA.triangle].neighbors[edgeA.edge] = edgeB.triangle;
+								ctx.triangles[edgeB.triangle].neighbors[edgeB.edge] = edgeA.triangle;
+								break;
+							}
+						}
+					}
+				}
+			});
+		}
+
+		static inline uint32 findCorner(const Context& ctx, uint32 f, uint32 v)
+		{
+			const uint32* corners = &ctx.corners[f * 3];
+			return corners[0] == v ? 0 : (corners[1] == v ? 1 : 2);
+		}
+
+		// Group with any triangle take orientation of the first group reach it, the only order dependency of mikktspace.
+		// Replay Build4RuleGroups seed order only on vertices touch such triangles, groups of other vertices never reach them.
+		// After that every orientation is final and groups of each vertex are independent.
+		static void resolveGroupWithAnyOrientation(Context& ctx)
+		{
+			std::vector<uint8> bTouchVertices(ctx.vertexCount, 0);
+			bool bExist = false;
+			for (uint32 f = 0; f < ctx.triangleCount; f++)
+			{
+				if ((ctx.triangles[f].flag & (kFlagDegenerate | kFlagGroupWithAny)) == kFlagGroupWithAny)
+				{
+					bTouchVertices[ctx.corners[f * 3 + 0]] = 1;
+					bTouchVertices[ctx.corners[f * 3 + 1]] = 1;
+					bTouchVertices[ctx.corners[f * 3 + 2]] = 1;
+					bExist = true;
+				}
+			}
+
+			if (!bExist)
+			{
+				return;
+			}
+
+			std::vector<uint8> bAssigned(ctx.corners.size(), 0);
+			std::vector<uint8> bResolved(ctx.triangleCount, 0);
+			std::vector<uint32> stack;
+			for (uint32 f = 0; f < ctx.triangleCount; f++)
+			{
+				if ((ctx.triangles[f].flag & (kFlagDegenerate | kFlagGroupWithAny)) != 0)
+				{
+					continue;
+				}
+
+				for (uint32 i = 0; i < 3; i++)
+				{
+					const uint32 v = ctx.corners[f * 3 + i];
+					if (!bTouchVertices[v] || bAssigned[f * 3 + i])
+					{
+						continue;
+					}
+
+					const uint32 orient = ctx.triangles[f].flag & kFlagOrientPreserving;
+					bAssigned[f * 3 + i] = 1;
+
+					auto pushNeighbors = [&](uint32 t, uint32 j)
+					{
+						const Triangle& tri = ctx.triangles[t];
+						if (tri.neighbors[j] != kInvalid) { stack.push_back(tri.neighbors[j]); }
+						if (tri.neighbors[j > 0 ? (j - 1) : 2] != kInvalid) { stack.push_back(tri.neighbors[j > 0 ? (j - 1) : 2]); }
+					};
+
+					pushNeighbors(f, i);
+					while (!stack.empty())
+					{
+						const uint32 t = stack.back();
+						stack.pop_back();
+
+						const uint32 j = findCorner(ctx, t, v);
+						if (bAssigned[t * 3 + j])
+						{
+							continue;
+						}
+
+						Triangle& tri = ctx.triangles[t];
+						if ((tri.flag & kFlagGroupWithAny) != 0 && !bResolved[t])
+						{
+							tri.flag = (tri.flag & ~kFlagOrientPreserving) | orient;
+						}
+						bResolved[t] = 1;
+
+						if ((tri.flag & kFlagOrientPreserving) != orient)
+						{
+							continue;
+						}
+
+						bAssigned[t * 3 + j] = 1;
+						pushNeighbors(t, j);
+					}
+				}
+			}
+		}
+
+		static inline void writeTangent(Context& ctx, std::vector<nanite::Vertex>& vertices, uint32 corner, const TSpace& tspace)
+		{
+			const uint32 vertex = ctx.indices[corner];
+			if (ctx.lastCorners[vertex] == corner)
+			{
+				vertices[vertex].tangent = float4(tspace.vOs.x, tspace.vOs.y, tspace.vOs.z, tspace.bOrient ? 1.0f : (-1.0f));
+			}
+		}
+
+		// Groups of one welded vertex by connectivity and orientation, then split into sub groups and
+		// evaluate tangent space like GenerateTSpaces and EvalTspace.
+		static void generateTSpaces(Context& ctx, std::vector<nanite::Vertex>& vertices)
+		{
+			const float thresholdCos = (float)std::cos((180.0f * math::pi<float>()) / 180.0f);
+
+			jobsystem::parallelFor("TangentGroups", EBusyWaitType::All, ctx.vertexCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+			{
+				std::vector<uint32> groupIds;
+				std::vector<uint32> fanFlags;
+				std::vector<uint32> groupFaces;
+				std::vector<uint32> stack;
+				std::vector<float3> projectOs;
+				std::vector<float3> projectOt;
+
+				// Unique sub groups of current group, members store in fan position.
+				std::vector<uint32> members;
+				std::vector<uint32> subGroupMembers;
+				std::vector<uint32> subGroupOffsets;
+				std::vector<TSpace> subGroupTSpaces;
+
+				for (uint32 v = loopStart; v < loopEnd; v++)
+				{
+					uint32 fanCount;
+					const uint32* fan = ctx.getFan(v, fanCount);
+					if (fanCount == 0)
+					{
+						continue;
+					}
+
+					auto findFan = [&](uint32 t)
+					{
+						return uint32(std::lower_bound(fan, fan + fanCount, t * 3) - fan);
+					};
+
+					auto pushNeighbors = [&](uint32 corner)
+					{
+						const Triangle& tri = ctx.triangles[corner / 3];
+						const uint32 j = corner % 3;
+						if (tri.neighbors[j] != kInvalid) { stack.push_back(tri.neighbors[j]); }
+						if (tri.neighbors[j > 0 ? (j - 1) : 2] != kInvalid) { stack.push_back(tri.neighbors[j > 0 ? (j - 1) : 2]); }
+					};
+
+					fanFlags.resize(fanCount);
+					for (uint32 k = 0; k < fanCount; k++)
+					{
+						fanFlags[k] = ctx.triangles[fan[k] / 3].flag;
+					}
+
+					groupIds.assign(fanCount, kInvalid);
+					uint32 groupCount = 0;
+					for (uint32 k = 0; k < fanCount; k++)
+					{
+						const uint32 flag = fanFlags[k];
+						if ((flag & kFlagGroupWithAny) != 0 || groupIds[k] != kInvalid)
+						{
+							continue;
+						}
+
+						const uint32 orient = flag & kFlagOrientPreserving;
+						groupIds[k] = groupCount;
+
+						pushNeighbors(fan[k]);
+						while (!stack.empty())
+						{
+							const uint32 p = findFan(stack.back());
+							stack.pop_back();
+
+							if (groupIds[p] != kInvalid || (fanFlags[p] & kFlagOrientPreserving) != orient)
+							{
+								continue;
+							}
+
+							groupIds[p] = groupCount;
+							pushNeighbors(fan[p]);
+						}
+						groupCount++;
+					}
+
+					// Normal is the same for all welded corners.
+					const float3& n = ctx.vertices[v].normal;
+					projectOs.resize(fanCount);
+					projectOt.resize(fanCount);
+
+					TSpace firstTSpace { };
+					for (uint32 g = 0; g < groupCount; g++)
+					{
+						groupFaces.clear();
+						for (uint32 k = 0; k < fanCount; k++)
+						{
+							if (groupIds[k] == g)
+							{
+								groupFaces.push_back(k);
+								projectOs[k] = project(n, ctx.triangles[fan[k] / 3].vOs);
+								projectOt[k] = project(n, ctx.triangles[fan[k] / 3].vOt);
+							}
+						}
+
+						const bool bOrient = (fanFlags[groupFaces[0]] & kFlagOrientPreserving) != 0;
+						subGroupMembers.clear();
+						subGroupOffsets.assign(1, 0);
+						subGroupTSpaces.clear();
+
+						for (const uint32 k : groupFaces)
+						{
+							members.clear();
+							for (const uint32 m : groupFaces)
+							{
+								const bool bAny = ((fanFlags[k] | fanFlags[m]) & kFlagGroupWithAny) != 0;
+								const float cosS = vdot(projectOs[k], projectOs[m]);
+								const float cosT = vdot(projectOt[k], projectOt[m]);
+								if (bAny || k == m || (cosS > thresholdCos && cosT > thresholdCos))
+								{
+									members.push_back(m);
+								}
+							}
+
+							uint32 subGroup = 0;
+							for (; subGroup < subGroupTSpaces.size(); subGroup++)
+							{
+								const uint32 offset = subGroupOffsets[subGroup];
+								const uint32 count = subGroupOffsets[subGroup + 1] - offset;
+								if (count == members.size() && std::equal(members.begin(), members.end(), subGroupMembers.begin() + offset))
+								{
+									break;
+								}
+							}
+
+							if (subGroup == subGroupTSpaces.size())
+							{
+								// Angle weighted sum of member derivatives, sum in triangle order.
+								float3 vOs = float3(0.0f);
+								for (const uint32 m : members)
+								{
+									const uint32 f = fan[m] / 3;
+									const uint32 i = fan[m] % 3;
+									if ((fanFlags[m] & kFlagGroupWithAny) != 0)
+									{
+										continue;
+									}
+
+									const float3& p0 = ctx.vertices[ctx.indices[f * 3 + (i > 0 ? (i - 1) : 2)]].position;
+									const float3& p1 = ctx.vertices[ctx.indices[f * 3 + i]].position;
+									const float3& p2 = ctx.vertices[ctx.indices[f * 3 + (i < 2 ? (i + 1) : 0)]].position;
+
+									const float3 v1 = project(n, vsub(p0, p1));
+									const float3 v2 = project(n, vsub(p2, p1));
+
+									float cosAngle = vdot(v1, v2);
+									cosAngle = cosAngle > 1 ? 1 : (cosAngle < (-1) ? (-1) : cosAngle);
+									const float angle = std::acos(cosAngle);
+
+									vOs = vadd(vOs, vscale(angle, projectOs[m]));
+								}
+
+								TSpace tspace { };
+								tspace.vOs = vNotZero(vOs) ? vnormalize(vOs) : vOs;
+								tspace.bOrient = bOrient;
+
+								subGroupMembers.insert(subGroupMembers.end(), members.begin(), members.end());
+								subGroupOffsets.push_back((uint32)subGroupMembers.size());
+								subGroupTSpaces.push_back(tspace);
+							}
+
+							if (k == 0)
+							{
+								firstTSpace = subGroupTSpaces[subGroup];
+							}
+							writeTangent(ctx, vertices, fan[k], subGroupTSpaces[subGroup]);
+						}
+					}
+
+					// Corners of group with any triangles no group reach keep default.
+					for (uint32 k = 0; k < fanCount; k++)
+					{
+						if (groupIds[k] == kInvalid)
+						{
+							writeTangent(ctx, vertices, fan[k], TSpace{ });
+						}
+					}
+
+					if (!ctx.firstTSpaces.empty())
+					{
+						ctx.firstTSpaces[v] = firstTSpace;
+					}
+				}
+			});
+		}
+
+		// Degenerate corners copy space of first good corner with same welded vertex, like DegenEpilogue.
+		static void resolveDegenerateTSpaces(Context& ctx, std::vector<nanite::Vertex>& vertices)
+		{
+			jobsystem::parallelFor("TangentDegenerate", EBusyWaitType::All, ctx.triangleCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+			{
+				for (uint32 f = loopStart; f < loopEnd; f++)
+				{
+					if ((ctx.triangles[f].flag & kFlagDegenerate) == 0)
+					{
+						continue;
+					}
+
+					for (uint32 i = 0; i < 3; i++)
+					{
+						const uint32 v = ctx.corners[f * 3 + i];
+						const bool bHasGood = ctx.fanOffsets[v + 1] > ctx.fanOffsets[v];
+						writeTangent(ctx, vertices, f * 3 + i, bHasGood ? ctx.firstTSpaces[v] : TSpace{ });
+					}
+				}
+			});
+		}
+	}
+
+	bool computeTangent(std::vector<nanite::Vertex>& rawVertices, const std::vector<uint32>& rawIndices)
 	{
-		auto* ctx = (MikkTSpaceContext*)pContext->m_pUserData;
-		uint32 id = ctx->rawIndicesPtr->at(iFace * 3 + iVert);
+		tangentspace::Context ctx
+		{
+			.vertices = rawVertices,
+			.indices = rawIndices,
+			.vertexCount = (uint32)rawVertices.size(),
+			.triangleCount = (uint32)(rawIndices.size() / 3),
+		};
+		if (ctx.triangleCount == 0)
+		{
+			return false;
+		}
+
+		ctx.corners.resize(ctx.triangleCount * 3);
+		ctx.triangles.resize(ctx.triangleCount);
 
-		fvTexcOut[0] = ctx->rawVerticesPtr->at(id).uv0.x;
-		fvTexcOut[1] = ctx->rawVerticesPtr->at(id).uv0.y;
-	};
-	ctx.m_pInterface->m_setTSpaceBasic = [](const SMikkTSpaceContext* pContext, const float fvTangent[], const float fSign, const int iFace, const int iVert)
+		uint32 degenerateCount = 0;
+		{
+			std::vector<uint32> welded;
+			tangentspace::weldVertices(ctx, welded);
+			if (!tangentspace::initTriangles(ctx, welded, degenerateCount))
+			{
+				LOG_ERROR("Tangent generate fail, index out of vertex range.");
+				return false;
+			}
+		}
+
+		ctx.lastCorners.assign(ctx.vertexCount, tangentspace::kInvalid);
+		jobsystem::parallelFor("TangentLastCorner", EBusyWaitType::All, ctx.triangleCount * 3, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+		{
+			for (uint32 c = loopStart; c < loopEnd; c++)
+			{
+				tangentspace::atomicMax(ctx.lastCorners[rawIndices[c]], c);
+			}
+		});
+
+		tangentspace::buildFans(ctx);
+		tangentspace::buildNeighbors(ctx);
+		tangentspace::resolveGroupWithAnyOrientation(ctx);
+
+		if (degenerateCount > 0)
+		{
+			ctx.firstTSpaces.resize(ctx.vertexCount);
+		}
+		tangentspace::generateTSpaces(ctx, rawVertices);
+
+		if (degenerateCount > 0)
+		{
+			tangentspace::resolveDegenerateTSpaces(ctx, rawVertices);
+		}
+
+		return true;
+	}
+
+	bool computeTangentReference(std::vector<nanite::Vertex>& rawVertices, const std::vector<uint32>& rawIndices)
 	{
-		auto* ctx = (MikkTSpaceContext*)pContext->m_pUserData;
-		uint32 id = ctx->rawIndicesPtr->at(iFace * 3 + iVert);
+		// MikkTSpace context.
+		struct MikkTSpaceContext
+		{
+			nanite::Vertex* vertices;
+			const uint32* indices;
+			int faceCount;
+		}
+		computeCtx
+		{
+			.vertices = rawVertices.data(),
+			.indices = rawIndices.data(),
+			.faceCount = int(rawIndices.size() / 3),
+		};
+
+		SMikkTSpaceContext ctx{};
+		SMikkTSpaceInterface ctxI{};
+
+		ctx.m_pInterface = &ctxI;
+		ctx.m_pUserData  = &computeCtx;
+
+		ctx.m_pInterface->m_getNumFaces = [](const SMikkTSpaceContext* pContext) -> int { return ((MikkTSpaceContext*)pContext->m_pUserData)->faceCount; };
+		ctx.m_pInterface->m_getNumVerticesOfFace = [](const SMikkTSpaceContext* pContext, const int iFace) -> int { return 3; };
+		ctx.m_pInterface->m_getPosition = [](const SMikkTSpaceContext* pContext, float fvPosOut[], const int iFace, const int iVert) -> void
+		{
+			auto* ctx = (MikkTSpaceContext*)pContext->m_pUserData;
+			const auto& vertex = ctx->vertices[ctx->indices[iFace * 3 + iVert]];
+
+			fvPosOut[0] = vertex.position.x;
+			fvPosOut[1] = vertex.position.y;
+			fvPosOut[2] = vertex.position.z;
+		};
+		ctx.m_pInterface->m_getNormal = [](const SMikkTSpaceContext* pContext, float fvNormOut[], const int iFace, const int iVert) -> void
+		{
+			auto* ctx = (MikkTSpaceContext*)pContext->m_pUserData;
+			const auto& vertex = ctx->vertices[ctx->indices[iFace * 3 + iVert]];
+
+			fvNormOut[0] = vertex.normal.x;
+			fvNormOut[1] = vertex.normal.y;
+			fvNormOut[2] = vertex.normal.z;
+		};
+		ctx.m_pInterface->m_getTexCoord = [](const SMikkTSpaceContext* pContext, float fvTexcOut[], const int iFace, const int iVert) -> void
+		{
+			auto* ctx = (MikkTSpaceContext*)pContext->m_pUserData;
+			const auto& vertex = ctx->vertices[ctx->indices[iFace * 3 + iVert]];
+
+			fvTexcOut[0] = vertex.uv0.x;
+			fvTexcOut[1] = vertex.uv0.y;
+		};
+		ctx.m_pInterface->m_setTSpaceBasic = [](const SMikkTSpaceContext* pContext, const float fvTangent[], const float fSign, const int iFace, const int iVert)
+		{
+			auto* ctx = (MikkTSpaceContext*)pContext->m_pUserData;
+			auto& vertex = ctx->vertices[ctx->indices[iFace * 3 + iVert]];
 
-		ctx->rawVerticesPtr->at(id).tangent.x = fvTangent[0];
-		ctx->rawVerticesPtr->at(id).tangent.y = fvTangent[1];
-		ctx->rawVerticesPtr->at(id).tangent.z = fvTangent[2];
-		ctx->rawVerticesPtr->at(id).tangent.w = fSign;
-	};
+			vertex.tangent = float4(fvTangent[0], fvTangent[1], fvTangent[2], fSign);
+		};
 
-	return genTangSpaceDefault(&ctx);
-}
\ No newline at end of file
+		return genTangSpaceDefault(&ctx);
+	}
+}
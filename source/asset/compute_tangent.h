@@ -4,5 +4,11 @@
 
 namespace chord
 {
-	extern bool computeTangent(std::vector<nanite::Vertex>& rawVerticesPtr, std::vector<uint32>& rawIndicesPtr);
-}
\ No newline at end of file
+	// MikkTSpace tangent of indexed triangle list, write tangent of every referenced vertex.
+	// Work on vertex array directly and run weld, neighbor, group and tangent space evaluate in parallel,
+	// output same as reference genTangSpaceDefault with per corner result resolve to vertex by last corner.
+	extern bool computeTangent(std::vector<nanite::Vertex>& rawVertices, const std::vector<uint32>& rawIndices);
+
+	// Single thread reference genTangSpaceDefault path, keep for validation and benchmark.
+	extern bool computeTangentReference(std::vector<nanite::Vertex>& rawVertices, const std::vector<uint32>& rawIndices);
+}
@@ -0,0 +1,150 @@
+#include <asset/cook_stats.h>
+#include <utils/cvar.h>
+#include <utils/log.h>
+
+namespace chord
+{
+	static uint32 sAssetImportReport = 0;
+	static AutoCVarRef cVarAssetImportReport(
+		"r.asset.import.report",
+		sAssetImportReport,
+		"Write per stage timing and memory report json next to imported asset, chord_cook enable it, editor keep content tree clean."
+	);
+
+	namespace cookstats
+	{
+		static std::mutex sStagesMutex;
+
+		// Key by literal pointer, avoid string build on hot path.
+		static std::unordered_map<const char*, Stage> sStages;
+
+		static void accumulate(Stage& stage, double seconds, uint64 bytes)
+		{
+			stage.seconds += seconds;
+			stage.count ++;
+			stage.bytes += bytes;
+		}
+
+		// Same literal may have different address in different translation unit, merge by name.
+		static std::map<std::string, Stage> mergeByName(const std::unordered_map<const char*, Stage>& stages)
+		{
+			std::map<std::string, Stage> result;
+			for (const auto& [name, stage] : stages)
+			{
+				auto& merged = result[name];
+				merged.seconds += stage.seconds;
+				merged.count += stage.count;
+				merged.bytes += stage.bytes;
+			}
+			return result;
+		}
+	}
+
+	void cookstats::add(const char* stage, double seconds, uint64 bytes)
+	{
+		std::lock_guard lock(sStagesMutex);
+		accumulate(sStages[stage], seconds, bytes);
+	}
+
+	std::map<std::string, cookstats::Stage> cookstats::collect()
+	{
+		std::lock_guard lock(sStagesMutex);
+		return mergeByName(sStages);
+	}
+
+	void cookstats::reset()
+	{
+		std::lock_guard lock(sStagesMutex);
+		sStages.clear();
+	}
+
+	cookstats::Report::Report(Report* parent)
+		: m_parent(parent)
+		, m_begin(std::chrono::high_resolution_clock::now())
+		, m_beginMemory(getProcessMemoryInfo())
+	{
+
+	}
+
+	void cookstats::Report::add(const char* stage, double seconds, uint64 bytes)
+	{
+		{
+			std::lock_guard lock(m_mutex);
+			accumulate(m_stages[stage], seconds, bytes);
+		}
+
+		if (m_parent)
+		{
+			m_parent->add(stage, seconds, bytes);
+		}
+	}
+
+	std::map<std::string, cookstats::Stage> cookstats::Report::collect() const
+	{
+		std::lock_guard lock(m_mutex);
+		return mergeByName(m_stages);
+	}
+
+	nlohmann::json cookstats::Report::toJson() const
+	{
+		const auto endMemory = getProcessMemoryInfo();
+
+		nlohmann::json result;
+		result["seconds"] = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - m_begin).count();
+
+		// Process wide, other imports in parallel also count in.
+		result["memory"] =
+		{
+			{ "beginResidentBytes", m_beginMemory.residentBytes },
+			{ "endResidentBytes",   endMemory.residentBytes     },
+			{ "peakResidentBytes",  endMemory.peakResidentBytes },
+		};
+
+		// Stage time accumulate across threads and nested stages also count in outer one.
+		auto& stages = result["stages"];
+		stages = nlohmann::json::object();
+		for (const auto& [name, stage] : collect())
+		{
+			stages[name] =
+			{
+				{ "count",   stage.count   },
+				{ "seconds", stage.seconds },
+				{ "bytes",   stage.bytes   },
+			};
+		}
+
+		return result;
+	}
+
+	bool cookstats::importWithReport(
+		const char* assetType,
+		const std::filesystem::path& srcPath,
+		const std::filesystem::path& storePath,
+		Report* parent,
+		const std::function<bool(Report*)>& importFunc)
+	{
+		Report report(parent);
+		const bool bResult = importFunc(&report);
+
+		if (sAssetImportReport == 0)
+		{
+			return bResult;
+		}
+
+		nlohmann::json json = report.toJson();
+		json["type"] = assetType;
+		json["source"] = utf8::utf16to8(srcPath.u16string());
+		json["succeed"] = bResult;
+
+		const std::filesystem::path reportPath = storePath.u16string() + u".import.json";
+		std::ofstream os(reportPath, std::ios::trunc);
+		if (!os.is_open())
+		{
+			LOG_WARN("Fail to write import report {}.", utf8::utf16to8(reportPath.u16string()));
+			return bResult;
+		}
+		os << json.dump(4);
+
+		return bResult;
+	}
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <utils/utils.h>
+
+namespace chord
+{
+	// Accumulate wall time of named import stages across all cook threads.
+	// Editor import ignore it, offline cooker report it after cook finish.
+	namespace cookstats
+	{
+		struct Stage
+		{
+			double seconds = 0.0;
+			uint64 count = 0;
+
+			// Bytes processed by stage, zero if stage not report it.
+			uint64 bytes = 0;
+		};
+
+		// Thread safe, stage name must be string literal.
+		extern void add(const char* stage, double seconds, uint64 bytes = 0);
+
+		// Snapshot of all stages, order by stage name.
+		extern std::map<std::string, Stage> collect();
+
+		extern void reset();
+
+		// Stages of one asset import, also accumulate into parent report so nested texture import show in gltf report.
+		class Report : NonCopyable
+		{
+		public:
+			explicit Report(Report* parent);
+
+			void add(const char* stage, double seconds, uint64 bytes);
+
+			std::map<std::string, Stage> collect() const;
+
+			// Stage table, wall time and process memory as json.
+			nlohmann::json toJson() const;
+
+		private:
+			Report* m_parent;
+			std::chrono::high_resolution_clock::time_point m_begin;
+			ProcessMemoryInfo m_beginMemory;
+
+			mutable std::mutex m_mutex;
+			std::unordered_map<const char*, Stage> m_stages;
+		};
+
+		// Run import with its own report, save json next to store path when r.asset.import.report enable (chord_cook only by default).
+		// Parent is report of outer import, nullptr if none. Import func must pass report to its stages and jobs explicitly.
+		extern bool importWithReport(
+			const char* assetType,
+			const std::filesystem::path& srcPath,
+			const std::filesystem::path& storePath,
+			Report* parent,
+			const std::function<bool(Report*)>& importFunc);
+
+		// Record into global stages and also into report when it is not nullptr.
+		class ScopedStage : NonCopyable
+		{
+		public:
+			explicit ScopedStage(const char* stage, Report* report = nullptr)
+				: m_stage(stage)
+				, m_report(report)
+				, m_begin(std::chrono::high_resolution_clock::now())
+			{
+
+			}
+
+			~ScopedStage()
+			{
+				const double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - m_begin).count();
+
+				add(m_stage, seconds, m_bytes);
+				if (m_report)
+				{
+					m_report->add(m_stage, seconds, m_bytes);
+				}
+			}
+
+			void setBytes(uint64 bytes)
+			{
+				m_bytes = bytes;
+			}
+
+		private:
+			const char* m_stage;
+			Report* m_report;
+			uint64 m_bytes = 0;
+			std::chrono::high_resolution_clock::time_point m_begin;
+		};
+	}
+}
@@ -0,0 +1,286 @@
+#include <asset/derived_data_cache.h>
+#include <utils/cityhash.h>
+#include <utils/cvar.h>
+#include <asset/cook_stats.h>
+#include <project.h>
+
+namespace chord
+{
+	static uint32 sDDCEnable = 1;
+	static AutoCVarRef cVarDDCEnable(
+		"r.ddc",
+		sDDCEnable,
+		"Enable derived data cache for asset import or not."
+	);
+
+	static uint32 sDDCMaxSize = 8192;
+	static AutoCVarRef cVarDDCMaxSize(
+		"r.ddc.maxsize",
+		sDDCMaxSize,
+		"Local derived data cache size budget in MB, least recently used entry evict when over budget."
+	);
+
+	static u16str sDDCSharedPath = u16str("");
+	static AutoCVarRef<u16str> cVarDDCSharedPath(
+		"r.ddc.shared.path",
+		sDDCSharedPath,
+		"Shared derived data cache folder, empty meaning disable."
+	);
+
+	namespace ddc
+	{
+		// Trim to this ratio of budget, avoid trim again on next put.
+		constexpr double kTrimRatio = 0.9;
+
+		static std::mutex sLocalSizeMutex;
+
+		// Local cache size, ~0 meaning not scan yet.
+		static uint64 sLocalSize = ~0ULL;
+
+		static std::filesystem::path getLocalFolder()
+		{
+			return std::filesystem::path(Project::get().getPath().cachePath.u16()) / "DDC";
+		}
+
+		// Two level folder avoid too many files in one folder.
+		static std::filesystem::path getEntryPath(const std::filesystem::path& folder, const Key& key)
+		{
+			const std::string name = key.toString();
+			return folder / name.substr(0, 2) / (name + ".ddc");
+		}
+
+		static uint64 getBudget()
+		{
+			return uint64(sDDCMaxSize) * 1024 * 1024;
+		}
+
+		// Copy to temp file then rename, reader never see half write entry.
+		static bool copyEntry(const std::filesystem::path& src, const std::filesystem::path& dest)
+		{
+			std::error_code ec;
+			std::filesystem::create_directories(dest.parent_path(), ec);
+
+			const auto tempPath = std::filesystem::path(dest).concat(std::format(".{}.tmp", std::hash<std::thread::id>{ }(std::this_thread::get_id())));
+			if (!std::filesystem::copy_file(src, tempPath, std::filesystem::copy_options::overwrite_existing, ec))
+			{
+				return false;
+			}
+
+			std::filesystem::rename(tempPath, dest, ec);
+			if (ec)
+			{
+				std::filesystem::remove(tempPath, ec);
+				return false;
+			}
+			return true;
+		}
+
+		static uint64 scanLocalSize()
+		{
+			uint64 size = 0;
+
+			std::error_code ec;
+			for (const auto& entry : std::filesystem::recursive_directory_iterator(getLocalFolder(), ec))
+			{
+				if (entry.is_regular_file(ec))
+				{
+					size += entry.file_size(ec);
+				}
+			}
+			return size;
+		}
+
+		static void addLocalSize(uint64 size)
+		{
+			bool bNeedTrim = false;
+			{
+				std::lock_guard lock(sLocalSizeMutex);
+				if (sLocalSize == ~0ULL)
+				{
+					sLocalSize = scanLocalSize();
+				}
+				else
+				{
+					sLocalSize += size;
+				}
+
+				bNeedTrim = sLocalSize > getBudget();
+			}
+
+			if (bNeedTrim)
+			{
+				trim();
+			}
+		}
+	}
+
+	std::string ddc::Key::toString() const
+	{
+		return std::format("{:016x}{:016x}", hash0, hash1);
+	}
+
+	ddc::KeyBuilder::KeyBuilder(const std::string& cookerName, uint32 cookerVersion)
+	{
+		update(cookerName);
+		update(cookerVersion);
+
+		// Container layout change also invalidate all entries.
+		update(assetbinary::kVersion);
+	}
+
+	ddc::KeyBuilder& ddc::KeyBuilder::update(const void* data, size_t size)
+	{
+		const auto hash = cityhash::cityhash128WithSeed((const char*)data, size, { m_key.hash0, m_key.hash1 });
+
+		m_key.hash0 = cityhash::uint128Low64(hash);
+		m_key.hash1 = cityhash::uint128High64(hash);
+		return *this;
+	}
+
+	bool ddc::KeyBuilder::updateFile(const std::filesystem::path& path)
+	{
+		MappedFile file;
+		if (!file.open(path))
+		{
+			return false;
+		}
+
+		update(file.data(), (size_t)file.size());
+		return true;
+	}
+
+	bool ddc::isEnable()
+	{
+		return sDDCEnable && Project::get().isSetup();
+	}
+
+	bool ddc::get(const Key& key, uint64 schemaHash, AssetBinaryReader& reader, cookstats::Report* report)
+	{
+		if (!isEnable())
+		{
+			return false;
+		}
+
+		cookstats::ScopedStage stage("ddc.get", report);
+
+		std::error_code ec;
+		const auto localPath = getEntryPath(getLocalFolder(), key);
+		if (!std::filesystem::exists(localPath, ec))
+		{
+			// Fetch from shared cache.
+			const std::filesystem::path sharedFolder = sDDCSharedPath.u16();
+			if (sharedFolder.empty() || !copyEntry(getEntryPath(sharedFolder, key), localPath))
+			{
+				return false;
+			}
+			addLocalSize(std::filesystem::file_size(localPath, ec));
+		}
+
+		if (!reader.open(localPath, schemaHash))
+		{
+			return false;
+		}
+
+		// Touch entry, trim evict by last write time.
+		std::filesystem::last_write_time(localPath, std::filesystem::file_time_type::clock::now(), ec);
+		return true;
+	}
+
+	bool ddc::put(const Key& key, uint64 schemaHash, const AssetBinaryWriter& writer, ECompressionMode compression, cookstats::Report* report)
+	{
+		if (!isEnable())
+		{
+			return false;
+		}
+
+		cookstats::ScopedStage stage("ddc.put", report);
+
+		std::error_code ec;
+		const auto localPath = getEntryPath(getLocalFolder(), key);
+		std::filesystem::create_directories(localPath.parent_path(), ec);
+
+		const auto tempPath = std::filesystem::path(localPath).concat(std::format(".{}.tmp", std::hash<std::thread::id>{ }(std::this_thread::get_id())));
+		if (!writer.write(tempPath, schemaHash, compression, nullptr))
+		{
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+
+		// Rename may fail when other thread put same key and entry is mapping, both entry are same so just skip.
+		std::filesystem::rename(tempPath, localPath, ec);
+		if (ec)
+		{
+			std::filesystem::remove(tempPath, ec);
+			return std::filesystem::exists(localPath, ec);
+		}
+
+		const std::filesystem::path sharedFolder = sDDCSharedPath.u16();
+		if (!sharedFolder.empty())
+		{
+			const auto sharedPath = getEntryPath(sharedFolder, key);
+			if (!std::filesystem::exists(sharedPath, ec) && !copyEntry(localPath, sharedPath))
+			{
+				LOG_WARN("Fail to push derived data {} to shared cache.", key.toString());
+			}
+		}
+
+		addLocalSize(std::filesystem::file_size(localPath, ec));
+		return true;
+	}
+
+	void ddc::trim()
+	{
+		if (!Project::get().isSetup())
+		{
+			return;
+		}
+
+		std::lock_guard lock(sLocalSizeMutex);
+
+		struct Entry
+		{
+			std::filesystem::path path;
+			uint64 size;
+			std::filesystem::file_time_type lastWriteTime;
+		};
+		std::vector<Entry> entries;
+
+		uint64 totalSize = 0;
+		std::error_code ec;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(getLocalFolder(), ec))
+		{
+			// Skip in-flight temp file.
+			if (entry.is_regular_file(ec) && entry.path().extension() == ".ddc")
+			{
+				entries.push_back({ entry.path(), entry.file_size(ec), entry.last_write_time(ec) });
+				totalSize += entries.back().size;
+			}
+		}
+
+		// Least recently used first.
+		std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastWriteTime < b.lastWriteTime; });
+
+		const uint64 targetSize = uint64(double(getBudget()) * kTrimRatio);
+		uint32 evictCount = 0;
+		for (const auto& entry : entries)
+		{
+			if (totalSize <= targetSize)
+			{
+				break;
+			}
+
+			// Entry may still mapping by reader, skip it.
+			if (std::filesystem::remove(entry.path, ec))
+			{
+				totalSize -= entry.size;
+				evictCount ++;
+			}
+		}
+
+		sLocalSize = totalSize;
+		if (evictCount > 0)
+		{
+			LOG_TRACE("Derived data cache evict {} entries, current size {} MB.", evictCount, totalSize / (1024 * 1024));
+		}
+	}
+}
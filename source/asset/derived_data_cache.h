@@ -0,0 +1,66 @@
+#pragma once
+
+#include <asset/asset_binary.h>
+
+namespace chord
+{
+	// Content addressed derived data cache for import cook result, store in Cache/DDC.
+	// Key build from source bytes, import config and cooker version, entry is an asset binary container.
+	// Local cache is size bounded by r.ddc.maxsize and evict least recently used entry first.
+	// Optional shared cache folder r.ddc.shared.path let machines reuse cook result of each other.
+	namespace ddc
+	{
+		struct Key
+		{
+			uint64 hash0 = 0;
+			uint64 hash1 = 0;
+
+			std::string toString() const;
+		};
+
+		class KeyBuilder
+		{
+		public:
+			// Cooker name and version is part of key, bump version when cook output change.
+			explicit KeyBuilder(const std::string& cookerName, uint32 cookerVersion);
+
+			KeyBuilder& update(const void* data, size_t size);
+
+			KeyBuilder& update(const std::string& value)
+			{
+				return update(value.data(), value.size());
+			}
+
+			template<typename T>
+			KeyBuilder& update(const T& value)
+			{
+				static_assert(std::is_trivially_copyable_v<T>, "Only hash POD value, use update(data, size) for other.");
+				return update(&value, sizeof(T));
+			}
+
+			// Hash whole file content, return false if file read fail.
+			bool updateFile(const std::filesystem::path& path);
+
+			Key finalize() const
+			{
+				return m_key;
+			}
+
+		private:
+			Key m_key;
+		};
+
+		// Derived data cache enable and project is setup.
+		extern bool isEnable();
+
+		// Open cache entry, fetch from shared cache when local miss. Hit entry mark as recently used.
+		extern bool get(const Key& key, uint64 schemaHash, AssetBinaryReader& reader, cookstats::Report* report = nullptr);
+
+		// Store entry in local and shared cache, evict local cache when over budget.
+		// NOTE: Entry never use dictionary, it must decodable in other machine.
+		extern bool put(const Key& key, uint64 schemaHash, const AssetBinaryWriter& writer, ECompressionMode compression, cookstats::Report* report = nullptr);
+
+		// Evict least recently used local entries until cache fit in budget.
+		extern void trim();
+	}
+}
@@ -1,5 +1,6 @@
 #include <asset/gltf/asset_gltf.h>
 #include <asset/gltf/asset_gltf_helper.h>
+#include <asset/gltf/gltf_compact.h>
 #include <asset/serialize.h>
 #include <renderer/gpu_scene.h>
 #include <shader/base.h>
@@ -9,6 +10,249 @@ namespace chord
 	const AssetTypeMeta GLTFAsset::kAssetTypeMeta = GLTFAsset::createTypeMeta();
 	const AssetTypeMeta GLTFMaterialAsset::kAssetTypeMeta = GLTFMaterialAsset::createTypeMeta();
 
+	uint64 GLTFBinary::getSchemaHash()
+	{
+		static const uint64 kSchemaHash = []()
+		{
+			std::vector<assetbinary::SchemaField> fields;
+
+			PrimitiveDatas layout { };
+			layout.forEachSection([&](const char* name, const auto& array, EAssetBinaryFilter)
+			{
+				using ElementType = typename std::decay_t<decltype(array)>::value_type;
+				fields.push_back({ .name = name, .stride = (uint32)sizeof(ElementType) });
+			});
+
+			return assetbinary::buildSchemaHash(fields);
+		}();
+
+		return kSchemaHash;
+	}
+
+	uint64 GLTFBinary::getCompactSchemaHash()
+	{
+		static const uint64 kSchemaHash = []()
+		{
+			std::vector<assetbinary::SchemaField> fields;
+			auto addField = [&](const char* name, const auto& array, EAssetBinaryFilter)
+			{
+				using ElementType = typename std::decay_t<decltype(array)>::value_type;
+				fields.push_back({ .name = name, .stride = (uint32)sizeof(ElementType) });
+			};
+
+			PrimitiveDatas layout { };
+			layout.forEachSection(addField);
+
+			gltfcompact::PrimitiveDatas compactLayout { };
+			compactLayout.forEachSection(addField);
+
+			return assetbinary::buildSchemaHash(fields);
+		}();
+
+		return kSchemaHash;
+	}
+
+	bool GLTFBinary::save(const std::filesystem::path& savePath, cookstats::Report* report)
+	{
+		AssetBinaryWriter writer;
+		writer.setDictionaryType("gltf");
+		writer.setReport(report);
+		primitiveData.forEachSection([&](const char*, const auto& array, EAssetBinaryFilter filter)
+		{
+			writer.addSection(array, filter);
+		});
+
+		return writer.write(savePath, getSchemaHash(), assetbinary::getConfigCompressionMode());
+	}
+
+	bool GLTFBinary::saveCompact(const std::filesystem::path& savePath, const std::vector<GLTFMesh>& meshes, cookstats::Report* report)
+	{
+		gltfcompact::PrimitiveDatas compact;
+		gltfcompact::encode(meshes, primitiveData, compact);
+
+		// Sections decode from compact datas when load.
+		auto isCompacted = [&](const void* array)
+		{
+			return
+				array == &primitiveData.positions  ||
+				array == &primitiveData.normals    ||
+				array == &primitiveData.texcoords0 ||
+				array == &primitiveData.tangents   ||
+				array == &primitiveData.meshletDatas;
+		};
+
+		AssetBinaryWriter writer;
+		writer.setDictionaryType("gltf");
+		writer.setReport(report);
+		primitiveData.forEachSection([&](const char*, const auto& array, EAssetBinaryFilter filter)
+		{
+			using ElementType = typename std::decay_t<decltype(array)>::value_type;
+			if (isCompacted(&array))
+			{
+				writer.addSection(nullptr, 0, (uint32)sizeof(ElementType));
+			}
+			else
+			{
+				writer.addSection(array, filter);
+			}
+		});
+		compact.forEachSection([&](const char*, const auto& array, EAssetBinaryFilter filter)
+		{
+			writer.addSection(array, filter);
+		});
+
+		return writer.write(savePath, getCompactSchemaHash(), assetbinary::getConfigCompressionMode());
+	}
+
+	bool GLTFBinary::saveMemory(std::string& out, const std::filesystem::path& debugPath)
+	{
+		AssetBinaryWriter writer;
+		primitiveData.forEachSection([&](const char*, const auto& array, EAssetBinaryFilter)
+		{
+			writer.addSection(array);
+		});
+
+		return writer.writeMemory(out, debugPath, getSchemaHash());
+	}
+
+	bool GLTFBinary::upgradeLegacy(const std::filesystem::path& path)
+	{
+		std::error_code ec;
+		if (!std::filesystem::is_regular_file(path, ec) || assetbinary::isAssetBinaryFile(path))
+		{
+			return true;
+		}
+
+		GLTFBinary legacyBin { };
+		if (!loadAsset(legacyBin, path) || !legacyBin.save(path))
+		{
+			LOG_ERROR("Fail to convert legacy gltf binary {}.", utf8::utf16to8(path.u16string()));
+			return false;
+		}
+		return true;
+	}
+
+	bool GLTFBinaryView::load(const std::filesystem::path& path, const std::vector<GLTFMesh>& meshes)
+	{
+		const uint64 schemaHashes[] = { GLTFBinary::getSchemaHash(), GLTFBinary::getCompactSchemaHash() };
+		if (m_reader.open(path, schemaHashes))
+		{
+			if (m_reader.getSchemaHash() == GLTFBinary::getCompactSchemaHash())
+			{
+				// Runtime consume fp32 layout, decode whole bin into memory once.
+				GLTFBinary decodedBin { };
+				std::string container;
+				if (!decodeCompact(meshes, decodedBin) || !decodedBin.saveMemory(container, path) || !m_reader.openMemory(std::move(container), path, GLTFBinary::getSchemaHash()))
+				{
+					LOG_ERROR("Fail to decode compact gltf binary {}.", utf8::utf16to8(path.u16string()));
+					return false;
+				}
+			}
+		}
+		else
+		{
+			if (assetbinary::isAssetBinaryFile(path))
+			{
+				LOG_ERROR("GLTF binary {} is stale, please re-import the asset.", utf8::utf16to8(path.u16string()));
+				return false;
+			}
+
+			// Legacy lz4 compressed cereal bin, decode into memory. Other reader may map the file, so rewrite only on save or cook.
+			GLTFBinary legacyBin { };
+			std::string container;
+			if (!loadAsset(legacyBin, path) || !legacyBin.saveMemory(container, path) || !m_reader.openMemory(std::move(container), path, GLTFBinary::getSchemaHash()))
+			{
+				LOG_ERROR("Fail to load legacy gltf binary {}.", utf8::utf16to8(path.u16string()));
+				return false;
+			}
+		}
+
+		uint32 sectionIndex = 0;
+		primitiveData.forEachSection([&](const char*, auto& array, EAssetBinaryFilter)
+		{
+			array.reader = &m_reader;
+			array.index  = sectionIndex;
+
+			check(array.stride() == m_reader.getSectionStride(sectionIndex));
+			sectionIndex ++;
+		});
+
+		// Schema hash already cover section count.
+		check(sectionIndex == m_reader.getSectionCount());
+		return true;
+	}
+
+	bool GLTFBinaryView::decodeCompact(const std::vector<GLTFMesh>& meshes, GLTFBinary& out) const
+	{
+		bool bResult = true;
+
+		uint32 sectionIndex = 0;
+		auto copySection = [&](const char*, auto& array, EAssetBinaryFilter)
+		{
+			bResult &= m_reader.copySection(sectionIndex, array);
+			sectionIndex ++;
+		};
+
+		gltfcompact::PrimitiveDatas compact;
+		out.primitiveData.forEachSection(copySection);
+		compact.forEachSection(copySection);
+
+		// Schema hash already cover section count.
+		check(sectionIndex == m_reader.getSectionCount());
+		return bResult && gltfcompact::decode(meshes, out.primitiveData.meshlets, compact, out.primitiveData);
+	}
+
+	bool GLTFBinaryView::readPrimitive(const GLTFPrimitive& primitive, GLTFBinary::PrimitiveDatas& out) const
+	{
+		const auto& in = primitiveData;
+
+		bool bResult = true;
+		bResult &= in.positions.read(primitive.vertexOffset, primitive.vertexCount, out.positions);
+		bResult &= in.normals.read(primitive.vertexOffset, primitive.vertexCount, out.normals);
+		bResult &= in.texcoords0.read(primitive.vertexOffset, primitive.vertexCount, out.texcoords0);
+		bResult &= in.tangents.read(primitive.vertexOffset, primitive.vertexCount, out.tangents);
+
+		if (primitive.bTextureCoord1Exist)
+		{
+			bResult &= in.texcoords1.read(primitive.textureCoord1Offset, primitive.vertexCount, out.texcoords1);
+		}
+		if (primitive.bColor0Exist)
+		{
+			bResult &= in.colors0.read(primitive.colors0Offset, primitive.vertexCount, out.colors0);
+		}
+		if (primitive.bSmoothNormalExist)
+		{
+			bResult &= in.smoothNormals.read(primitive.smoothNormalOffset, primitive.vertexCount, out.smoothNormals);
+		}
+
+		bResult &= in.lod0Indices.read(primitive.lod0IndicesOffset, primitive.lod0IndicesCount, out.lod0Indices);
+		bResult &= in.bvhNodes.read(primitive.bvhNodeOffset, primitive.bvhNodeCount, out.bvhNodes);
+		bResult &= in.meshletGroups.read(primitive.meshletGroupOffset, primitive.meshletGroupCount, out.meshletGroups);
+
+		// Cluster pages rebase to read ranges, so out page offsets index into out page groups and dependencies.
+		if (bResult && primitive.clusterPageCount > 0)
+		{
+			bResult &= in.clusterPages.read(primitive.clusterPageOffset, primitive.clusterPageCount, out.clusterPages);
+			if (bResult)
+			{
+				const uint32 groupBegin = out.clusterPages.front().groupOffset;
+				const uint32 groupEnd = out.clusterPages.back().groupOffset + out.clusterPages.back().groupCount;
+				const uint32 dependencyBegin = out.clusterPages.front().dependencyOffset;
+				const uint32 dependencyEnd = out.clusterPages.back().dependencyOffset + out.clusterPages.back().dependencyCount;
+
+				bResult &= in.clusterPageGroups.read(groupBegin, groupEnd - groupBegin, out.clusterPageGroups);
+				bResult &= in.clusterPageDependencies.read(dependencyBegin, dependencyEnd - dependencyBegin, out.clusterPageDependencies);
+				for (auto& page : out.clusterPages)
+				{
+					page.groupOffset -= groupBegin;
+					page.dependencyOffset -= dependencyBegin;
+				}
+			}
+		}
+
+		return bResult;
+	}
+
 	GLTFAsset::GLTFAsset(const AssetSaveInfo& saveInfo)
 		: IAsset(saveInfo)
 	{
@@ -43,8 +287,8 @@ namespace chord
 		getContext().getAsyncUploader().addTask(m_gltfBinSize,
 			[newGPUPrimitives, assetPtr, totalUsedSize](uint32 offset, uint32 queueFamily, void* mapped, VkCommandBuffer cmd, VkBuffer buffer)
 			{
-				GLTFBinary gltfBin{};
-				if (!std::filesystem::exists(assetPtr->getBinPath()))
+				GLTFBinaryView gltfBin{};
+				if (!assetpack::exists(assetPtr->getBinPath()))
 				{
 					checkEntry();
 				}
@@ -52,11 +296,11 @@ namespace chord
 				{
 					LOG_TRACE("Found bin for asset {} cache in disk so just load.",
 						utf8::utf16to8(assetPtr->getSaveInfo().relativeAssetStorePath().u16string()));
-					loadAsset(gltfBin, assetPtr->getBinPath());
+					check(gltfBin.load(assetPtr->getBinPath(), assetPtr->getMeshes()));
 				}
 
 				size_t sizeAccumulate = 0;
-				auto copyBuffer = [&](const ComponentBuffer& comp, const void* data)
+				auto copyBuffer = [&](const ComponentBuffer& comp, const auto& section)
 				{
 					VkBufferCopy regionCopy{ };
 
@@ -64,7 +308,7 @@ namespace chord
 					regionCopy.srcOffset = offset + sizeAccumulate;
 					regionCopy.dstOffset = 0;
 
-					memcpy((void*)((char*)mapped + sizeAccumulate), data, regionCopy.size);
+					check(section.read((char*)mapped + sizeAccumulate));
 					vkCmdCopyBuffer(cmd, buffer, *comp.buffer, 1, &regionCopy);
 
 					sizeAccumulate += regionCopy.size;
@@ -87,17 +331,17 @@ namespace chord
 						getRuntimeUniqueGPUAssetName(assetPtr->getName().u8() + "_meshlet"),
 						bufferFlagBasic,
 						bufferFlagVMA,
-						(uint32)sizeof(gltfBin.primitiveData.meshlets[0]),
+						gltfBin.primitiveData.meshlets.stride(),
 						(uint32)gltfBin.primitiveData.meshlets.size());
-					copyBuffer(*newGPUPrimitives->meshlet, gltfBin.primitiveData.meshlets.data());
+					copyBuffer(*newGPUPrimitives->meshlet, gltfBin.primitiveData.meshlets);
 
 					newGPUPrimitives->meshletData = std::make_unique<ComponentBuffer>(
 						getRuntimeUniqueGPUAssetName(assetPtr->getName().u8() + "_meshletData"),
 						bufferFlagBasic,
 						bufferFlagVMA,
-						(uint32)sizeof(gltfBin.primitiveData.meshletDatas[0]),
+						gltfBin.primitiveData.meshletDatas.stride(),
 						(uint32)gltfBin.primitiveData.meshletDatas.size());
-					copyBuffer(*newGPUPrimitives->meshletData, gltfBin.primitiveData.meshletDatas.data());
+					copyBuffer(*newGPUPrimitives->meshletData, gltfBin.primitiveData.meshletDatas);
 
 					check(!gltfBin.primitiveData.bvhNodes.empty());
 					{
@@ -105,66 +349,66 @@ namespace chord
 							getRuntimeUniqueGPUAssetName(assetPtr->getName().u8() + "_bvhNodes"),
 							bufferFlagBasic,
 							bufferFlagVMA,
-							(uint32)sizeof(gltfBin.primitiveData.bvhNodes[0]),
+							gltfBin.primitiveData.bvhNodes.stride(),
 							(uint32)gltfBin.primitiveData.bvhNodes.size());
-						copyBuffer(*newGPUPrimitives->bvhNodeData, gltfBin.primitiveData.bvhNodes.data());
+						copyBuffer(*newGPUPrimitives->bvhNodeData, gltfBin.primitiveData.bvhNodes);
 					}
 
 					newGPUPrimitives->meshletGroup = std::make_unique<ComponentBuffer>(
 						getRuntimeUniqueGPUAssetName(assetPtr->getName().u8() + "_meshletGroup"),
 						bufferFlagBasic,
 						bufferFlagVMA,
-						(uint32)sizeof(gltfBin.primitiveData.meshletGroups[0]),
+						gltfBin.primitiveData.meshletGroups.stride(),
 						(uint32)gltfBin.primitiveData.meshletGroups.size());
-					copyBuffer(*newGPUPrimitives->meshletGroup, gltfBin.primitiveData.meshletGroups.data());
+					copyBuffer(*newGPUPrimitives->meshletGroup, gltfBin.primitiveData.meshletGroups);
 
 					newGPUPrimitives->meshletGroupIndices = std::make_unique<ComponentBuffer>(
 						getRuntimeUniqueGPUAssetName(assetPtr->getName().u8() + "_meshletGroupIndices"),
 						bufferFlagBasic,
 						bufferFlagVMA,
-						(uint32)sizeof(gltfBin.primitiveData.meshletGroupIndices[0]),
+						gltfBin.primitiveData.meshletGroupIndices.stride(),
 						(uint32)gltfBin.primitiveData.meshletGroupIndices.size());
-					copyBuffer(*newGPUPrimitives->meshletGroupIndices, gltfBin.primitiveData.meshletGroupIndices.data());
+					copyBuffer(*newGPUPrimitives->meshletGroupIndices, gltfBin.primitiveData.meshletGroupIndices);
 
 					newGPUPrimitives->lod0Indices = std::make_unique<ComponentBuffer>(
 						getRuntimeUniqueGPUAssetName(assetPtr->getName().u8() + "_lod0Indices"),
 						bufferFlagBasic,
 						bufferFlagVMA,
-						(uint32)sizeof(gltfBin.primitiveData.lod0Indices[0]),
+						gltfBin.primitiveData.lod0Indices.stride(),
 						(uint32)gltfBin.primitiveData.lod0Indices.size());
-					copyBuffer(*newGPUPrimitives->lod0Indices, gltfBin.primitiveData.lod0Indices.data());
+					copyBuffer(*newGPUPrimitives->lod0Indices, gltfBin.primitiveData.lod0Indices);
 
 					newGPUPrimitives->positions = std::make_unique<ComponentBuffer>(
 						getRuntimeUniqueGPUAssetName(assetPtr->getName().u8() + "_positions"),
 						bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 						bufferFlagVMA,
-						(uint32)sizeof(gltfBin.primitiveData.positions[0]),
+						gltfBin.primitiveData.positions.stride(),
 						(uint32)gltfBin.primitiveData.positions.size());
-					copyBuffer(*newGPUPrimitives->positions, gltfBin.primitiveData.positions.data());
+					copyBuffer(*newGPUPrimitives->positions, gltfBin.primitiveData.positions);
 
 					newGPUPrimitives->normals = std::make_unique<ComponentBuffer>(
 						getRuntimeUniqueGPUAssetName(assetPtr->getName().u8() + "_normals"),
 						bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 						bufferFlagVMA,
-						(uint32)sizeof(gltfBin.primitiveData.normals[0]),
+						gltfBin.primitiveData.normals.stride(),
 						(uint32)gltfBin.primitiveData.normals.size());
-					copyBuffer(*newGPUPrimitives->normals, gltfBin.primitiveData.normals.data());
+					copyBuffer(*newGPUPrimitives->normals, gltfBin.primitiveData.normals);
 
 					newGPUPrimitives->uv0s = std::make_unique<ComponentBuffer>(
 						getRuntimeUniqueGPUAssetName(assetPtr->getName().u8() + "_uv0s"),
 						bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 						bufferFlagVMA,
-						(uint32)sizeof(gltfBin.primitiveData.texcoords0[0]),
+						gltfBin.primitiveData.texcoords0.stride(),
 						(uint32)gltfBin.primitiveData.texcoords0.size());
-					copyBuffer(*newGPUPrimitives->uv0s, gltfBin.primitiveData.texcoords0.data());
+					copyBuffer(*newGPUPrimitives->uv0s, gltfBin.primitiveData.texcoords0);
 
 					newGPUPrimitives->tangents = std::make_unique<ComponentBuffer>(
 						getRuntimeUniqueGPUAssetName(assetPtr->getName().u8() + "_tangents"),
 						bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 						bufferFlagVMA,
-						(uint32)sizeof(gltfBin.primitiveData.tangents[0]),
+						gltfBin.primitiveData.tangents.stride(),
 						(uint32)gltfBin.primitiveData.tangents.size());
-					copyBuffer(*newGPUPrimitives->tangents, gltfBin.primitiveData.tangents.data());
+					copyBuffer(*newGPUPrimitives->tangents, gltfBin.primitiveData.tangents);
 
 					if (!gltfBin.primitiveData.smoothNormals.empty())
 					{
@@ -172,10 +416,10 @@ namespace chord
 							getRuntimeUniqueGPUAssetName(assetPtr->getName().u8() + "_smoothNormals"),
 							bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 							bufferFlagVMA,
-							(uint32)sizeof(gltfBin.primitiveData.smoothNormals[0]),
+							gltfBin.primitiveData.smoothNormals.stride(),
 							(uint32)gltfBin.primitiveData.smoothNormals.size());
 
-						copyBuffer(*newGPUPrimitives->smoothNormals, gltfBin.primitiveData.smoothNormals.data());
+						copyBuffer(*newGPUPrimitives->smoothNormals, gltfBin.primitiveData.smoothNormals);
 					}
 
 					if (!gltfBin.primitiveData.colors0.empty())
@@ -184,10 +428,10 @@ namespace chord
 							getRuntimeUniqueGPUAssetName(assetPtr->getName().u8() + "_colors0"),
 							bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 							bufferFlagVMA,
-							(uint32)sizeof(gltfBin.primitiveData.colors0[0]),
+							gltfBin.primitiveData.colors0.stride(),
 							(uint32)gltfBin.primitiveData.colors0.size());
 
-						copyBuffer(*newGPUPrimitives->colors, gltfBin.primitiveData.colors0.data());
+						copyBuffer(*newGPUPrimitives->colors, gltfBin.primitiveData.colors0);
 					}
 
 					if (!gltfBin.primitiveData.texcoords1.empty())
@@ -196,10 +440,10 @@ namespace chord
 							getRuntimeUniqueGPUAssetName(assetPtr->getName().u8() + "_texcoords1"),
 							bufferFlagBasic | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
 							bufferFlagVMA,
-							(uint32)sizeof(gltfBin.primitiveData.texcoords1[0]),
+							gltfBin.primitiveData.texcoords1.stride(),
 							(uint32)gltfBin.primitiveData.texcoords1.size());
 
-						copyBuffer(*newGPUPrimitives->uv1s, gltfBin.primitiveData.texcoords1.data());
+						copyBuffer(*newGPUPrimitives->uv1s, gltfBin.primitiveData.texcoords1);
 					}
 				}
 
@@ -228,10 +472,21 @@ namespace chord
 
 	bool GLTFAsset::onSave()
 	{
+		if (!GLTFBinary::upgradeLegacy(getBinPath()))
+		{
+			return false;
+		}
+
 		std::shared_ptr<IAsset> asset = ptr<GLTFAsset>();
 		return saveAsset(asset, ECompressionMode::Lz4, m_saveInfo.path(), false);
 	}
 
+	bool GLTFAsset::onSaveSnapshot(AsyncSaveSnapshot& out)
+	{
+		out.onWrite = [binPath = getBinPath()]() { return GLTFBinary::upgradeLegacy(binPath); };
+		return IAsset::onSaveSnapshot(out);
+	}
+
 	void GLTFAsset::onUnload()
 	{
 
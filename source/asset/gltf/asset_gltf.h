@@ -1,5 +1,6 @@
 #pragma once
 #include <asset/asset.h>
+#include <asset/asset_binary.h>
 #include <asset/gltf/asset_gltf_helper.h>
 
 #include <shader/gltf.h>
@@ -191,6 +192,33 @@ namespace chord
 	};
 	CHORD_CHECK_SIZE_GPU_SAFE(GLTFMeshlet);
 
+	// Streaming page of primitive cluster hierarchy, whole meshlet groups of one lod.
+	struct GLTFClusterPage
+	{
+		// Range in page groups, value is meshlet group index local to primitive.
+		uint32 groupOffset;
+		uint32 groupCount;
+
+		// Range in page dependencies, value is parent page index local to primitive.
+		// Parent page hold coarser clusters which must be resident before this page.
+		uint32 dependencyOffset;
+		uint32 dependencyCount;
+
+		// Bounding sphere of page meshlets in primitive local space.
+		math::vec3 boundsCenter;
+		float boundsRadius;
+
+		// Max error of parent clusters, page required when it project larger than threshold.
+		float parentError;
+
+		uint32 lod;
+		uint32 meshletCount;
+
+		// Meshlets, meshlet datas and meshlet groups size of page.
+		uint32 byteSize;
+	};
+	static_assert(sizeof(GLTFClusterPage) == 48);
+
 	struct GLTFPrimitive
 	{
 		ARCHIVE_DECLARE;
@@ -215,6 +243,10 @@ namespace chord
 
 		uint32 lod0IndicesOffset = 0;
 		uint32 lod0IndicesCount  = 0;
+
+		// Cluster streaming pages, ordered from coarse to fine.
+		uint32 clusterPageOffset = 0;
+		uint32 clusterPageCount  = 0;
 		 
 		bool bColor0Exist = false;
 		bool bSmoothNormalExist = false;
@@ -257,53 +289,126 @@ namespace chord
 		std::vector<int32> nodes;
 	};
 
+	// Data from primitive accessor, Array is std::vector when build and AssetBinarySection when load from disk.
+	template<template<typename> class Array>
+	struct GLTFPrimitiveDatas
+	{
+		// Meshlet need to push to gpu buffer directly, take care of size pad.
+		Array<GLTFMeshlet>      meshlets;
+		Array<uint32>           meshletDatas;
+		Array<GLTFBVHNode>      bvhNodes;
+		Array<GLTFMeshletGroup> meshletGroups;
+		Array<uint32>           meshletGroupIndices;
+
+		// LOD0 indices.
+		Array<uint32> lod0Indices;
+
+		// required.
+		Array<math::vec3> positions;
+		Array<math::vec3> normals;
+		Array<math::vec2> texcoords0; 
+		Array<math::vec4> tangents;
+
+		// optional.
+		Array<math::vec2> texcoords1;    
+		Array<math::vec4> colors0;    
+		Array<math::vec3> smoothNormals;
+
+		// Cluster streaming pages.
+		Array<GLTFClusterPage> clusterPages;
+		Array<uint32>          clusterPageGroups;
+		Array<uint32>          clusterPageDependencies;
+
+		// Visit all arrays in binary section order with preferred filter, never change order without bump schema.
+		// Octahedral only apply when r.asset.binary.filter.lossy enable, otherwise fallback to lossless shuffle delta.
+		template<typename Func>
+		void forEachSection(Func&& func)
+		{
+			func("meshlets",            meshlets,            EAssetBinaryFilter::MeshoptVertex);
+			func("meshletDatas",        meshletDatas,        EAssetBinaryFilter::MeshoptIndexSequence);
+			func("bvhNodes",            bvhNodes,            EAssetBinaryFilter::MeshoptVertex);
+			func("meshletGroups",       meshletGroups,       EAssetBinaryFilter::MeshoptVertex);
+			func("meshletGroupIndices", meshletGroupIndices, EAssetBinaryFilter::MeshoptIndexSequence);
+			func("lod0Indices",         lod0Indices,         EAssetBinaryFilter::MeshoptIndexTriangle);
+			func("positions",           positions,           EAssetBinaryFilter::MeshoptVertex);
+			func("normals",             normals,             EAssetBinaryFilter::Octahedral);
+			func("texcoords0",          texcoords0,          EAssetBinaryFilter::ShuffleDelta);
+			func("tangents",            tangents,            EAssetBinaryFilter::OctahedralTangent);
+			func("texcoords1",          texcoords1,          EAssetBinaryFilter::ShuffleDelta);
+			func("colors0",             colors0,             EAssetBinaryFilter::ShuffleDelta);
+			func("smoothNormals",       smoothNormals,       EAssetBinaryFilter::Octahedral);
+			func("clusterPages",            clusterPages,            EAssetBinaryFilter::MeshoptVertex);
+			func("clusterPageGroups",       clusterPageGroups,       EAssetBinaryFilter::MeshoptIndexSequence);
+			func("clusterPageDependencies", clusterPageDependencies, EAssetBinaryFilter::MeshoptIndexSequence);
+		}
+
+		// GPU upload size, cluster pages only used by cpu residency.
+		size_t size() const
+		{
+			auto sizeofV = [](const auto& a) { return a.size() * sizeof(a[0]); };
+			return
+				  sizeofV(positions)
+				+ sizeofV(normals)
+				+ sizeofV(texcoords0)
+				+ sizeofV(tangents)
+				+ sizeofV(texcoords1)
+				+ sizeofV(colors0)
+				+ sizeofV(smoothNormals) 
+				+ sizeofV(meshlets)
+				+ sizeofV(meshletDatas)
+				+ sizeofV(bvhNodes)
+				+ sizeofV(meshletGroups)
+				+ sizeofV(meshletGroupIndices)
+				+ sizeofV(lod0Indices);
+		}
+	};
+
+	template<typename T> using GLTFBinaryArray = std::vector<T>;
+
 	struct GLTFBinary
 	{
 		ARCHIVE_DECLARE;
 
-		// Data from primitive accessor.
-		struct PrimitiveDatas
-		{
-			// Meshlet need to push to gpu buffer directly, take care of size pad.
-			std::vector<GLTFMeshlet>      meshlets;
-			std::vector<uint32>           meshletDatas;
-			std::vector<GLTFBVHNode>      bvhNodes;
-			std::vector<GLTFMeshletGroup> meshletGroups;
-			std::vector<uint32>           meshletGroupIndices;
-
-			// LOD0 indices.
-			std::vector<uint32> lod0Indices;
-
-			// required.
-			std::vector<math::vec3> positions;
-			std::vector<math::vec3> normals;
-			std::vector<math::vec2> texcoords0; 
-			std::vector<math::vec4> tangents;
-
-			// optional.
-			std::vector<math::vec2> texcoords1;    
-			std::vector<math::vec4> colors0;    
-			std::vector<math::vec3> smoothNormals;
-
-			size_t size() const
-			{
-				auto sizeofV = [](const auto& a) { return a.size() * sizeof(a[0]); };
-				return
-					  sizeofV(positions)
-					+ sizeofV(normals)
-					+ sizeofV(texcoords0)
-					+ sizeofV(tangents)
-					+ sizeofV(texcoords1)
-					+ sizeofV(colors0)
-					+ sizeofV(smoothNormals) 
-					+ sizeofV(meshlets)
-					+ sizeofV(meshletDatas)
-					+ sizeofV(bvhNodes)
-					+ sizeofV(meshletGroups)
-					+ sizeofV(meshletGroupIndices)
-					+ sizeofV(lod0Indices);
-			}
-		} primitiveData;
+		using PrimitiveDatas = GLTFPrimitiveDatas<GLTFBinaryArray>;
+		PrimitiveDatas primitiveData;
+
+		// Layout hash of the chunked binary.
+		static uint64 getSchemaHash();
+
+		// Layout hash of compact storage, compacted sections keep empty and compact sections append after them.
+		static uint64 getCompactSchemaHash();
+
+		// Save as chunked asset binary.
+		bool save(const std::filesystem::path& savePath, cookstats::Report* report = nullptr);
+
+		// Save positions, normals, texcoords0, tangents and meshlet datas with gltfcompact encoding, lossy.
+		bool saveCompact(const std::filesystem::path& savePath, const std::vector<GLTFMesh>& meshes, cookstats::Report* report = nullptr);
+
+		// Save as uncompressed chunked asset binary in memory.
+		bool saveMemory(std::string& out, const std::filesystem::path& debugPath);
+
+		// Rewrite legacy lz4 cereal bin to current format in place, only call from save or cook path.
+		static bool upgradeLegacy(const std::filesystem::path& path);
+	};
+
+	// Chunked view of GLTFBinary, section data only decompress when read.
+	struct GLTFBinaryView
+	{
+		using PrimitiveDatas = GLTFPrimitiveDatas<AssetBinarySection>;
+		PrimitiveDatas primitiveData;
+
+		// Map binary file, legacy lz4 bin and compact bin decode into memory and file keep untouched.
+		bool load(const std::filesystem::path& path, const std::vector<GLTFMesh>& meshes);
+
+		// Only read vertex attributes, lod0 indices, bvh nodes, meshlet groups and cluster pages of one primitive.
+		bool readPrimitive(const GLTFPrimitive& primitive, GLTFBinary::PrimitiveDatas& out) const;
+
+	private:
+		// Read all sections of compact bin and decode into full layout.
+		bool decodeCompact(const std::vector<GLTFMesh>& meshes, GLTFBinary& out) const;
+
+	private:
+		AssetBinaryReader m_reader;
 	};
 
 	class GLTFAsset : public IAsset
@@ -311,7 +416,7 @@ namespace chord
 		REGISTER_BODY_DECLARE(IAsset);
 
 		friend class AssetManager;
-		friend bool importFromConfig(GLTFAssetImportConfigRef config);
+		friend bool importFromConfig(GLTFAssetImportConfigRef config, cookstats::Report* report);
 	public:
 		static const AssetTypeMeta kAssetTypeMeta;
 
@@ -343,6 +448,7 @@ namespace chord
 
 		virtual bool onSave() override;
 		virtual void onUnload() override;
+		virtual bool onSaveSnapshot(AsyncSaveSnapshot& out) override;
 		// ~IAsset virtual function.
 
 	private:
@@ -367,9 +473,9 @@ namespace chord
 	using GLTFAssetRef = std::shared_ptr<GLTFAsset>;
 	using GLTFAssetWeak = std::weak_ptr<GLTFAsset>;
 
-	extern GLTFMaterialAssetRef tryLoadGLTFMaterialAsset(const std::filesystem::path& path, bool bThreadSafe = true);
-	inline GLTFMaterialAssetRef tryLoadGLTFMaterialAsset(const AssetSaveInfo& info, bool bThreadSafe = true)
+	extern GLTFMaterialAssetRef tryLoadGLTFMaterialAsset(const std::filesystem::path& path);
+	inline GLTFMaterialAssetRef tryLoadGLTFMaterialAsset(const AssetSaveInfo& info)
 	{
-		return tryLoadGLTFMaterialAsset(info.path(), bThreadSafe);
+		return tryLoadGLTFMaterialAsset(info.path());
 	}
 }
\ No newline at end of file
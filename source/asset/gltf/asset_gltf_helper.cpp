@@ -19,10 +19,85 @@
 #include <utils/cityhash.h>
 
 #include <asset/nanite_builder.h>
+#include <asset/nanite_page.h>
 #include <asset/gltf/asset_gltf_material.h>
+#include <asset/derived_data_cache.h>
+#include <asset/cook_stats.h>
+#include <asset/gltf/gltf_compact.h>
+#include <asset/gltf/gltf_source.h>
+#include <utils/cvar.h>
+#include <utils/job_system.h>
 
 namespace chord
 {
+	static uint32 sGLTFImportParallel = 1;
+	static AutoCVarRef cVarGLTFImportParallel(
+		"r.gltf.import.parallel",
+		sGLTFImportParallel,
+		"Cook gltf primitives in parallel when import or not, output is same as serial import."
+	);
+
+	static uint32 sGLTFImportDedupContent = 1;
+	static AutoCVarRef cVarGLTFImportDedupContent(
+		"r.gltf.import.dedup.content",
+		sGLTFImportDedupContent,
+		"Dedup gltf primitives by hash of decoded index and vertex content or by accessor ids only."
+	);
+
+	static uint32 sGLTFCompactValidate = 0;
+	static AutoCVarRef cVarGLTFCompactValidate(
+		"r.gltf.compact.validate",
+		sGLTFCompactValidate,
+		"Encode imported gltf primitive datas with compact encoding, decode and report size and error or not."
+	);
+
+	static uint32 sGLTFCompactStorage = 0;
+	static AutoCVarRef cVarGLTFCompactStorage(
+		"r.gltf.compact.storage",
+		sGLTFCompactStorage,
+		"Save imported gltf bin with lossy compact encoding and decode when load, default off keep fp32 bit exact."
+	);
+
+	// Round trip compact encoding of imported datas, log saving and max error.
+	static void validateCompactEncoding(const std::string& assetName, const std::vector<GLTFMesh>& meshes, const GLTFBinary& gltfBin, cookstats::Report* report)
+	{
+		cookstats::ScopedStage stage("gltf.compact", report);
+		const auto& data = gltfBin.primitiveData;
+
+		gltfcompact::PrimitiveDatas compact;
+		gltfcompact::encode(meshes, data, compact);
+
+		GLTFBinary::PrimitiveDatas decoded;
+		if (!gltfcompact::decode(meshes, data.meshlets, compact, decoded))
+		{
+			LOG_ERROR("GLTF '{}' compact encoding decode failed.", assetName);
+			return;
+		}
+
+		float positionBound = 0.0f;
+		for (const auto& mesh : meshes)
+		{
+			for (const auto& primitive : mesh.primitives)
+			{
+				positionBound = math::max(positionBound, gltfcompact::getPositionErrorBound(primitive));
+			}
+		}
+
+		const auto sizeofV = [](const auto& a) { return uint64(a.size() * sizeof(a[0])); };
+		const uint64 rawSize = sizeofV(data.positions) + sizeofV(data.normals) + sizeofV(data.tangents) + sizeofV(data.texcoords0) + sizeofV(data.meshletDatas);
+
+		const auto error = gltfcompact::measureError(data, decoded);
+		if (!error.bMeshletDatasMatch || error.position > positionBound * 1.01f + 1e-6f)
+		{
+			LOG_ERROR("GLTF '{}' compact encoding out of error bound, position error {} bound {}, meshlet datas match {}.",
+				assetName, error.position, positionBound, error.bMeshletDatasMatch);
+		}
+
+		LOG_INFO("GLTF '{}' compact encoding {} KB -> {} KB ({:.1f}%), max error position {:.6f}, normal {:.3f} deg, tangent {:.3f} deg, uv0 {:.6f}.",
+			assetName, rawSize / 1024, compact.size() / 1024, rawSize > 0 ? 100.0 * double(compact.size()) / double(rawSize) : 0.0,
+			error.position, error.normal, error.tangent, error.uv0);
+	}
+
 	static void uiDrawImportConfig(GLTFAssetImportConfigRef config)
 	{
 		ImGui::Checkbox("##SmoothNormal", &config->bGenerateSmoothNormal); ImGui::SameLine(); ImGui::Text("Generate Smooth Normal");
@@ -35,6 +110,19 @@ namespace chord
 
 		ImGui::Separator();
 		ImGui::DragFloat("Meshlet ConeWeight", &config->meshletConeWeight, 0.1f, 0.0f, 1.0f);
+
+		int partitionerValue = (int)config->meshletPartitioner;
+
+		std::array<std::string, (size_t)EMeshletPartitioner::MAX> partitionerList { };
+		std::array<const char*, (size_t)EMeshletPartitioner::MAX> partitionerListChar { };
+		for (size_t i = 0; i < partitionerList.size(); i++)
+		{
+			partitionerList[i] = std::string(nameof::nameof_enum(EMeshletPartitioner(i)));
+			partitionerListChar[i] = partitionerList[i].c_str();
+		}
+
+		ImGui::Combo("Meshlet Partitioner", &partitionerValue, partitionerListChar.data(), partitionerListChar.size());
+		config->meshletPartitioner = EMeshletPartitioner(partitionerValue);
 	}
 
 	struct LoadMeshOptionalAttribute
@@ -44,8 +132,19 @@ namespace chord
 		bool bColor0 = false;
 	};
 
+	// View of primitive attribute, log when it can't read.
+	static bool getAttributeView(const GLTFSource& source, const tinygltf::Primitive& mesh, const char* attributeName, const std::string& meshName, GLTFAccessorView& out)
+	{
+		if (!source.getAccessor(mesh.attributes.at(attributeName), out))
+		{
+			LOG_ERROR("Mesh '{}' attribute {} is sparse or out of buffer range, skip...", meshName, attributeName);
+			return false;
+		}
+		return true;
+	}
+
 	static bool loadMesh(
-		const tinygltf::Model& model,
+		const GLTFSource& source,
 		const tinygltf::Primitive& mesh, 
 		const std::string& meshName,
 		LoadMeshOptionalAttribute& optional,
@@ -54,7 +153,8 @@ namespace chord
 		std::vector<uint32>& outputIndices,
 		math::vec3& meshPosMin,
 		math::vec3& meshPosMax,
-		math::vec3& meshPosAvg)
+		math::vec3& meshPosAvg,
+		cookstats::Report* report)
 	{
 		if (!mesh.attributes.contains("POSITION"))
 		{
@@ -65,16 +165,21 @@ namespace chord
 		// Prepare indices.
 		if (mesh.indices > -1)
 		{
-			const tinygltf::Accessor& indexAccessor = model.accessors[mesh.indices];
-			const tinygltf::BufferView& bufferView  = model.bufferViews[indexAccessor.bufferView];
+			const tinygltf::Accessor& indexAccessor = source.getModel().accessors[mesh.indices];
+
+			GLTFAccessorView view;
+			if (!source.getAccessor(mesh.indices, view))
+			{
+				LOG_ERROR("Mesh '{}' indices is sparse or out of buffer range, skip...", meshName);
+				return false;
+			}
 
-			outputIndices.resize(indexAccessor.count);
+			outputIndices.resize(view.count);
 			auto insertIndices = [&]<typename T>()
 			{
-				const auto* buf = reinterpret_cast<const T*>(&model.buffers[bufferView.buffer].data[indexAccessor.byteOffset + bufferView.byteOffset]);
-				for (auto index = 0; index < indexAccessor.count; index++)
+				for (uint64 index = 0; index < view.count; index++)
 				{
-					outputIndices[index] = buf[index];
+					outputIndices[index] = view.get<T>(index);
 				}
 			};
 			switch (indexAccessor.componentType)
@@ -89,7 +194,7 @@ namespace chord
 		{
 			LOG_TRACE("No INDICES found in mesh '{}', use triangle order indexing...", meshName);
 
-			const auto& accessor = model.accessors[mesh.attributes.find("POSITION")->second];
+			const auto& accessor = source.getModel().accessors[mesh.attributes.find("POSITION")->second];
 			outputIndices.resize(accessor.count);
 			for (auto i = 0; i < accessor.count; i++)
 			{
@@ -99,21 +204,20 @@ namespace chord
 
 		// Position.
 		{
-			const tinygltf::Accessor& accessor = model.accessors[mesh.attributes.find("POSITION")->second];
-			const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
+			GLTFAccessorView view;
+			if (!getAttributeView(source, mesh, "POSITION", meshName, view)) { return false; }
 
-			const float* posBuffer = reinterpret_cast<const float*>(&(model.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
 			math::vec3 positionMin = math::vec3( std::numeric_limits<float>::max());
 			math::vec3 positionMax = math::vec3(-std::numeric_limits<float>::max());
 
 			// Summary of position, use double to keep precision.
 			math::dvec3 positionSum = math::dvec3(0.0);
-			outputVertices.resize(accessor.count);
+			outputVertices.resize(view.count);
 
-			for (auto index = 0; index < accessor.count; index++)
+			for (uint64 index = 0; index < view.count; index++)
 			{
+				const float* posBuffer = &view.get<float>(index);
 				outputVertices[index].position = { posBuffer[0], posBuffer[1], posBuffer[2] };
-				posBuffer += 3;
 
 				positionMin = math::min(positionMin, outputVertices[index].position);
 				positionMax = math::max(positionMax, outputVertices[index].position);
@@ -125,22 +229,20 @@ namespace chord
 			meshPosMin = positionMin;
 
 			// Position average.
-			meshPosAvg = positionSum / double(accessor.count);
+			meshPosAvg = positionSum / double(view.count);
 		}
 
 		// Normal.
 		if (mesh.attributes.contains("NORMAL"))
 		{
-			const tinygltf::Accessor& accessor = model.accessors[mesh.attributes.find("NORMAL")->second];
-			const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
+			GLTFAccessorView view;
+			if (!getAttributeView(source, mesh, "NORMAL", meshName, view)) { return false; }
+			check(view.count == outputVertices.size());
 
-			const float* normalBuffer = reinterpret_cast<const float*>(&(model.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-			check(accessor.count == outputVertices.size());
-
-			for (auto index = 0; index < accessor.count; index++)
+			for (uint64 index = 0; index < view.count; index++)
 			{
+				const float* normalBuffer = &view.get<float>(index);
 				outputVertices[index].normal = { normalBuffer[0], normalBuffer[1], normalBuffer[2] };
-				normalBuffer += 3;
 			}
 		}
 		else
@@ -171,15 +273,13 @@ namespace chord
 		const bool bExistTextureCoord0 = mesh.attributes.contains("TEXCOORD_0");
 		if (bExistTextureCoord0)
 		{
-			const tinygltf::Accessor& accessor = model.accessors[mesh.attributes.find("TEXCOORD_0")->second];
-			const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
-
-			const float* textureCoord0Buffer = reinterpret_cast<const float*>(&(model.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-			check(accessor.count == outputVertices.size());
-			for (auto index = 0; index < accessor.count; index++)
+			GLTFAccessorView view;
+			if (!getAttributeView(source, mesh, "TEXCOORD_0", meshName, view)) { return false; }
+			check(view.count == outputVertices.size());
+			for (uint64 index = 0; index < view.count; index++)
 			{
+				const float* textureCoord0Buffer = &view.get<float>(index);
 				outputVertices[index].uv0 = { textureCoord0Buffer[0], textureCoord0Buffer[1] };
-				textureCoord0Buffer += 2;
 			}
 		}
 		else
@@ -197,20 +297,21 @@ namespace chord
 			if (mesh.attributes.contains("TANGENT"))
 			{
 				// Tangent already exist so just import.
-				const tinygltf::Accessor& accessor = model.accessors[mesh.attributes.find("TANGENT")->second];
-				const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
+				GLTFAccessorView view;
+				if (!getAttributeView(source, mesh, "TANGENT", meshName, view)) { return false; }
+				check(view.count == outputVertices.size());
 
-				const float* tangentBuffer = reinterpret_cast<const float*>(&(model.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-				check(accessor.count == outputVertices.size());
-				for (auto index = 0; index < accessor.count; index++)
+				for (uint64 index = 0; index < view.count; index++)
 				{
+					const float* tangentBuffer = &view.get<float>(index);
 					outputVertices[index].tangent = { tangentBuffer[0], tangentBuffer[1], tangentBuffer[2], tangentBuffer[3] };
-					tangentBuffer += 4;
 				}
 			}
 			else
 			{
 				LOG_TRACE("No tangent found in mesh '{}', generating mikktspace...", meshName);
+
+				cookstats::ScopedStage stage("gltf.mesh.tangent", report);
 				if (!computeTangent(outputVertices, outputIndices))
 				{
 					LOG_ERROR("Mesh '{}' mikktspace generate error, skip...", meshName);
@@ -231,31 +332,7 @@ namespace chord
 		optional.bSmoothNormal = bGenerateSmoothNormal;
 		if (optional.bSmoothNormal)
 		{
-			std::vector<math::vec3> newSmoothNormals(outputVertices.size());
-			for (auto i = 0; i < outputIndices.size(); i += 3)
-			{
-				uint32 ind0 = outputIndices[i + 0];
-				uint32 ind1 = outputIndices[i + 1];
-				uint32 ind2 = outputIndices[i + 2];
-
-				const auto& n0 = outputVertices[ind0].normal;
-				const auto& n1 = outputVertices[ind1].normal;
-				const auto& n2 = outputVertices[ind2].normal;
-
-				newSmoothNormals[ind0] += n0;
-				newSmoothNormals[ind1] += n1;
-				newSmoothNormals[ind2] += n2;
-			}
-
-			for (auto& n : newSmoothNormals)
-			{
-				n = math::normalize(n);
-			}
-
-			for (uint i = 0; i < outputVertices.size(); i++)
-			{
-				outputVertices[i].smoothNormal = newSmoothNormals[i];
-			}
+			nanite::computeSmoothNormals(outputIndices, outputVertices);
 		}
 
 		/////////////////////////////
@@ -266,15 +343,13 @@ namespace chord
 		optional.bUv1 = mesh.attributes.contains("TEXCOORD_1");
 		if (optional.bUv1)
 		{
-			const tinygltf::Accessor& accessor = model.accessors[mesh.attributes.find("TEXCOORD_1")->second];
-			const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
-
-			const float* textureCoord1Buffer = reinterpret_cast<const float*>(&(model.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-			check(accessor.count == outputVertices.size());
-			for (auto index = 0; index < accessor.count; index++)
+			GLTFAccessorView view;
+			if (!getAttributeView(source, mesh, "TEXCOORD_1", meshName, view)) { return false; }
+			check(view.count == outputVertices.size());
+			for (uint64 index = 0; index < view.count; index++)
 			{
+				const float* textureCoord1Buffer = &view.get<float>(index);
 				outputVertices[index].uv1 = { textureCoord1Buffer[0], textureCoord1Buffer[1] };
-				textureCoord1Buffer += 2;
 			}
 		}
 
@@ -282,23 +357,529 @@ namespace chord
 		optional.bColor0 = mesh.attributes.contains("COLOR_0");
 		if (optional.bColor0)
 		{
-			const tinygltf::Accessor& accessor = model.accessors[mesh.attributes.find("COLOR_0")->second];
-			const tinygltf::BufferView& view = model.bufferViews[accessor.bufferView];
-
-			const float* colorBuffer = reinterpret_cast<const float*>(&(model.buffers[view.buffer].data[accessor.byteOffset + view.byteOffset]));
-			check(accessor.count == outputVertices.size());
+			GLTFAccessorView view;
+			if (!getAttributeView(source, mesh, "COLOR_0", meshName, view)) { return false; }
+			check(view.count == outputVertices.size());
 
-			for (auto index = 0; index < accessor.count; index++)
+			for (uint64 index = 0; index < view.count; index++)
 			{
+				const float* colorBuffer = &view.get<float>(index);
 				outputVertices[index].color0 = { colorBuffer[0], colorBuffer[1], colorBuffer[2], colorBuffer[3]};
-				colorBuffer += 4;
 			}
 		}
 
 		return true;
 	}
 
-	bool importFromConfig(GLTFAssetImportConfigRef config)
+	// Primitive cook result before append to gltf binary, loadMesh and nanite build output.
+	struct CookedPrimitive
+	{
+		LoadMeshOptionalAttribute optionalAttri { };
+		math::vec3 posMin;
+		math::vec3 posMax;
+		math::vec3 posAvg;
+
+		nanite::MeshletContainer meshletCtx;
+		std::vector<nanite::Vertex> vertices;
+		std::vector<uint32> lod0Indices;
+
+		// Derived from meshletCtx after cook or cache hit, not store in derived data cache.
+		nanite::ClusterPages clusterPages;
+
+		// Seconds of cook, store in derived data cache so cache hit know build time it save.
+		float cookSeconds = 0.0f;
+		bool bCacheHit = false;
+	};
+
+	static bool cookPrimitive(const GLTFSource& source, const tinygltf::Primitive& mesh, const std::string& name, const GLTFAssetImportConfig& config, CookedPrimitive& cooked, cookstats::Report* report)
+	{
+		std::vector<nanite::Vertex> rawVertices;
+		std::vector<uint32> rawIndices;
+		{
+			cookstats::ScopedStage stage("gltf.mesh.load", report);
+
+			bool bLoadResult = loadMesh(source, mesh, name, cooked.optionalAttri, config.bGenerateSmoothNormal, rawVertices, rawIndices, cooked.posMin, cooked.posMax, cooked.posAvg, report);
+			if (!bLoadResult) { return false; }
+		}
+
+		cookstats::ScopedStage stage("gltf.mesh.nanite", report);
+		if (nanite::useStreamingBuild(rawIndices.size() / 3))
+		{
+			// Brick files store in project cache, builder remove them when finish. Unique folder name so cook processes share cache safely.
+			const auto workFolder = std::filesystem::path(Project::get().getPath().cachePath.u16()) / std::format("nanite_bricks_{}", generateUUID());
+			LOG_INFO("Mesh {} with {} triangles use streaming nanite build by r.nanite.streaming.threshold.", name, rawIndices.size() / 3);
+
+			nanite::NaniteStreamingBuilder builder(
+				workFolder,
+				cooked.posMin,
+				cooked.posMax,
+				rawIndices.size() / 3,
+				config.bFuse,
+				config.bFuseIgnoreNormal,
+				config.meshletConeWeight,
+				config.meshletPartitioner,
+				report);
+
+			bool bResult = builder.addTriangles(rawIndices, rawVertices);
+
+			// Source mesh already in bricks, free before build.
+			rawIndices = { };
+			rawVertices = { };
+
+			return bResult && builder.build(cooked.meshletCtx, cooked.vertices, cooked.lod0Indices);
+		}
+
+		nanite::NaniteBuilder builder(
+			std::move(rawIndices), 
+			std::move(rawVertices), 
+			config.bFuse, 
+			config.bFuseIgnoreNormal, 
+			config.meshletConeWeight,
+			config.meshletPartitioner,
+			report);
+
+		cooked.meshletCtx = builder.build();
+		cooked.vertices = builder.getVertices();
+		cooked.lod0Indices = builder.getIndices();
+
+		return true;
+	}
+
+	// Primitive cook result store in derived data cache, bump version when loadMesh or nanite builder output change.
+	// Key build from the primitive content, so same primitive in different gltf file also share entry.
+	namespace gltf_ddc
+	{
+		constexpr uint32 kCookVersion = 3;
+
+		struct Record
+		{
+			math::vec3 posMin;
+			math::vec3 posMax;
+			math::vec3 posAvg;
+
+			uint32 bSmoothNormal;
+			uint32 bUv1;
+			uint32 bColor0;
+
+			float cookSeconds;
+		};
+
+		static uint64 getSchemaHash()
+		{
+			static const uint64 kSchemaHash = assetbinary::buildSchemaHash(
+			{
+				{ "record",              sizeof(Record)                   },
+				{ "triangles",           sizeof(uint8)                    },
+				{ "vertices",            sizeof(uint32)                   },
+				{ "meshlets",            sizeof(nanite::Meshlet)          },
+				{ "meshletGroups",       sizeof(GPUGLTFMeshletGroup)      },
+				{ "meshletGroupIndices", sizeof(uint32)                   },
+				{ "bvhNodes",            sizeof(GPUBVHNode)               },
+				{ "builderVertices",     sizeof(nanite::Vertex)           },
+				{ "lod0Indices",         sizeof(uint32)                   },
+			});
+			return kSchemaHash;
+		}
+
+		// Hash accessor elements as loadMesh read them, independent of buffer view, offset and stride.
+		static bool updateAccessor(ddc::KeyBuilder& builder, const GLTFSource& source, int32 accessorId)
+		{
+			// Sparse or out of range accessor rarely used, just no dedup.
+			GLTFAccessorView view;
+			if (!source.getAccessor(accessorId, view))
+			{
+				return false;
+			}
+
+			const tinygltf::Accessor& accessor = source.getModel().accessors[accessorId];
+			builder.update(accessor.componentType);
+			builder.update(accessor.type);
+			builder.update(accessor.count);
+			builder.update(accessor.normalized);
+
+			if (view.isPacked())
+			{
+				builder.update(view.data, view.count * view.elementSize);
+			}
+			else
+			{
+				std::vector<uint8> packed(view.count * view.elementSize);
+				for (uint64 i = 0; i < view.count; i++)
+				{
+					std::memcpy(packed.data() + i * view.elementSize, &view.get<uint8>(i), view.elementSize);
+				}
+				builder.update(packed.data(), packed.size());
+			}
+
+			return true;
+		}
+
+		// Content key of decoded indices and attributes, primitives of same key cook to same result.
+		static bool buildContentKey(const GLTFSource& source, const tinygltf::Primitive& mesh, ddc::Key& outKey)
+		{
+			ddc::KeyBuilder builder("gltf_primitive_content", kCookVersion);
+
+			// Attributes is ordered map, key is stable.
+			for (const auto& [attributeName, accessorId] : mesh.attributes)
+			{
+				builder.update(attributeName);
+				if (!updateAccessor(builder, source, accessorId))
+				{
+					return false;
+				}
+			}
+
+			// Indices decode to uint32 like loadMesh, so 16 bit and 32 bit copies of same mesh match.
+			if (mesh.indices > -1)
+			{
+				GLTFAccessorView view;
+				if (!source.getAccessor(mesh.indices, view))
+				{
+					return false;
+				}
+
+				std::vector<uint32> indices(view.count);
+				auto decodeIndices = [&]<typename T>()
+				{
+					for (uint64 i = 0; i < view.count; i++)
+					{
+						indices[i] = view.get<T>(i);
+					}
+				};
+				switch (source.getModel().accessors[mesh.indices].componentType)
+				{
+				case TINYGLTF_PARAMETER_TYPE_UNSIGNED_INT: { decodeIndices.operator()<uint32>(); break; }
+				case TINYGLTF_PARAMETER_TYPE_UNSIGNED_SHORT: { decodeIndices.operator()<uint16>(); break; }
+				case TINYGLTF_PARAMETER_TYPE_UNSIGNED_BYTE: { decodeIndices.operator()<uint8>(); break; }
+				default: return false;
+				}
+
+				builder.update(view.count);
+				builder.update(indices.data(), indices.size() * sizeof(uint32));
+			}
+			else
+			{
+				builder.update(mesh.indices);
+			}
+
+			outKey = builder.finalize();
+			return true;
+		}
+
+		static ddc::Key buildKey(const ddc::Key& contentKey, const GLTFAssetImportConfig& config)
+		{
+			ddc::KeyBuilder builder("gltf_primitive", kCookVersion);
+
+			builder.update(contentKey);
+			builder.update(config.bGenerateSmoothNormal);
+			builder.update(config.bFuse);
+			builder.update(config.bFuseIgnoreNormal);
+			builder.update(config.meshletConeWeight);
+			builder.update(config.meshletPartitioner);
+			builder.update(nanite::getBuildCVarsHash());
+
+			return builder.finalize();
+		}
+
+		static bool load(const ddc::Key& key, CookedPrimitive& cooked, cookstats::Report* report)
+		{
+			AssetBinaryReader reader;
+			if (!ddc::get(key, getSchemaHash(), reader, report) || reader.getSectionCount() != 9)
+			{
+				return false;
+			}
+
+			std::vector<Record> record;
+			bool bResult = reader.copySection(0, record) && record.size() == 1;
+
+			bResult = bResult && reader.copySection(1, cooked.meshletCtx.triangles);
+			bResult = bResult && reader.copySection(2, cooked.meshletCtx.vertices);
+			bResult = bResult && reader.copySection(3, cooked.meshletCtx.meshlets);
+			bResult = bResult && reader.copySection(4, cooked.meshletCtx.meshletGroups);
+			bResult = bResult && reader.copySection(5, cooked.meshletCtx.meshletGroupIndices);
+			bResult = bResult && reader.copySection(6, cooked.meshletCtx.bvhNodes);
+			bResult = bResult && reader.copySection(7, cooked.vertices);
+			bResult = bResult && reader.copySection(8, cooked.lod0Indices);
+
+			if (!bResult || cooked.meshletCtx.bvhNodes.empty())
+			{
+				return false;
+			}
+
+			cooked.posMin = record[0].posMin;
+			cooked.posMax = record[0].posMax;
+			cooked.posAvg = record[0].posAvg;
+			cooked.optionalAttri.bSmoothNormal = record[0].bSmoothNormal != 0;
+			cooked.optionalAttri.bUv1 = record[0].bUv1 != 0;
+			cooked.optionalAttri.bColor0 = record[0].bColor0 != 0;
+			cooked.cookSeconds = record[0].cookSeconds;
+
+			return true;
+		}
+
+		static void save(const ddc::Key& key, const CookedPrimitive& cooked, const std::string& name, cookstats::Report* report)
+		{
+			Record record { };
+			record.posMin = cooked.posMin;
+			record.posMax = cooked.posMax;
+			record.posAvg = cooked.posAvg;
+			record.bSmoothNormal = cooked.optionalAttri.bSmoothNormal ? 1 : 0;
+			record.bUv1 = cooked.optionalAttri.bUv1 ? 1 : 0;
+			record.bColor0 = cooked.optionalAttri.bColor0 ? 1 : 0;
+			record.cookSeconds = cooked.cookSeconds;
+
+			AssetBinaryWriter writer;
+			writer.addSection(&record, sizeof(record), sizeof(record));
+			writer.addSection(cooked.meshletCtx.triangles);
+			writer.addSection(cooked.meshletCtx.vertices);
+			writer.addSection(cooked.meshletCtx.meshlets);
+			writer.addSection(cooked.meshletCtx.meshletGroups);
+			writer.addSection(cooked.meshletCtx.meshletGroupIndices);
+			writer.addSection(cooked.meshletCtx.bvhNodes);
+			writer.addSection(cooked.vertices);
+			writer.addSection(cooked.lod0Indices);
+
+			if (!ddc::put(key, getSchemaHash(), writer, assetbinary::getConfigCompressionMode(), report))
+			{
+				LOG_WARN("Fail to store gltf primitive '{}' in derived data cache.", name);
+			}
+		}
+	}
+
+	// Load primitive cook result from derived data cache, cook and store it when miss.
+	// Content key is null when primitive content can't hash, always cook it.
+	static bool loadOrCookPrimitive(const GLTFSource& source, const tinygltf::Primitive& mesh, const std::string& name, const GLTFAssetImportConfig& config, const ddc::Key* contentKey, CookedPrimitive& cooked, cookstats::Report* report)
+	{
+		// Cache hit skip mikktspace, nanite clustering and simplification.
+		ddc::Key ddcKey { };
+		const bool bDDCKeyValid = ddc::isEnable() && contentKey != nullptr;
+		if (bDDCKeyValid)
+		{
+			ddcKey = gltf_ddc::buildKey(*contentKey, config);
+		}
+
+		if (bDDCKeyValid && gltf_ddc::load(ddcKey, cooked, report))
+		{
+			cooked.bCacheHit = true;
+			LOG_TRACE("Primitive '{}' hit derived data cache {}.", name, ddcKey.toString());
+		}
+		else
+		{
+			cooked = { };
+
+			const auto cookBegin = std::chrono::high_resolution_clock::now();
+			if (!cookPrimitive(source, mesh, name, config, cooked, report)) { return false; }
+			cooked.cookSeconds = std::chrono::duration<float>(std::chrono::high_resolution_clock::now() - cookBegin).count();
+
+			if (bDDCKeyValid)
+			{
+				gltf_ddc::save(ddcKey, cooked, name, report);
+			}
+		}
+
+		cookstats::ScopedStage stage("gltf.mesh.pages", report);
+		if (!nanite::buildClusterPages(cooked.meshletCtx, cooked.clusterPages))
+		{
+			LOG_ERROR("Fail to build cluster pages of gltf primitive '{}'.", name);
+			return false;
+		}
+		return true;
+	}
+
+	// Create a key made of the attributes, to see if the primitive was already processed.
+	static std::string buildPrimitiveAttributeKey(const tinygltf::Primitive& mesh)
+	{
+		std::stringstream o;
+		for (auto& a : mesh.attributes)
+		{
+			o << a.first << a.second;
+		}
+		return o.str();
+	}
+
+	// Element offsets of one cooked primitive in gltf binary, also used as running size of binary.
+	struct PrimitiveAppendRange
+	{
+		const CookedPrimitive* cooked = nullptr;
+
+		uint32 vertexOffset = 0;
+		uint32 lod0IndicesOffset = 0;
+		uint32 colors0Offset = 0;
+		uint32 textureCoord1Offset = 0;
+		uint32 smoothNormalOffset = 0;
+
+		uint32 meshletOffset = 0;
+		uint32 meshletDataOffset = 0;
+		uint32 meshletGroupOffset = 0;
+		uint32 meshletGroupIndicesOffset = 0;
+		uint32 bvhNodeOffset = 0;
+
+		uint32 clusterPageOffset = 0;
+		uint32 clusterPageGroupOffset = 0;
+		uint32 clusterPageDependencyOffset = 0;
+	};
+
+	// Fill primitive from cooked result with offsets of cursor, then advance cursor by cooked sizes.
+	static PrimitiveAppendRange allocatePrimitiveRange(GLTFPrimitive& primitiveMesh, const CookedPrimitive& cooked, PrimitiveAppendRange& cursor)
+	{
+		PrimitiveAppendRange range = cursor;
+		range.cooked = &cooked;
+
+		const auto& meshletCtx = cooked.meshletCtx;
+		const uint32 vertexCount = (uint32)cooked.vertices.size();
+
+		primitiveMesh.vertexOffset = range.vertexOffset;
+		primitiveMesh.lod0IndicesOffset = range.lod0IndicesOffset;
+
+		// Optional attribute offset.
+		primitiveMesh.colors0Offset       = range.colors0Offset;
+		primitiveMesh.textureCoord1Offset = range.textureCoord1Offset;
+		primitiveMesh.smoothNormalOffset  = range.smoothNormalOffset;
+
+		// Meshlet offset.
+		primitiveMesh.meshletOffset = range.meshletOffset;
+		primitiveMesh.meshletGroupOffset = range.meshletGroupOffset;
+		primitiveMesh.meshletGroupIndicesOffset = range.meshletGroupIndicesOffset;
+		primitiveMesh.bvhNodeOffset = range.bvhNodeOffset;
+
+		// Cluster streaming pages.
+		primitiveMesh.clusterPageOffset = range.clusterPageOffset;
+		primitiveMesh.clusterPageCount = (uint32)cooked.clusterPages.pages.size();
+
+		// Position min, max and average.
+		primitiveMesh.posMin = cooked.posMin;
+		primitiveMesh.posMax = cooked.posMax;
+		primitiveMesh.posAverage = cooked.posAvg;
+
+		primitiveMesh.bvhNodeCount = meshletCtx.bvhNodes[0].bvhNodeCount;
+		primitiveMesh.meshletGroupCount = (uint32)meshletCtx.meshletGroups.size();
+
+		uint32 meshletDataCount = 0;
+		primitiveMesh.lod0meshletCount = 0;
+		for (const auto& meshlet : meshletCtx.meshlets)
+		{
+			meshletDataCount += meshlet.info.vertex_count + meshlet.info.triangle_count;
+			if (meshlet.lod == 0) { primitiveMesh.lod0meshletCount ++; }
+		}
+
+		primitiveMesh.vertexCount = vertexCount;
+		primitiveMesh.lod0IndicesCount = (uint32)cooked.lod0Indices.size();
+
+		// Fill exist state.
+		primitiveMesh.bColor0Exist = cooked.optionalAttri.bColor0;
+		primitiveMesh.bSmoothNormalExist = cooked.optionalAttri.bSmoothNormal;
+		primitiveMesh.bTextureCoord1Exist = cooked.optionalAttri.bUv1;
+
+		cursor.vertexOffset              += vertexCount;
+		cursor.lod0IndicesOffset         += (uint32)cooked.lod0Indices.size();
+		cursor.colors0Offset             += primitiveMesh.bColor0Exist ? vertexCount : 0;
+		cursor.textureCoord1Offset       += primitiveMesh.bTextureCoord1Exist ? vertexCount : 0;
+		cursor.smoothNormalOffset        += primitiveMesh.bSmoothNormalExist ? vertexCount : 0;
+		cursor.meshletOffset             += (uint32)meshletCtx.meshlets.size();
+		cursor.meshletDataOffset         += meshletDataCount;
+		cursor.meshletGroupOffset        += (uint32)meshletCtx.meshletGroups.size();
+		cursor.meshletGroupIndicesOffset += (uint32)meshletCtx.meshletGroupIndices.size();
+		cursor.bvhNodeOffset             += (uint32)meshletCtx.bvhNodes.size();
+
+		cursor.clusterPageOffset           += (uint32)cooked.clusterPages.pages.size();
+		cursor.clusterPageGroupOffset      += (uint32)cooked.clusterPages.pageGroups.size();
+		cursor.clusterPageDependencyOffset += (uint32)cooked.clusterPages.pageDependencies.size();
+
+		return range;
+	}
+
+	// Upload bytes of cooked primitive in gltf binary, same sections as GLTFPrimitiveDatas::size.
+	static uint64 getCookedPrimitiveBytes(const CookedPrimitive& cooked)
+	{
+		GLTFPrimitive primitiveMesh;
+		PrimitiveAppendRange size { };
+		allocatePrimitiveRange(primitiveMesh, cooked, size);
+
+		return
+			  uint64(size.vertexOffset) * (sizeof(math::vec3) * 2 + sizeof(math::vec2) + sizeof(math::vec4))
+			+ uint64(size.textureCoord1Offset) * sizeof(math::vec2)
+			+ uint64(size.colors0Offset) * sizeof(math::vec4)
+			+ uint64(size.smoothNormalOffset) * sizeof(math::vec3)
+			+ uint64(size.meshletOffset) * sizeof(GLTFMeshlet)
+			+ uint64(size.meshletDataOffset) * sizeof(uint32)
+			+ uint64(size.bvhNodeOffset) * sizeof(GLTFBVHNode)
+			+ uint64(size.meshletGroupOffset) * sizeof(GLTFMeshletGroup)
+			+ uint64(size.meshletGroupIndicesOffset) * sizeof(uint32)
+			+ uint64(size.lod0IndicesOffset) * sizeof(uint32);
+	}
+
+	// Copy cooked primitive into its range of gltf binary, ranges never overlap so all primitives copy in parallel.
+	static void copyPrimitiveRange(const PrimitiveAppendRange& range, GLTFBinary& gltfBin)
+	{
+		auto& data = gltfBin.primitiveData;
+		const auto& cooked = *range.cooked;
+		const auto& meshletCtx = cooked.meshletCtx;
+
+		std::copy(meshletCtx.meshletGroups.begin(), meshletCtx.meshletGroups.end(), data.meshletGroups.begin() + range.meshletGroupOffset);
+		std::copy(meshletCtx.meshletGroupIndices.begin(), meshletCtx.meshletGroupIndices.end(), data.meshletGroupIndices.begin() + range.meshletGroupIndicesOffset);
+		std::copy(meshletCtx.bvhNodes.begin(), meshletCtx.bvhNodes.end(), data.bvhNodes.begin() + range.bvhNodeOffset);
+
+		uint32 dataOffset = range.meshletDataOffset;
+		for (uint32 i = 0; i < (uint32)meshletCtx.meshlets.size(); i++)
+		{
+			const auto& meshlet = meshletCtx.meshlets[i];
+			data.meshlets[range.meshletOffset + i] = meshlet.getGLTFMeshlet(dataOffset);
+
+			// Fill meshlet indices data.
+			for (auto j = 0; j < meshlet.info.vertex_count; ++j)
+			{
+				data.meshletDatas[dataOffset ++] = meshletCtx.vertices[meshlet.info.vertex_offset + j];
+			}
+
+			for (auto j = 0; j < meshlet.info.triangle_count; ++j)
+			{
+				uint8 id0 = meshletCtx.triangles[meshlet.info.triangle_offset + j * 3 + 0];
+				uint8 id1 = meshletCtx.triangles[meshlet.info.triangle_offset + j * 3 + 1];
+				uint8 id2 = meshletCtx.triangles[meshlet.info.triangle_offset + j * 3 + 2];
+
+				uint32 idx = id0;
+				idx |= (uint32(id1) << 8);
+				idx |= (uint32(id2) << 16);
+
+				data.meshletDatas[dataOffset ++] = idx;
+			}
+		}
+
+		// Page offsets relative to whole binary, page group and dependency values stay local to primitive.
+		const auto& clusterPages = cooked.clusterPages;
+		for (uint32 i = 0; i < (uint32)clusterPages.pages.size(); i++)
+		{
+			GLTFClusterPage page = clusterPages.pages[i];
+			page.groupOffset += range.clusterPageGroupOffset;
+			page.dependencyOffset += range.clusterPageDependencyOffset;
+			data.clusterPages[range.clusterPageOffset + i] = page;
+		}
+		std::copy(clusterPages.pageGroups.begin(), clusterPages.pageGroups.end(), data.clusterPageGroups.begin() + range.clusterPageGroupOffset);
+		std::copy(clusterPages.pageDependencies.begin(), clusterPages.pageDependencies.end(), data.clusterPageDependencies.begin() + range.clusterPageDependencyOffset);
+
+		// Fill lod0 indices. (Used for voxelize, ray tracing or sdf generation, etc.)
+		std::copy(cooked.lod0Indices.begin(), cooked.lod0Indices.end(), data.lod0Indices.begin() + range.lod0IndicesOffset);
+
+		uint32 colors0Offset = range.colors0Offset;
+		uint32 textureCoord1Offset = range.textureCoord1Offset;
+		uint32 smoothNormalOffset = range.smoothNormalOffset;
+		for (uint32 i = 0; i < (uint32)cooked.vertices.size(); i++)
+		{
+			const auto& vertex = cooked.vertices[i];
+			const uint32 vertexId = range.vertexOffset + i;
+
+			data.texcoords0[vertexId] = vertex.uv0;
+			data.positions[vertexId] = vertex.position;
+			data.normals[vertexId] = vertex.normal;
+			data.tangents[vertexId] = vertex.tangent;
+
+			if (cooked.optionalAttri.bColor0) { data.colors0[colors0Offset ++] = vertex.color0; }
+			if (cooked.optionalAttri.bUv1) { data.texcoords1[textureCoord1Offset ++] = vertex.uv1; }
+			if (cooked.optionalAttri.bSmoothNormal) { data.smoothNormals[smoothNormalOffset ++] = vertex.smoothNormal; }
+		}
+	}
+
+	bool importFromConfig(GLTFAssetImportConfigRef config, cookstats::Report* report)
 	{
 		const std::filesystem::path& srcPath = config->importFilePath;
 		const std::filesystem::path& savePath = config->storeFilePath;
@@ -308,22 +889,16 @@ namespace chord
 		const auto& meta         = GLTFAsset::kAssetTypeMeta;
 		const auto srcBaseDir    = srcPath.parent_path();
 
-		tinygltf::Model model;
+		// Buffers stay mapped and images encoded until primitives and textures cooked.
+		GLTFSource source;
+		const tinygltf::Model& model = source.getModel();
 		{
-			tinygltf::TinyGLTF tcontext;
+			cookstats::ScopedStage stage("gltf.parse", report);
+
 			std::string warning;
 			std::string error;
-
-			auto ext = srcPath.extension().string();
-			bool bSuccess = false;
-			if (ext == ".gltf")
-			{
-				bSuccess = tcontext.LoadASCIIFromFile(&model, &error, &warning, srcPath.string());
-			}
-			else if (ext == ".glb")
-			{
-				bSuccess = tcontext.LoadBinaryFromFile(&model, &error, &warning, srcPath.string());
-			}
+			const bool bSuccess = source.open(srcPath, error, warning);
+			stage.setBytes(source.getMappedSize());
 
 			if (!warning.empty()) { LOG_WARN("GLTF '{0} import exist some warnings: '{1}'.", utf8::utf16to8(srcPath.u16string()), warning); }
 			if (!error.empty()) { LOG_ERROR("GLTF '{0} import exist some errors: '{1}'.", utf8::utf16to8(srcPath.u16string()), error); }
@@ -358,10 +933,18 @@ namespace chord
 		}
 
 		// Import all images in gltf.
-		const auto importedImages = gltf::importMaterialUsedImages(srcPath, savePath, model);
+		std::unordered_map<int32, AssetSaveInfo> importedImages;
+		{
+			cookstats::ScopedStage stage("gltf.images", report);
+			importedImages = gltf::importMaterialUsedImages(srcPath, savePath, source, report);
+		}
 
 		// Import all materials.
-		const auto importedMaterials = gltf::importMaterials(srcPath, savePath, importedImages, model);
+		std::unordered_map<int32, AssetSaveInfo> importedMaterials;
+		{
+			cookstats::ScopedStage stage("gltf.materials", report);
+			importedMaterials = gltf::importMaterials(srcPath, savePath, importedImages, model);
+		}
 
 		GLTFAssetRef gltfPtr;
 		{
@@ -418,174 +1001,146 @@ namespace chord
 				gltfPtr->m_nodes.push_back(std::move(gltfNode));
 			}
 			
-			// Load all mesh data.
-			std::unordered_map<std::string, GLTFPrimitive> cachePrimMesh;
-			auto processMesh = [&](GLTFPrimitive& primitiveMesh, const tinygltf::Model& model, const tinygltf::Primitive& mesh, const std::string& name, bool bGenerateSmoothNormal)
+			// Flatten all primitives, first triangle primitive of each dedup key need cook.
+			struct PrimitiveTask
 			{
-				// Only triangles are supported
-				// 0:point, 1:lines, 2:line_loop, 3:line_strip, 4:triangles, 5:triangle_strip, 6:triangle_fan
-				if (mesh.mode != 4)
-				{
-					LOG_ERROR("Current GLTF mesh '{}' no triangle mesh, skip...", name);
-					return;
-				}
-
-				bool bPrimitiveCache = false;
+				const tinygltf::Primitive* primitive;
+				const std::string* name;
 				std::string key;
-				{
-					// Create a key made of the attributes, to see if the primitive was already
-					// processed. If it is, we will re-use the cache, but allow the material and
-					// indices to be different.
 
-					std::stringstream o;
-					for (auto& a : mesh.attributes)
-					{
-						o << a.first << a.second;
-					}
-					key = o.str();
+				// Hash of decoded content, also key of derived data cache.
+				ddc::Key contentKey { };
+				bool bContentKeyValid = false;
 
-					// Found a cache - will not need to append vertex
-					auto it = cachePrimMesh.find(key);
-					if (it != cachePrimMesh.end())
+				// Index of precooked result, -1 if primitive not precook.
+				int32 cookIndex = -1;
+			};
+			std::vector<PrimitiveTask> primitiveTasks;
+			std::vector<uint32> cookTaskIds;
+			{
+				for (const auto& mesh : model.meshes)
+				{
+					for (const auto& primitive : mesh.primitives)
 					{
-						bPrimitiveCache = true;
-
-						// Copy value.
-						primitiveMesh = it->second;
-
-						LOG_TRACE("Primitive '{0}' cache found same format which created by primitive '{1}', we reuse cache one to save memory.", name, primitiveMesh.name);
+						primitiveTasks.push_back({ &primitive, &mesh.name });
 					}
 				}
 
-				// Name and material can be special.
-				primitiveMesh.name = name;
-				if (mesh.material > -1)
+				// Content hash read all primitive bytes, run in parallel.
 				{
-					primitiveMesh.material = importedMaterials.at(mesh.material);
-				}
+					cookstats::ScopedStage stage("gltf.mesh.hash", report);
 
-				if (!bPrimitiveCache)
-				{
-					LoadMeshOptionalAttribute optionalAttri { };
-					std::vector<nanite::Vertex> rawVertices;
-					std::vector<uint32> rawIndices;
-					math::vec3 meshPosMin;
-					math::vec3 meshPosMax;
-					math::vec3 meshPosAvg;
-
-					bool bLoadResult = loadMesh(model, mesh, primitiveMesh.name, optionalAttri, bGenerateSmoothNormal, rawVertices, rawIndices, meshPosMin, meshPosMax, meshPosAvg);
-					if (!bLoadResult) { return; }
-
-					// Get vertex offset.
-					primitiveMesh.vertexOffset = gltfBin.primitiveData.positions.size();
-					primitiveMesh.lod0IndicesOffset = gltfBin.primitiveData.lod0Indices.size();
-
-					check(primitiveMesh.vertexOffset == gltfBin.primitiveData.normals.size());
-					check(primitiveMesh.vertexOffset == gltfBin.primitiveData.texcoords0.size());
-					check(primitiveMesh.vertexOffset == gltfBin.primitiveData.tangents.size());
-
-					// Optional attribute offset.
-					primitiveMesh.colors0Offset       = gltfBin.primitiveData.colors0.size();
-					primitiveMesh.textureCoord1Offset = gltfBin.primitiveData.texcoords1.size();
-					primitiveMesh.smoothNormalOffset  = gltfBin.primitiveData.smoothNormals.size();
-
-					// Meshlet offset.
-					primitiveMesh.meshletOffset = gltfBin.primitiveData.meshlets.size();
-					primitiveMesh.meshletGroupOffset = gltfBin.primitiveData.meshletGroups.size();
-					primitiveMesh.meshletGroupIndicesOffset = gltfBin.primitiveData.meshletGroupIndices.size();
-					primitiveMesh.bvhNodeOffset = gltfBin.primitiveData.bvhNodes.size();
-					primitiveMesh.meshletGroupCount = gltfBin.primitiveData.meshletGroups.size();
-
-					// Position min, max and average.
-					primitiveMesh.posMin = meshPosMin;
-					primitiveMesh.posMax = meshPosMax;
-					primitiveMesh.posAverage = meshPosAvg;
-
-
-
-					nanite::NaniteBuilder builder(
-						std::move(rawIndices), 
-						std::move(rawVertices), 
-						config->bFuse, 
-						config->bFuseIgnoreNormal, 
-						config->meshletConeWeight);
+					auto hashTask = [&](PrimitiveTask& task)
 					{
-						auto meshletCtx = builder.build();
-
-						primitiveMesh.bvhNodeCount = meshletCtx.bvhNodes[0].bvhNodeCount;
-						primitiveMesh.meshletGroupCount = meshletCtx.meshletGroups.size();
-
-						gltfBin.primitiveData.meshletGroups.insert(gltfBin.primitiveData.meshletGroups.end(), meshletCtx.meshletGroups.begin(), meshletCtx.meshletGroups.end());
-						gltfBin.primitiveData.meshletGroupIndices.insert(gltfBin.primitiveData.meshletGroupIndices.end(), meshletCtx.meshletGroupIndices.begin(), meshletCtx.meshletGroupIndices.end());
-						gltfBin.primitiveData.bvhNodes.insert(gltfBin.primitiveData.bvhNodes.end(), meshletCtx.bvhNodes.begin(), meshletCtx.bvhNodes.end());
-
-						for (const auto& meshlet : meshletCtx.meshlets)
+						if (task.primitive->mode == 4)
 						{
-							const auto dataOffset = gltfBin.primitiveData.meshletDatas.size();
+							task.bContentKeyValid = gltf_ddc::buildContentKey(source, *task.primitive, task.contentKey);
+						}
+					};
 
-							// Fill meshlet indices data.
+					if (sGLTFImportParallel && primitiveTasks.size() > 1)
+					{
+						jobsystem::parallelFor("GLTFHashPrimitive", EBusyWaitType::All, (uint32)primitiveTasks.size(), EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+						{
+							for (uint32 i = loopStart; i < loopEnd; i++)
 							{
-								for (auto i = 0; i < meshlet.info.vertex_count; ++i) 
-								{ 
-									gltfBin.primitiveData.meshletDatas.push_back(meshletCtx.vertices[meshlet.info.vertex_offset + i]);
-								}
-
-								for (auto i = 0; i < meshlet.info.triangle_count; ++i)
-								{ 
-									uint8 id0 = meshletCtx.triangles[meshlet.info.triangle_offset + i * 3 + 0];
-									uint8 id1 = meshletCtx.triangles[meshlet.info.triangle_offset + i * 3 + 1];
-									uint8 id2 = meshletCtx.triangles[meshlet.info.triangle_offset + i * 3 + 2];
-
-									uint32 idx = id0;
-									idx |= (uint32(id1) << 8);
-									idx |= (uint32(id2) << 16);
-
-									gltfBin.primitiveData.meshletDatas.push_back(idx);
-								}
+								hashTask(primitiveTasks[i]);
 							}
-
-							gltfBin.primitiveData.meshlets.push_back(meshlet.getGLTFMeshlet(dataOffset));
-						}
-
-						primitiveMesh.lod0meshletCount = 0;
-						for (const auto& meshlet : meshletCtx.meshlets)
+						});
+					}
+					else
+					{
+						for (auto& task : primitiveTasks)
 						{
-							if (meshlet.lod == 0) { primitiveMesh.lod0meshletCount ++; }
+							hashTask(task);
 						}
 					}
+				}
 
-					const std::vector<nanite::Vertex>& builderVertices = builder.getVertices();
-					const std::vector<uint32> lod0Indices = builder.getIndices();
+				std::unordered_set<std::string> cookKeys;
+				for (uint32 i = 0; i < (uint32)primitiveTasks.size(); i++)
+				{
+					auto& task = primitiveTasks[i];
+					if (task.primitive->mode != 4)
+					{
+						continue;
+					}
 
-					// 
-					primitiveMesh.vertexCount = builderVertices.size();
-					primitiveMesh.lod0IndicesCount = lod0Indices.size();
+					// Primitive content can't hash fallback to accessor ids.
+					task.key = (sGLTFImportDedupContent && task.bContentKeyValid)
+						? "content_" + task.contentKey.toString()
+						: "accessor_" + buildPrimitiveAttributeKey(*task.primitive);
 
-					// Fill exist state.
-					primitiveMesh.bColor0Exist = optionalAttri.bColor0;
-					primitiveMesh.bSmoothNormalExist = optionalAttri.bSmoothNormal;
-					primitiveMesh.bTextureCoord1Exist = optionalAttri.bUv1;
+					if (cookKeys.insert(task.key).second)
+					{
+						task.cookIndex = (int32)cookTaskIds.size();
+						cookTaskIds.push_back(i);
+					}
+				}
+			}
 
-					// Fill lod0 indices. (Used for voxelize, ray tracing or sdf generation, etc.)
-					gltfBin.primitiveData.lod0Indices.insert(gltfBin.primitiveData.lod0Indices.end(), lod0Indices.begin(), lod0Indices.end());
+			// Cook every primitive as independent job, each one own its meshlet container.
+			const auto cookBegin = std::chrono::high_resolution_clock::now();
+			std::vector<CookedPrimitive> cookedPrimitives(cookTaskIds.size());
+			std::vector<uint8> cookedResults(cookTaskIds.size(), 0);
+			{
+				struct CookContext
+				{
+					// Import report, cook jobs pass it to stages explicitly.
+					cookstats::Report* report;
+					const GLTFSource* source;
+					const GLTFAssetImportConfig* config;
+					const std::vector<PrimitiveTask>* tasks;
+					const std::vector<uint32>* taskIds;
+					std::vector<CookedPrimitive>* cooked;
+					std::vector<uint8>* results;
+				};
+				const CookContext ctx { report, &source, config.get(), &primitiveTasks, &cookTaskIds, &cookedPrimitives, &cookedResults };
 
-					// Insert back to binary data.
-					for (auto& vertex : builderVertices)
+				auto cookOne = [](const CookContext& ctx, uint32 index)
+				{
+					const auto& task = (*ctx.tasks)[(*ctx.taskIds)[index]];
+					const ddc::Key* contentKey = task.bContentKeyValid ? &task.contentKey : nullptr;
+					(*ctx.results)[index] = loadOrCookPrimitive(*ctx.source, *task.primitive, *task.name, *ctx.config, contentKey, (*ctx.cooked)[index], ctx.report) ? 1 : 0;
+				};
+
+				if (sGLTFImportParallel && cookTaskIds.size() > 1)
+				{
+					// Primitive cost vary a lot, one job per primitive balance better than range split.
+					FutureCollection futures;
+					for (uint32 i = 0; i < (uint32)cookTaskIds.size(); i++)
 					{
-						gltfBin.primitiveData.texcoords0.push_back(vertex.uv0);
-						gltfBin.primitiveData.positions.push_back(vertex.position);
-						gltfBin.primitiveData.normals.push_back(vertex.normal);
-						gltfBin.primitiveData.tangents.push_back(vertex.tangent);
-
-						if (primitiveMesh.bColor0Exist) { gltfBin.primitiveData.colors0.push_back(vertex.color0); }
-						if (primitiveMesh.bTextureCoord1Exist) { gltfBin.primitiveData.texcoords1.push_back(vertex.uv1); }
-						if (primitiveMesh.bSmoothNormalExist) { gltfBin.primitiveData.smoothNormals.push_back(vertex.smoothNormal); }
+						futures.add(jobsystem::launch("GLTFCookPrimitive", EJobFlags::Foreground, [&ctx, &cookOne, i]()
+						{
+							cookOne(ctx, i);
+						}));
 					}
-
-					cachePrimMesh[key] = primitiveMesh;
+					futures.wait(EBusyWaitType::All);
 				}
-			};
-
+				else
+				{
+					for (uint32 i = 0; i < (uint32)cookTaskIds.size(); i++)
+					{
+						cookOne(ctx, i);
+					}
+				}
+			}
+			const double cookSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - cookBegin).count();
+
+			// Serial pass in primitive order, same cache reuse as serial import and prefix sum binary offsets.
+			std::unordered_map<std::string, std::pair<GLTFPrimitive, const CookedPrimitive*>> cachePrimMesh;
+			std::vector<std::unique_ptr<CookedPrimitive>> fallbackCookedPrimitives;
+			std::vector<PrimitiveAppendRange> appendRanges;
+			PrimitiveAppendRange cursor { };
+
+			// Dedup primitives share range of first one, derived data cache hit skip cook.
+			uint32 dedupCount = 0;
+			uint64 dedupBytes = 0;
+			double dedupSeconds = 0.0;
+			uint32 cacheHitCount = 0;
+			double cacheHitSeconds = 0.0;
+
+			uint32 taskId = 0;
 			for (const auto& mesh : model.meshes)
 			{
 				GLTFMesh gltfMesh;
@@ -594,19 +1149,145 @@ namespace chord
 
 				for (const auto& primitive : mesh.primitives)
 				{
-					GLTFPrimitive gltfPrimitive;
-					processMesh(gltfPrimitive, model, primitive, mesh.name, config->bGenerateSmoothNormal);
+					const auto& task = primitiveTasks[taskId ++];
+					const std::string& name = mesh.name;
+
+					GLTFPrimitive primitiveMesh;
+
+					// Only triangles are supported
+					// 0:point, 1:lines, 2:line_loop, 3:line_strip, 4:triangles, 5:triangle_strip, 6:triangle_fan
+					if (primitive.mode != 4)
+					{
+						LOG_ERROR("Current GLTF mesh '{}' no triangle mesh, skip...", name);
+						gltfMesh.primitives.push_back(primitiveMesh);
+						continue;
+					}
+
+					// If cache found, will not need to append vertex, but allow the material and indices to be different.
+					bool bPrimitiveCache = false;
+					if (auto it = cachePrimMesh.find(task.key); it != cachePrimMesh.end())
+					{
+						bPrimitiveCache = true;
+
+						// Copy value.
+						primitiveMesh = it->second.first;
+
+						dedupCount++;
+						dedupBytes += getCookedPrimitiveBytes(*it->second.second);
+						dedupSeconds += it->second.second->cookSeconds;
+
+						LOG_TRACE("Primitive '{0}' cache found same format which created by primitive '{1}', we reuse cache one to save memory.", name, primitiveMesh.name);
+					}
+
+					// Name and material can be special.
+					primitiveMesh.name = name;
+					if (primitive.material > -1)
+					{
+						primitiveMesh.material = importedMaterials.at(primitive.material);
+					}
+
+					if (!bPrimitiveCache)
+					{
+						const CookedPrimitive* cooked = nullptr;
+						if (task.cookIndex >= 0)
+						{
+							cooked = cookedResults[task.cookIndex] ? &cookedPrimitives[task.cookIndex] : nullptr;
+						}
+						else
+						{
+							// Earlier primitive of same key fail to cook, serial import cook again here.
+							auto fallback = std::make_unique<CookedPrimitive>();
+							if (loadOrCookPrimitive(source, primitive, name, *config, task.bContentKeyValid ? &task.contentKey : nullptr, *fallback, report))
+							{
+								cooked = fallback.get();
+								fallbackCookedPrimitives.push_back(std::move(fallback));
+							}
+						}
+
+						if (cooked)
+						{
+							appendRanges.push_back(allocatePrimitiveRange(primitiveMesh, *cooked, cursor));
+							cachePrimMesh[task.key] = { primitiveMesh, cooked };
+
+							if (cooked->bCacheHit)
+							{
+								cacheHitCount++;
+								cacheHitSeconds += cooked->cookSeconds;
+							}
+						}
+					}
 
 					// Prepare gltf mesh.
-					gltfMesh.primitives.push_back(gltfPrimitive);
+					gltfMesh.primitives.push_back(primitiveMesh);
 				}
 
 				gltfPtr->m_meshes.push_back(std::move(gltfMesh));
 			}
+
+			// Copy all cooked primitives into gltf binary.
+			{
+				cookstats::ScopedStage stage("gltf.mesh.copy", report);
+
+				auto& data = gltfBin.primitiveData;
+				data.positions.resize(cursor.vertexOffset);
+				data.normals.resize(cursor.vertexOffset);
+				data.texcoords0.resize(cursor.vertexOffset);
+				data.tangents.resize(cursor.vertexOffset);
+				data.colors0.resize(cursor.colors0Offset);
+				data.texcoords1.resize(cursor.textureCoord1Offset);
+				data.smoothNormals.resize(cursor.smoothNormalOffset);
+				data.lod0Indices.resize(cursor.lod0IndicesOffset);
+				data.meshlets.resize(cursor.meshletOffset);
+				data.meshletDatas.resize(cursor.meshletDataOffset);
+				data.meshletGroups.resize(cursor.meshletGroupOffset);
+				data.meshletGroupIndices.resize(cursor.meshletGroupIndicesOffset);
+				data.bvhNodes.resize(cursor.bvhNodeOffset);
+				data.clusterPages.resize(cursor.clusterPageOffset);
+				data.clusterPageGroups.resize(cursor.clusterPageGroupOffset);
+				data.clusterPageDependencies.resize(cursor.clusterPageDependencyOffset);
+
+				if (sGLTFImportParallel && appendRanges.size() > 1)
+				{
+					jobsystem::parallelFor("GLTFCopyPrimitive", EBusyWaitType::All, (uint32)appendRanges.size(), EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+					{
+						for (uint32 i = loopStart; i < loopEnd; i++)
+						{
+							copyPrimitiveRange(appendRanges[i], gltfBin);
+						}
+					});
+				}
+				else
+				{
+					for (const auto& range : appendRanges)
+					{
+						copyPrimitiveRange(range, gltfBin);
+					}
+				}
+			}
+
+			LOG_INFO("GLTF '{}' cook {} primitives, {} unique, {} cook in {:.3f} s.",
+				assetNameUtf8, primitiveTasks.size(), cookTaskIds.size(), sGLTFImportParallel ? "parallel" : "serial", cookSeconds);
+			LOG_INFO("GLTF '{}' dedup {} primitives save {} KB and {:.3f} s build, {} derived data cache hits save {:.3f} s build.",
+				assetNameUtf8, dedupCount, dedupBytes / 1024, dedupSeconds, cacheHitCount, cacheHitSeconds);
 		}
 
+		if (sGLTFCompactValidate || sGLTFCompactStorage)
+		{
+			validateCompactEncoding(assetNameUtf8, gltfPtr->m_meshes, gltfBin, report);
+		}
+
+		cookstats::ScopedStage stage("gltf.save", report);
+
+		// Decoded size, upload always consume fp32 layout.
 		gltfPtr->m_gltfBinSize = gltfBin.primitiveData.size();
-		saveAsset(gltfBin, ECompressionMode::Lz4, gltfPtr->getBinPath(), false);
+		if (sGLTFCompactStorage)
+		{
+			gltfBin.saveCompact(gltfPtr->getBinPath(), gltfPtr->m_meshes, report);
+		}
+		else
+		{
+			gltfBin.save(gltfPtr->getBinPath(), report);
+		}
 
 		return gltfPtr->save();
 	}
@@ -633,7 +1314,10 @@ namespace chord
 			};
 			result.importConfig.importAssetFromConfig = [](IAssetImportConfigRef config)
 			{
-				return importFromConfig(std::static_pointer_cast<GLTFAssetImportConfig>(config));
+				return cookstats::importWithReport("gltf", config->importFilePath, config->storeFilePath, config->parentReport, [&config](cookstats::Report* report)
+				{
+					return importFromConfig(std::static_pointer_cast<GLTFAssetImportConfig>(config), report);
+				});
 			};
 		}
 
@@ -713,24 +1397,14 @@ namespace chord
 		graphics::BuiltinMeshRef result = std::make_shared<graphics::BuiltinMesh>();
 		result->meshTypeUniqueId = crc::crc32(loadPath.c_str(), loadPath.size(), 0);
 
-		tinygltf::Model model;
+		GLTFSource source;
+		const tinygltf::Model& model = source.getModel();
 		{
-			tinygltf::TinyGLTF tcontext;
 			std::string warning;
 			std::string error;
 
 			std::filesystem::path srcPath = loadPath;
-
-			auto ext = srcPath.extension().string();
-			bool bSuccess = false;
-			if (ext == ".gltf")
-			{
-				bSuccess = tcontext.LoadASCIIFromFile(&model, &error, &warning, srcPath.string());
-			}
-			else if (ext == ".glb")
-			{
-				bSuccess = tcontext.LoadBinaryFromFile(&model, &error, &warning, srcPath.string());
-			}
+			const bool bSuccess = source.open(srcPath, error, warning);
 
 			if (!warning.empty()) { LOG_WARN("GLTF '{0} import exist some warnings: '{1}'.", utf8::utf16to8(srcPath.u16string()), warning); }
 			if (!error.empty()) { LOG_ERROR("GLTF '{0} import exist some errors: '{1}'.", utf8::utf16to8(srcPath.u16string()), error); }
@@ -752,7 +1426,7 @@ namespace chord
 			math::vec3 meshPosMin;
 			math::vec3 meshPosMax;
 			math::vec3 meshPosAvg;
-			check(loadMesh(model, model.meshes[0].primitives[0], loadPath, optionalAttri, false, rawVertices, rawIndices, meshPosMin, meshPosMax, meshPosAvg));
+			check(loadMesh(source, model.meshes[0].primitives[0], loadPath, optionalAttri, false, rawVertices, rawIndices, meshPosMin, meshPosMax, meshPosAvg, nullptr));
 		}
 
 		using namespace graphics;
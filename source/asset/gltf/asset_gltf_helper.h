@@ -8,12 +8,25 @@
 
 namespace chord
 {
+	// Meshlet grouping graph partitioner of nanite build.
+	enum class EMeshletPartitioner
+	{
+		// METIS k-way, smallest group boundary but single thread.
+		Metis,
+
+		// Morton order of meshlet centers with greedy refine by shared edges, much faster on large meshes.
+		Spatial,
+
+		MAX,
+	};
+
 	struct GLTFAssetImportConfig : public IAssetImportConfig
 	{
 		bool bGenerateSmoothNormal = false;
 		bool bFuse = true;
 		bool bFuseIgnoreNormal = false;
 		float meshletConeWeight = 0.7f;
+		EMeshletPartitioner meshletPartitioner = EMeshletPartitioner::Metis;
 	};
 	using GLTFAssetImportConfigRef = std::shared_ptr<GLTFAssetImportConfig>;
 	class GLTFAsset;
@@ -3,7 +3,9 @@
 #include <asset/texture/asset_texture.h>
 #include <application/application.h>
 #include <asset/gltf/asset_gltf.h>
+#include <asset/gltf/gltf_source.h>
 #include <utils/job_system.h>
+#include <asset/cook_stats.h>
 
 namespace chord
 {
@@ -113,11 +115,22 @@ namespace chord
 		}
 	};
 
+	// File extension of embedded image mime type, texture import decode by content.
+	static const char* getEmbeddedImageExtension(const std::string& mimeType)
+	{
+		if (mimeType == "image/jpeg") { return ".jpg"; }
+		if (mimeType == "image/bmp")  { return ".bmp"; }
+		if (mimeType == "image/gif")  { return ".gif"; }
+		return ".png";
+	}
+
 	std::unordered_map<int32, AssetSaveInfo> gltf::importMaterialUsedImages(
 		const std::filesystem::path& srcPath,
 		const std::filesystem::path& savePath,
-		const tinygltf::Model& model)
+		const GLTFSource& source,
+		cookstats::Report* report)
 	{
+		const auto& model = source.getModel();
 		const auto& projectPaths = Project::get().getPath();
 		auto& assetManager = Application::get().getAssetManager();
 		const auto srcBaseDir = srcPath.parent_path();
@@ -365,6 +378,7 @@ namespace chord
 		}
 
 		std::filesystem::path tempCacheTextureFolder = std::filesystem::path(projectPaths.cachePath.u16()) / generateUUID();
+		std::filesystem::create_directories(tempCacheTextureFolder);
 
 		// Composition: run with async task.
 		std::unordered_map<int32, std::filesystem::path> compositedSaveImage;
@@ -373,6 +387,7 @@ namespace chord
 		jobsystem::parallelFor("Composition Textures", EBusyWaitType::All, model.images.size(), EJobFlags::Foreground, 
 			[&pendingCompositeImages = std::as_const(pendingCompositeImages),
 			&model = std::as_const(model),
+			&source,
 			&srcBaseDir = std::as_const(srcBaseDir),
 			&srgbImagesMap = std::as_const(srgbImagesMap),
 			&tempCacheTextureFolder = std::as_const(tempCacheTextureFolder),
@@ -390,8 +405,8 @@ namespace chord
 				const auto& pendingCompositions = pendingCompositeImages.at(i);
 				const auto& destImage = model.images[i];
 
-				std::vector<uint8> compositeMemory{ };
-				compositeMemory.resize(destImage.width * destImage.height * 4);
+				// Embedded image keep encoded after parse, decode here.
+				ImageLdr2D destLdr{ };
 				std::filesystem::path destUri;
 				{
 					std::string uriDecoded;
@@ -401,17 +416,26 @@ namespace chord
 
 					if (extension.empty())
 					{
-						memcpy(compositeMemory.data(), destImage.image.data(), compositeMemory.size());
+						const auto bytes = source.getImageBytes(i);
+						destLdr.fillFromMemory(bytes.data(), bytes.size());
 					}
 					else
 					{
-						ImageLdr2D ldr{ };
 						std::filesystem::path imgUri = srcBaseDir / destUri;
-						ldr.fillFromFile(imgUri.string());
-
-						memcpy(compositeMemory.data(), ldr.getPixels(), compositeMemory.size());
+						destLdr.fillFromFile(imgUri.string());
 					}
 				}
+
+				if (destLdr.isEmpty())
+				{
+					LOG_ERROR("Fail to decode image '{}' for composition, skip...", destImage.name);
+					continue;
+				}
+
+				const int32 destWidth = destLdr.getWidth();
+				const int32 destHeight = destLdr.getHeight();
+				std::vector<uint8> compositeMemory(destLdr.getPixels(), destLdr.getPixels() + destLdr.getSize());
+
 				std::string imgName = destUri.filename().string();
 
 				for (const auto& detail : pendingCompositions)
@@ -428,29 +452,33 @@ namespace chord
 					std::filesystem::path uri = std::filesystem::path(uriDecoded);
 					std::string extension = uri.extension().string();
 
-					std::unique_ptr<ImageLdr2D> imagePtr = nullptr;
-					const uint8* srcData = nullptr;
+					ImageLdr2D srcLdr{ };
 					if (extension.empty())
 					{
 						// Load from glb.
-						srcData = srcImage.image.data();
+						const auto bytes = source.getImageBytes(detail.srcImage);
+						srcLdr.fillFromMemory(bytes.data(), bytes.size());
 					}
 					else
 					{
-						imagePtr = std::make_unique<ImageLdr2D>();
 						std::filesystem::path imgUri = srcBaseDir / uri;
+						srcLdr.fillFromFile(imgUri.string());
+					}
 
-						imagePtr->fillFromFile(imgUri.string());
-						srcData = imagePtr->getPixels();
+					if (srcLdr.isEmpty())
+					{
+						LOG_ERROR("Fail to decode image '{}' for composition, skip...", srcImage.name);
+						continue;
 					}
+					const uint8* srcData = srcLdr.getPixels();
 
 					std::vector<uint8> sizeFitData{ };
-					if (srcImage.width != destImage.width || srcImage.height != destImage.height)
+					if (srcLdr.getWidth() != destWidth || srcLdr.getHeight() != destHeight)
 					{
-						sizeFitData.resize(destImage.width * destImage.height * 4);
+						sizeFitData.resize(destWidth * destHeight * 4);
 						stbir_resize_uint8(
-							srcData, srcImage.width, srcImage.height, 0,
-							sizeFitData.data(), destImage.width, destImage.height, 0, 4);
+							srcData, srcLdr.getWidth(), srcLdr.getHeight(), 0,
+							sizeFitData.data(), destWidth, destHeight, 0, 4);
 
 						srcData = sizeFitData.data();
 					}
@@ -471,8 +499,8 @@ namespace chord
 
 				// Save files.
 				std::filesystem::path tempSavedTexturesPath = tempCacheTextureFolder / imgName;
-				stbi_write_png(tempSavedTexturesPath.string().c_str(), destImage.width, destImage.height,
-					4, compositeMemory.data(), destImage.width * 4);
+				stbi_write_png(tempSavedTexturesPath.string().c_str(), destWidth, destHeight,
+					4, compositeMemory.data(), destWidth * 4);
 
 				{
 					std::lock_guard lock(compositedSaveImage_mutex);
@@ -482,9 +510,12 @@ namespace chord
 			}
 		});
 
+		// Texture import run on workers, texture report parent is gltf import report so stages roll up into it.
 		jobsystem::parallelFor("Blit texture", EBusyWaitType::All, model.images.size(), EJobFlags::Foreground, [
+			report,
 			&pendingCompositeImages = std::as_const(pendingCompositeImages),
 			&model = std::as_const(model),
+			&source,
 			&srcBaseDir = std::as_const(srcBaseDir),
 			&srgbImagesMap = std::as_const(srgbImagesMap),
 			&tempCacheTextureFolder = std::as_const(tempCacheTextureFolder),
@@ -540,22 +571,20 @@ namespace chord
 
 				if (extension.empty() && (!bCompositedSaved))
 				{
-					// Loaded from glb, first extract to png.
+					// Loaded from glb, extract encoded bytes and texture import decode them.
 					if (imgName.empty())
 					{
-						imgName = generateUUID() + ".png";
+						imgName = generateUUID() + getEmbeddedImageExtension(gltfImage.mimeType);
 					}
 					std::filesystem::path tempSavedTexturesPath = tempCacheTextureFolder / imgName;
 
-					int32 channelNum = gltfImage.component == -1 ? 4 : gltfImage.component;
-					if (gltfImage.bits != 8 && gltfImage.bits != -1)
+					const auto bytes = source.getImageBytes(imageIndex);
 					{
-						LOG_ERROR("Image '{0}' embed with bit {1} not support.", gltfImage.name, gltfImage.bits);
+						std::ofstream os(tempSavedTexturesPath, std::ios::binary | std::ios::trunc);
+						os.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
 					}
-					stbi_write_png(tempSavedTexturesPath.string().c_str(), gltfImage.width, gltfImage.height,
-						channelNum, gltfImage.image.data(), gltfImage.width * channelNum);
 
-					const bool b16Bit = (gltfImage.bits == 16);
+					const bool b16Bit = stbi_is_16_bit_from_memory(bytes.data(), int32(bytes.size()));
 					auto textureAssetImportConfig = std::make_shared<TextureAssetImportConfig>();
 
 					textureAssetImportConfig->importFilePath = tempSavedTexturesPath;
@@ -564,6 +593,7 @@ namespace chord
 					textureAssetImportConfig->bGenerateMipmap = true;
 					textureAssetImportConfig->alphaMipmapCutoff = bAlphaCoverage ? alphaCoverageImagesMap.at(imageIndex) : 1.0f;
 					textureAssetImportConfig->format = imageChannelUsageMap.at(imageIndex).getFormat(b16Bit);
+					textureAssetImportConfig->parentReport = report;
 
 					if (!TextureAsset::kAssetTypeMeta.importConfig.importAssetFromConfig(textureAssetImportConfig))
 					{
@@ -590,6 +620,7 @@ namespace chord
 					textureAssetImportConfig->bGenerateMipmap = true;
 					textureAssetImportConfig->alphaMipmapCutoff = bAlphaCoverage ? alphaCoverageImagesMap.at(imageIndex) : 1.0f;
 					textureAssetImportConfig->format = imageChannelUsageMap.at(imageIndex).getFormat(b16Bit);
+					textureAssetImportConfig->parentReport = report;
 
 					if (!TextureAsset::kAssetTypeMeta.importConfig.importAssetFromConfig(textureAssetImportConfig))
 					{
@@ -619,6 +650,7 @@ namespace chord
 				std::filesystem::remove(tempSavedCompositedImages[i]);
 			}
 		});
+		std::filesystem::remove_all(tempCacheTextureFolder);
 
 		// Skip image use it's composite image save info.
 		for (int32 imageIndex = 0; imageIndex < model.images.size(); imageIndex++)
@@ -731,9 +763,9 @@ namespace chord
 		return std::move(importedMaterials);
 	}
 
-	GLTFMaterialAssetRef chord::tryLoadGLTFMaterialAsset(const std::filesystem::path& path, bool bThreadSafe)
+	GLTFMaterialAssetRef chord::tryLoadGLTFMaterialAsset(const std::filesystem::path& path)
 	{
-		return Application::get().getAssetManager().getOrLoadAsset<GLTFMaterialAsset>(path, bThreadSafe);
+		return Application::get().getAssetManager().getOrLoadAsset<GLTFMaterialAsset>(path);
 	}
 
 }
\ No newline at end of file
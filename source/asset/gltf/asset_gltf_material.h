@@ -3,15 +3,23 @@
 #include <utils/utils.h>
 #include <asset/asset_common.h>
 
+namespace chord
+{
+	class GLTFSource;
+}
+
 namespace chord::gltf
 {
 	
 	extern bool isGLTFExtensionSupported(const std::string& name);
 
+	// Embedded images decode in parallel texture import, not when gltf parse.
+	// Texture import stages roll up into report of gltf import.
 	extern std::unordered_map<int32, AssetSaveInfo> importMaterialUsedImages(
 		const std::filesystem::path& srcPath,
 		const std::filesystem::path& savePath,
-		const tinygltf::Model& model);
+		const GLTFSource& source,
+		cookstats::Report* report);
 
 	extern std::unordered_map<int32, AssetSaveInfo> importMaterials(
 		const std::filesystem::path& srcPath,
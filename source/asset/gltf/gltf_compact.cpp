@@ -0,0 +1,196 @@
+#include <asset/gltf/gltf_compact.h>
+#include <asset/asset_binary_filter.h>
+#include <shader/gltf.h>
+
+#include <glm/gtc/packing.hpp>
+
+namespace chord
+{
+	namespace gltfcompact
+	{
+		constexpr float kQuantizeMax = 65535.0f;
+
+		static inline uint16 quantizeUnorm16(float v, float min, float extent)
+		{
+			const float t = extent > 0.0f ? (v - min) / extent : 0.0f;
+			return uint16(std::round(math::clamp(t, 0.0f, 1.0f) * kQuantizeMax));
+		}
+
+		static inline float dequantizeUnorm16(uint16 v, float min, float extent)
+		{
+			return min + float(v) * (1.0f / kQuantizeMax) * extent;
+		}
+
+		static inline float getAngleDegree(const math::vec3& a, const math::vec3& b)
+		{
+			const float la = math::length(a);
+			const float lb = math::length(b);
+			if (la <= 0.0f || lb <= 0.0f)
+			{
+				return 0.0f;
+			}
+			return math::degrees(std::acos(math::clamp(math::dot(a, b) / (la * lb), -1.0f, 1.0f)));
+		}
+
+		template<typename Func>
+		static void forEachPrimitive(const std::vector<GLTFMesh>& meshes, Func&& func)
+		{
+			for (const auto& mesh : meshes)
+			{
+				for (const auto& primitive : mesh.primitives)
+				{
+					func(primitive);
+				}
+			}
+		}
+	}
+
+	float gltfcompact::getPositionErrorBound(const GLTFPrimitive& primitive)
+	{
+		const math::vec3 extent = primitive.posMax - primitive.posMin;
+		return 0.5f * math::length(extent) / kQuantizeMax;
+	}
+
+	void gltfcompact::encode(const std::vector<GLTFMesh>& meshes, const GLTFBinary::PrimitiveDatas& in, PrimitiveDatas& out)
+	{
+		out.vertices.assign(in.positions.size(), Vertex{ });
+		forEachPrimitive(meshes, [&](const GLTFPrimitive& primitive)
+		{
+			const math::vec3 posMin = primitive.posMin;
+			const math::vec3 extent = primitive.posMax - primitive.posMin;
+
+			for (uint32 i = primitive.vertexOffset; i < primitive.vertexOffset + primitive.vertexCount; i++)
+			{
+				auto& vertex = out.vertices[i];
+				for (uint32 c = 0; c < 3; c++)
+				{
+					vertex.position[c] = quantizeUnorm16(in.positions[i][c], posMin[c], extent[c]);
+				}
+
+				assetbinary::encodeOctahedral(&in.normals[i].x, vertex.normal);
+				assetbinary::encodeOctahedral(&in.tangents[i].x, vertex.tangent);
+				vertex.tangentSign = in.tangents[i].w < 0.0f ? 1 : 0;
+
+				vertex.uv0[0] = math::packHalf1x16(in.texcoords0[i].x);
+				vertex.uv0[1] = math::packHalf1x16(in.texcoords0[i].y);
+			}
+		});
+
+		out.meshletVertices.clear();
+		out.meshletTriangles.clear();
+		for (const auto& meshlet : in.meshlets)
+		{
+			const uint32 vertexCount = unpackVertexCount(meshlet.data.vertexTriangleCount);
+			const uint32 triangleCount = unpackTriangleCount(meshlet.data.vertexTriangleCount);
+
+			const uint32* datas = in.meshletDatas.data() + meshlet.data.dataOffset;
+			out.meshletVertices.insert(out.meshletVertices.end(), datas, datas + vertexCount);
+
+			// Drop pad byte of packed triangle.
+			for (uint32 j = 0; j < triangleCount; j++)
+			{
+				const uint32 triangle = datas[vertexCount + j];
+				out.meshletTriangles.push_back(uint8(triangle));
+				out.meshletTriangles.push_back(uint8(triangle >> 8));
+				out.meshletTriangles.push_back(uint8(triangle >> 16));
+			}
+		}
+	}
+
+	bool gltfcompact::decode(const std::vector<GLTFMesh>& meshes, const std::vector<GLTFMeshlet>& meshlets, const PrimitiveDatas& in, GLTFBinary::PrimitiveDatas& out)
+	{
+		const uint64 vertexCount = in.vertices.size();
+		out.positions.assign(vertexCount, math::vec3(0.0f));
+		out.normals.assign(vertexCount, math::vec3(0.0f));
+		out.tangents.assign(vertexCount, math::vec4(0.0f));
+		out.texcoords0.assign(vertexCount, math::vec2(0.0f));
+
+		bool bResult = true;
+		forEachPrimitive(meshes, [&](const GLTFPrimitive& primitive)
+		{
+			if (uint64(primitive.vertexOffset) + primitive.vertexCount > vertexCount)
+			{
+				bResult = false;
+				return;
+			}
+
+			const math::vec3 posMin = primitive.posMin;
+			const math::vec3 extent = primitive.posMax - primitive.posMin;
+
+			for (uint32 i = primitive.vertexOffset; i < primitive.vertexOffset + primitive.vertexCount; i++)
+			{
+				const auto& vertex = in.vertices[i];
+				for (uint32 c = 0; c < 3; c++)
+				{
+					out.positions[i][c] = dequantizeUnorm16(vertex.position[c], posMin[c], extent[c]);
+				}
+
+				assetbinary::decodeOctahedral(vertex.normal, &out.normals[i].x);
+				assetbinary::decodeOctahedral(vertex.tangent, &out.tangents[i].x);
+				out.tangents[i].w = vertex.tangentSign ? -1.0f : 1.0f;
+
+				out.texcoords0[i].x = math::unpackHalf1x16(vertex.uv0[0]);
+				out.texcoords0[i].y = math::unpackHalf1x16(vertex.uv0[1]);
+			}
+		});
+
+		uint64 meshletDataCount = 0;
+		for (const auto& meshlet : meshlets)
+		{
+			const uint32 count = unpackVertexCount(meshlet.data.vertexTriangleCount) + unpackTriangleCount(meshlet.data.vertexTriangleCount);
+			meshletDataCount = math::max(meshletDataCount, uint64(meshlet.data.dataOffset) + count);
+		}
+		out.meshletDatas.assign(meshletDataCount, 0);
+
+		uint64 vertexCursor = 0;
+		uint64 triangleCursor = 0;
+		for (const auto& meshlet : meshlets)
+		{
+			const uint32 meshletVertexCount = unpackVertexCount(meshlet.data.vertexTriangleCount);
+			const uint32 triangleCount = unpackTriangleCount(meshlet.data.vertexTriangleCount);
+			if (vertexCursor + meshletVertexCount > in.meshletVertices.size() || (triangleCursor + triangleCount) * 3 > in.meshletTriangles.size())
+			{
+				return false;
+			}
+
+			uint32* datas = out.meshletDatas.data() + meshlet.data.dataOffset;
+			std::copy_n(in.meshletVertices.begin() + vertexCursor, meshletVertexCount, datas);
+			vertexCursor += meshletVertexCount;
+
+			for (uint32 j = 0; j < triangleCount; j++)
+			{
+				const uint8* triangle = in.meshletTriangles.data() + (triangleCursor + j) * 3;
+				datas[meshletVertexCount + j] = uint32(triangle[0]) | (uint32(triangle[1]) << 8) | (uint32(triangle[2]) << 16);
+			}
+			triangleCursor += triangleCount;
+		}
+
+		return bResult && (vertexCursor == in.meshletVertices.size()) && (triangleCursor * 3 == in.meshletTriangles.size());
+	}
+
+	gltfcompact::Error gltfcompact::measureError(const GLTFBinary::PrimitiveDatas& src, const GLTFBinary::PrimitiveDatas& decoded)
+	{
+		Error error { };
+		error.bMeshletDatasMatch = (src.meshletDatas == decoded.meshletDatas);
+
+		if (src.positions.size() != decoded.positions.size())
+		{
+			error.position = std::numeric_limits<float>::max();
+			return error;
+		}
+
+		for (uint64 i = 0; i < src.positions.size(); i++)
+		{
+			error.position = math::max(error.position, math::distance(src.positions[i], decoded.positions[i]));
+			error.normal   = math::max(error.normal, getAngleDegree(src.normals[i], decoded.normals[i]));
+
+			const bool bSignMatch = (src.tangents[i].w < 0.0f) == (decoded.tangents[i].w < 0.0f);
+			error.tangent = math::max(error.tangent, bSignMatch ? getAngleDegree(math::vec3(src.tangents[i]), math::vec3(decoded.tangents[i])) : 180.0f);
+
+			const math::vec2 uvDiff = math::abs(src.texcoords0[i] - decoded.texcoords0[i]);
+			error.uv0 = math::max(error.uv0, math::max(uvDiff.x, uvDiff.y));
+		}
+
+		return error;
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <asset/gltf/asset_gltf.h>
+
+namespace chord
+{
+	// Compact encoding of gltf primitive datas, less than half size of fp32 layout.
+	//   Position: unorm16 relative to primitive posMin/posMax.
+	//   Normal and tangent: octahedral snorm16, tangent w store as sign.
+	//   UV0: half float.
+	//   Meshlet triangle: 24 bit, three uint8 local indices without pad byte.
+	// Decode back to GLTFBinary::PrimitiveDatas layout, used to validate error or load bin saved by r.gltf.compact.storage.
+	namespace gltfcompact
+	{
+		struct Vertex
+		{
+			uint16 position[3];
+			uint16 tangentSign; // 1 when tangent w negative.
+			int16  normal[2];
+			int16  tangent[2];
+			uint16 uv0[2];
+		};
+		static_assert(sizeof(Vertex) == 20);
+
+		struct PrimitiveDatas
+		{
+			std::vector<Vertex> vertices;
+
+			// Meshlet datas split into vertex part and triangle part, both in meshlet order.
+			std::vector<uint32> meshletVertices;
+			std::vector<uint8>  meshletTriangles;
+
+			uint64 size() const
+			{
+				return vertices.size() * sizeof(Vertex) + meshletVertices.size() * sizeof(uint32) + meshletTriangles.size();
+			}
+
+			// Sections append after GLTFBinary sections in compact storage, never change order without bump schema.
+			template<typename Func>
+			void forEachSection(Func&& func)
+			{
+				func("compactVertices",         vertices,         EAssetBinaryFilter::MeshoptVertex);
+				func("compactMeshletVertices",  meshletVertices,  EAssetBinaryFilter::MeshoptIndexSequence);
+				func("compactMeshletTriangles", meshletTriangles, EAssetBinaryFilter::None);
+			}
+		};
+
+		struct Error
+		{
+			// Max distance in primitive local space.
+			float position = 0.0f;
+
+			// Max angle in degree.
+			float normal  = 0.0f;
+			float tangent = 0.0f;
+
+			float uv0 = 0.0f;
+
+			// Meshlet datas decode exactly or not.
+			bool bMeshletDatasMatch = true;
+		};
+
+		// Max position error of primitive, half quantization step of its bounds.
+		extern float getPositionErrorBound(const GLTFPrimitive& primitive);
+
+		// Encode required vertex attributes and meshlet datas, vertices outside any primitive keep zero.
+		extern void encode(const std::vector<GLTFMesh>& meshes, const GLTFBinary::PrimitiveDatas& in, PrimitiveDatas& out);
+
+		// Decode into positions, normals, tangents, texcoords0 and meshletDatas of out, meshlets is layout of meshlet datas.
+		extern bool decode(const std::vector<GLTFMesh>& meshes, const std::vector<GLTFMeshlet>& meshlets, const PrimitiveDatas& in, GLTFBinary::PrimitiveDatas& out);
+
+		// Compare decoded datas with source.
+		extern Error measureError(const GLTFBinary::PrimitiveDatas& src, const GLTFBinary::PrimitiveDatas& decoded);
+	}
+}
@@ -0,0 +1,602 @@
+#include <asset/gltf/gltf_source.h>
+#include <utils/cvar.h>
+
+namespace chord
+{
+	static uint32 sGLTFImportMapped = 1;
+	static AutoCVarRef cVarGLTFImportMapped(
+		"r.gltf.import.mapped",
+		sGLTFImportMapped,
+		"Memory map glb and external buffers when import gltf, or copy them into tinygltf model."
+	);
+
+	namespace gltf_source
+	{
+		// Four zero bytes, tinygltf not accept empty buffer.
+		static const char* kStubBufferUri = "data:application/octet-stream;base64,AAAAAA==";
+		constexpr uint32 kStubBufferSize = 4;
+
+		constexpr uint32 kGLBMagic     = 0x46546C67; // "glTF"
+		constexpr uint32 kGLBChunkJSON = 0x4E4F534A;
+		constexpr uint32 kGLBChunkBIN  = 0x004E4942;
+		constexpr uint64 kGLBHeaderSize = 20;
+
+		// Only data uri image keep its encoded bytes, others read from buffer view or file later.
+		static bool loadImageDeferred(tinygltf::Image* image, const int, std::string*, std::string*, int, int, const unsigned char* bytes, int size, void*)
+		{
+			if (image->uri.empty() && image->bufferView < 0)
+			{
+				image->image.assign(bytes, bytes + size);
+			}
+			return true;
+		}
+
+		static uint32 readUint32(const uint8* data)
+		{
+			uint32 value;
+			std::memcpy(&value, data, sizeof(value));
+			return value;
+		}
+
+		// Byte range of json value in source text.
+		struct JsonRange
+		{
+			uint64 begin = 0;
+			uint64 end = 0;
+		};
+
+		// Text replace of json source, empty range is insert.
+		struct JsonPatch
+		{
+			uint64 begin;
+			uint64 end;
+			std::string text;
+		};
+
+		static void skipJsonWhitespace(std::string_view text, uint64& pos)
+		{
+			while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\n' || text[pos] == '\r'))
+			{
+				pos++;
+			}
+		}
+
+		static bool skipJsonString(std::string_view text, uint64& pos)
+		{
+			for (pos++; pos < text.size(); pos++)
+			{
+				if (text[pos] == '\\')
+				{
+					pos++;
+				}
+				else if (text[pos] == '"')
+				{
+					pos++;
+					return true;
+				}
+			}
+			return false;
+		}
+
+		// Skip one value without build it, only locate members, tinygltf validate whole json later.
+		static bool skipJsonValue(std::string_view text, uint64& pos)
+		{
+			if (pos >= text.size())
+			{
+				return false;
+			}
+
+			if (text[pos] == '"')
+			{
+				return skipJsonString(text, pos);
+			}
+
+			if (text[pos] == '{' || text[pos] == '[')
+			{
+				uint64 depth = 0;
+				while (pos < text.size())
+				{
+					const char c = text[pos];
+					if (c == '"')
+					{
+						if (!skipJsonString(text, pos))
+						{
+							return false;
+						}
+						continue;
+					}
+
+					if (c == '{' || c == '[')
+					{
+						depth++;
+					}
+					else if ((c == '}' || c == ']') && --depth == 0)
+					{
+						pos++;
+						return true;
+					}
+					pos++;
+				}
+				return false;
+			}
+
+			// Number, true, false and null.
+			const uint64 begin = pos;
+			while (pos < text.size() && text[pos] != ',' && text[pos] != '}' && text[pos] != ']' && text[pos] != ' ' && text[pos] != '\t' && text[pos] != '\n' && text[pos] != '\r')
+			{
+				pos++;
+			}
+			return pos > begin;
+		}
+
+		// Value ranges of top level object members, key without escape only.
+		static bool findTopLevelMembers(std::string_view text, uint64& outObjectBegin, std::unordered_map<std::string_view, JsonRange>& outMembers)
+		{
+			uint64 pos = 0;
+			skipJsonWhitespace(text, pos);
+			if (pos >= text.size() || text[pos] != '{')
+			{
+				return false;
+			}
+			outObjectBegin = pos++;
+
+			skipJsonWhitespace(text, pos);
+			if (pos < text.size() && text[pos] == '}')
+			{
+				return true;
+			}
+
+			while (pos < text.size())
+			{
+				if (text[pos] != '"')
+				{
+					return false;
+				}
+
+				const uint64 keyBegin = pos + 1;
+				if (!skipJsonString(text, pos))
+				{
+					return false;
+				}
+				const std::string_view key = text.substr(keyBegin, pos - 1 - keyBegin);
+
+				skipJsonWhitespace(text, pos);
+				if (pos >= text.size() || text[pos] != ':')
+				{
+					return false;
+				}
+				pos++;
+
+				skipJsonWhitespace(text, pos);
+				JsonRange range { pos, pos };
+				if (!skipJsonValue(text, pos))
+				{
+					return false;
+				}
+				range.end = pos;
+				outMembers[key] = range;
+
+				skipJsonWhitespace(text, pos);
+				if (pos < text.size() && text[pos] == '}')
+				{
+					return true;
+				}
+				if (pos >= text.size() || text[pos] != ',')
+				{
+					return false;
+				}
+				pos++;
+				skipJsonWhitespace(text, pos);
+			}
+			return false;
+		}
+
+		static uint64 countJsonArrayElements(std::string_view text, const JsonRange& range)
+		{
+			uint64 pos = range.begin + 1;
+			skipJsonWhitespace(text, pos);
+			if (pos >= range.end || text[pos] == ']')
+			{
+				return 0;
+			}
+
+			uint64 count = 0;
+			while (pos < range.end && skipJsonValue(text, pos))
+			{
+				count++;
+				skipJsonWhitespace(text, pos);
+				if (pos >= range.end || text[pos] != ',')
+				{
+					break;
+				}
+				pos++;
+				skipJsonWhitespace(text, pos);
+			}
+			return count;
+		}
+	}
+
+	bool GLTFSource::open(const std::filesystem::path& path, std::string& outError, std::string& outWarning)
+	{
+		m_model = { };
+		m_mappedFiles.clear();
+		m_buffers.clear();
+
+		const auto ext = path.extension().string();
+		if (ext != ".gltf" && ext != ".glb")
+		{
+			outError = std::format("Unsupported gltf file extension '{}'.", ext);
+			return false;
+		}
+
+		if (sGLTFImportMapped)
+		{
+			return loadMapped(path, outError, outWarning);
+		}
+
+		tinygltf::TinyGLTF context;
+		context.SetImageLoader(gltf_source::loadImageDeferred, nullptr);
+
+		const bool bResult = (ext == ".glb")
+			? context.LoadBinaryFromFile(&m_model, &outError, &outWarning, path.string())
+			: context.LoadASCIIFromFile(&m_model, &outError, &outWarning, path.string());
+		if (!bResult)
+		{
+			return false;
+		}
+
+		for (const auto& buffer : m_model.buffers)
+		{
+			m_buffers.push_back(buffer.data);
+		}
+		return true;
+	}
+
+	// Locate top level members without build json, patch buffers to stub and redirect images to a dummy view,
+	// then tinygltf parse the whole json once. Redirect keep tinygltf from copying buffers or reading image files.
+	bool GLTFSource::loadMapped(const std::filesystem::path& path, std::string& outError, std::string& outWarning)
+	{
+		auto file = std::make_unique<MappedFile>();
+		if (!file->open(path))
+		{
+			outError = "Fail to map gltf file.";
+			return false;
+		}
+
+		const uint8* jsonData = file->data();
+		uint64 jsonSize = file->size();
+		std::span<const uint8> binChunk { };
+
+		if (path.extension() == ".glb")
+		{
+			const uint8* data = file->data();
+			const uint64 size = file->size();
+			if (size < gltf_source::kGLBHeaderSize || gltf_source::readUint32(data) != gltf_source::kGLBMagic || gltf_source::readUint32(data + 8) > size)
+			{
+				outError = "Invalid glb header.";
+				return false;
+			}
+
+			const uint64 length = gltf_source::readUint32(data + 8);
+			jsonSize = gltf_source::readUint32(data + 12);
+			jsonData = data + gltf_source::kGLBHeaderSize;
+			if (gltf_source::readUint32(data + 16) != gltf_source::kGLBChunkJSON || gltf_source::kGLBHeaderSize + jsonSize > length)
+			{
+				outError = "Invalid glb json chunk.";
+				return false;
+			}
+
+			// BIN chunk is optional.
+			const uint64 binOffset = gltf_source::kGLBHeaderSize + jsonSize;
+			if (binOffset + 8 <= length && gltf_source::readUint32(data + binOffset + 4) == gltf_source::kGLBChunkBIN)
+			{
+				const uint64 binSize = gltf_source::readUint32(data + binOffset);
+				if (binOffset + 8 + binSize > length)
+				{
+					outError = "Invalid glb BIN chunk.";
+					return false;
+				}
+				binChunk = { data + binOffset + 8, binSize };
+			}
+		}
+
+		// Only locate top level members, whole json parse once by tinygltf after patch.
+		const std::string_view jsonText((const char*)jsonData, jsonSize);
+		uint64 objectBegin = 0;
+		std::unordered_map<std::string_view, gltf_source::JsonRange> members;
+		if (!gltf_source::findTopLevelMembers(jsonText, objectBegin, members))
+		{
+			outError = "Invalid gltf json.";
+			return false;
+		}
+
+		// Small buffers and images arrays parse alone and write back as patch.
+		auto parseMember = [&](std::string_view name, nlohmann::json& out)
+		{
+			const auto iter = members.find(name);
+			if (iter == members.end())
+			{
+				out = nlohmann::json::array();
+				return true;
+			}
+
+			out = nlohmann::json::parse(jsonText.begin() + iter->second.begin, jsonText.begin() + iter->second.end, nullptr, false);
+			return !out.is_discarded() && out.is_array();
+		};
+
+		nlohmann::json buffers, images;
+		if (!parseMember("buffers", buffers) || !parseMember("images", images))
+		{
+			outError = "Invalid gltf json buffers or images.";
+			return false;
+		}
+
+		const auto baseDir = path.parent_path();
+		m_mappedFiles.push_back(std::move(file));
+
+		// Buffers of BIN chunk or external file use mapped bytes, data uri buffer still decode by tinygltf.
+		std::vector<std::span<const uint8>> mappedBuffers(buffers.size());
+		std::vector<uint8> bMappedBuffers(buffers.size(), 0);
+		for (uint64 i = 0; i < buffers.size(); i++)
+		{
+			auto& buffer = buffers[i];
+			if (!buffer.is_object())
+			{
+				continue;
+			}
+
+			const uint64 byteLength = buffer.value("byteLength", uint64(0));
+			const std::string uri = buffer.value("uri", std::string());
+			if (tinygltf::IsDataURI(uri))
+			{
+				continue;
+			}
+
+			if (uri.empty())
+			{
+				if (byteLength > binChunk.size())
+				{
+					outError = std::format("Buffer {} larger than glb BIN chunk.", i);
+					return false;
+				}
+				mappedBuffers[i] = binChunk.subspan(0, byteLength);
+			}
+			else
+			{
+				std::string decodedUri;
+				tinygltf::URIDecode(uri, &decodedUri, nullptr);
+
+				auto bufferFile = std::make_unique<MappedFile>();
+				if (!bufferFile->open(baseDir / utf8::utf8to16(decodedUri)) || bufferFile->size() < byteLength)
+				{
+					outError = std::format("Fail to map gltf buffer '{}'.", decodedUri);
+					return false;
+				}
+
+				mappedBuffers[i] = { bufferFile->data(), byteLength };
+				m_mappedFiles.push_back(std::move(bufferFile));
+			}
+
+			bMappedBuffers[i] = 1;
+			buffer["byteLength"] = gltf_source::kStubBufferSize;
+			buffer["uri"] = gltf_source::kStubBufferUri;
+		}
+
+		// Images of buffer view or external file point to dummy view when tinygltf parse, restore after.
+		struct ImageSource
+		{
+			bool bRedirect = false;
+			int32 bufferView = -1;
+			std::string uri;
+		};
+		std::vector<ImageSource> imageSources(images.size());
+
+		const auto bufferViewsIter = members.find("bufferViews");
+		const uint64 bufferViewCount = (bufferViewsIter != members.end()) ? gltf_source::countJsonArrayElements(jsonText, bufferViewsIter->second) : 0;
+		for (uint64 i = 0; i < images.size(); i++)
+		{
+			auto& image = images[i];
+			auto& source = imageSources[i];
+			if (!image.is_object())
+			{
+				continue;
+			}
+
+			if (image.contains("bufferView"))
+			{
+				source.bufferView = image["bufferView"].get<int32>();
+			}
+			else if (image.contains("uri") && !tinygltf::IsDataURI(image["uri"].get<std::string>()))
+			{
+				source.uri = image["uri"].get<std::string>();
+				image.erase("uri");
+			}
+			else
+			{
+				continue;
+			}
+
+			source.bRedirect = true;
+			image["bufferView"] = int32(bufferViewCount);
+		}
+
+		const bool bRedirectImages = std::ranges::any_of(imageSources, [](const ImageSource& source) { return source.bRedirect; });
+		if (bRedirectImages)
+		{
+			buffers.push_back({ { "byteLength", gltf_source::kStubBufferSize }, { "uri", gltf_source::kStubBufferUri } });
+		}
+
+		std::vector<gltf_source::JsonPatch> patches;
+		auto replaceMember = [&](std::string_view name, const nlohmann::json& value)
+		{
+			if (const auto iter = members.find(name); iter != members.end())
+			{
+				patches.push_back({ iter->second.begin, iter->second.end, value.dump() });
+			}
+			else
+			{
+				// Insert as first member, object not empty because images exist.
+				patches.push_back({ objectBegin + 1, objectBegin + 1, std::format("\"{}\":{},", name, value.dump()) });
+			}
+		};
+
+		if (std::ranges::any_of(bMappedBuffers, [](uint8 b) { return b != 0; }) || bRedirectImages)
+		{
+			replaceMember("buffers", buffers);
+		}
+
+		if (bRedirectImages)
+		{
+			replaceMember("images", images);
+
+			const nlohmann::json dummyView = { { "buffer", buffers.size() - 1 }, { "byteLength", gltf_source::kStubBufferSize } };
+			if (bufferViewsIter != members.end())
+			{
+				// Append before close bracket.
+				const uint64 closePos = bufferViewsIter->second.end - 1;
+				patches.push_back({ closePos, closePos, (bufferViewCount > 0 ? "," : "") + dummyView.dump() });
+			}
+			else
+			{
+				replaceMember("bufferViews", nlohmann::json::array({ dummyView }));
+			}
+		}
+
+		{
+			// Apply from back to front so earlier offsets stay valid.
+			std::string patchedJson;
+			if (!patches.empty())
+			{
+				std::ranges::sort(patches, [](const gltf_source::JsonPatch& a, const gltf_source::JsonPatch& b) { return a.begin > b.begin; });
+
+				patchedJson.assign(jsonText);
+				for (const auto& patch : patches)
+				{
+					patchedJson.replace(patch.begin, patch.end - patch.begin, patch.text);
+				}
+			}
+			const std::string_view parseJson = patches.empty() ? jsonText : std::string_view(patchedJson);
+
+			tinygltf::TinyGLTF context;
+			context.SetImageLoader(gltf_source::loadImageDeferred, nullptr);
+			if (!context.LoadASCIIFromString(&m_model, &outError, &outWarning, parseJson.data(), uint32(parseJson.size()), baseDir.string()))
+			{
+				return false;
+			}
+		}
+
+		if (bRedirectImages)
+		{
+			m_model.bufferViews.pop_back();
+			m_model.buffers.pop_back();
+		}
+
+		for (uint32 i = 0; i < (uint32)imageSources.size(); i++)
+		{
+			if (imageSources[i].bRedirect)
+			{
+				m_model.images[i].bufferView = imageSources[i].bufferView;
+				m_model.images[i].uri = std::move(imageSources[i].uri);
+			}
+		}
+
+		m_buffers.resize(m_model.buffers.size());
+		for (uint32 i = 0; i < (uint32)m_model.buffers.size(); i++)
+		{
+			if (i < bMappedBuffers.size() && bMappedBuffers[i])
+			{
+				m_buffers[i] = mappedBuffers[i];
+				m_model.buffers[i].data = { };
+			}
+			else
+			{
+				m_buffers[i] = m_model.buffers[i].data;
+			}
+		}
+
+		return true;
+	}
+
+	bool GLTFSource::getAccessor(int32 accessorId, GLTFAccessorView& out) const
+	{
+		if (accessorId < 0 || accessorId >= (int32)m_model.accessors.size())
+		{
+			return false;
+		}
+
+		const tinygltf::Accessor& accessor = m_model.accessors[accessorId];
+		if (accessor.sparse.isSparse)
+		{
+			return false;
+		}
+
+		const int32 componentSize = tinygltf::GetComponentSizeInBytes(accessor.componentType);
+		const int32 componentCount = tinygltf::GetNumComponentsInType(accessor.type);
+		const auto view = getBufferView(accessor.bufferView);
+		if (componentSize <= 0 || componentCount <= 0 || view.empty())
+		{
+			return false;
+		}
+
+		out.elementSize = uint32(componentSize * componentCount);
+		out.stride = m_model.bufferViews[accessor.bufferView].byteStride > 0 ? uint32(m_model.bufferViews[accessor.bufferView].byteStride) : out.elementSize;
+		out.count = accessor.count;
+
+		const uint64 byteSize = (out.count > 0) ? (out.count - 1) * out.stride + out.elementSize : 0;
+		if (accessor.byteOffset + byteSize > view.size())
+		{
+			return false;
+		}
+
+		out.data = view.data() + accessor.byteOffset;
+		return true;
+	}
+
+	std::span<const uint8> GLTFSource::getBufferView(int32 bufferViewId) const
+	{
+		if (bufferViewId < 0 || bufferViewId >= (int32)m_model.bufferViews.size())
+		{
+			return { };
+		}
+
+		const tinygltf::BufferView& view = m_model.bufferViews[bufferViewId];
+		if (view.buffer < 0 || view.buffer >= (int32)m_buffers.size())
+		{
+			return { };
+		}
+
+		const auto& buffer = m_buffers[view.buffer];
+		if (view.byteOffset + view.byteLength > buffer.size())
+		{
+			return { };
+		}
+
+		return buffer.subspan(view.byteOffset, view.byteLength);
+	}
+
+	std::span<const uint8> GLTFSource::getImageBytes(int32 imageId) const
+	{
+		const tinygltf::Image& image = m_model.images[imageId];
+		if (image.bufferView >= 0)
+		{
+			return getBufferView(image.bufferView);
+		}
+
+		if (image.uri.empty())
+		{
+			return image.image;
+		}
+
+		return { };
+	}
+
+	uint64 GLTFSource::getMappedSize() const
+	{
+		uint64 size = 0;
+		for (const auto& file : m_mappedFiles)
+		{
+			size += file->size();
+		}
+		return size;
+	}
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <utils/utils.h>
+#include <utils/mapped_file.h>
+
+namespace chord
+{
+	// Strided view of accessor elements, point into mapped file or buffer owned by source.
+	struct GLTFAccessorView
+	{
+		const uint8* data = nullptr;
+		uint64 count = 0;
+		uint32 stride = 0;
+		uint32 elementSize = 0;
+
+		template<typename T>
+		const T& get(uint64 index) const
+		{
+			return *reinterpret_cast<const T*>(data + index * stride);
+		}
+
+		bool isPacked() const
+		{
+			return stride == elementSize;
+		}
+	};
+
+	// GLTF source of one import, json parse by tinygltf and no buffer copy into tinygltf model:
+	//   GLB BIN chunk and external .bin files are memory mapped, model buffers only keep stub, read bytes by views.
+	//   Images never decode when open, embedded bytes keep encoded for texture import decode in parallel.
+	// r.gltf.import.mapped 0 load buffers by tinygltf as before, views point into model buffers.
+	class GLTFSource : NonCopyable
+	{
+	public:
+		bool open(const std::filesystem::path& path, std::string& outError, std::string& outWarning);
+
+		const tinygltf::Model& getModel() const
+		{
+			return m_model;
+		}
+
+		// Return false if accessor sparse, no buffer view or out of buffer range.
+		bool getAccessor(int32 accessorId, GLTFAccessorView& out) const;
+
+		// Empty if buffer view out of buffer range.
+		std::span<const uint8> getBufferView(int32 bufferViewId) const;
+
+		// Encoded bytes of image embed in buffer view or data uri, empty if image is external file.
+		std::span<const uint8> getImageBytes(int32 imageId) const;
+
+		// Bytes mapped from files, not hold in memory.
+		uint64 getMappedSize() const;
+
+	private:
+		bool loadMapped(const std::filesystem::path& path, std::string& outError, std::string& outWarning);
+
+	private:
+		tinygltf::Model m_model;
+
+		std::vector<std::unique_ptr<MappedFile>> m_mappedFiles;
+		std::vector<std::span<const uint8>> m_buffers;
+	};
+}
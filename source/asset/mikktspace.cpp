@@ -1532,6 +1532,8 @@ static void BuildNeighborsFast(STriInfo pTriInfos[], SEdge * pEdges, const int p
 			QuickSortEdges(pEdges, iL, iR, 1, uSeed);	// sort channel 1 which is i1
 		}
 	}
+	// last run has no following boundary, sort it too.
+	QuickSortEdges(pEdges, iCurStartIndex, iEntries-1, 1, uSeed);
 
 	// sub sort over f, which should be fast.
 	// this step is to remain compliant with BuildNeighborsSlow() when
@@ -1548,6 +1550,7 @@ static void BuildNeighborsFast(STriInfo pTriInfos[], SEdge * pEdges, const int p
 			QuickSortEdges(pEdges, iL, iR, 2, uSeed);	// sort channel 2 which is f
 		}
 	}
+	QuickSortEdges(pEdges, iCurStartIndex, iEntries-1, 2, uSeed);
 
 	// pair up, adjacent triangles
 	for (i=0; i<iEntries; i++)
@@ -4,6 +4,9 @@
 #include <shader/base.h>
 #include <utils/log.h>
 #include <utils/cityhash.h>
+#include <utils/cvar.h>
+#include <utils/job_system.h>
+#include <asset/cook_stats.h>
 
 #include <shader/instance_culling.hlsl>
 #include <asset/mikktspace.h>
@@ -11,6 +14,62 @@
 namespace chord::nanite
 { 
 
+static uint32 sNaniteBuildParallel = 1;
+static AutoCVarRef cVarNaniteBuildParallel(
+	"r.nanite.build.parallel",
+	sNaniteBuildParallel,
+	"Merge-simplify-split meshlet groups of one lod in parallel when nanite build, output is same as serial build."
+);
+
+static uint32 sNaniteBVHSAH = 1;
+static AutoCVarRef cVarNaniteBVHSAH(
+	"r.nanite.bvh.sah",
+	sNaniteBVHSAH,
+	"Build cluster group bvh with binned SAH, or with legacy longest axis median split."
+);
+
+static uint32 sNaniteBVHWidth = 8;
+static AutoCVarRef cVarNaniteBVHWidth(
+	"r.nanite.bvh.width",
+	sNaniteBVHWidth,
+	"Branching factor of binned SAH cluster group bvh, 4 or 8, max is kNaniteBVHLevelNodeCount."
+);
+
+static uint32 sNaniteStreamingThreshold = 0;
+static AutoCVarRef cVarNaniteStreamingThreshold(
+	"r.nanite.streaming.threshold",
+	sNaniteStreamingThreshold,
+	"Triangle count from which mesh import use bricked streaming nanite build, 0 meaning never (default), brick seams make its lod differ from in core build."
+);
+
+static uint32 sNaniteStreamingBrickTriangles = 1024 * 1024;
+static AutoCVarRef cVarNaniteStreamingBrickTriangles(
+	"r.nanite.streaming.brick",
+	sNaniteStreamingBrickTriangles,
+	"Target triangle count of one brick in streaming nanite build."
+);
+
+static uint32 sNaniteStreamingJobCount = 4;
+static AutoCVarRef cVarNaniteStreamingJobCount(
+	"r.nanite.streaming.jobs",
+	sNaniteStreamingJobCount,
+	"Max bricks build in parallel in streaming nanite build, bound peak memory."
+);
+
+static uint32 sNaniteBuildSortAdjacency = 1;
+static AutoCVarRef cVarNaniteBuildSortAdjacency(
+	"r.nanite.build.adjacency.sort",
+	sNaniteBuildSortAdjacency,
+	"Build meshlet adjacency for grouping by radix sort edges into CSR, or by legacy hash map."
+);
+
+static uint32 sNaniteFuseSort = 1;
+static AutoCVarRef cVarNaniteFuseSort(
+	"r.nanite.fuse.sort",
+	sNaniteFuseSort,
+	"Fuse vertices by parallel hash and radix sort, or by legacy serial hash map, output is same."
+);
+
 // Group-merge-simplify-split parameters.
 constexpr uint32 kMinNumMeshletPerGroup = 2;
 constexpr uint32 kMaxNumMeshletPerGroup = 4;
@@ -212,6 +271,211 @@ static void buildBVH(const MeshletContainer& ctx, ClusterParentErrorBVHTree::Nod
 	}
 }
 
+// Binned SAH bin count per axis.
+constexpr uint32 kBVHSAHBinCount = 16;
+
+// Subtree with more groups than this build on job system.
+constexpr uint32 kBVHParallelGroupCount = 256;
+
+struct BVHBuildRange
+{
+	std::vector<const ClusterGroup*> groups;
+
+	float3 minPos = float3( FLT_MAX);
+	float3 maxPos = float3(-FLT_MAX);
+
+	void add(const ClusterGroup* group)
+	{
+		minPos = math::min(minPos, group->parentPosCenter - group->parentError);
+		maxPos = math::max(maxPos, group->parentPosCenter + group->parentError);
+		groups.push_back(group);
+	}
+};
+
+static float getSurfaceArea(float3 minPos, float3 maxPos)
+{
+	const float3 extent = math::max(maxPos - minPos, float3(0.0f));
+	return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+}
+
+// Split range on the lowest cost binned SAH plane of group centers, fallback to median when centers degenerate.
+// Both output ranges never empty when input has more than one group.
+static void splitBinnedSAH(const BVHBuildRange& range, BVHBuildRange& outLeft, BVHBuildRange& outRight)
+{
+	float3 centerMin = float3( FLT_MAX);
+	float3 centerMax = float3(-FLT_MAX);
+	for (const auto* group : range.groups)
+	{
+		centerMin = math::min(centerMin, group->parentPosCenter);
+		centerMax = math::max(centerMax, group->parentPosCenter);
+	}
+
+	auto getBinIndex = [&](const ClusterGroup* group, uint32 axis)
+	{
+		const float scale = float(kBVHSAHBinCount) / (centerMax[axis] - centerMin[axis]);
+		return math::min(uint32((group->parentPosCenter[axis] - centerMin[axis]) * scale), kBVHSAHBinCount - 1);
+	};
+
+	float bestCost = FLT_MAX;
+	uint32 bestAxis = ~0U;
+	uint32 bestBin = 0;
+	for (uint32 axis = 0; axis < 3; axis++)
+	{
+		if (centerMax[axis] <= centerMin[axis])
+		{
+			continue;
+		}
+
+		struct Bin
+		{
+			float3 minPos = float3( FLT_MAX);
+			float3 maxPos = float3(-FLT_MAX);
+			uint32 count  = 0;
+		};
+
+		std::array<Bin, kBVHSAHBinCount> bins { };
+		for (const auto* group : range.groups)
+		{
+			auto& bin = bins[getBinIndex(group, axis)];
+			bin.minPos = math::min(bin.minPos, group->parentPosCenter - group->parentError);
+			bin.maxPos = math::max(bin.maxPos, group->parentPosCenter + group->parentError);
+			bin.count++;
+		}
+
+		// Right sweep, rightCosts[i] is cost of bins (i, kBVHSAHBinCount).
+		std::array<float, kBVHSAHBinCount> rightCosts { };
+		{
+			float3 minPos = float3( FLT_MAX);
+			float3 maxPos = float3(-FLT_MAX);
+			uint32 count = 0;
+			for (uint32 i = kBVHSAHBinCount - 1; i > 0; i--)
+			{
+				minPos = math::min(minPos, bins[i].minPos);
+				maxPos = math::max(maxPos, bins[i].maxPos);
+				count += bins[i].count;
+				rightCosts[i - 1] = count > 0 ? getSurfaceArea(minPos, maxPos) * count : FLT_MAX;
+			}
+		}
+
+		// Left sweep, plane after bin i.
+		float3 minPos = float3( FLT_MAX);
+		float3 maxPos = float3(-FLT_MAX);
+		uint32 count = 0;
+		for (uint32 i = 0; i < kBVHSAHBinCount - 1; i++)
+		{
+			minPos = math::min(minPos, bins[i].minPos);
+			maxPos = math::max(maxPos, bins[i].maxPos);
+			count += bins[i].count;
+
+			if (count == 0 || rightCosts[i] == FLT_MAX)
+			{
+				continue;
+			}
+
+			const float cost = getSurfaceArea(minPos, maxPos) * count + rightCosts[i];
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestBin = i;
+			}
+		}
+	}
+
+	if (bestAxis == ~0U)
+	{
+		// All centers same, split half.
+		const size_t half = range.groups.size() / 2;
+		for (size_t i = 0; i < range.groups.size(); i++)
+		{
+			(i < half ? outLeft : outRight).add(range.groups[i]);
+		}
+		return;
+	}
+
+	for (const auto* group : range.groups)
+	{
+		(getBinIndex(group, bestAxis) <= bestBin ? outLeft : outRight).add(group);
+	}
+}
+
+// Wide bvh node: keep open the largest child by binned SAH split until width children, then build children subtree in parallel.
+static void buildBVHSAHNode(ClusterParentErrorBVHTree::Node& node, std::vector<const ClusterGroup*>&& groups, uint32 width)
+{
+	if (groups.empty())
+	{
+		return;
+	}
+
+	// No enough node to split, build leaf.
+	if (groups.size() < width || (node.depth == (kNaniteMaxBVHLevelCount - 1)))
+	{
+		for (const auto* groupPtr : groups)
+		{
+			node.leaves.push_back(*groupPtr);
+		}
+		return;
+	}
+
+	std::vector<BVHBuildRange> childRanges(1);
+	for (const auto* groupPtr : groups)
+	{
+		childRanges[0].add(groupPtr);
+	}
+
+	while (childRanges.size() < width)
+	{
+		uint32 splitIndex = ~0U;
+		float maxArea = -1.0f;
+		for (uint32 i = 0; i < childRanges.size(); i++)
+		{
+			const float area = getSurfaceArea(childRanges[i].minPos, childRanges[i].maxPos);
+			if (childRanges[i].groups.size() > 1 && area > maxArea)
+			{
+				maxArea = area;
+				splitIndex = i;
+			}
+		}
+
+		if (splitIndex == ~0U)
+		{
+			break;
+		}
+
+		BVHBuildRange left { };
+		BVHBuildRange right { };
+		splitBinnedSAH(childRanges[splitIndex], left, right);
+
+		childRanges[splitIndex] = std::move(left);
+		childRanges.push_back(std::move(right));
+	}
+
+	FutureCollection futures { };
+	for (uint32 i = 0; i < childRanges.size(); i++)
+	{
+		auto& child = node.children[i];
+		child = std::make_unique<ClusterParentErrorBVHTree::Node>();
+		child->depth = node.depth + 1; // Depth add one.
+		child->minPos = childRanges[i].minPos;
+		child->maxPos = childRanges[i].maxPos;
+
+		auto* childPtr = child.get();
+		auto* rangePtr = &childRanges[i];
+		if (rangePtr->groups.size() >= kBVHParallelGroupCount)
+		{
+			futures.add(jobsystem::launch("NaniteBVH", EJobFlags::Foreground, [childPtr, rangePtr, width]()
+			{
+				buildBVHSAHNode(*childPtr, std::move(rangePtr->groups), width);
+			}));
+		}
+		else
+		{
+			buildBVHSAHNode(*childPtr, std::move(rangePtr->groups), width);
+		}
+	}
+	futures.wait(EBusyWaitType::All);
+}
+
 static void flattenBVH(
 	const MeshletContainer& ctx, 
 	ClusterParentErrorBVHTree::Node& root, 
@@ -297,9 +561,8 @@ static void flattenBVH(
 		{
 			auto& child = node->children[i];
 
-			const bool bChild0ValidState = node->children[0] != nullptr;
-			const bool bCurrentStateValid = child != nullptr;
-			check(bChild0ValidState == bCurrentStateValid);
+			// Valid children always packed at front, narrow bvh leave tail invalid.
+			check(child == nullptr || i == 0 || node->children[i - 1] != nullptr);
 
 			if (child)
 			{
@@ -402,7 +665,15 @@ static void buildBVHTree(
 			clusterGroupInBounds[i] = &parentValidMeshlet[i];
 		}
 
-		buildBVH(ctx, *bvh.root, std::move(clusterGroupInBounds));
+		if (sNaniteBVHSAH)
+		{
+			const uint32 width = math::clamp(sNaniteBVHWidth, 2U, uint32(kNaniteBVHLevelNodeCount));
+			buildBVHSAHNode(*bvh.root, std::move(clusterGroupInBounds), width);
+		}
+		else
+		{
+			buildBVH(ctx, *bvh.root, std::move(clusterGroupInBounds));
+		}
 	}
 	
 	// 2. Flatten bvh.
@@ -581,19 +852,11 @@ uint32 hashPosition(float3 pos, float posFuseThreshold)
 #endif
 }
 
-static bool buildClusterGroup(const MeshletContainer& ctx, std::vector<ConbimeMeshlets>& outGroup, const std::vector<Vertex>& vertices, float posFuseThreshold)
+// Hash map based adjacency build, only keep for benchmark compare.
+static void buildClusterAdjacencyHashMap(const MeshletContainer& ctx, ClusterAdjacency& out, const std::vector<Vertex>& vertices, float posFuseThreshold)
 {
 	const auto& meshlets = ctx.meshlets;
 
-	if (meshlets.size() < kMinNumMeshletPerGroup)
-	{
-		// No enough meshlet count to group-simplify-split, just return one group.
-		outGroup = buildOneClusterGroup(ctx);
-		return false;
-	}
-
-	const uint32 groupMeshletCount = math::min(uint32(meshlets.size()) / kMinNumMeshletPerGroup, kMaxNumMeshletPerGroup);
-
 	std::unordered_map<MeshletEdge,  std::unordered_set<MeshletIndex>, MeshletEdge::Hash>  edges2Meshlets;
 	std::unordered_map<MeshletIndex, std::unordered_set<MeshletEdge,   MeshletEdge::Hash>> meshlets2Edges;
 	{
@@ -626,67 +889,235 @@ static bool buildClusterGroup(const MeshletContainer& ctx, std::vector<ConbimeMe
 	// Remove edges which are not connected to 2 different meshlets.
 	std::erase_if(edges2Meshlets, [&](const auto& pair) { return pair.second.size() <= 1; });
 
-	if (edges2Meshlets.empty()) 
+	auto& xadjacency = out.xadjacency;
+	auto& edgeAdjacency = out.edgeAdjacency;
+	auto& edgeWeights = out.edgeWeights;
+
+	xadjacency.reserve(meshlets.size() + 1);
+	for (MeshletIndex meshletIndex = 0; meshletIndex < meshlets.size(); meshletIndex++) 
 	{
-		// No connected meshlet exist, return one group.
-		outGroup = buildOneClusterGroup(ctx);
-		return false;
+		size_t edgeAdjOffset = edgeAdjacency.size();
+		xadjacency.push_back(edgeAdjOffset);
+
+		for (const auto& edge : meshlets2Edges[meshletIndex]) 
+		{
+			auto connectionsIter = edges2Meshlets.find(edge);
+			if (connectionsIter == edges2Meshlets.end()) 
+			{
+				// This edge no connected any meshlet.
+				continue;
+			}
+
+			const auto& connections = connectionsIter->second;
+			for (const auto& connectedMeshlet : connections) 
+			{
+				// Only use other meshlet.
+				if (connectedMeshlet != meshletIndex) 
+				{
+					auto existingEdgeIter = std::find(edgeAdjacency.begin() + edgeAdjOffset, edgeAdjacency.end(), connectedMeshlet);
+					if (existingEdgeIter == edgeAdjacency.end())
+					{
+						checkMsgf(edgeAdjacency.size() == edgeWeights.size(),
+							"edgeWeights and edgeAdjacency must have the same length.");
+
+						edgeAdjacency.push_back(connectedMeshlet);
+						edgeWeights.push_back(1);
+					}
+					else 
+					{
+						std::ptrdiff_t d = existingEdgeIter - edgeAdjacency.begin();
+						checkMsgf(d >= 0 && d < edgeWeights.size(), 
+							"edgeWeights and edgeAdjacency do not have the same length.");
+
+						// More than one meshlet conneted, edge weight plus.
+						edgeWeights[d]++;
+					}
+				}
+			}
+		}
+	}
+	xadjacency.push_back(edgeAdjacency.size());
+}
+
+// Stable LSD radix sort by 64 bit key, 8 bit digit per pass, pass skipped when all items share the digit.
+template<typename T, typename KeyFunc>
+static void radixSort64(std::vector<T>& items, KeyFunc&& getKey)
+{
+	std::vector<T> sorted(items.size());
+	for (uint32 shift = 0; shift < 64; shift += 8)
+	{
+		std::array<size_t, 256> offsets { };
+		for (const auto& item : items)
+		{
+			offsets[(getKey(item) >> shift) & 0xFF]++;
+		}
+
+		if (std::find(offsets.begin(), offsets.end(), items.size()) != offsets.end())
+		{
+			continue;
+		}
+
+		size_t sum = 0;
+		for (auto& offset : offsets)
+		{
+			const size_t count = offset;
+			offset = sum;
+			sum += count;
+		}
+
+		for (const auto& item : items)
+		{
+			sorted[offsets[(getKey(item) >> shift) & 0xFF]++] = item;
+		}
+		items.swap(sorted);
 	}
+}
+
+// Sort based adjacency build:
+// 1. Generate (edge key, meshlet) pairs of all triangle edges in parallel, each meshlet write its own range.
+// 2. Radix sort by edge key, pairs of same edge become one run with meshlet ascending.
+// 3. Each run shared by different meshlets emit (meshlet, neighbor) links, radix sort links and scan runs into CSR.
+static void buildClusterAdjacencySort(const MeshletContainer& ctx, ClusterAdjacency& out, const std::vector<Vertex>& vertices, float posFuseThreshold)
+{
+	const auto& meshlets = ctx.meshlets;
+	const uint32 meshletCount = (uint32)meshlets.size();
 
-	// Metis group partition.
+	struct EdgeMeshlet
 	{
-		// Vertex count, from the point of view of METIS, where Meshlet = vertex
-		idx_t vertexCount = meshlets.size();
+		uint64 edgeKey;
+		MeshletIndex meshletIndex;
+	};
 
-		std::vector<idx_t> xadjacency;
-		xadjacency.reserve(vertexCount + 1);
+	std::vector<size_t> edgeOffsets(meshletCount + 1);
+	for (MeshletIndex meshletIndex = 0; meshletIndex < meshletCount; meshletIndex++)
+	{
+		edgeOffsets[meshletIndex + 1] = edgeOffsets[meshletIndex] + meshlets[meshletIndex].info.triangle_count * 3;
+	}
 
-		std::vector<idx_t> edgeAdjacency { };
-		std::vector<idx_t> edgeWeights { };
-		for (MeshletIndex meshletIndex = 0; meshletIndex < meshlets.size(); meshletIndex++) 
+	std::vector<EdgeMeshlet> edgeMeshlets(edgeOffsets.back());
+	jobsystem::parallelFor("NaniteClusterEdges", EBusyWaitType::All, meshletCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+	{
+		std::array<uint32, 256> positionHashes;
+		for (MeshletIndex meshletIndex = loopStart; meshletIndex < loopEnd; meshletIndex++)
 		{
-			size_t edgeAdjOffset = edgeAdjacency.size();
-			xadjacency.push_back(edgeAdjOffset);
+			const auto& meshletInfo = meshlets[meshletIndex].info;
+
+			// Hash once per meshlet vertex, triangles index local vertices.
+			for (uint32 i = 0; i < meshletInfo.vertex_count; i++)
+			{
+				positionHashes[i] = hashPosition(vertices[ctx.vertices[meshletInfo.vertex_offset + i]].position, posFuseThreshold);
+			}
 
-			for (const auto& edge : meshlets2Edges[meshletIndex]) 
+			const uint8* triangles = &ctx.triangles[meshletInfo.triangle_offset];
+			EdgeMeshlet* dest = &edgeMeshlets[edgeOffsets[meshletIndex]];
+			for (uint32 triangleIndex = 0; triangleIndex < meshletInfo.triangle_count; triangleIndex++)
 			{
-				auto connectionsIter = edges2Meshlets.find(edge);
-				if (connectionsIter == edges2Meshlets.end()) 
+				for (uint32 i = 0; i < 3; i++) // 0-1 1-2 2-0
 				{
-					// This edge no connected any meshlet.
-					continue;
+					const uint32 h0 = positionHashes[triangles[triangleIndex * 3 + i]];
+					const uint32 h1 = positionHashes[triangles[triangleIndex * 3 + (i + 1) % 3]];
+
+					*dest++ = { MeshletEdge::Hash()(MeshletEdge(h0, h1)), meshletIndex };
 				}
+			}
+		}
+	});
 
-				const auto& connections = connectionsIter->second;
-				for (const auto& connectedMeshlet : connections) 
-				{
-					// Only use other meshlet.
-					if (connectedMeshlet != meshletIndex) 
-					{
-						auto existingEdgeIter = std::find(edgeAdjacency.begin() + edgeAdjOffset, edgeAdjacency.end(), connectedMeshlet);
-						if (existingEdgeIter == edgeAdjacency.end())
-						{
-							checkMsgf(edgeAdjacency.size() == edgeWeights.size(),
-								"edgeWeights and edgeAdjacency must have the same length.");
+	// Pairs generate in meshlet order, stable sort keep meshlet ascending inside each edge run.
+	radixSort64(edgeMeshlets, [](const EdgeMeshlet& e) { return e.edgeKey; });
 
-							edgeAdjacency.push_back(connectedMeshlet);
-							edgeWeights.push_back(1);
-						}
-						else 
-						{
-							std::ptrdiff_t d = existingEdgeIter - edgeAdjacency.begin();
-							checkMsgf(d >= 0 && d < edgeWeights.size(), 
-								"edgeWeights and edgeAdjacency do not have the same length.");
+	// Link key is (meshlet << 32 | neighbor).
+	std::vector<uint64> links;
+	std::vector<MeshletIndex> runMeshlets;
+	for (size_t runStart = 0; runStart < edgeMeshlets.size();)
+	{
+		const uint64 edgeKey = edgeMeshlets[runStart].edgeKey;
 
-							// More than one meshlet conneted, edge weight plus.
-							edgeWeights[d]++;
-						}
-					}
+		runMeshlets.clear();
+		size_t runEnd = runStart;
+		for (; runEnd < edgeMeshlets.size() && edgeMeshlets[runEnd].edgeKey == edgeKey; runEnd++)
+		{
+			const MeshletIndex meshletIndex = edgeMeshlets[runEnd].meshletIndex;
+			if (runMeshlets.empty() || runMeshlets.back() != meshletIndex)
+			{
+				runMeshlets.push_back(meshletIndex);
+			}
+		}
+		runStart = runEnd;
+
+		// Edges only used by one meshlet no connect anything.
+		if (runMeshlets.size() <= 1)
+		{
+			continue;
+		}
+
+		for (MeshletIndex a : runMeshlets)
+		{
+			for (MeshletIndex b : runMeshlets)
+			{
+				if (a != b)
+				{
+					links.push_back((uint64(a) << 32) | uint64(b));
 				}
 			}
 		}
-		xadjacency.push_back(edgeAdjacency.size());
-		checkMsgf(xadjacency.size() == vertexCount + 1, "unexpected count of vertices for METIS graph.");
+	}
+
+	radixSort64(links, [](uint64 link) { return link; });
+
+	// Scan link runs into CSR, run length is edge weight.
+	out.xadjacency.assign(meshletCount + 1, 0);
+	out.edgeAdjacency.clear();
+	out.edgeWeights.clear();
+	for (size_t runStart = 0; runStart < links.size();)
+	{
+		size_t runEnd = runStart + 1;
+		while (runEnd < links.size() && links[runEnd] == links[runStart])
+		{
+			runEnd++;
+		}
+
+		out.xadjacency[(links[runStart] >> 32) + 1]++;
+		out.edgeAdjacency.push_back(idx_t(links[runStart] & 0xFFFFFFFF));
+		out.edgeWeights.push_back(idx_t(runEnd - runStart));
+
+		runStart = runEnd;
+	}
+
+	for (uint32 i = 0; i < meshletCount; i++)
+	{
+		out.xadjacency[i + 1] += out.xadjacency[i];
+	}
+}
+
+void buildClusterAdjacency(const MeshletContainer& ctx, const std::vector<Vertex>& vertices, float posFuseThreshold, ClusterAdjacency& out)
+{
+	if (sNaniteBuildSortAdjacency)
+	{
+		buildClusterAdjacencySort(ctx, out, vertices, posFuseThreshold);
+	}
+	else
+	{
+		buildClusterAdjacencyHashMap(ctx, out, vertices, posFuseThreshold);
+	}
+}
+
+// Meshlet graph partitioner, split meshlets into partCount groups and keep shared edge cut small.
+class IMeshletPartitioner
+{
+public:
+	virtual ~IMeshletPartitioner() = default;
+
+	virtual void partition(const MeshletContainer& ctx, ClusterAdjacency& adjacency, uint32 partCount, std::vector<idx_t>& outPartition) const = 0;
+};
+
+class MetisMeshletPartitioner final : public IMeshletPartitioner
+{
+public:
+	virtual void partition(const MeshletContainer& ctx, ClusterAdjacency& adjacency, uint32 partCount, std::vector<idx_t>& outPartition) const override
+	{
+		// Vertex count, from the point of view of METIS, where Meshlet = vertex
+		idx_t vertexCount = ctx.meshlets.size();
 
 		idx_t options[METIS_NOPTIONS];
 		METIS_SetDefaultOptions(options);
@@ -696,82 +1127,272 @@ static bool buildClusterGroup(const MeshletContainer& ctx, std::vector<ConbimeMe
 
 		idx_t edgeCut;
 		idx_t ncon = 1;
-		idx_t nparts = meshlets.size() / groupMeshletCount;
-		std::vector<idx_t> partition(vertexCount);
+		idx_t nparts = partCount;
+		outPartition.resize(vertexCount);
 		int metisPartResult = METIS_PartGraphKway(&vertexCount,
 			&ncon,
-			xadjacency.data(),
-			edgeAdjacency.data(),
+			adjacency.xadjacency.data(),
+			adjacency.edgeAdjacency.data(),
 			nullptr, /* vertex weights */
 			nullptr, /* vertex size */
-			edgeWeights.data(),
+			adjacency.edgeWeights.data(),
 			&nparts,
 			nullptr,
 			nullptr,
 			options,
 			&edgeCut,
-			partition.data()
+			outPartition.data()
 		);
 		checkMsgf(metisPartResult == METIS_OK, "Graph partitioning failed!");
-
-		outGroup.resize(nparts);
-		for (std::size_t i = 0; i < meshlets.size(); i++) 
-		{
-			idx_t partitionNumber = partition[i];
-			outGroup[partitionNumber].push_back(i);
-		}
 	}
+};
 
-	return true;
-}
-
-static bool isLooseGeometry(const std::vector<uint32>& indices, const std::vector<Vertex>& vertices)
+// Order meshlets along morton curve of their centers and cut into consecutive groups,
+// then greedy move boundary meshlets to the neighbor group they share most edge weight with.
+class SpatialMeshletPartitioner final : public IMeshletPartitioner
 {
-	std::unordered_map<MeshletEdge, uint32, MeshletEdge::Hash> edgeUsedCount;
+public:
+	static constexpr uint32 kRefinePassCount = 4;
 
-	const uint triangleCount = indices.size() / 3;
-	for (uint triangleId = 0; triangleId < triangleCount; triangleId++) // Loop all triangle.
+	virtual void partition(const MeshletContainer& ctx, ClusterAdjacency& adjacency, uint32 partCount, std::vector<idx_t>& outPartition) const override
 	{
-		for (uint i = 0; i < 3; i++) // Loop all edge.
+		const auto& meshlets = ctx.meshlets;
+		const uint32 meshletCount = (uint32)meshlets.size();
+
+		float3 centerMin = math::vec3( FLT_MAX);
+		float3 centerMax = math::vec3(-FLT_MAX);
+		for (const auto& meshlet : meshlets)
 		{
-			uint32 v0 = indices[triangleId * 3 + i];
-			uint32 v1 = indices[triangleId * 3 + (i + 1) % 3];
+			const float3 center = 0.5f * (meshlet.posMin + meshlet.posMax);
+			centerMin = math::min(centerMin, center);
+			centerMax = math::max(centerMax, center);
+		}
+		const float3 centerExtent = math::max(centerMax - centerMin, math::vec3(FLT_MIN));
 
-			MeshletEdge edge(v0, v1);
-			edgeUsedCount[edge]++;
+		// Key is (morton code << 32 | meshlet index), meshlet index break tie keep order stable.
+		std::vector<uint64> orderKeys(meshletCount);
+		for (uint32 i = 0; i < meshletCount; i++)
+		{
+			const float3 center = 0.5f * (meshlets[i].posMin + meshlets[i].posMax);
+			const math::uvec3 quantized = math::uvec3(math::clamp((center - centerMin) / centerExtent, 0.0f, 1.0f) * 1023.0f);
+			orderKeys[i] = (uint64(expandBits(quantized.x) | (expandBits(quantized.y) << 1) | (expandBits(quantized.z) << 2)) << 32) | i;
 		}
-	}
+		std::sort(orderKeys.begin(), orderKeys.end());
 
-	uint32 edgeBorderCount = 0;
-	for (const auto& pair : edgeUsedCount)
-	{
-		if (pair.second == 1) // is edge.
+		// Consecutive cut, part size differ at most one.
+		outPartition.resize(meshletCount);
+		std::vector<uint32> partSizes(partCount, 0);
+		for (uint32 order = 0; order < meshletCount; order++)
 		{
-			edgeBorderCount++;
+			const uint32 part = uint32(uint64(order) * partCount / meshletCount);
+			outPartition[orderKeys[order] & 0xFFFFFFFF] = part;
+			partSizes[part]++;
 		}
-	}
 
-	if (edgeBorderCount == edgeUsedCount.size())
-	{
-		return true;
-	}
+		// Small slack so greedy move can happen, but keep groups balanced like METIS.
+		const uint32 maxPartSize = divideRoundingUp(meshletCount, partCount) + 1;
 
-	return false;
-}
+		std::vector<idx_t> neighborWeights(partCount, 0);
+		std::vector<idx_t> touchedParts;
+		for (uint32 pass = 0; pass < kRefinePassCount; pass++)
+		{
+			uint32 moveCount = 0;
+			for (uint32 i = 0; i < meshletCount; i++)
+			{
+				const idx_t currentPart = outPartition[i];
+				if (partSizes[currentPart] <= 1)
+				{
+					continue;
+				}
 
-// Input one lod level meshlet container, do Group-Merge-Simplify-Split operation.
-// Return true if success, return false if stop.
+				touchedParts.clear();
+				for (idx_t e = adjacency.xadjacency[i]; e < adjacency.xadjacency[i + 1]; e++)
+				{
+					const idx_t part = outPartition[adjacency.edgeAdjacency[e]];
+					if (neighborWeights[part] == 0)
+					{
+						touchedParts.push_back(part);
+					}
+					neighborWeights[part] += adjacency.edgeWeights[e];
+				}
+
+				// Lowest part id win tie, result no depend on neighbor order.
+				idx_t bestPart = currentPart;
+				idx_t bestWeight = neighborWeights[currentPart];
+				for (idx_t part : touchedParts)
+				{
+					if (part == currentPart || partSizes[part] >= maxPartSize)
+					{
+						continue;
+					}
+
+					if (neighborWeights[part] > bestWeight || (neighborWeights[part] == bestWeight && part < bestPart && bestPart != currentPart))
+					{
+						bestPart = part;
+						bestWeight = neighborWeights[part];
+					}
+				}
+
+				for (idx_t part : touchedParts)
+				{
+					neighborWeights[part] = 0;
+				}
+
+				if (bestPart != currentPart)
+				{
+					partSizes[currentPart]--;
+					partSizes[bestPart]++;
+					outPartition[i] = bestPart;
+					moveCount++;
+				}
+			}
+
+			if (moveCount == 0)
+			{
+				break;
+			}
+		}
+	}
+
+private:
+	// Spread 10 bits to every third bit.
+	static uint32 expandBits(uint32 v)
+	{
+		v = (v * 0x00010001u) & 0xFF0000FFu;
+		v = (v * 0x00000101u) & 0x0F00F00Fu;
+		v = (v * 0x00000011u) & 0xC30C30C3u;
+		v = (v * 0x00000005u) & 0x49249249u;
+		return v;
+	}
+};
+
+static const IMeshletPartitioner& getMeshletPartitioner(EMeshletPartitioner type)
+{
+	static const MetisMeshletPartitioner sMetis { };
+	static const SpatialMeshletPartitioner sSpatial { };
+
+	switch (type)
+	{
+	case EMeshletPartitioner::Metis:   return sMetis;
+	case EMeshletPartitioner::Spatial: return sSpatial;
+	}
+
+	checkEntry();
+	return sMetis;
+}
+
+static bool buildClusterGroup(
+	const MeshletContainer& ctx, 
+	std::vector<ConbimeMeshlets>& outGroup, 
+	const std::vector<Vertex>& vertices, 
+	float posFuseThreshold,
+	EMeshletPartitioner partitioner,
+	uint64& outBoundaryEdgeCount)
+{
+	const auto& meshlets = ctx.meshlets;
+
+	if (meshlets.size() < kMinNumMeshletPerGroup)
+	{
+		// No enough meshlet count to group-simplify-split, just return one group.
+		outGroup = buildOneClusterGroup(ctx);
+		return false;
+	}
+
+	const uint32 groupMeshletCount = math::min(uint32(meshlets.size()) / kMinNumMeshletPerGroup, kMaxNumMeshletPerGroup);
+
+	ClusterAdjacency adjacency { };
+	buildClusterAdjacency(ctx, vertices, posFuseThreshold, adjacency);
+
+	if (adjacency.edgeAdjacency.empty()) 
+	{
+		// No connected meshlet exist, return one group.
+		outGroup = buildOneClusterGroup(ctx);
+		return false;
+	}
+
+	checkMsgf(adjacency.xadjacency.size() == meshlets.size() + 1, "unexpected count of vertices for meshlet graph.");
+	checkMsgf(adjacency.edgeAdjacency.size() == adjacency.edgeWeights.size(), "edgeWeights and edgeAdjacency must have the same length.");
+
+	// Group partition.
+	{
+		const uint32 partCount = uint32(meshlets.size()) / groupMeshletCount;
+
+		std::vector<idx_t> partition;
+		getMeshletPartitioner(partitioner).partition(ctx, adjacency, partCount, partition);
+
+		outGroup.resize(partCount);
+		for (std::size_t i = 0; i < meshlets.size(); i++) 
+		{
+			idx_t partitionNumber = partition[i];
+			outGroup[partitionNumber].push_back(i);
+		}
+
+		// Shared edges cross group, these edges lock when simplify, count twice in CSR.
+		uint64 boundaryEdgeWeight = 0;
+		for (std::size_t i = 0; i < meshlets.size(); i++)
+		{
+			for (idx_t e = adjacency.xadjacency[i]; e < adjacency.xadjacency[i + 1]; e++)
+			{
+				if (partition[i] != partition[adjacency.edgeAdjacency[e]])
+				{
+					boundaryEdgeWeight += adjacency.edgeWeights[e];
+				}
+			}
+		}
+		outBoundaryEdgeCount += boundaryEdgeWeight / 2;
+	}
+
+	return true;
+}
+
+static bool isLooseGeometry(const std::vector<uint32>& indices, const std::vector<Vertex>& vertices)
+{
+	std::unordered_map<MeshletEdge, uint32, MeshletEdge::Hash> edgeUsedCount;
+
+	const uint triangleCount = indices.size() / 3;
+	for (uint triangleId = 0; triangleId < triangleCount; triangleId++) // Loop all triangle.
+	{
+		for (uint i = 0; i < 3; i++) // Loop all edge.
+		{
+			uint32 v0 = indices[triangleId * 3 + i];
+			uint32 v1 = indices[triangleId * 3 + (i + 1) % 3];
+
+			MeshletEdge edge(v0, v1);
+			edgeUsedCount[edge]++;
+		}
+	}
+
+	uint32 edgeBorderCount = 0;
+	for (const auto& pair : edgeUsedCount)
+	{
+		if (pair.second == 1) // is edge.
+		{
+			edgeBorderCount++;
+		}
+	}
+
+	if (edgeBorderCount == edgeUsedCount.size())
+	{
+		return true;
+	}
+
+	return false;
+}
+
+// Input one lod level meshlet container, do Group-Merge-Simplify-Split operation.
+// Return true if success, return false if stop.
 void NaniteBuilder::MeshletsGMSS(
 	MeshletContainer& srcCtx,
 	MeshletContainer& outCtx, 
 	float targetError, 
-	uint32 lod) const
+	uint32 lod,
+	NaniteBuildStats& outStats) const
 {
 	// Group.
 	std::vector<ConbimeMeshlets> clusterGroups;
 	const float posFuseThreshold = targetError * kGroupMergePosError;
 
-	bool bCanGroup = buildClusterGroup(srcCtx, clusterGroups, m_vertices, posFuseThreshold);
+	bool bCanGroup = buildClusterGroup(srcCtx, clusterGroups, m_vertices, posFuseThreshold, m_partitioner, outStats.boundaryEdgeCount);
 
 	if (bCanGroup)
 	{
@@ -783,9 +1404,12 @@ void NaniteBuilder::MeshletsGMSS(
 		return;
 	}
 
-	// Merge-Simplify-Split.
-	for (const auto& clusterGroup : clusterGroups)
+	// Merge-Simplify-Split, each group output to own container.
+	std::vector<MeshletContainer> groupCtxs(clusterGroups.size());
+	auto processGroup = [&](uint32 groupIndex)
 	{
+		const auto& clusterGroup = clusterGroups[groupIndex];
+
 		// Merge meshlet in one group.
 		std::vector<VertexIndex> groupMergeVertices;
 		{
@@ -860,39 +1484,111 @@ void NaniteBuilder::MeshletsGMSS(
 				}
 
 				const float3 clusterPosCenter = 0.5f * (posMax + posMin);
-				// Fill parent infos.
+
+				// Fill parent infos, meshlets of groups are disjoint so no race.
 				for (uint32 sMid : clusterGroup)
 				{
 					srcCtx.meshlets[sMid].parentError = clusterError;
 					srcCtx.meshlets[sMid].parentPosCenter = clusterPosCenter;
 				}
 
-				// Split new meshlets, and fill in return ctx.
-				MeshletContainer nextMeshletCtx = buildMeshlets(m_vertices, simplifiedVertices, m_coneWeight, lod, clusterError, clusterPosCenter);
-				outCtx.merge(std::move(nextMeshletCtx));
+				// Split new meshlets.
+				groupCtxs[groupIndex] = buildMeshlets(m_vertices, simplifiedVertices, m_coneWeight, lod, clusterError, clusterPosCenter);
 			}
 		}
 		else
 		{
 			// Current meshlet group can't simplify anymore.
 		}
+	};
+
+	if (sNaniteBuildParallel && clusterGroups.size() > 1)
+	{
+		jobsystem::parallelFor("NaniteGMSS", EBusyWaitType::All, (uint32)clusterGroups.size(), EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+		{
+			for (uint32 groupIndex = loopStart; groupIndex < loopEnd; groupIndex++)
+			{
+				processGroup(groupIndex);
+			}
+		});
+	}
+	else
+	{
+		for (uint32 groupIndex = 0; groupIndex < clusterGroups.size(); groupIndex++)
+		{
+			processGroup(groupIndex);
+		}
+	}
+
+	// Merge in group order, output same as serial build.
+	for (auto& groupCtx : groupCtxs)
+	{
+		if (!groupCtx.meshlets.empty())
+		{
+			outCtx.merge(std::move(groupCtx));
+		}
 	}
 }
 
-MeshletContainer NaniteBuilder::build() const
+MeshletContainer NaniteBuilder::build(NaniteBuildStats* outStats) const
 {
+	const auto beginTime = std::chrono::high_resolution_clock::now();
+	NaniteBuildStats stats { };
+
 	MeshletContainer finalCtx { };
 	checkMsgf(m_indices.size() % 3 == 0, "Nanite only support triangle mesh!");
 
 	// Compute simplify scale for later cluster simplify.
 	const float meshOptSimplifyScale = meshopt_simplifyScale(&m_vertices[0].position.x, m_vertices.size(), sizeof(m_vertices[0]));
+	buildLods(meshOptSimplifyScale, finalCtx, stats);
+
+	{
+		cookstats::ScopedStage stage("nanite.bvh", m_report);
 
+		const auto bvhBeginTime = std::chrono::high_resolution_clock::now();
+		buildBVHTree(finalCtx, finalCtx.meshletGroups, finalCtx.bvhNodes, finalCtx.meshletGroupIndices);
+		stats.bvhSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - bvhBeginTime).count();
+	}
+	stats.bvhNodeCount = (uint32)finalCtx.bvhNodes.size();
+	stats.bvhTraversalCost = computeBVHTraversalCost(finalCtx.bvhNodes);
+	stats.lodErrors = computeLodErrors(finalCtx);
+
+	stats.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - beginTime).count();
+	LOG_TRACE("Nanite build {} meshlets in {} lods with {} partitioner, {} group boundary edges, {} bvh nodes with traversal cost {:.2f}, cost {:.3f} s.",
+		finalCtx.meshlets.size(), stats.lodCount, nameof::nameof_enum(m_partitioner), stats.boundaryEdgeCount, stats.bvhNodeCount, stats.bvhTraversalCost, stats.seconds);
+
+	if (outStats)
+	{
+		*outStats = stats;
+	}
+	return finalCtx;
+}
+
+void NaniteBuilder::buildLods(float simplifyScale, MeshletContainer& outCtx, NaniteBuildStats& stats) const
+{
 	// Src mesh input meshlet context, lod0 default use negative error.
-	MeshletContainer currentLodCtx = buildMeshlets(m_vertices, m_indices, m_coneWeight, 0, -1.0f, math::vec3(0.0f));
+	MeshletContainer lod0Ctx { };
+	{
+		cookstats::ScopedStage stage("nanite.cluster", m_report);
+		lod0Ctx = buildMeshlets(m_vertices, m_indices, m_coneWeight, 0, -1.0f, math::vec3(0.0f));
+	}
+
+	cookstats::ScopedStage stage("nanite.simplify", m_report);
+	buildLodChain(std::move(lod0Ctx), 0, simplifyScale, outCtx, stats);
+}
+
+void NaniteBuilder::buildLodChain(MeshletContainer&& srcCtx, uint32 baseLod, float simplifyScale, MeshletContainer& outCtx, NaniteBuildStats& stats) const
+{
+	MeshletContainer currentLodCtx = std::move(srcCtx);
+	if (baseLod >= (kNaniteMaxLODCount - 1))
+	{
+		outCtx.merge(std::move(currentLodCtx));
+		return;
+	}
 
 	//
 	MeshletContainer nextLodCtx = { };
-	for (uint32 lod = 0; lod < (kNaniteMaxLODCount - 1); lod++)
+	for (uint32 lod = baseLod; lod < (kNaniteMaxLODCount - 1); lod++)
 	{
 		// Clear next lod ctx.
 		nextLodCtx = {};
@@ -900,11 +1596,12 @@ MeshletContainer NaniteBuilder::build() const
 		const uint32 targetLod = lod + 1;
 		const float tagetLodError = float(lod) / float(kNaniteMaxLODCount);
 
-		const float lodErrorAbsolute = math::lerp(kSimplifyErrorMin, kSimplifyErrorMax, tagetLodError) * meshOptSimplifyScale;
-		MeshletsGMSS(currentLodCtx, nextLodCtx, lodErrorAbsolute, targetLod);
+		const float lodErrorAbsolute = math::lerp(kSimplifyErrorMin, kSimplifyErrorMax, tagetLodError) * simplifyScale;
+		MeshletsGMSS(currentLodCtx, nextLodCtx, lodErrorAbsolute, targetLod, stats);
 
 		// Current lod ctx already update parent data, so merge to final.
-		finalCtx.merge(std::move(currentLodCtx));
+		outCtx.merge(std::move(currentLodCtx));
+		stats.lodCount = math::max(stats.lodCount, targetLod);
 
 		if (nextLodCtx.meshlets.empty())
 		{
@@ -914,23 +1611,77 @@ MeshletContainer NaniteBuilder::build() const
 		// Swap for next lod.
 		currentLodCtx = std::move(nextLodCtx);
 	}
+}
 
-	buildBVHTree(finalCtx, finalCtx.meshletGroups, finalCtx.bvhNodes, finalCtx.meshletGroupIndices);
+float computeBVHTraversalCost(const std::vector<GPUBVHNode>& nodes)
+{
+	if (nodes.empty())
+	{
+		return 0.0f;
+	}
 
-	return finalCtx;
+	// Root without parent valid group has no meaningful bounds, treat every node always visit.
+	const float rootRadius2 = nodes[0].sphere.w * nodes[0].sphere.w;
+	const bool bRootValid = std::isfinite(rootRadius2) && rootRadius2 > 0.0f;
+
+	float cost = 0.0f;
+	for (const auto& node : nodes)
+	{
+		uint32 childCount = 0;
+		for (uint32 i = 0; i < kNaniteBVHLevelNodeCount; i++)
+		{
+			childCount += (node.children[i] != kUnvalidIdUint32) ? 1 : 0;
+		}
+
+		const float radius2 = node.sphere.w * node.sphere.w;
+		const float visitProbability = (bRootValid && std::isfinite(radius2)) ? math::min(radius2 / rootRadius2, 1.0f) : 1.0f;
+		cost += visitProbability * float(childCount + node.leafMeshletGroupCount);
+	}
+	return cost;
 }
 
-void fuseVertices(std::vector<uint32>& indices, std::vector<Vertex>& vertices, bool bFuseIgnoreNormal)
+std::vector<NaniteLodError> computeLodErrors(const MeshletContainer& ctx)
 {
-	std::vector<Vertex> remapVertices;
-	remapVertices.reserve(vertices.size());
+	std::vector<NaniteLodError> result;
+	std::vector<double> sums;
+	for (const auto& meshlet : ctx.meshlets)
+	{
+		if (meshlet.lod >= result.size())
+		{
+			result.resize(meshlet.lod + 1);
+			sums.resize(meshlet.lod + 1, 0.0);
+		}
 
-	std::vector<uint32> remapIndices;
-	remapIndices.reserve(indices.size());
+		const float error = math::max(meshlet.error, 0.0f);
+		auto& lodError = result[meshlet.lod];
+		lodError.meshletCount++;
+		lodError.maxError = math::max(lodError.maxError, error);
+		sums[meshlet.lod] += error;
+	}
 
-	std::map<uint64, size_t> verticesMap;
+	for (uint32 lod = 0; lod < result.size(); lod++)
+	{
+		if (result[lod].meshletCount > 0)
+		{
+			result[lod].meanError = float(sums[lod] / result[lod].meshletCount);
+		}
+	}
+	return result;
+}
 
-	// 
+uint64 getBuildCVarsHash()
+{
+	const uint32 values[] = { sNaniteBuildSortAdjacency, sNaniteBVHSAH, sNaniteBVHWidth, sNaniteStreamingThreshold, sNaniteStreamingBrickTriangles };
+	return cityhash::cityhash64((const char*)values, sizeof(values));
+}
+
+bool useStreamingBuild(uint64 triangleCount)
+{
+	return sNaniteStreamingThreshold > 0 && triangleCount >= sNaniteStreamingThreshold;
+}
+
+static uint64 hashFuseVertex(const Vertex& vertex, bool bFuseIgnoreNormal)
+{
 	struct HashVertexInfo
 	{
 		float3 position;
@@ -941,58 +1692,199 @@ void fuseVertices(std::vector<uint32>& indices, std::vector<Vertex>& vertices, b
 		float tangentW;
 	};
 
-	uint fuseCount = 0;
+	HashVertexInfo hashInfo { };
+	hashInfo.position = vertex.position;
+	hashInfo.uv0 = vertex.uv0;
+	hashInfo.uv1 = vertex.uv1;
+	hashInfo.color0 = vertex.color0;
+	hashInfo.tangentW = vertex.tangent.w;
 
-	//
+	if (!bFuseIgnoreNormal)
+	{
+		hashInfo.normal[0] = (signed char)(meshopt_quantizeSnorm(vertex.normal[0], 8));
+		hashInfo.normal[1] = (signed char)(meshopt_quantizeSnorm(vertex.normal[1], 8));
+		hashInfo.normal[2] = (signed char)(meshopt_quantizeSnorm(vertex.normal[2], 8));
+	}
+
+	return cityhash::cityhash64((const char*)&hashInfo, sizeof(HashVertexInfo));
+}
+
+// Legacy fuse, serial walk indices with hash map.
+static void fuseVerticesHashMap(std::vector<uint32>& indices, std::vector<Vertex>& vertices, bool bFuseIgnoreNormal)
+{
+	std::vector<Vertex> remapVertices;
+	remapVertices.reserve(vertices.size());
+
+	std::vector<uint32> remapIndices;
+	remapIndices.reserve(indices.size());
+
+	std::map<uint64, size_t> verticesMap;
 	for (uint32 index : indices)
 	{
 		const Vertex& vertex = vertices[index];
 
-		HashVertexInfo hashInfo { };
-		hashInfo.position = vertex.position;
-		hashInfo.uv0 = vertex.uv0;
-		hashInfo.uv1 = vertex.uv1;
-		hashInfo.color0 = vertex.color0;
-		hashInfo.tangentW = vertex.tangent.w;
+		const uint64 hashId = hashFuseVertex(vertex, bFuseIgnoreNormal);
+		if (!verticesMap.contains(hashId))
+		{
+			verticesMap[hashId] = remapVertices.size();
+			remapVertices.push_back(vertex);
+		}
+
+		remapIndices.push_back(verticesMap[hashId]);
+	}
+
+	indices  = std::move(remapIndices);
+	vertices = std::move(remapVertices);
+}
+
+// Sort based fuse, same output as hash map path:
+// 1. Record first index position of each vertex and hash referenced vertices in parallel.
+// 2. Radix sort (hash, vertex) pairs, each run is one fused vertex which first appear at min position of run.
+// 3. Fused vertex emit at its first position, so output keep first occurrence order.
+static void fuseVerticesSort(std::vector<uint32>& indices, std::vector<Vertex>& vertices, bool bFuseIgnoreNormal)
+{
+	const uint32 indexCount = (uint32)indices.size();
+	const uint32 vertexCount = (uint32)vertices.size();
+
+	std::vector<uint32> firstPositions(vertexCount, kUnvalidIdUint32);
+	jobsystem::parallelFor("NaniteFuseFirst", EBusyWaitType::All, indexCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+	{
+		for (uint32 i = loopStart; i < loopEnd; i++)
+		{
+			std::atomic_ref<uint32> firstPosition(firstPositions[indices[i]]);
+			uint32 current = firstPosition.load(std::memory_order_relaxed);
+			while (i < current && !firstPosition.compare_exchange_weak(current, i, std::memory_order_relaxed))
+			{
+			}
+		}
+	});
+
+	struct HashVertex
+	{
+		uint64 hash;
+		VertexIndex vertexIndex;
+	};
 
-		if (!bFuseIgnoreNormal)
+	std::vector<HashVertex> hashVertices(vertexCount);
+	jobsystem::parallelFor("NaniteFuseHash", EBusyWaitType::All, vertexCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+	{
+		for (VertexIndex vertexIndex = loopStart; vertexIndex < loopEnd; vertexIndex++)
 		{
-			hashInfo.normal[0] = (signed char)(meshopt_quantizeSnorm(vertex.normal[0], 8));
-			hashInfo.normal[1] = (signed char)(meshopt_quantizeSnorm(vertex.normal[1], 8));
-			hashInfo.normal[2] = (signed char)(meshopt_quantizeSnorm(vertex.normal[2], 8));
+			const bool bReferenced = firstPositions[vertexIndex] != kUnvalidIdUint32;
+			hashVertices[vertexIndex] = { bReferenced ? hashFuseVertex(vertices[vertexIndex], bFuseIgnoreNormal) : 0, vertexIndex };
 		}
+	});
 
+	std::erase_if(hashVertices, [&](const HashVertex& item) { return firstPositions[item.vertexIndex] == kUnvalidIdUint32; });
+	radixSort64(hashVertices, [](const HashVertex& item) { return item.hash; });
 
-		const uint64 hashId = cityhash::cityhash64((const char*)&hashInfo, sizeof(HashVertexInfo));
-		if (!verticesMap.contains(hashId))
+	// Fused first position of each referenced vertex.
+	std::vector<uint32> fusedPositions(vertexCount, kUnvalidIdUint32);
+	for (size_t runStart = 0; runStart < hashVertices.size();)
+	{
+		size_t runEnd = runStart;
+		uint32 minPosition = kUnvalidIdUint32;
+		while (runEnd < hashVertices.size() && hashVertices[runEnd].hash == hashVertices[runStart].hash)
 		{
-			verticesMap[hashId] = remapVertices.size();
-			remapVertices.push_back(vertex);
+			minPosition = math::min(minPosition, firstPositions[hashVertices[runEnd].vertexIndex]);
+			runEnd++;
 		}
-		else
+
+		for (size_t i = runStart; i < runEnd; i++)
 		{
-			fuseCount ++;
+			fusedPositions[hashVertices[i].vertexIndex] = minPosition;
 		}
+		runStart = runEnd;
+	}
 
-		remapIndices.push_back(verticesMap[hashId]);
+	// Fused vertex id is count of fused vertices first appear before it.
+	std::vector<uint32> positionIds(indexCount);
+	uint32 fusedCount = 0;
+	for (uint32 i = 0; i < indexCount; i++)
+	{
+		if (fusedPositions[indices[i]] == i)
+		{
+			positionIds[i] = fusedCount++;
+		}
 	}
 
-	LOG_TRACE("Fuse vertices to {1}%.", fuseCount, 100.0f * float(remapVertices.size()) / float(vertices.size()))
+	std::vector<Vertex> remapVertices(fusedCount);
+	std::vector<uint32> remapIndices(indexCount);
+	jobsystem::parallelFor("NaniteFuseRemap", EBusyWaitType::All, indexCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+	{
+		for (uint32 i = loopStart; i < loopEnd; i++)
+		{
+			const uint32 position = fusedPositions[indices[i]];
+			remapIndices[i] = positionIds[position];
+			if (position == i)
+			{
+				remapVertices[positionIds[i]] = vertices[indices[i]];
+			}
+		}
+	});
 
 	indices  = std::move(remapIndices);
 	vertices = std::move(remapVertices);
 }
 
+void fuseVertices(std::vector<uint32>& indices, std::vector<Vertex>& vertices, bool bFuseIgnoreNormal)
+{
+	const size_t srcVertexCount = vertices.size();
+	if (sNaniteFuseSort)
+	{
+		fuseVerticesSort(indices, vertices, bFuseIgnoreNormal);
+	}
+	else
+	{
+		fuseVerticesHashMap(indices, vertices, bFuseIgnoreNormal);
+	}
+
+	LOG_TRACE("Fuse vertices to {}%.", 100.0f * float(vertices.size()) / float(srcVertexCount));
+}
+
+void computeSmoothNormals(const std::vector<uint32>& indices, std::vector<Vertex>& vertices)
+{
+	const uint32 vertexCount = (uint32)vertices.size();
+
+	std::vector<uint32> cornerCounts(vertexCount, 0);
+	jobsystem::parallelFor("NaniteSmoothNormalCount", EBusyWaitType::All, (uint32)indices.size(), EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+	{
+		for (uint32 i = loopStart; i < loopEnd; i++)
+		{
+			std::atomic_ref<uint32>(cornerCounts[indices[i]]).fetch_add(1, std::memory_order_relaxed);
+		}
+	});
+
+	jobsystem::parallelFor("NaniteSmoothNormal", EBusyWaitType::All, vertexCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+	{
+		for (VertexIndex vertexIndex = loopStart; vertexIndex < loopEnd; vertexIndex++)
+		{
+			// Add one by one, keep float sum same as per corner accumulate.
+			float3 sum = float3(0.0f);
+			for (uint32 i = 0; i < cornerCounts[vertexIndex]; i++)
+			{
+				sum += vertices[vertexIndex].normal;
+			}
+			vertices[vertexIndex].smoothNormal = math::normalize(sum);
+		}
+	});
+}
+
 NaniteBuilder::NaniteBuilder(
 	std::vector<uint32>&& inputIndices,
 	std::vector<Vertex>&& inputVertices,
 	bool bFuse,
 	bool bFuseIgnoreNormal,
-	float coneWeight)
+	float coneWeight,
+	EMeshletPartitioner partitioner,
+	cookstats::Report* report)
 	: m_indices(inputIndices)
 	, m_vertices(inputVertices)
 	, m_coneWeight(coneWeight)
+	, m_partitioner(partitioner)
+	, m_report(report)
 {
+	cookstats::ScopedStage stage("nanite.weld", m_report);
 	if (bFuse)
 	{
 		fuseVertices(m_indices, m_vertices, bFuseIgnoreNormal);
@@ -1016,6 +1908,432 @@ NaniteBuilder::NaniteBuilder(
 	m_vertices = std::move(remapVertices);
 }
 
+NaniteBuilder::NaniteBuilder(std::vector<Vertex>&& vertices, float coneWeight, EMeshletPartitioner partitioner, cookstats::Report* report)
+	: m_coneWeight(coneWeight)
+	, m_partitioner(partitioner)
+	, m_report(report)
+	, m_vertices(std::move(vertices))
+{
+
+}
+
+// Brick buffer flush when one brick or all bricks buffer too much vertices.
+constexpr uint64 kBrickFlushVertexCount = 64 * 1024 * 3;
+constexpr uint64 kBrickMaxBufferedVertexCount = 4 * 1024 * 1024 * 3;
+
+// Brick grid max dimension per axis.
+constexpr uint32 kBrickMaxDim = 64;
+
+NaniteStreamingBuilder::NaniteStreamingBuilder(
+	const std::filesystem::path& workFolder,
+	float3 posMin,
+	float3 posMax,
+	uint64 triangleCountHint,
+	bool bFuse,
+	bool bFuseIgnoreNormal,
+	float coneWeight,
+	EMeshletPartitioner partitioner,
+	cookstats::Report* report)
+	: m_workFolder(workFolder)
+	, m_bFuse(bFuse)
+	, m_bFuseIgnoreNormal(bFuseIgnoreNormal)
+	, m_coneWeight(coneWeight)
+	, m_partitioner(partitioner)
+	, m_report(report)
+	, m_posMin(posMin)
+	, m_posMax(posMax)
+{
+	// Brick files append, stale bricks of crashed build must clear first.
+	std::error_code ec;
+	std::filesystem::remove_all(m_workFolder, ec);
+	std::filesystem::create_directories(m_workFolder, ec);
+
+	// Cubic bricks, flat axis still keep one brick.
+	const float3 extent = math::max(m_posMax - m_posMin, float3(0.0f));
+	const float maxExtent = math::max(math::max(extent.x, extent.y), math::max(extent.z, FLT_MIN));
+	const float3 safeExtent = math::max(extent, float3(maxExtent * 1e-3f));
+
+	const uint64 brickCount = math::max(divideRoundingUp(triangleCountHint, uint64(math::max(sNaniteStreamingBrickTriangles, 1U))), uint64(1));
+	const float brickSize = std::cbrt(safeExtent.x * safeExtent.y * safeExtent.z / float(brickCount));
+	m_brickDim = math::clamp(math::uvec3(math::ceil(safeExtent / brickSize)), math::uvec3(1), math::uvec3(kBrickMaxDim));
+
+	m_brickBuffers.resize(getBrickCount());
+	m_brickTriangleCounts.resize(getBrickCount(), 0);
+}
+
+NaniteStreamingBuilder::~NaniteStreamingBuilder()
+{
+	std::error_code ec;
+	std::filesystem::remove_all(m_workFolder, ec);
+}
+
+uint32 NaniteStreamingBuilder::getBrickIndex(float3 position) const
+{
+	const float3 uvw = (position - m_posMin) / math::max(m_posMax - m_posMin, float3(FLT_MIN));
+	const math::uvec3 cell = math::min(math::uvec3(math::clamp(uvw, 0.0f, 1.0f) * float3(m_brickDim)), m_brickDim - 1U);
+	return (cell.z * m_brickDim.y + cell.y) * m_brickDim.x + cell.x;
+}
+
+std::filesystem::path NaniteStreamingBuilder::getBrickPath(uint32 brickIndex) const
+{
+	return m_workFolder / std::format("brick_{}.bin", brickIndex);
+}
+
+bool NaniteStreamingBuilder::flushBrick(uint32 brickIndex)
+{
+	auto& buffer = m_brickBuffers[brickIndex];
+	if (buffer.empty())
+	{
+		return true;
+	}
+
+	std::ofstream os(getBrickPath(brickIndex), std::ios::binary | std::ios::app);
+	os.write((const char*)buffer.data(), std::streamsize(buffer.size() * sizeof(Vertex)));
+	if (!os.good())
+	{
+		LOG_ERROR("Fail to write nanite brick {}.", utf8::utf16to8(getBrickPath(brickIndex).u16string()));
+		m_bWriteFailed = true;
+		return false;
+	}
+
+	m_bufferedVertexCount -= buffer.size();
+	buffer = { };
+	return true;
+}
+
+bool NaniteStreamingBuilder::addTriangles(const std::vector<uint32>& indices, const std::vector<Vertex>& vertices)
+{
+	checkMsgf(indices.size() % 3 == 0, "Nanite only support triangle mesh!");
+
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		const Vertex& v0 = vertices[indices[i + 0]];
+		const Vertex& v1 = vertices[indices[i + 1]];
+		const Vertex& v2 = vertices[indices[i + 2]];
+
+		const uint32 brickIndex = getBrickIndex((v0.position + v1.position + v2.position) / 3.0f);
+		auto& buffer = m_brickBuffers[brickIndex];
+		buffer.push_back(v0);
+		buffer.push_back(v1);
+		buffer.push_back(v2);
+
+		m_brickTriangleCounts[brickIndex]++;
+		m_bufferedVertexCount += 3;
+
+		if (buffer.size() >= kBrickFlushVertexCount)
+		{
+			flushBrick(brickIndex);
+		}
+
+		if (m_bufferedVertexCount >= kBrickMaxBufferedVertexCount)
+		{
+			for (uint32 b = 0; b < getBrickCount(); b++)
+			{
+				flushBrick(b);
+			}
+		}
+	}
+
+	return !m_bWriteFailed;
+}
+
+// Meshlet of one streaming node, node is brick or stitched cell.
+struct StreamingRootRef
+{
+	uint32 node;
+	uint32 meshlet;
+};
+
+bool NaniteStreamingBuilder::build(MeshletContainer& outCtx, std::vector<Vertex>& outVertices, std::vector<uint32>& outIndices, NaniteBuildStats* outStats)
+{
+	const auto beginTime = std::chrono::high_resolution_clock::now();
+	NaniteBuildStats stats { };
+
+	for (uint32 b = 0; b < getBrickCount(); b++)
+	{
+		flushBrick(b);
+	}
+	m_brickBuffers = { };
+
+	if (m_bWriteFailed)
+	{
+		return false;
+	}
+
+	// Same as meshopt_simplifyScale of whole mesh, keep lod error of every brick comparable.
+	const float3 extent = m_posMax - m_posMin;
+	const float simplifyScale = math::max(math::max(extent.x, extent.y), extent.z);
+
+	struct BrickResult
+	{
+		MeshletContainer ctx;
+		std::vector<Vertex> vertices;
+		std::vector<uint32> indices;
+		NaniteBuildStats stats;
+		bool bFailed = false;
+	};
+	std::vector<BrickResult> bricks(getBrickCount());
+
+	// 1. Build bricks, jobs pull bricks one by one so only jobs count bricks in memory.
+	{
+		std::atomic<uint32> nextBrick = 0;
+		auto buildBrickJob = [&]()
+		{
+			for (uint32 b = nextBrick++; b < getBrickCount(); b = nextBrick++)
+			{
+				if (m_brickTriangleCounts[b] == 0)
+				{
+					continue;
+				}
+
+				const auto brickPath = getBrickPath(b);
+				std::vector<Vertex> soup(m_brickTriangleCounts[b] * 3);
+				{
+					std::ifstream is(brickPath, std::ios::binary);
+					is.read((char*)soup.data(), std::streamsize(soup.size() * sizeof(Vertex)));
+					if (!is.good())
+					{
+						LOG_ERROR("Fail to read nanite brick {}.", utf8::utf16to8(brickPath.u16string()));
+						bricks[b].bFailed = true;
+						continue;
+					}
+				}
+
+				std::error_code ec;
+				std::filesystem::remove(brickPath, ec);
+
+				std::vector<uint32> soupIndices(soup.size());
+				for (uint32 i = 0; i < soupIndices.size(); i++)
+				{
+					soupIndices[i] = i;
+				}
+
+				NaniteBuilder builder(std::move(soupIndices), std::move(soup), m_bFuse, m_bFuseIgnoreNormal, m_coneWeight, m_partitioner, m_report);
+				builder.buildLods(simplifyScale, bricks[b].ctx, bricks[b].stats);
+
+				bricks[b].vertices = builder.getVertices();
+				bricks[b].indices = builder.getIndices();
+			}
+		};
+
+		FutureCollection futures { };
+		const uint32 jobCount = math::clamp(sNaniteStreamingJobCount, 1U, getBrickCount());
+		for (uint32 i = 0; i < jobCount; i++)
+		{
+			futures.add(jobsystem::launch("NaniteBrick", EJobFlags::Foreground, [&buildBrickJob]() { buildBrickJob(); }));
+		}
+		futures.wait(EBusyWaitType::All);
+	}
+
+	// 2. Vertices of all bricks append in brick order, brick meshlet vertex change to global index.
+	outVertices.clear();
+	outIndices.clear();
+
+	std::vector<MeshletContainer> nodes(getBrickCount());
+	std::vector<std::vector<StreamingRootRef>> cellRoots(getBrickCount());
+	for (uint32 b = 0; b < getBrickCount(); b++)
+	{
+		auto& brick = bricks[b];
+		if (brick.bFailed)
+		{
+			return false;
+		}
+
+		const uint32 baseVertex = (uint32)outVertices.size();
+		for (auto& id : brick.ctx.vertices) { id += baseVertex; }
+		for (auto& id : brick.indices) { id += baseVertex; }
+
+		outVertices.insert(outVertices.end(), brick.vertices.begin(), brick.vertices.end());
+		outIndices.insert(outIndices.end(), brick.indices.begin(), brick.indices.end());
+
+		stats.boundaryEdgeCount += brick.stats.boundaryEdgeCount;
+		stats.lodCount = math::max(stats.lodCount, brick.stats.lodCount);
+
+		nodes[b] = std::move(brick.ctx);
+		for (uint32 m = 0; m < nodes[b].meshlets.size(); m++)
+		{
+			if (!nodes[b].meshlets[m].isParentSet())
+			{
+				cellRoots[b].push_back({ b, m });
+			}
+		}
+
+		brick = { };
+	}
+	bricks = { };
+
+	// 3. Stitch 2x2x2 cells level by level until one cell.
+	math::uvec3 cellDim = m_brickDim;
+	while (cellDim.x * cellDim.y * cellDim.z > 1)
+	{
+		const math::uvec3 parentDim = (cellDim + 1U) / 2U;
+		const uint32 parentCount = parentDim.x * parentDim.y * parentDim.z;
+
+		std::vector<std::vector<StreamingRootRef>> parentRoots(parentCount);
+		for (uint32 z = 0; z < cellDim.z; z++)
+		{
+			for (uint32 y = 0; y < cellDim.y; y++)
+			{
+				for (uint32 x = 0; x < cellDim.x; x++)
+				{
+					const uint32 cell = (z * cellDim.y + y) * cellDim.x + x;
+					const uint32 parent = ((z / 2) * parentDim.y + (y / 2)) * parentDim.x + (x / 2);
+					parentRoots[parent].insert(parentRoots[parent].end(), cellRoots[cell].begin(), cellRoots[cell].end());
+				}
+			}
+		}
+
+		// Node id reserve before parallel, cells only touch their own subtree nodes.
+		const uint32 baseNode = (uint32)nodes.size();
+		nodes.resize(baseNode + parentCount);
+
+		std::vector<NaniteBuildStats> cellStats(parentCount);
+		jobsystem::parallelFor("NaniteStitch", EBusyWaitType::All, parentCount, EJobFlags::Foreground, [&](const uint32 loopStart, const uint32 loopEnd)
+		{
+			for (uint32 cell = loopStart; cell < loopEnd; cell++)
+			{
+				auto& roots = parentRoots[cell];
+				if (roots.size() < kMinNumMeshletPerGroup)
+				{
+					continue;
+				}
+
+				// Gather roots, weld same vertex from different bricks so seam become interior.
+				MeshletContainer srcCtx { };
+				std::vector<Vertex> localVertices;
+				std::vector<uint32> localToGlobal;
+				std::unordered_map<uint64, uint32> weldMap;
+				std::unordered_map<uint32, uint32> globalToLocal;
+
+				uint32 baseLod = 0;
+				for (const auto& ref : roots)
+				{
+					const auto& srcNode = nodes[ref.node];
+					Meshlet meshlet = srcNode.meshlets[ref.meshlet];
+					baseLod = math::max(baseLod, meshlet.lod);
+
+					const uint32 triangleOffset = (uint32)srcCtx.triangles.size();
+					const uint32 vertexOffset = (uint32)srcCtx.vertices.size();
+					srcCtx.triangles.insert(srcCtx.triangles.end(),
+						srcNode.triangles.begin() + meshlet.info.triangle_offset,
+						srcNode.triangles.begin() + meshlet.info.triangle_offset + meshlet.info.triangle_count * 3);
+
+					for (uint32 i = 0; i < meshlet.info.vertex_count; i++)
+					{
+						const uint32 globalId = srcNode.vertices[meshlet.info.vertex_offset + i];
+
+						auto localIter = globalToLocal.find(globalId);
+						if (localIter == globalToLocal.end())
+						{
+							const uint64 hash = cityhash::cityhash64((const char*)&outVertices[globalId], sizeof(Vertex));
+							auto [weldIter, bInserted] = weldMap.try_emplace(hash, (uint32)localVertices.size());
+							if (bInserted)
+							{
+								localVertices.push_back(outVertices[globalId]);
+								localToGlobal.push_back(globalId);
+							}
+							localIter = globalToLocal.emplace(globalId, weldIter->second).first;
+						}
+						srcCtx.vertices.push_back(localIter->second);
+					}
+
+					meshlet.info.triangle_offset = triangleOffset;
+					meshlet.info.vertex_offset = vertexOffset;
+					srcCtx.meshlets.push_back(meshlet);
+				}
+
+				if (baseLod >= (kNaniteMaxLODCount - 1))
+				{
+					continue;
+				}
+
+				const size_t srcTriangleSize = srcCtx.triangles.size();
+				const size_t srcVertexSize = srcCtx.vertices.size();
+
+				MeshletContainer chainCtx { };
+				NaniteBuilder stitcher(std::move(localVertices), m_coneWeight, m_partitioner, m_report);
+				stitcher.buildLodChain(std::move(srcCtx), baseLod, simplifyScale, chainCtx, cellStats[cell]);
+
+				// Roots merge first, write back parent data.
+				std::vector<StreamingRootRef> remainRoots;
+				for (uint32 i = 0; i < roots.size(); i++)
+				{
+					const auto& stitched = chainCtx.meshlets[i];
+					auto& dest = nodes[roots[i].node].meshlets[roots[i].meshlet];
+
+					dest.parentError = stitched.parentError;
+					dest.parentPosCenter = stitched.parentPosCenter;
+					if (!dest.isParentSet())
+					{
+						remainRoots.push_back(roots[i]);
+					}
+				}
+
+				// Strip roots, keep coarser lods with global vertex index.
+				auto& node = nodes[baseNode + cell];
+				node.meshlets.assign(chainCtx.meshlets.begin() + roots.size(), chainCtx.meshlets.end());
+				node.triangles.assign(chainCtx.triangles.begin() + srcTriangleSize, chainCtx.triangles.end());
+				node.vertices.resize(chainCtx.vertices.size() - srcVertexSize);
+				for (size_t i = 0; i < node.vertices.size(); i++)
+				{
+					node.vertices[i] = localToGlobal[chainCtx.vertices[srcVertexSize + i]];
+				}
+
+				for (uint32 m = 0; m < node.meshlets.size(); m++)
+				{
+					node.meshlets[m].info.triangle_offset -= (uint32)srcTriangleSize;
+					node.meshlets[m].info.vertex_offset -= (uint32)srcVertexSize;
+
+					if (!node.meshlets[m].isParentSet())
+					{
+						remainRoots.push_back({ baseNode + cell, m });
+					}
+				}
+
+				roots = std::move(remainRoots);
+			}
+		});
+
+		for (const auto& cellStat : cellStats)
+		{
+			stats.boundaryEdgeCount += cellStat.boundaryEdgeCount;
+			stats.lodCount = math::max(stats.lodCount, cellStat.lodCount);
+		}
+
+		cellRoots = std::move(parentRoots);
+		cellDim = parentDim;
+	}
+
+	// 4. Assemble all nodes and build bvh.
+	outCtx = { };
+	for (auto& node : nodes)
+	{
+		outCtx.merge(std::move(node));
+	}
+	nodes = { };
+
+	{
+		cookstats::ScopedStage stage("nanite.bvh", m_report);
+
+		const auto bvhBeginTime = std::chrono::high_resolution_clock::now();
+		buildBVHTree(outCtx, outCtx.meshletGroups, outCtx.bvhNodes, outCtx.meshletGroupIndices);
+		stats.bvhSeconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - bvhBeginTime).count();
+	}
+	stats.bvhNodeCount = (uint32)outCtx.bvhNodes.size();
+	stats.bvhTraversalCost = computeBVHTraversalCost(outCtx.bvhNodes);
+	stats.lodErrors = computeLodErrors(outCtx);
+
+	stats.seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - beginTime).count();
+	LOG_TRACE("Nanite streaming build {} meshlets from {}x{}x{} bricks in {} lods, {} bvh nodes, cost {:.3f} s.",
+		outCtx.meshlets.size(), m_brickDim.x, m_brickDim.y, m_brickDim.z, stats.lodCount, stats.bvhNodeCount, stats.seconds);
+
+	if (outStats)
+	{
+		*outStats = stats;
+	}
+	return true;
+}
+
 bool Meshlet::isParentSet() const
 {
 	return parentError != kMeshletParentErrorUninitialized;
@@ -1044,10 +2362,8 @@ GLTFMeshlet Meshlet::getGLTFMeshlet(uint32 dataOffset) const
 }
 
 
-void MeshletContainer::merge(MeshletContainer&& inRhs)
+void MeshletContainer::merge(MeshletContainer&& rhs)
 {
-	MeshletContainer rhs = inRhs;
-
 	uint32 baseTriangleOffset = triangles.size();
 	uint32 baseVerticesOffset = vertices.size();
 
@@ -2,7 +2,9 @@
 
 #include <utils/utils.h>
 #include <asset/meshoptimizer/meshoptimizer.h>
+#include <metis/metis.h>
 #include <asset/gltf/asset_gltf.h>
+#include <asset/cook_stats.h>
 #include <shader/gltf.h>
 
 namespace chord::nanite
@@ -65,6 +67,65 @@ namespace chord::nanite
 		void merge(MeshletContainer&& rhs);
 	};
 
+	// Output meshlet error of one lod, lod0 error is negative and clamp to zero.
+	struct NaniteLodError
+	{
+		uint32 meshletCount = 0;
+		float meanError = 0.0f;
+		float maxError = 0.0f;
+	};
+
+	struct NaniteBuildStats
+	{
+		// Shared edges cross meshlet groups of all lods, these edges lock when simplify.
+		uint64 boundaryEdgeCount = 0;
+
+		// Lod count which try to simplify.
+		uint32 lodCount = 0;
+
+		// Cluster group bvh node count and estimate traversal cost, see computeBVHTraversalCost.
+		uint32 bvhNodeCount = 0;
+		float bvhTraversalCost = 0.0f;
+
+		// Error distribution indexed by lod, used to compare partitioner quality.
+		std::vector<NaniteLodError> lodErrors;
+
+		double bvhSeconds = 0.0;
+		double seconds = 0.0;
+	};
+
+	// Collect error distribution of each lod from build output.
+	extern std::vector<NaniteLodError> computeLodErrors(const MeshletContainer& ctx);
+
+	// CPU estimate of GPU cluster group culling cost, lower is better.
+	// Node visit probability approximate by bound sphere area relative to root, visit cost is child and leaf group test count.
+	extern float computeBVHTraversalCost(const std::vector<GPUBVHNode>& nodes);
+
+	// Hash of console variables which change build output, derived data key must include it.
+	extern uint64 getBuildCVarsHash();
+
+	// Mesh with triangle count reach r.nanite.streaming.threshold should use NaniteStreamingBuilder.
+	extern bool useStreamingBuild(uint64 triangleCount);
+
+	// Meshlet graph in CSR form, neighbors of meshlet i are edgeAdjacency[xadjacency[i], xadjacency[i + 1]).
+	// Edge weight is count of shared position hashed edges.
+	struct ClusterAdjacency
+	{
+		std::vector<idx_t> xadjacency;
+		std::vector<idx_t> edgeAdjacency;
+		std::vector<idx_t> edgeWeights;
+	};
+
+	// Build meshlet graph for grouping, by radix sort or legacy hash map path of r.nanite.build.adjacency.sort.
+	// Neighbor order inside a row differ between paths, neighbor set and weights are same.
+	extern void buildClusterAdjacency(const MeshletContainer& ctx, const std::vector<Vertex>& vertices, float posFuseThreshold, ClusterAdjacency& out);
+
+	// Merge vertices with same position, uvs, color, tangent sign and 8 bit quantized normal, output keep first occurrence order.
+	extern void fuseVertices(std::vector<uint32>& indices, std::vector<Vertex>& vertices, bool bFuseIgnoreNormal);
+
+	// Smooth normal of each vertex, normalized sum of its normal over all referencing corners.
+	extern void computeSmoothNormals(const std::vector<uint32>& indices, std::vector<Vertex>& vertices);
+
 	class NaniteBuilder
 	{
 	public:
@@ -73,22 +134,40 @@ namespace chord::nanite
 			std::vector<Vertex>&& vertices,
 			bool bFuse,
 			bool bFuseIgnoreNormal,
-			float coneWeight);
+			float coneWeight,
+			EMeshletPartitioner partitioner = EMeshletPartitioner::Metis,
+			cookstats::Report* report = nullptr);
 
-		MeshletContainer build() const;
+		MeshletContainer build(NaniteBuildStats* outStats = nullptr) const;
 
 		const std::vector<Vertex>& getVertices() const { return m_vertices; }
 		const std::vector<uint32>& getIndices()  const { return m_indices;  }
 
 	private:
+		friend class NaniteStreamingBuilder;
+
+		// Simplify only builder over prepared vertices, no fuse and remap, used to stitch streaming bricks.
+		explicit NaniteBuilder(std::vector<Vertex>&& vertices, float coneWeight, EMeshletPartitioner partitioner, cookstats::Report* report);
+
+		// Cluster lod0 and simplify lod chain into outCtx, no bvh.
+		void buildLods(float simplifyScale, MeshletContainer& outCtx, NaniteBuildStats& stats) const;
+
+		// Group-merge-simplify-split from srcCtx lod until stop, merge srcCtx and every coarser lod into outCtx in lod order.
+		void buildLodChain(MeshletContainer&& srcCtx, uint32 baseLod, float simplifyScale, MeshletContainer& outCtx, NaniteBuildStats& stats) const;
+
 		void MeshletsGMSS(
 			MeshletContainer& srcCtx, 
 			MeshletContainer& outCtx, 
 			float targetError, 
-			uint32 lod) const;
+			uint32 lod,
+			NaniteBuildStats& outStats) const;
 
 	private:
 		const float m_coneWeight;
+		const EMeshletPartitioner m_partitioner;
+
+		// Import report which stages also record into, nullptr if none.
+		cookstats::Report* const m_report;
 
 		// Indices of triangles.
 		std::vector<uint32> m_indices;
@@ -96,5 +175,64 @@ namespace chord::nanite
 		// Vertices.
 		std::vector<Vertex> m_vertices;
 	};
-}
 
+	// Bricked build for very large meshes.
+	// Input triangles stream into brick files on a uniform grid by centroid. Each brick cluster and simplify independently,
+	// brick seams are open borders so simplify lock them. Then bricks stitch in octree order: root meshlets of 2x2x2 child
+	// cells weld seam vertices and continue simplify together, until the whole mesh reduce to the top.
+	// Only cluster and simplify working set bound by brick size times r.nanite.streaming.jobs. It is not out of core yet:
+	// caller still hold the whole input before addTriangles, and brick results stay in memory until stitch, so peak memory
+	// is about input size plus output size.
+	class NaniteStreamingBuilder : NonCopyable
+	{
+	public:
+		// Bounds of all input positions and triangle count hint decide brick grid.
+		explicit NaniteStreamingBuilder(
+			const std::filesystem::path& workFolder,
+			float3 posMin,
+			float3 posMax,
+			uint64 triangleCountHint,
+			bool bFuse,
+			bool bFuseIgnoreNormal,
+			float coneWeight,
+			EMeshletPartitioner partitioner = EMeshletPartitioner::Metis,
+			cookstats::Report* report = nullptr);
+
+		// Remove brick files.
+		~NaniteStreamingBuilder();
+
+		// Append triangles, can call many times with chunks, brick buffers flush to disk when full.
+		bool addTriangles(const std::vector<uint32>& indices, const std::vector<Vertex>& vertices);
+
+		// Build bricks in parallel and stitch, output same layout as NaniteBuilder build, getVertices and getIndices.
+		bool build(MeshletContainer& outCtx, std::vector<Vertex>& outVertices, std::vector<uint32>& outIndices, NaniteBuildStats* outStats = nullptr);
+
+		uint32 getBrickCount() const 
+		{ 
+			return m_brickDim.x * m_brickDim.y * m_brickDim.z; 
+		}
+
+	private:
+		uint32 getBrickIndex(float3 position) const;
+		std::filesystem::path getBrickPath(uint32 brickIndex) const;
+		bool flushBrick(uint32 brickIndex);
+
+	private:
+		const std::filesystem::path m_workFolder;
+		const bool m_bFuse;
+		const bool m_bFuseIgnoreNormal;
+		const float m_coneWeight;
+		const EMeshletPartitioner m_partitioner;
+		cookstats::Report* const m_report;
+
+		float3 m_posMin;
+		float3 m_posMax;
+		math::uvec3 m_brickDim;
+
+		// Triangle soup of each brick wait to flush, three vertices per triangle.
+		std::vector<std::vector<Vertex>> m_brickBuffers;
+		std::vector<uint64> m_brickTriangleCounts;
+		uint64 m_bufferedVertexCount = 0;
+		bool m_bWriteFailed = false;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,556 @@
+#include <asset/nanite_page.h>
+
+#include <utils/log.h>
+#include <utils/cityhash.h>
+#include <utils/cvar.h>
+
+namespace chord::nanite
+{
+
+static uint32 sNanitePageSize = 128 * 1024;
+static AutoCVarRef cVarNanitePageSize(
+	"r.nanite.page.size",
+	sNanitePageSize,
+	"Byte budget of one nanite cluster streaming page, page hold whole meshlet groups so can exceed when one group is larger."
+);
+
+namespace clusterpage
+{
+	constexpr float kRootParentError = std::numeric_limits<float>::max();
+
+	// Avoid infinite projected error when camera inside page bounds.
+	constexpr float kMinProjectDistance = 1e-3f;
+
+	struct GroupInfo
+	{
+		uint32 index;
+		uint32 lod;
+		uint32 meshletCount;
+		uint32 byteSize;
+		uint64 mortonCode;
+		bool bRoot;
+
+		float3 posMin;
+		float3 posMax;
+	};
+
+	static uint64 hashClusterKey(float3 posCenter, float error)
+	{
+		const float4 key = float4(posCenter, error);
+		return cityhash::cityhash64((const char*)&key, sizeof(key));
+	}
+
+	static uint64 expandBits21(uint64 v)
+	{
+		v &= 0x1fffff;
+		v = (v | (v << 32)) & 0x001f00000000ffffULL;
+		v = (v | (v << 16)) & 0x001f0000ff0000ffULL;
+		v = (v | (v <<  8)) & 0x100f00f00f00f00fULL;
+		v = (v | (v <<  4)) & 0x10c30c30c30c30c3ULL;
+		v = (v | (v <<  2)) & 0x1249249249249249ULL;
+		return v;
+	}
+}
+
+uint32 getClusterPageSize()
+{
+	return math::max(sNanitePageSize, 1024U);
+}
+
+bool buildClusterPages(const MeshletContainer& ctx, ClusterPages& out)
+{
+	using namespace clusterpage;
+	out = { };
+
+	const uint32 groupCount = (uint32)ctx.meshletGroups.size();
+	if (groupCount == 0)
+	{
+		return true;
+	}
+
+	std::vector<GroupInfo> groups(groupCount);
+	float3 centerMin = float3( FLT_MAX);
+	float3 centerMax = float3(-FLT_MAX);
+	for (uint32 i = 0; i < groupCount; i++)
+	{
+		const auto& group = ctx.meshletGroups[i];
+
+		auto& info = groups[i];
+		info.index = i;
+		info.lod = 0;
+		info.meshletCount = group.meshletCount;
+		info.byteSize = sizeof(GPUGLTFMeshletGroup);
+		info.bRoot = (group.parentError == kRootParentError);
+		info.posMin = float3( FLT_MAX);
+		info.posMax = float3(-FLT_MAX);
+
+		for (uint32 j = 0; j < group.meshletCount; j++)
+		{
+			const auto& meshlet = ctx.meshlets[ctx.meshletGroupIndices[group.meshletOffset + j]];
+
+			info.lod = math::max(info.lod, meshlet.lod);
+			info.byteSize += sizeof(GLTFMeshlet) + (meshlet.info.vertex_count + meshlet.info.triangle_count) * sizeof(uint32);
+			info.posMin = math::min(info.posMin, meshlet.posMin);
+			info.posMax = math::max(info.posMax, meshlet.posMax);
+		}
+
+		centerMin = math::min(centerMin, group.clusterPosCenter);
+		centerMax = math::max(centerMax, group.clusterPosCenter);
+	}
+
+	// Spatial order inside lod so page bounds stay tight.
+	const float3 extent = math::max(centerMax - centerMin, float3(1e-6f));
+	for (auto& info : groups)
+	{
+		const float3 t = (ctx.meshletGroups[info.index].clusterPosCenter - centerMin) / extent;
+		const math::uvec3 q = math::uvec3(math::clamp(t, 0.0f, 1.0f) * float((1 << 21) - 1));
+		info.mortonCode = expandBits21(q.x) | (expandBits21(q.y) << 1) | (expandBits21(q.z) << 2);
+	}
+
+	// Root pages first, then coarse to fine, parent page usually before its children.
+	std::sort(groups.begin(), groups.end(), [](const GroupInfo& a, const GroupInfo& b)
+	{
+		if (a.bRoot != b.bRoot) { return a.bRoot; }
+		if (a.lod != b.lod) { return a.lod > b.lod; }
+		if (a.mortonCode != b.mortonCode) { return a.mortonCode < b.mortonCode; }
+		return a.index < b.index;
+	});
+
+	const uint32 pageSize = getClusterPageSize();
+	std::vector<std::pair<float3, float3>> pageBounds;
+	std::vector<uint32> groupPages(groupCount);
+	for (uint32 i = 0; i < groupCount; i++)
+	{
+		const auto& info = groups[i];
+
+		bool bNewPage = out.pages.empty();
+		if (!bNewPage)
+		{
+			const auto& page = out.pages.back();
+			const auto& last = groups[i - 1];
+			bNewPage = (last.bRoot != info.bRoot) || (last.lod != info.lod) || (page.byteSize + info.byteSize > pageSize);
+		}
+
+		if (bNewPage)
+		{
+			GLTFClusterPage page { };
+			page.groupOffset = (uint32)out.pageGroups.size();
+			page.lod = info.lod;
+			page.parentError = info.bRoot ? kRootParentError : 0.0f;
+
+			out.pages.push_back(page);
+			pageBounds.push_back({ float3(FLT_MAX), float3(-FLT_MAX) });
+		}
+
+		const uint32 pageIndex = (uint32)out.pages.size() - 1;
+		auto& page = out.pages.back();
+		page.groupCount ++;
+		page.meshletCount += info.meshletCount;
+		page.byteSize += info.byteSize;
+		if (!info.bRoot)
+		{
+			page.parentError = math::max(page.parentError, ctx.meshletGroups[info.index].parentError);
+		}
+
+		pageBounds[pageIndex].first  = math::min(pageBounds[pageIndex].first,  info.posMin);
+		pageBounds[pageIndex].second = math::max(pageBounds[pageIndex].second, info.posMax);
+
+		out.pageGroups.push_back(info.index);
+		groupPages[info.index] = pageIndex;
+	}
+
+	// Pages which hold clusters of one key, key split into many groups when group too large.
+	std::unordered_map<uint64, std::vector<uint32>> clusterKeyPages;
+	for (uint32 i = 0; i < groupCount; i++)
+	{
+		const auto& group = ctx.meshletGroups[i];
+
+		auto& pages = clusterKeyPages[hashClusterKey(group.clusterPosCenter, group.error)];
+		if (pages.empty() || pages.back() != groupPages[i])
+		{
+			pages.push_back(groupPages[i]);
+		}
+	}
+
+	const uint32 pageCount = (uint32)out.pages.size();
+	std::vector<std::vector<uint32>> pageParents(pageCount);
+	for (uint32 pageIndex = 0; pageIndex < pageCount; pageIndex++)
+	{
+		const auto& page = out.pages[pageIndex];
+		auto& parents = pageParents[pageIndex];
+
+		for (uint32 j = 0; j < page.groupCount; j++)
+		{
+			const uint32 groupIndex = out.pageGroups[page.groupOffset + j];
+			const auto& group = ctx.meshletGroups[groupIndex];
+			if (group.parentError == kRootParentError)
+			{
+				continue;
+			}
+
+			auto iter = clusterKeyPages.find(hashClusterKey(group.parentPosCenter, group.parentError));
+			if (iter == clusterKeyPages.end())
+			{
+				LOG_ERROR("Parent clusters of meshlet group #{} not found, cluster hierarchy is broken.", groupIndex);
+				out = { };
+				return false;
+			}
+
+			for (uint32 parentPage : iter->second)
+			{
+				if (parentPage != pageIndex)
+				{
+					parents.push_back(parentPage);
+				}
+			}
+		}
+
+		std::sort(parents.begin(), parents.end());
+		parents.erase(std::unique(parents.begin(), parents.end()), parents.end());
+
+		if (page.parentError != kRootParentError && parents.empty())
+		{
+			LOG_ERROR("Cluster page #{} is not root but has no parent page, cluster hierarchy is broken.", pageIndex);
+			out = { };
+			return false;
+		}
+	}
+
+	// Topological order, keep sort order when it already place parent page before child.
+	std::vector<uint32> order;
+	{
+		order.reserve(pageCount);
+
+		std::vector<uint32> pendingParentCount(pageCount);
+		std::vector<std::vector<uint32>> pageChildren(pageCount);
+		for (uint32 pageIndex = 0; pageIndex < pageCount; pageIndex++)
+		{
+			pendingParentCount[pageIndex] = (uint32)pageParents[pageIndex].size();
+			for (uint32 parentPage : pageParents[pageIndex])
+			{
+				pageChildren[parentPage].push_back(pageIndex);
+			}
+		}
+
+		std::priority_queue<uint32, std::vector<uint32>, std::greater<uint32>> readyPages;
+		for (uint32 pageIndex = 0; pageIndex < pageCount; pageIndex++)
+		{
+			if (pendingParentCount[pageIndex] == 0)
+			{
+				readyPages.push(pageIndex);
+			}
+		}
+
+		while (!readyPages.empty())
+		{
+			const uint32 pageIndex = readyPages.top();
+			readyPages.pop();
+
+			order.push_back(pageIndex);
+			for (uint32 child : pageChildren[pageIndex])
+			{
+				if (-- pendingParentCount[child] == 0)
+				{
+					readyPages.push(child);
+				}
+			}
+		}
+
+		if (order.size() != pageCount)
+		{
+			LOG_ERROR("Cluster page dependencies have cycle, cluster hierarchy is broken.");
+			out = { };
+			return false;
+		}
+	}
+
+	std::vector<uint32> sortedIndex(pageCount);
+	for (uint32 i = 0; i < pageCount; i++)
+	{
+		sortedIndex[order[i]] = i;
+	}
+
+	std::vector<GLTFClusterPage> sortedPages(pageCount);
+	std::vector<uint32> dependencies;
+	for (uint32 i = 0; i < pageCount; i++)
+	{
+		const uint32 pageIndex = order[i];
+
+		auto& page = sortedPages[i];
+		page = out.pages[pageIndex];
+
+		page.boundsCenter = 0.5f * (pageBounds[pageIndex].first + pageBounds[pageIndex].second);
+		page.boundsRadius = 0.5f * math::length(pageBounds[pageIndex].second - pageBounds[pageIndex].first);
+
+		dependencies.clear();
+		for (uint32 parentPage : pageParents[pageIndex])
+		{
+			dependencies.push_back(sortedIndex[parentPage]);
+		}
+		std::sort(dependencies.begin(), dependencies.end());
+
+		page.dependencyOffset = (uint32)out.pageDependencies.size();
+		page.dependencyCount = (uint32)dependencies.size();
+		out.pageDependencies.insert(out.pageDependencies.end(), dependencies.begin(), dependencies.end());
+	}
+	out.pages = std::move(sortedPages);
+
+	return true;
+}
+
+ClusterPageResidency::ClusterPageResidency(uint64 budgetBytes, uint32 maxLoadPerUpdate)
+	: m_budgetBytes(budgetBytes)
+	, m_maxLoadPerUpdate(math::max(maxLoadPerUpdate, 1U))
+{
+
+}
+
+uint32 ClusterPageResidency::addPrimitive(const std::vector<GLTFClusterPage>& pages, const std::vector<uint32>& pageDependencies, const math::mat4& localToWorld)
+{
+	// Root page hold hierarchy root groups, other pages must resolve parent pages order before them.
+	for (uint32 i = 0; i < (uint32)pages.size(); i++)
+	{
+		const auto& src = pages[i];
+
+		const bool bRoot = (src.parentError == clusterpage::kRootParentError);
+		bool bValid = bRoot || (src.dependencyCount > 0);
+		bValid &= (uint64(src.dependencyOffset) + src.dependencyCount <= pageDependencies.size());
+		for (uint32 j = 0; j < src.dependencyCount && bValid; j++)
+		{
+			bValid &= (pageDependencies[src.dependencyOffset + j] < i);
+		}
+
+		if (!bValid)
+		{
+			LOG_ERROR("Cluster page #{} parent pages unresolved, skip primitive.", i);
+			return kInvalidPage;
+		}
+	}
+
+	const uint32 firstPage = (uint32)m_pages.size();
+
+	// Error and bounds scale by max axis scale.
+	const float scale = math::max(math::length(float3(localToWorld[0])), math::max(math::length(float3(localToWorld[1])), math::length(float3(localToWorld[2]))));
+
+	for (uint32 i = 0; i < (uint32)pages.size(); i++)
+	{
+		const auto& src = pages[i];
+
+		Page page { };
+		page.center = float3(localToWorld * float4(src.boundsCenter, 1.0f));
+		page.radius = src.boundsRadius * scale;
+		page.byteSize = src.byteSize;
+		page.bRoot = (src.parentError == clusterpage::kRootParentError);
+		page.parentError = page.bRoot ? src.parentError : src.parentError * scale;
+
+		page.dependencyOffset = (uint32)m_dependencies.size();
+		page.dependencyCount = src.dependencyCount;
+		for (uint32 j = 0; j < src.dependencyCount; j++)
+		{
+			m_dependencies.push_back(firstPage + pageDependencies[src.dependencyOffset + j]);
+		}
+
+		m_pages.push_back(page);
+	}
+
+	// Root pages pinned.
+	for (uint32 i = firstPage; i < (uint32)m_pages.size(); i++)
+	{
+		if (m_pages[i].bRoot)
+		{
+			load(i);
+		}
+	}
+
+	return firstPage;
+}
+
+float ClusterPageResidency::getPriority(const Page& page, const ClusterPageView& view) const
+{
+	const float distance = math::max(math::distance(view.position, page.center) - page.radius, clusterpage::kMinProjectDistance);
+	return page.parentError * view.projectScale / distance;
+}
+
+void ClusterPageResidency::load(uint32 pageIndex)
+{
+	auto& page = m_pages[pageIndex];
+	check(!page.bResident);
+
+	page.bResident = true;
+	for (uint32 i = 0; i < page.dependencyCount; i++)
+	{
+		m_pages[m_dependencies[page.dependencyOffset + i]].residentChildCount ++;
+	}
+
+	if (!page.bRoot)
+	{
+		m_residentBytes += page.byteSize;
+
+		m_lru.push_front(pageIndex);
+		page.lruIterator = m_lru.begin();
+	}
+}
+
+void ClusterPageResidency::evict(uint32 pageIndex)
+{
+	auto& page = m_pages[pageIndex];
+	check(page.bResident && !page.bRoot && page.residentChildCount == 0);
+
+	page.bResident = false;
+	for (uint32 i = 0; i < page.dependencyCount; i++)
+	{
+		m_pages[m_dependencies[page.dependencyOffset + i]].residentChildCount --;
+	}
+
+	m_residentBytes -= page.byteSize;
+	m_lru.erase(page.lruIterator);
+	m_evictCount ++;
+}
+
+bool ClusterPageResidency::makeRoom(uint64 byteSize)
+{
+	while (m_residentBytes + byteSize > m_budgetBytes)
+	{
+		// Leaf page only, evict parent before children break hierarchy.
+		auto iter = m_lru.rbegin();
+		while (iter != m_lru.rend())
+		{
+			const auto& page = m_pages[*iter];
+			if (page.residentChildCount == 0 && page.lastRequiredUpdate != m_updateIndex)
+			{
+				break;
+			}
+			++iter;
+		}
+
+		if (iter == m_lru.rend())
+		{
+			return false;
+		}
+		evict(*iter);
+	}
+	return true;
+}
+
+ClusterPageResidencyStats ClusterPageResidency::update(const ClusterPageView& view)
+{
+	ClusterPageResidencyStats stats { };
+	m_updateIndex ++;
+
+	// Pages order parents first, so one pass can require parent of every required page.
+	std::vector<uint8> required(m_pages.size(), 0);
+	std::vector<std::pair<float, uint32>> requests;
+	for (uint32 i = 0; i < (uint32)m_pages.size(); i++)
+	{
+		auto& page = m_pages[i];
+
+		float priority = std::numeric_limits<float>::max();
+		bool bRequired = page.bRoot;
+		if (!bRequired)
+		{
+			priority = getPriority(page, view);
+			bRequired = priority > view.errorThreshold;
+			for (uint32 j = 0; j < page.dependencyCount && bRequired; j++)
+			{
+				bRequired = required[m_dependencies[page.dependencyOffset + j]];
+			}
+		}
+
+		if (!bRequired)
+		{
+			continue;
+		}
+
+		required[i] = 1;
+		stats.requiredCount ++;
+		page.lastRequiredUpdate = m_updateIndex;
+
+		if (page.bRoot)
+		{
+			continue;
+		}
+
+		if (page.bResident)
+		{
+			m_lru.splice(m_lru.begin(), m_lru, page.lruIterator);
+		}
+		else
+		{
+			requests.push_back({ priority, i });
+		}
+	}
+
+	// Largest projected error first, page wait next update when its parent still missing.
+	std::stable_sort(requests.begin(), requests.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+	for (const auto& [priority, pageIndex] : requests)
+	{
+		if (stats.loadCount >= m_maxLoadPerUpdate)
+		{
+			break;
+		}
+
+		const auto& page = m_pages[pageIndex];
+
+		bool bParentResident = true;
+		for (uint32 j = 0; j < page.dependencyCount && bParentResident; j++)
+		{
+			bParentResident = m_pages[m_dependencies[page.dependencyOffset + j]].bResident;
+		}
+
+		if (bParentResident && makeRoom(page.byteSize))
+		{
+			load(pageIndex);
+			stats.loadCount ++;
+		}
+	}
+
+	for (uint32 i = 0; i < (uint32)m_pages.size(); i++)
+	{
+		stats.residentCount += m_pages[i].bResident ? 1 : 0;
+		stats.missingCount += (required[i] && !m_pages[i].bResident) ? 1 : 0;
+	}
+
+	stats.evictCount = m_evictCount;
+	m_evictCount = 0;
+
+	stats.residentBytes = m_residentBytes;
+	return stats;
+}
+
+bool ClusterPageResidency::isValid() const
+{
+	if (m_residentBytes > m_budgetBytes)
+	{
+		return false;
+	}
+
+	std::vector<uint32> residentChildCounts(m_pages.size(), 0);
+	for (const auto& page : m_pages)
+	{
+		if (!page.bResident)
+		{
+			continue;
+		}
+
+		for (uint32 i = 0; i < page.dependencyCount; i++)
+		{
+			const uint32 dependency = m_dependencies[page.dependencyOffset + i];
+			if (!m_pages[dependency].bResident)
+			{
+				return false;
+			}
+			residentChildCounts[dependency] ++;
+		}
+	}
+
+	for (uint32 i = 0; i < (uint32)m_pages.size(); i++)
+	{
+		if (residentChildCounts[i] != m_pages[i].residentChildCount)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <asset/nanite_builder.h>
+
+namespace chord::nanite
+{
+	// Cluster hierarchy split into fixed size streaming pages.
+	// Page hold whole meshlet groups of one lod, pages order from coarse to fine and topological sort so parent page index always smaller.
+	// Group parent relation match by cluster key: child group parentPosCenter and parentError equal to
+	// clusterPosCenter and error of groups build from its simplified meshlets.
+	struct ClusterPages
+	{
+		std::vector<GLTFClusterPage> pages;
+
+		// Page group indices and page dependencies, offsets in pages index into them.
+		std::vector<uint32> pageGroups;
+		std::vector<uint32> pageDependencies;
+	};
+
+	// Page byte budget, see r.nanite.page.size.
+	extern uint32 getClusterPageSize();
+
+	// Return false when cluster hierarchy broken, parent clusters miss or page dependencies have cycle.
+	extern bool buildClusterPages(const MeshletContainer& ctx, ClusterPages& out);
+
+	// Camera of one residency update, position in world space.
+	struct ClusterPageView
+	{
+		float3 position;
+
+		// Pixels per unit at distance one, screenHeight / (2 * tan(fovY / 2)).
+		float  projectScale;
+
+		// Page required when projected parent error larger than this pixels.
+		float  errorThreshold = 1.0f;
+	};
+
+	struct ClusterPageResidencyStats
+	{
+		uint32 requiredCount = 0;
+		uint32 residentCount = 0;
+
+		// Required pages not resident after update, wait load or out of budget.
+		uint32 missingCount = 0;
+
+		uint32 loadCount = 0;
+		uint32 evictCount = 0;
+
+		uint64 residentBytes = 0;
+	};
+
+	// CPU side cluster page residency, drive by camera views without GPU.
+	// Root pages (hold hierarchy root groups) always resident. Each update mark required pages by projected parent error,
+	// request missing ones by priority with resident parents, and evict least recently required leaf pages when over budget.
+	class ClusterPageResidency : NonCopyable
+	{
+	public:
+		// Budget of non root pages, max new page load of one update.
+		explicit ClusterPageResidency(uint64 budgetBytes, uint32 maxLoadPerUpdate = 64);
+
+		static constexpr uint32 kInvalidPage = ~0U;
+
+		// Register pages of one primitive instance, localToWorld scale error and bounds.
+		// Return first global page index, kInvalidPage if non root page parents unresolved.
+		uint32 addPrimitive(const std::vector<GLTFClusterPage>& pages, const std::vector<uint32>& pageDependencies, const math::mat4& localToWorld);
+
+		// Mark required pages of view, load and evict, return stats after update.
+		ClusterPageResidencyStats update(const ClusterPageView& view);
+
+		uint32 getPageCount() const
+		{
+			return (uint32)m_pages.size();
+		}
+
+		bool isResident(uint32 pageIndex) const
+		{
+			return m_pages[pageIndex].bResident;
+		}
+
+		// Every resident page has resident parents, resident size within budget.
+		bool isValid() const;
+
+		uint64 getResidentBytes() const
+		{
+			return m_residentBytes;
+		}
+
+	private:
+		struct Page
+		{
+			float3 center;
+			float  radius;
+			float  parentError;
+			uint32 byteSize;
+
+			// Global parent page indices.
+			uint32 dependencyOffset;
+			uint32 dependencyCount;
+
+			uint32 residentChildCount = 0;
+			uint64 lastRequiredUpdate = 0;
+
+			bool bResident = false;
+			bool bRoot = false;
+
+			// Position in lru list when resident and not root.
+			std::list<uint32>::iterator lruIterator;
+		};
+
+		float getPriority(const Page& page, const ClusterPageView& view) const;
+		void load(uint32 pageIndex);
+		void evict(uint32 pageIndex);
+
+		// Evict lru leaf pages not required this update until size fit, return false if can't.
+		bool makeRoom(uint64 byteSize);
+
+	private:
+		const uint64 m_budgetBytes;
+		const uint32 m_maxLoadPerUpdate;
+
+		std::vector<Page> m_pages;
+		std::vector<uint32> m_dependencies;
+
+		// Front is most recent required.
+		std::list<uint32> m_lru;
+
+		uint64 m_residentBytes = 0;
+		uint64 m_updateIndex = 0;
+		uint32 m_evictCount = 0;
+	};
+}
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <asset/asset.h>
+#include <asset/asset_binary.h>
+#include <asset/asset_pack.h>
+#include <lz4hc.h>
 #include <asset/texture/asset_texture.h>
 
 #include <scene/scene.h>
@@ -70,7 +73,8 @@ registerPODClassMember(GLTFMeshlet)
 	ar(data.lod);
 }
 
-registerPODClassMember(GLTFPrimitive)
+// Version 1: cluster page range.
+registerPODClassMemberVersion(GLTFPrimitive, 1)
 {
 	ar(name, material, vertexCount, vertexOffset);
 	ar(bColor0Exist, bSmoothNormalExist, bTextureCoord1Exist);
@@ -79,6 +83,10 @@ registerPODClassMember(GLTFPrimitive)
 
 	ar(lod0IndicesOffset, lod0IndicesCount);
 
+	if (version > 0)
+	{
+		ar(clusterPageOffset, clusterPageCount);
+	}
 }
 
 registerPODClassMember(GLTFMesh)
@@ -191,14 +199,6 @@ registerClassMemberInherit(Scene, IAsset)
 
 namespace chord
 {
-	enum class ECompressionMode
-	{
-		None,
-		Lz4,
-
-		MAX
-	};
-
 	class AssetCompressedMeta
 	{
 	public:
@@ -213,27 +213,9 @@ namespace chord
 		}
 	};
 
-	template<typename T>
-	static bool saveAsset(const T& in, ECompressionMode compressionMode, const std::filesystem::path& savePath, bool bRequireNoExist = true)
+	// Compress raw serialized data and write to temp file then rename, reader never see half write asset.
+	inline bool writeAsset(std::string&& rawData, ECompressionMode compressionMode, const std::filesystem::path& savePath)
 	{
-		std::filesystem::path rawSavePath = savePath;
-		if (bRequireNoExist && std::filesystem::exists(rawSavePath))
-		{
-			LOG_ERROR("Meta data {} already exist, make sure never import save resource at same folder!",
-				utf8::utf16to8(rawSavePath.u16string()));
-			return false;
-		}
-
-		std::string rawData;
-		{
-			std::stringstream ss;
-			cereal::BinaryOutputArchive archive(ss);
-			archive(in);
-
-			// Exist copy construct.
-			rawData = std::move(ss.str());
-		}
-
 		AssetCompressedMeta meta;
 		meta.compressionMode = compressionMode;
 		meta.rawSize = (int32)rawData.size();
@@ -250,6 +232,18 @@ namespace chord
 
 			compressedData.resize(meta.compressionSize);
 		}
+		else if (compressionMode == ECompressionMode::Lz4HC)
+		{
+			compressedData.resize(LZ4_compressBound((int32)rawData.size()));
+			meta.compressionSize = LZ4_compress_HC(
+				rawData.c_str(),
+				compressedData.data(),
+				(int32)rawData.size(),
+				(int32)compressedData.size(),
+				LZ4HC_CLEVEL_DEFAULT);
+
+			compressedData.resize(meta.compressionSize);
+		}
 		else if (meta.compressionMode == ECompressionMode::None)
 		{
 			meta.compressionSize = meta.rawSize;
@@ -261,26 +255,83 @@ namespace chord
 		}
 		check(compressedData.size() == meta.compressionSize);
 
+		const auto tempPath = std::filesystem::path(savePath).concat(std::format(".{}.tmp", std::hash<std::thread::id>{ }(std::this_thread::get_id())));
 		{
-			std::ofstream os(rawSavePath, std::ios::binary);
+			std::ofstream os(tempPath, std::ios::binary | std::ios::trunc);
+			if (!os.is_open())
+			{
+				LOG_ERROR("Fail to open {} for write.", utf8::utf16to8(tempPath.u16string()));
+				return false;
+			}
+
 			cereal::BinaryOutputArchive archive(os);
 			archive(meta, compressedData);
 		}
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, savePath, ec);
+		if (ec)
+		{
+			LOG_ERROR("Fail to replace asset {}: {}.", utf8::utf16to8(savePath.u16string()), ec.message());
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+
+		assetpack::FileView packed { };
+		if (assetpack::findFile(savePath, packed))
+		{
+			LOG_WARN("Asset {} is in mounted pack, saved loose file is shadowed until pack rebuild.", utf8::utf16to8(savePath.u16string()));
+		}
 		return true;
 	}
 
 	template<typename T>
-	static bool loadAsset(T& out, const std::filesystem::path& savePath)
+	static std::string serializeAsset(const T& in)
 	{
-		if (!std::filesystem::exists(savePath))
+		std::stringstream ss;
+		cereal::BinaryOutputArchive archive(ss);
+		archive(in);
+
+		return std::move(ss).str();
+	}
+
+	template<typename T>
+	static bool saveAsset(const T& in, ECompressionMode compressionMode, const std::filesystem::path& savePath, bool bRequireNoExist = true)
+	{
+		if (bRequireNoExist && std::filesystem::exists(savePath))
 		{
-			LOG_ERROR("Asset data {} miss!", utf8::utf16to8(savePath.u16string()));
+			LOG_ERROR("Meta data {} already exist, make sure never import save resource at same folder!",
+				utf8::utf16to8(savePath.u16string()));
 			return false;
 		}
 
+		return writeAsset(serializeAsset(in), compressionMode, savePath);
+	}
+
+	template<typename T>
+	static bool loadAsset(T& out, const std::filesystem::path& savePath)
+	{
 		AssetCompressedMeta meta;
 		std::string compressedData;
+
+		// Mounted pack first, it never touch file system.
+		std::string packedData;
+		if (assetpack::readPackedFile(savePath, packedData))
+		{
+			std::istringstream is(std::move(packedData));
+			cereal::BinaryInputArchive archive(is);
+			archive(meta, compressedData);
+
+			check(meta.compressionSize == compressedData.size());
+		}
+		else
 		{
+			if (!std::filesystem::exists(savePath))
+			{
+				LOG_ERROR("Asset data {} miss!", utf8::utf16to8(savePath.u16string()));
+				return false;
+			}
+
 			std::ifstream is(savePath, std::ios::binary);
 			cereal::BinaryInputArchive archive(is);
 			archive(meta, compressedData);
@@ -290,7 +341,7 @@ namespace chord
 
 		// Allocate raw data memory.
 		std::string rawData;
-		if (meta.compressionMode == ECompressionMode::Lz4)
+		if (meta.compressionMode == ECompressionMode::Lz4 || meta.compressionMode == ECompressionMode::Lz4HC)
 		{
 			rawData.resize(meta.rawSize);
 
@@ -6,6 +6,76 @@ namespace chord
 {
 	const AssetTypeMeta TextureAsset::kAssetTypeMeta = TextureAsset::createTypeMeta();
 
+	uint64 TextureAssetBin::getSchemaHash()
+	{
+		static const uint64 kSchemaHash = assetbinary::buildSchemaHash({ { .name = "mipmapDatas", .stride = 1 } });
+		return kSchemaHash;
+	}
+
+	bool TextureAssetBin::save(const std::filesystem::path& savePath, cookstats::Report* report) const
+	{
+		AssetBinaryWriter writer;
+		writer.setDictionaryType("texture");
+		writer.setReport(report);
+		for (const auto& mip : mipmapDatas)
+		{
+			writer.addSection(mip);
+		}
+
+		return writer.write(savePath, getSchemaHash(), assetbinary::getConfigCompressionMode());
+	}
+
+	bool TextureAssetBin::saveMemory(std::string& out, const std::filesystem::path& debugPath) const
+	{
+		AssetBinaryWriter writer;
+		for (const auto& mip : mipmapDatas)
+		{
+			writer.addSection(mip);
+		}
+
+		return writer.writeMemory(out, debugPath, getSchemaHash());
+	}
+
+	bool TextureAssetBin::upgradeLegacy(const std::filesystem::path& path)
+	{
+		std::error_code ec;
+		if (!std::filesystem::is_regular_file(path, ec) || assetbinary::isAssetBinaryFile(path))
+		{
+			return true;
+		}
+
+		TextureAssetBin legacyBin { };
+		if (!loadAsset(legacyBin, path) || !legacyBin.save(path))
+		{
+			LOG_ERROR("Fail to convert legacy texture binary {}.", utf8::utf16to8(path.u16string()));
+			return false;
+		}
+		return true;
+	}
+
+	bool TextureAssetBinView::load(const std::filesystem::path& path)
+	{
+		if (!m_reader.open(path, TextureAssetBin::getSchemaHash()))
+		{
+			if (assetbinary::isAssetBinaryFile(path))
+			{
+				LOG_ERROR("Texture binary {} is stale, please re-import the asset.", utf8::utf16to8(path.u16string()));
+				return false;
+			}
+
+			// Legacy lz4 compressed cereal bin, decode into memory. Other reader may map the file, so rewrite only on save or cook.
+			TextureAssetBin legacyBin { };
+			std::string container;
+			if (!loadAsset(legacyBin, path) || !legacyBin.saveMemory(container, path) || !m_reader.openMemory(std::move(container), path, TextureAssetBin::getSchemaHash()))
+			{
+				LOG_ERROR("Fail to load legacy texture binary {}.", utf8::utf16to8(path.u16string()));
+				return false;
+			}
+		}
+
+		return true;
+	}
+
 	TextureAsset::TextureAsset(const AssetSaveInfo& saveInfo)
 		: IAsset(saveInfo)
 	{
@@ -19,18 +89,29 @@ namespace chord
 
 	bool TextureAsset::onSave()
 	{
+		if (!TextureAssetBin::upgradeLegacy(getBinPath()))
+		{
+			return false;
+		}
+
 		std::shared_ptr<IAsset> asset = ptr<TextureAsset>();
 		return saveAsset(asset, ECompressionMode::Lz4, m_saveInfo.path(), false);
 	}
 
+	bool TextureAsset::onSaveSnapshot(AsyncSaveSnapshot& out)
+	{
+		out.onWrite = [binPath = getBinPath()]() { return TextureAssetBin::upgradeLegacy(binPath); };
+		return IAsset::onSaveSnapshot(out);
+	}
+
 	void TextureAsset::onUnload()
 	{
 
 	}
 
-	TextureAssetRef tryLoadTextureAsset(const std::filesystem::path& path, bool bThreadSafe)
+	TextureAssetRef tryLoadTextureAsset(const std::filesystem::path& path)
 	{
-		return Application::get().getAssetManager().getOrLoadAsset<TextureAsset>(path, bThreadSafe);
+		return Application::get().getAssetManager().getOrLoadAsset<TextureAsset>(path);
 	}
 
 	bool TextureAsset::isGPUTextureStreamingReady() const
@@ -81,8 +162,8 @@ namespace chord
 			[newGPUTexture, assetPtr](uint32 offset, uint32 queueFamily, void* mapped, VkCommandBuffer cmd, VkBuffer buffer)
 			{
 				auto texture = newGPUTexture->getOwnHandle();
-				TextureAssetBin textureBin{};
-				if (!std::filesystem::exists(assetPtr->getBinPath()))
+				TextureAssetBinView textureBin{};
+				if (!assetpack::exists(assetPtr->getBinPath()))
 				{
 					checkEntry();
 				}
@@ -90,7 +171,7 @@ namespace chord
 				{
 					LOG_TRACE("Found bin for asset {} cache in disk so just load.",
 						utf8::utf16to8(assetPtr->getSaveInfo().relativeAssetStorePath().u16string()));
-					loadAsset(textureBin, assetPtr->getBinPath());
+					check(textureBin.load(assetPtr->getBinPath()));
 				}
 
 				VkImageSubresourceRange rangeAllMips = helper::buildBasicImageSubresource();
@@ -110,16 +191,15 @@ namespace chord
 				region.bufferImageHeight = 0;
 
 				std::vector<VkBufferImageCopy> copyRegions{};
-				const auto& mipmapDatas = textureBin.mipmapDatas;
+				check(textureBin.getMipmapCount() >= assetPtr->getMipmapCount());
 				for (uint32 level = 0; level < assetPtr->getMipmapCount(); level++)
 				{
-					const auto& currentMip = mipmapDatas.at(level);
-					const uint32 currentMipSize = (uint32)currentMip.size();
+					const uint32 currentMipSize = (uint32)textureBin.getMipmapSize(level);
 
 					uint32 mipWidth  = std::max<uint32>(assetPtr->getDimension().x >> level, 1);
 					uint32 mipHeight = std::max<uint32>(assetPtr->getDimension().y >> level, 1);
 
-					memcpy((void*)((char*)mapped + bufferOffset), currentMip.data(), currentMipSize);
+					check(textureBin.readMipmap(level, (char*)mapped + bufferOffset));
 
 					region.bufferOffset = offset + bufferOffset;
 					region.imageSubresource.mipLevel = level;
@@ -3,6 +3,7 @@
 #include <utils/utils.h>
 #include <asset/asset_common.h>
 #include <asset/asset.h>
+#include <asset/asset_binary.h>
 #include <asset/texture/asset_Texture_helper.h>
 
 namespace chord
@@ -15,6 +16,44 @@ namespace chord
 		{
 			ar(mipmapDatas);
 		}
+
+		// Layout hash of the chunked binary.
+		static uint64 getSchemaHash();
+
+		// Save as chunked asset binary, one section per mip.
+		bool save(const std::filesystem::path& savePath, cookstats::Report* report = nullptr) const;
+
+		// Save as uncompressed chunked asset binary in memory.
+		bool saveMemory(std::string& out, const std::filesystem::path& debugPath) const;
+
+		// Rewrite legacy lz4 cereal bin to current format in place, only call from save or cook path.
+		static bool upgradeLegacy(const std::filesystem::path& path);
+	};
+
+	// Chunked view of TextureAssetBin, each mip can read alone.
+	struct TextureAssetBinView
+	{
+		// Map binary file, legacy lz4 bin decode into memory and file keep untouched.
+		bool load(const std::filesystem::path& path);
+
+		uint32 getMipmapCount() const
+		{
+			return m_reader.getSectionCount();
+		}
+
+		uint64 getMipmapSize(uint32 level) const
+		{
+			return m_reader.getSectionSize(level);
+		}
+
+		// Decompress one mip into dest, dest size must >= mip size.
+		bool readMipmap(uint32 level, void* dest) const
+		{
+			return m_reader.readSection(level, dest);
+		}
+
+	private:
+		AssetBinaryReader m_reader;
 	};
 
 	class TextureAsset : public IAsset
@@ -22,7 +61,7 @@ namespace chord
 		REGISTER_BODY_DECLARE(IAsset);
 
 		friend class AssetManager;
-		friend bool importFromConfig(TextureAssetImportConfigRef);
+		friend bool importFromConfig(TextureAssetImportConfigRef, cookstats::Report*);
 	public:
 		// Color gamma space.
 		enum class EColorSpace
@@ -48,6 +87,7 @@ namespace chord
 
 		virtual bool onSave() override;
 		virtual void onUnload() override;
+		virtual bool onSaveSnapshot(AsyncSaveSnapshot& out) override;
 		// ~IAsset virtual function.
 
 	public:
@@ -127,9 +167,9 @@ namespace chord
 	};
 	using TextureAssetRef = std::shared_ptr<TextureAsset>;
 
-	extern TextureAssetRef tryLoadTextureAsset(const std::filesystem::path& path, bool bThreadSafe = true);
-	inline TextureAssetRef tryLoadTextureAsset(const AssetSaveInfo& info, bool bThreadSafe = true)
+	extern TextureAssetRef tryLoadTextureAsset(const std::filesystem::path& path);
+	inline TextureAssetRef tryLoadTextureAsset(const AssetSaveInfo& info)
 	{
-		return tryLoadTextureAsset(info.path(), bThreadSafe);
+		return tryLoadTextureAsset(info.path());
 	}
 }
@@ -1,5 +1,6 @@
 #include <asset/serialize.h>
 #include <asset/texture/asset_texture_helper.h>
+#include <asset/texture/texture_mipmap.h>
 #include <ui/ui_helper.h>
 #include <asset/texture/asset_texture.h>
 #include <asset/asset.h>
@@ -15,6 +16,8 @@
 #include <graphics/uploader.h>
 #include <graphics/helper.h>
 #include <utils/job_system.h>
+#include <asset/derived_data_cache.h>
+#include <asset/cook_stats.h>
 
 namespace chord
 {
@@ -335,205 +338,6 @@ namespace chord
 		}
 	}
 
-	namespace mipmap
-	{
-		constexpr int32 kFindBestAlphaCount = 50;
-
-		template<typename T> double getQuantifySize() { checkEntry(); return 0.0; }
-		
-		// When mipmap downsample average, we 
-		template<> double getQuantifySize<uint8 >() { return double(1 <<  8) - 1.0; }
-		template<> double getQuantifySize<uint16>() { return double(1 << 16) - 1.0; }
-		template<> double getQuantifySize<float >() { return 1.0; }
-
-		void checkMipmapParams(uint32 channelCount, uint32 pixelOffsetPerSample, float alphaMipmapCutoff)
-		{
-			check(channelCount == 1 || channelCount == 2 || channelCount == 4);
-			check(channelCount + pixelOffsetPerSample <= 4);
-			check(alphaMipmapCutoff >= 0.0f && alphaMipmapCutoff <= 1.0f);
-		}
-
-		template<typename T>
-		static double getAlphaCoverage(const T* data, uint32 width, uint32 height, double scale, double cutoff)
-		{
-			const double kQuantitySize = getQuantifySize<T>();
-
-			double value = 0.0;
-			T* pImg = (T*)data;
-
-			// Loop all texture to get coverage alpha data.
-			for (uint32 y = 0; y < height; y++)
-			{
-				for (uint32 x = 0; x < width; x++)
-				{
-					T* pPixel = pImg;
-					pImg += 4;
-
-					double alpha = scale * double(pPixel[3]) / kQuantitySize;
-
-					if (alpha > 1.0) { alpha = 1.0; }
-					if (alpha < cutoff) { continue; }
-
-					// Accumulate.
-					value += alpha;
-				}
-			}
-
-			// Normalize.
-			return value / double(height * width);
-		}
-
-		// Apply scale in alpha channel.
-		template<typename T>
-		static void scaleAlpha(const T* data, uint32 width, uint32 height, double scale)
-		{
-			constexpr double kQuantitySize = getQuantifySize<T>();
-
-			T* pImg = (T*)data;
-			for (uint32 y = 0; y < height; y++)
-			{
-				for (uint32 x = 0; x < width; x++)
-				{
-					T* pPixel = pImg;
-					pImg += 4;
-
-					// Load and apply scale in alpha.
-					double alpha = scale * double(pPixel[3]) / kQuantitySize;
-					alpha = math::clamp(alpha, 0.0, 1.0);
-
-					pPixel[3] = T(alpha * kQuantitySize);
-				}
-			}
-		}
-
-		template<typename T>
-		void buildMipmapData(
-			uint32 channelCount,
-			uint32 pixelOffsetPerSample,
-			const T* srcPixels,
-			TextureAssetBin& outBinData,
-			uint32 mipmapCount,
-			uint32 inWidth,
-			uint32 inHeight,
-			float alphaMipmapCutoff,
-			bool bSRGB)
-		{
-			if (bSRGB)
-			{
-				constexpr bool bUnit8 = std::is_same_v<T, uint8>;
-				check(bUnit8);
-			}
-
-			checkMipmapParams(channelCount, pixelOffsetPerSample, alphaMipmapCutoff);
-			const double kQuantitySize = getQuantifySize<T>();
-
-			float alphaCoverage = 1.0f;
-			const bool bKeepAlphaCoverage = (alphaMipmapCutoff < 1.0f) && (channelCount == 4);
-
-			// Prepare mipmap datas.
-			outBinData.mipmapDatas.resize(mipmapCount);
-
-			// Get strip size.
-			const auto kStripSize = sizeof(T) * channelCount;
-
-			// Now build each mipmap.
-			for (auto mip = 0; mip < outBinData.mipmapDatas.size(); mip++)
-			{
-				auto& destMipData = outBinData.mipmapDatas[mip];
-
-				// Compute mipmap size.
-				uint32 destWidth  = math::max<uint32>(inWidth  >> mip, 1);
-				uint32 destHeight = math::max<uint32>(inHeight >> mip, 1);
-
-				// Allocate memory.
-				destMipData.resize(destWidth * destHeight * kStripSize);
-
-				T* pDestData = (T*)destMipData.data();
-				if (mip == 0)
-				{
-					if (channelCount == 4)
-					{
-						// Source data copy.
-						memcpy((void*)pDestData, srcPixels, destMipData.size() * sizeof(destMipData[0]));
-					}
-					else
-					{
-						for (auto i = 0; i < destWidth * destHeight; i++)
-						{
-							for (auto j = 0; j < channelCount; j++)
-							{
-								pDestData[i * channelCount + j] = srcPixels[i * 4 + j + pixelOffsetPerSample];
-							}
-						}
-					}
-
-					if (bKeepAlphaCoverage)
-					{
-						alphaCoverage = getAlphaCoverage<T>((const T*)destMipData.data(), destWidth, destHeight, 1.0, alphaMipmapCutoff);
-					}
-				}
-				else
-				{
-					const auto srcMip = mip - 1;
-					const T* pSrcData = (const T*)outBinData.mipmapDatas[srcMip].data();
-
-					for (auto y = 0; y < destHeight; y++)
-					{
-						for (auto x = 0; x < destWidth; x++)
-						{
-							// Get src data.
-							uint32 srcWidth  = std::max<uint32>(inWidth  >> srcMip, 1);
-							uint32 srcHeight = std::max<uint32>(inHeight >> srcMip, 1);
-
-							// Clamp src data fetech edge.
-							auto srcX0 = std::min<uint32>(uint32(x * 2 + 0), srcWidth  - 1);
-							auto srcX1 = std::min<uint32>(uint32(x * 2 + 1), srcWidth  - 1);
-							auto srcY0 = std::min<uint32>(uint32(y * 2 + 0), srcHeight - 1);
-							auto srcY1 = std::min<uint32>(uint32(y * 2 + 1), srcHeight - 1);
-
-							uint32 srcPixelStart[] =
-							{
-								(srcY0 * srcWidth + srcX0) * channelCount, // X0Y0
-								(srcY0 * srcWidth + srcX1) * channelCount, // X1Y0
-								(srcY1 * srcWidth + srcX0) * channelCount, // X0Y1
-								(srcY1 * srcWidth + srcX1) * channelCount, // X1Y1
-							};
-							
-							auto destPixelPosStart = (y * destWidth + x) * channelCount;
-
-							for (auto channelId = 0; channelId < channelCount; channelId++)
-							{
-								double sumValue = 0.0;
-								const bool bAlphaChannel = (channelId + pixelOffsetPerSample == 3);
-
-								for (auto srcPixelId = 0; srcPixelId < 4; srcPixelId++)
-								{
-									T rawData = pSrcData[srcPixelStart[srcPixelId] + channelId];
-
-									double normalizeValue = double(rawData) / kQuantitySize;
-									if (!bAlphaChannel && bSRGB)
-									{
-										normalizeValue = double(rec709GammaDecode(float(normalizeValue)));
-									}
-
-									sumValue += normalizeValue;
-								}
-								sumValue *= 0.25;
-
-								if (!bAlphaChannel && bSRGB)
-								{
-									sumValue = double(rec709GammaEncode(float(sumValue)));
-								}
-								pDestData[destPixelPosStart + channelId] = T(sumValue * kQuantitySize);
-							}
-						}
-					}
-				}
-				check(destHeight * destWidth * kStripSize == destMipData.size());
-			}
-		}
-	}
-	
 	VkFormat getFormatFromConfig(const TextureAssetImportConfig& config, bool bCanCompressed)
 	{
 		if (config.format == ETextureFormat::R16Unorm)
@@ -847,7 +651,7 @@ namespace chord
 
 				{
 					std::vector<uint8> snapshotData{ };
-					if (!std::filesystem::exists(assetPtr->getSnapshotPath()))
+					if (!assetpack::exists(assetPtr->getSnapshotPath()))
 					{
 						checkEntry();
 					}
@@ -941,7 +745,98 @@ namespace chord
 		}
 	}
 
-	bool importFromConfig(TextureAssetImportConfigRef config)
+	// Texture cook result store in derived data cache, bump version when cook output change.
+	namespace texture_ddc
+	{
+		constexpr uint32 kCookVersion = 2;
+
+		struct Record
+		{
+			uint32 bSRGB;
+			uint32 mipmapCount;
+			int32  format;
+			float  alphaMipmapCutoff;
+			math::uvec3 dimension;
+			math::uvec2 snapshotDimension;
+		};
+
+		// Sections: record, snapshot, mip 0 ... mip N.
+		static uint64 getSchemaHash()
+		{
+			static const uint64 kSchemaHash = assetbinary::buildSchemaHash({ { "record", sizeof(Record) }, { "snapshot", 1 }, { "mipmapDatas", 1 } });
+			return kSchemaHash;
+		}
+
+		static bool buildKey(const TextureAssetImportConfig& config, ddc::Key& outKey)
+		{
+			ddc::KeyBuilder builder("texture", kCookVersion);
+			if (!builder.updateFile(config.importFilePath))
+			{
+				return false;
+			}
+
+			builder.update(config.bSRGB);
+			builder.update(config.bGenerateMipmap);
+			builder.update(config.alphaMipmapCutoff);
+			builder.update(config.format);
+
+			outKey = builder.finalize();
+			return true;
+		}
+
+		static bool load(const ddc::Key& key, Record& outRecord, TextureAssetBin& outBin, std::vector<uint8>& outSnapshot, cookstats::Report* report)
+		{
+			AssetBinaryReader reader;
+			if (!ddc::get(key, getSchemaHash(), reader, report) || reader.getSectionCount() < 2)
+			{
+				return false;
+			}
+
+			std::vector<Record> record;
+			if (!reader.copySection(0, record) || record.size() != 1 || !reader.copySection(1, outSnapshot))
+			{
+				return false;
+			}
+
+			outBin.mipmapDatas.resize(reader.getSectionCount() - 2);
+			for (uint32 i = 0; i < outBin.mipmapDatas.size(); i++)
+			{
+				if (!reader.copySection(i + 2, outBin.mipmapDatas[i]))
+				{
+					return false;
+				}
+			}
+
+			outRecord = record[0];
+			return true;
+		}
+
+		static void save(const ddc::Key& key, const TextureAsset& texture, const TextureAssetBin& bin, const std::vector<uint8>& snapshot, const math::uvec2& snapshotDimension, cookstats::Report* report)
+		{
+			Record record { };
+			record.bSRGB = texture.isSRGB() ? 1 : 0;
+			record.mipmapCount = texture.getMipmapCount();
+			record.format = (int32)texture.getFormat();
+			record.alphaMipmapCutoff = texture.getAlphaMipmapCutOff();
+			record.dimension = texture.getDimension();
+			record.snapshotDimension = snapshotDimension;
+
+			AssetBinaryWriter writer;
+			writer.addSection(&record, sizeof(record), sizeof(record));
+			writer.addSection(snapshot);
+			for (const auto& mip : bin.mipmapDatas)
+			{
+				writer.addSection(mip);
+			}
+
+			if (!ddc::put(key, getSchemaHash(), writer, assetbinary::getConfigCompressionMode(), report))
+			{
+				LOG_WARN("Fail to store texture {} in derived data cache.", utf8::utf16to8(texture.getSaveInfo().path().u16string()));
+			}
+		}
+	}
+
+	bool importFromConfig(TextureAssetImportConfigRef config, cookstats::Report* report)
 	{
 		const std::filesystem::path& srcPath = config->importFilePath;
 		const std::filesystem::path& savePath = config->storeFilePath;
@@ -962,12 +857,21 @@ namespace chord
 		uint32 pixelSampleOffset;
 		getChannelCountOffset(channelCount, pixelSampleOffset, config->format);
 
+		// Cook result, also store in derived data cache.
+		TextureAssetBin cookedBin { };
+		std::vector<uint8> cookedSnapshot { };
+		math::uvec2 cookedSnapshotDimension { 0, 0 };
+
 		auto importLdrTexture = [&]() -> bool
 		{
 			auto imageLdr = std::make_unique<ImageLdr2D>();
-			if (!imageLdr->fillFromFile(srcPath.string()))
 			{
-				return false;
+				cookstats::ScopedStage stage("texture.decode", report);
+				if (!imageLdr->fillFromFile(srcPath.string()))
+				{
+					return false;
+				}
+				stage.setBytes(imageLdr->getSize());
 			}
 
 			const int32 texWidth = imageLdr->getWidth();
@@ -993,6 +897,8 @@ namespace chord
 
 			// Build snapshot.
 			{
+				cookstats::ScopedStage stage("texture.snapshot", report);
+
 				math::uvec2 dimSnapshot;
 				std::vector<uint8> data{};
 
@@ -1000,21 +906,26 @@ namespace chord
 				snapshot::build8bit(*texturePtr, data, (const unsigned char*)pixels, 4, dimSnapshot);
 
 				texturePtr->saveSnapShot(dimSnapshot, data);
+
+				cookedSnapshot = std::move(data);
+				cookedSnapshotDimension = dimSnapshot;
 			}
 
 			// Build mipmap.
 			{
-				TextureAssetBin bin{};
-				mipmap::buildMipmapData<uint8>(
-					channelCount, 
-					pixelSampleOffset, 
-					pixels, 
-					bin,
-					texturePtr->m_mipmapCount,
-					texturePtr->m_dimension.x,
-					texturePtr->m_dimension.y,
-					texturePtr->m_mipmapAlphaCutoff,
-					texturePtr->m_bSRGB);
+				TextureAssetBin& bin = cookedBin;
+				{
+					cookstats::ScopedStage stage("texture.mipmap", report);
+					buildMipmap<uint8>(
+						channelCount,
+						pixelSampleOffset,
+						pixels,
+						texturePtr->m_mipmapCount,
+						texturePtr->m_dimension.x,
+						texturePtr->m_dimension.y,
+						texturePtr->m_bSRGB,
+						bin.mipmapDatas);
+				}
 
 				switch (texturePtr->getFormat())
 				{
@@ -1034,13 +945,16 @@ namespace chord
 				case VK_FORMAT_BC4_UNORM_BLOCK:
 				{
 					check(bCanCompressed);
+
+					cookstats::ScopedStage stage("texture.compress", report);
 					dxt::mipmapCompressBC(bin, *texturePtr);
 				}
 				break;
 				default: checkEntry();
 				}
 
-				saveAsset(bin, ECompressionMode::Lz4, texturePtr->getBinPath(), false);
+				cookstats::ScopedStage stage("texture.save", report);
+				bin.save(texturePtr->getBinPath(), report);
 			}
 
 			return true;
@@ -1049,9 +963,13 @@ namespace chord
 		auto importHalfTexture = [&]() -> bool
 		{
 			auto imageHalf = std::make_unique<ImageHalf2D>();
-			if (!imageHalf->fillFromFile(srcPath.string()))
 			{
-				return false;
+				cookstats::ScopedStage stage("texture.decode", report);
+				if (!imageHalf->fillFromFile(srcPath.string()))
+				{
+					return false;
+				}
+				stage.setBytes(imageHalf->getSize());
 			}
 
 			const auto* pixels = imageHalf->getPixels();
@@ -1077,27 +995,34 @@ namespace chord
 
 			// Build snapshot.
 			{
+				cookstats::ScopedStage stage("texture.snapshot", report);
+
 				math::uvec2 dimSnapshot;
 				std::vector<uint8> data{};
 
 				snapshot::build16bit(*texturePtr, data, pixels, 4, dimSnapshot);
 
 				texturePtr->saveSnapShot(dimSnapshot, data);
+
+				cookedSnapshot = std::move(data);
+				cookedSnapshotDimension = dimSnapshot;
 			}
 
 			// Build mipmap.
 			{
-				TextureAssetBin bin{};
-				mipmap::buildMipmapData<uint16>(
-					channelCount,
-					pixelSampleOffset,
-					pixels,
-					bin,
-					texturePtr->m_mipmapCount,
-					texturePtr->m_dimension.x,
-					texturePtr->m_dimension.y,
-					texturePtr->m_mipmapAlphaCutoff,
-					texturePtr->m_bSRGB);
+				TextureAssetBin& bin = cookedBin;
+				{
+					cookstats::ScopedStage stage("texture.mipmap", report);
+					buildMipmap<uint16>(
+						channelCount,
+						pixelSampleOffset,
+						pixels,
+						texturePtr->m_mipmapCount,
+						texturePtr->m_dimension.x,
+						texturePtr->m_dimension.y,
+						texturePtr->m_bSRGB,
+						bin.mipmapDatas);
+				}
 
 				switch (texturePtr->getFormat())
 				{
@@ -1110,7 +1035,8 @@ namespace chord
 				default: checkEntry();
 				}
 
-				saveAsset(bin, ECompressionMode::Lz4, texturePtr->getBinPath(), false);
+				cookstats::ScopedStage stage("texture.save", report);
+				bin.save(texturePtr->getBinPath(), report);
 			}
 
 			return true;
@@ -1118,35 +1044,62 @@ namespace chord
 
 
 		bool bImportSucceed = false;
-		switch (config->format)
-		{
-		case ETextureFormat::R8G8B8A8:
-		case ETextureFormat::BC3:
-		case ETextureFormat::BC1:
-		case ETextureFormat::BC5:
-		case ETextureFormat::R8G8:
-		case ETextureFormat::Greyscale:
-		case ETextureFormat::R8:
-		case ETextureFormat::G8:
-		case ETextureFormat::B8:
-		case ETextureFormat::A8:
-		case ETextureFormat::BC4Greyscale:
-		case ETextureFormat::BC4R8:
-		case ETextureFormat::BC4G8:
-		case ETextureFormat::BC4B8:
-		case ETextureFormat::BC4A8:
+
+		// Cache hit skip decode, mipmap generation and block compression.
+		ddc::Key ddcKey { };
+		const bool bDDCKeyValid = ddc::isEnable() && texture_ddc::buildKey(*config, ddcKey);
+		texture_ddc::Record ddcRecord { };
+		if (bDDCKeyValid && texture_ddc::load(ddcKey, ddcRecord, cookedBin, cookedSnapshot, report))
 		{
-			bImportSucceed = importLdrTexture();
-			break;
+			LOG_TRACE("Texture '{}' hit derived data cache {}.", utf8::utf16to8(srcPath.u16string()), ddcKey.toString());
+
+			texturePtr->initBasicInfo(
+				ddcRecord.bSRGB != 0,
+				ddcRecord.mipmapCount,
+				VkFormat(ddcRecord.format),
+				ddcRecord.dimension,
+				ddcRecord.alphaMipmapCutoff);
+
+			texturePtr->saveSnapShot(ddcRecord.snapshotDimension, cookedSnapshot);
+			bImportSucceed = cookedBin.save(texturePtr->getBinPath(), report);
 		}
-		case ETextureFormat::RGBA16Unorm:
-		case ETextureFormat::R16Unorm:
+		else
 		{
-			bImportSucceed = importHalfTexture();
-			break;
-		}
-		default:
-			checkEntry();
+			switch (config->format)
+			{
+			case ETextureFormat::R8G8B8A8:
+			case ETextureFormat::BC3:
+			case ETextureFormat::BC1:
+			case ETextureFormat::BC5:
+			case ETextureFormat::R8G8:
+			case ETextureFormat::Greyscale:
+			case ETextureFormat::R8:
+			case ETextureFormat::G8:
+			case ETextureFormat::B8:
+			case ETextureFormat::A8:
+			case ETextureFormat::BC4Greyscale:
+			case ETextureFormat::BC4R8:
+			case ETextureFormat::BC4G8:
+			case ETextureFormat::BC4B8:
+			case ETextureFormat::BC4A8:
+			{
+				bImportSucceed = importLdrTexture();
+				break;
+			}
+			case ETextureFormat::RGBA16Unorm:
+			case ETextureFormat::R16Unorm:
+			{
+				bImportSucceed = importHalfTexture();
+				break;
+			}
+			default:
+				checkEntry();
+			}
+
+			if (bImportSucceed && bDDCKeyValid)
+			{
+				texture_ddc::save(ddcKey, *texturePtr, cookedBin, cookedSnapshot, cookedSnapshotDimension, report);
+			}
 		}
 
 		// Copy raw asset to project asset.
@@ -1193,7 +1146,10 @@ namespace chord
 			};
 			result.importConfig.importAssetFromConfig = [](IAssetImportConfigRef config)
 			{
-				return importFromConfig(std::static_pointer_cast<TextureAssetImportConfig>(config));
+				return cookstats::importWithReport("texture", config->importFilePath, config->storeFilePath, config->parentReport, [&config](cookstats::Report* report)
+				{
+					return importFromConfig(std::static_pointer_cast<TextureAssetImportConfig>(config), report);
+				});
 			};
 		}
 
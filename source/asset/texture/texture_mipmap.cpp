@@ -0,0 +1,351 @@
+#include <asset/texture/texture_mipmap.h>
+#include <shader/colorspace.h>
+#include <utils/job_system.h>
+#include <utils/cvar.h>
+
+namespace chord
+{
+	static uint32 sTextureMipmapParallel = 1;
+	static AutoCVarRef cVarTextureMipmapParallel(
+		"r.texture.mipmap.parallel",
+		sTextureMipmapParallel,
+		"Build texture mipmap with srgb lookup tables and rows split across job system, or with single thread reference path."
+	);
+
+	namespace texture_mipmap
+	{
+		// Mip with less rows than this downsample on current thread.
+		constexpr uint32 kParallelMinRowCount = 64;
+
+		struct SRGBTables
+		{
+			// Linear value of each srgb uint8.
+			std::array<float, 256> decode;
+
+			// Smallest linear value which encode to each srgb uint8, infinity if never reach.
+			std::array<float, 256> encodeThresholds;
+		};
+
+		static float decodeReference(uint8 value)
+		{
+			return rec709GammaDecode(float(value) / 255.0f);
+		}
+
+		static const SRGBTables& getSRGBTables()
+		{
+			static const SRGBTables kTables = []()
+			{
+				SRGBTables tables { };
+				for (uint32 value = 0; value < 256; value++)
+				{
+					tables.decode[value] = decodeReference(uint8(value));
+				}
+
+				// Encode is monotonic in [0, 1], positive float bits keep value order so binary search on bits.
+				const uint32 maxBits = std::bit_cast<uint32>(1.0f);
+				tables.encodeThresholds[0] = 0.0f;
+				for (uint32 level = 1; level < 256; level++)
+				{
+					if (srgbEncodeReference(1.0f) < level)
+					{
+						tables.encodeThresholds[level] = std::numeric_limits<float>::infinity();
+						continue;
+					}
+
+					uint32 low = 0;
+					uint32 high = maxBits;
+					while (low < high)
+					{
+						const uint32 mid = low + (high - low) / 2;
+						if (srgbEncodeReference(std::bit_cast<float>(mid)) >= level)
+						{
+							high = mid;
+						}
+						else
+						{
+							low = mid + 1;
+						}
+					}
+					tables.encodeThresholds[level] = std::bit_cast<float>(low);
+				}
+
+				return tables;
+			}();
+			return kTables;
+		}
+
+		// Branchless search of last threshold not greater than linear.
+		static inline uint8 encode(const SRGBTables& tables, float linear)
+		{
+			uint32 level = 0;
+			for (uint32 step = 128; step > 0; step >>= 1)
+			{
+				level += (linear >= tables.encodeThresholds[level + step]) ? step : 0;
+			}
+			return uint8(level);
+		}
+
+		static void checkParams(uint32 channelCount, uint32 pixelOffsetPerSample, bool bSRGB, bool bUint8)
+		{
+			check(channelCount == 1 || channelCount == 2 || channelCount == 4);
+			check(channelCount + pixelOffsetPerSample <= 4);
+			check(!bSRGB || bUint8);
+		}
+
+		// Alpha channel always linear.
+		static uint32 getSRGBChannelMask(uint32 channelCount, uint32 pixelOffsetPerSample, bool bSRGB)
+		{
+			uint32 mask = 0;
+			for (uint32 channelId = 0; channelId < channelCount; channelId++)
+			{
+				if (bSRGB && (channelId + pixelOffsetPerSample != 3))
+				{
+					mask |= (1U << channelId);
+				}
+			}
+			return mask;
+		}
+
+		template<typename T>
+		static void copyMip0(uint32 channelCount, uint32 pixelOffsetPerSample, const T* srcPixels, uint32 width, uint32 height, std::vector<uint8>& outData)
+		{
+			outData.resize(uint64(width) * height * channelCount * sizeof(T));
+
+			T* pDestData = (T*)outData.data();
+			if (channelCount == 4)
+			{
+				memcpy((void*)pDestData, srcPixels, outData.size());
+				return;
+			}
+
+			for (uint64 i = 0; i < uint64(width) * height; i++)
+			{
+				for (uint32 j = 0; j < channelCount; j++)
+				{
+					pDestData[i * channelCount + j] = srcPixels[i * 4 + j + pixelOffsetPerSample];
+				}
+			}
+		}
+
+		// One dest row, channel count is compile time so channel loop unroll and linear only rows vectorize.
+		template<typename T, uint32 kChannelCount>
+		static void downsampleRow(const T* srcRow0, const T* srcRow1, uint32 srcWidth, T* destRow, uint32 destWidth, uint32 srgbChannelMask, const SRGBTables& tables)
+		{
+			for (uint32 x = 0; x < destWidth; x++)
+			{
+				const uint32 x0 = math::min(x * 2 + 0, srcWidth - 1) * kChannelCount;
+				const uint32 x1 = math::min(x * 2 + 1, srcWidth - 1) * kChannelCount;
+
+				for (uint32 channelId = 0; channelId < kChannelCount; channelId++)
+				{
+					T& dest = destRow[x * kChannelCount + channelId];
+					if constexpr (std::is_same_v<T, uint8>)
+					{
+						if (srgbChannelMask & (1U << channelId))
+						{
+							const float sum =
+								((tables.decode[srcRow0[x0 + channelId]] + tables.decode[srcRow0[x1 + channelId]])
+								+ tables.decode[srcRow1[x0 + channelId]])
+								+ tables.decode[srcRow1[x1 + channelId]];
+
+							dest = encode(tables, sum * 0.25f);
+							continue;
+						}
+					}
+
+					const uint32 sum = uint32(srcRow0[x0 + channelId]) + uint32(srcRow0[x1 + channelId]) + uint32(srcRow1[x0 + channelId]) + uint32(srcRow1[x1 + channelId]);
+					dest = T(sum >> 2);
+				}
+			}
+		}
+
+		template<typename T>
+		static void downsampleRows(
+			uint32 channelCount,
+			const T* pSrcData,
+			uint32 srcWidth,
+			uint32 srcHeight,
+			T* pDestData,
+			uint32 destWidth,
+			uint32 srgbChannelMask,
+			const SRGBTables& tables,
+			uint32 rowStart,
+			uint32 rowEnd)
+		{
+			const uint64 srcRowSize = uint64(srcWidth) * channelCount;
+			const uint64 destRowSize = uint64(destWidth) * channelCount;
+
+			for (uint32 y = rowStart; y < rowEnd; y++)
+			{
+				const T* srcRow0 = pSrcData + math::min(y * 2 + 0, srcHeight - 1) * srcRowSize;
+				const T* srcRow1 = pSrcData + math::min(y * 2 + 1, srcHeight - 1) * srcRowSize;
+				T* destRow = pDestData + y * destRowSize;
+
+				switch (channelCount)
+				{
+				case 1: downsampleRow<T, 1>(srcRow0, srcRow1, srcWidth, destRow, destWidth, srgbChannelMask, tables); break;
+				case 2: downsampleRow<T, 2>(srcRow0, srcRow1, srcWidth, destRow, destWidth, srgbChannelMask, tables); break;
+				case 4: downsampleRow<T, 4>(srcRow0, srcRow1, srcWidth, destRow, destWidth, srgbChannelMask, tables); break;
+				default: checkEntry();
+				}
+			}
+		}
+	}
+
+	float srgbDecode(uint8 value)
+	{
+		return texture_mipmap::getSRGBTables().decode[value];
+	}
+
+	uint8 srgbEncode(float linear)
+	{
+		return texture_mipmap::encode(texture_mipmap::getSRGBTables(), linear);
+	}
+
+	uint8 srgbEncodeReference(float linear)
+	{
+		return uint8(double(rec709GammaEncode(math::min(linear, 1.0f))) * 255.0);
+	}
+
+	template<typename T>
+	void buildMipmap(
+		uint32 channelCount,
+		uint32 pixelOffsetPerSample,
+		const T* srcPixels,
+		uint32 mipmapCount,
+		uint32 width,
+		uint32 height,
+		bool bSRGB,
+		std::vector<std::vector<uint8>>& outMipmapDatas)
+	{
+		if (sTextureMipmapParallel == 0)
+		{
+			buildMipmapReference<T>(channelCount, pixelOffsetPerSample, srcPixels, mipmapCount, width, height, bSRGB, outMipmapDatas);
+			return;
+		}
+
+		texture_mipmap::checkParams(channelCount, pixelOffsetPerSample, bSRGB, std::is_same_v<T, uint8>);
+
+		const auto& tables = texture_mipmap::getSRGBTables();
+		const uint32 srgbChannelMask = texture_mipmap::getSRGBChannelMask(channelCount, pixelOffsetPerSample, bSRGB);
+
+		outMipmapDatas.resize(mipmapCount);
+		for (uint32 mip = 0; mip < mipmapCount; mip++)
+		{
+			const uint32 destWidth  = math::max<uint32>(width  >> mip, 1);
+			const uint32 destHeight = math::max<uint32>(height >> mip, 1);
+			if (mip == 0)
+			{
+				texture_mipmap::copyMip0(channelCount, pixelOffsetPerSample, srcPixels, destWidth, destHeight, outMipmapDatas[mip]);
+				continue;
+			}
+
+			const uint32 srcWidth  = math::max<uint32>(width  >> (mip - 1), 1);
+			const uint32 srcHeight = math::max<uint32>(height >> (mip - 1), 1);
+
+			auto& destMipData = outMipmapDatas[mip];
+			destMipData.resize(uint64(destWidth) * destHeight * channelCount * sizeof(T));
+
+			const T* pSrcData = (const T*)outMipmapDatas[mip - 1].data();
+			T* pDestData = (T*)destMipData.data();
+
+			auto downsample = [&](const uint32 loopStart, const uint32 loopEnd)
+			{
+				texture_mipmap::downsampleRows<T>(channelCount, pSrcData, srcWidth, srcHeight, pDestData, destWidth, srgbChannelMask, tables, loopStart, loopEnd);
+			};
+
+			if (destHeight >= texture_mipmap::kParallelMinRowCount)
+			{
+				jobsystem::parallelFor("TextureMipmap", EBusyWaitType::All, destHeight, EJobFlags::Foreground, downsample);
+			}
+			else
+			{
+				downsample(0, destHeight);
+			}
+		}
+	}
+
+	template<typename T>
+	void buildMipmapReference(
+		uint32 channelCount,
+		uint32 pixelOffsetPerSample,
+		const T* srcPixels,
+		uint32 mipmapCount,
+		uint32 width,
+		uint32 height,
+		bool bSRGB,
+		std::vector<std::vector<uint8>>& outMipmapDatas)
+	{
+		texture_mipmap::checkParams(channelCount, pixelOffsetPerSample, bSRGB, std::is_same_v<T, uint8>);
+
+		outMipmapDatas.resize(mipmapCount);
+		for (uint32 mip = 0; mip < mipmapCount; mip++)
+		{
+			const uint32 destWidth  = math::max<uint32>(width  >> mip, 1);
+			const uint32 destHeight = math::max<uint32>(height >> mip, 1);
+			if (mip == 0)
+			{
+				texture_mipmap::copyMip0(channelCount, pixelOffsetPerSample, srcPixels, destWidth, destHeight, outMipmapDatas[mip]);
+				continue;
+			}
+
+			const uint32 srcWidth  = math::max<uint32>(width  >> (mip - 1), 1);
+			const uint32 srcHeight = math::max<uint32>(height >> (mip - 1), 1);
+
+			auto& destMipData = outMipmapDatas[mip];
+			destMipData.resize(uint64(destWidth) * destHeight * channelCount * sizeof(T));
+
+			const T* pSrcData = (const T*)outMipmapDatas[mip - 1].data();
+			T* pDestData = (T*)destMipData.data();
+
+			for (uint32 y = 0; y < destHeight; y++)
+			{
+				for (uint32 x = 0; x < destWidth; x++)
+				{
+					// Clamp src data fetch edge.
+					const uint32 srcX0 = math::min(x * 2 + 0, srcWidth  - 1);
+					const uint32 srcX1 = math::min(x * 2 + 1, srcWidth  - 1);
+					const uint32 srcY0 = math::min(y * 2 + 0, srcHeight - 1);
+					const uint32 srcY1 = math::min(y * 2 + 1, srcHeight - 1);
+
+					const uint64 srcPixelStart[] =
+					{
+						(uint64(srcY0) * srcWidth + srcX0) * channelCount, // X0Y0
+						(uint64(srcY0) * srcWidth + srcX1) * channelCount, // X1Y0
+						(uint64(srcY1) * srcWidth + srcX0) * channelCount, // X0Y1
+						(uint64(srcY1) * srcWidth + srcX1) * channelCount, // X1Y1
+					};
+
+					const uint64 destPixelPosStart = (uint64(y) * destWidth + x) * channelCount;
+					for (uint32 channelId = 0; channelId < channelCount; channelId++)
+					{
+						const bool bAlphaChannel = (channelId + pixelOffsetPerSample == 3);
+						if (bSRGB && !bAlphaChannel)
+						{
+							float sum = 0.0f;
+							for (uint32 srcPixelId = 0; srcPixelId < 4; srcPixelId++)
+							{
+								sum += texture_mipmap::decodeReference(uint8(pSrcData[srcPixelStart[srcPixelId] + channelId]));
+							}
+							pDestData[destPixelPosStart + channelId] = T(srgbEncodeReference(sum * 0.25f));
+						}
+						else
+						{
+							uint32 sum = 0;
+							for (uint32 srcPixelId = 0; srcPixelId < 4; srcPixelId++)
+							{
+								sum += uint32(pSrcData[srcPixelStart[srcPixelId] + channelId]);
+							}
+							pDestData[destPixelPosStart + channelId] = T(sum >> 2);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	template void buildMipmap<uint8>(uint32, uint32, const uint8*, uint32, uint32, uint32, bool, std::vector<std::vector<uint8>>&);
+	template void buildMipmap<uint16>(uint32, uint32, const uint16*, uint32, uint32, uint32, bool, std::vector<std::vector<uint8>>&);
+	template void buildMipmapReference<uint8>(uint32, uint32, const uint8*, uint32, uint32, uint32, bool, std::vector<std::vector<uint8>>&);
+	template void buildMipmapReference<uint16>(uint32, uint32, const uint16*, uint32, uint32, uint32, bool, std::vector<std::vector<uint8>>&);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <utils/utils.h>
+
+namespace chord
+{
+	// Box filter mip chain of 1, 2 or 4 channel texture, srgb channels average in linear space and alpha stay linear.
+	// Source pixels always 4 channel, pixelOffsetPerSample select first channel to keep, mip 0 is copy of selected channels.
+	// Srgb convert by lookup tables with float32 accumulation and rows split across job system,
+	// output same as buildMipmapReference bit by bit.
+	template<typename T>
+	void buildMipmap(
+		uint32 channelCount,
+		uint32 pixelOffsetPerSample,
+		const T* srcPixels,
+		uint32 mipmapCount,
+		uint32 width,
+		uint32 height,
+		bool bSRGB,
+		std::vector<std::vector<uint8>>& outMipmapDatas);
+
+	// Single thread per sample pow path, keep for validation and benchmark.
+	template<typename T>
+	void buildMipmapReference(
+		uint32 channelCount,
+		uint32 pixelOffsetPerSample,
+		const T* srcPixels,
+		uint32 mipmapCount,
+		uint32 width,
+		uint32 height,
+		bool bSRGB,
+		std::vector<std::vector<uint8>>& outMipmapDatas);
+
+	// Srgb uint8 to linear by table, same as rec709GammaDecode(value / 255).
+	extern float srgbDecode(uint8 value);
+
+	// Linear to srgb uint8 by threshold table search, same as srgbEncodeReference.
+	extern uint8 srgbEncode(float linear);
+
+	// Truncated rec709GammaEncode, linear clamp to one.
+	extern uint8 srgbEncodeReference(float linear);
+}
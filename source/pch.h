@@ -41,6 +41,7 @@
 #include <execution>
 #include <regex>
 #include <shared_mutex>
+#include <span>
 
 // GLM math library config.
 // 0. glm force compute on radians.
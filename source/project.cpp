@@ -44,8 +44,11 @@ namespace chord
 		LoggerSystem::get().updateLoggerWriterAnyThread();
 		LoggerSystem::cleanDiskSavedLogFile(2);
 
-		const auto titleName = getAppTitleName();
-		glfwSetWindowTitle(Application::get().getWindowData().window, titleName.c_str());
+		if (!Application::get().isHeadless())
+		{
+			const auto titleName = getAppTitleName();
+			glfwSetWindowTitle(Application::get().getWindowData().window, titleName.c_str());
+		}
 
 		// Final update setup state.
 		m_bSetup = true;
@@ -41,7 +41,7 @@ namespace chord
 	void GLTFMeshComponent::reloadMesh()
 	{
 		m_cachedDrawCommandNeedLoading = true;
-		m_gltfAsset = Application::get().getAssetManager().getOrLoadAsset<GLTFAsset>(m_gltfAssetInfo.path(), true);
+		m_gltfAsset = Application::get().getAssetManager().getOrLoadAsset<GLTFAsset>(m_gltfAssetInfo.path());
 		m_gltfGPU = m_gltfAsset->getGPUPrimitives_AnyThread();
 	}
 
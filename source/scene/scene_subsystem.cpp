@@ -1,5 +1,7 @@
 #include <scene/scene_subsystem.h>
 #include <asset/asset.h>
+#include <asset/asset_prefetch.h>
+#include <graphics/graphics.h>
 #include <project.h>
 #include <scene/component/component_gltf_mesh.h>
 #include <scene/component/component_transform.h>
@@ -31,6 +33,16 @@ namespace chord
 			getActiveScene()->tick(tickData.appTickDaata);
 		}
 
+		// Scene assets all upload after postLoad, first frame no pending upload is the first full frame.
+		if (m_bWaitFirstFullFrame && !graphics::getContext().getAsyncUploader().busy())
+		{
+			m_bWaitFirstFullFrame = false;
+
+			const double seconds = assetprefetch::endSceneOpen();
+			LOG_INFO("Scene '{}' first full frame after {:.3f} s, prefetch {} assets.",
+				m_scene.lock()->getSaveInfo().getName().u8(), seconds, m_prefetchCount);
+		}
+
 		return true;
 	}
 
@@ -65,6 +77,12 @@ namespace chord
 	{
 		if (auto scene = m_scene.lock())
 		{
+			if (m_bWaitFirstFullFrame)
+			{
+				m_bWaitFirstFullFrame = false;
+				assetprefetch::cancel();
+			}
+
 			// Active scene switch now.
 			onSceneUnload.broadcast(scene);
 
@@ -83,16 +101,21 @@ namespace chord
 			releaseScene();
 		}
 
-		if (auto newScene = Application::get().getAssetManager().getOrLoadAsset<Scene>(loadPath, true))
+		// Prefetch overlap with scene construction below.
+		m_prefetchCount = assetprefetch::beginSceneOpen(loadPath);
+
+		if (auto newScene = Application::get().getAssetManager().getOrLoadAsset<Scene>(loadPath))
 		{
 			m_scene = newScene;
 
 			newScene->postLoad();
 			onSceneLoad.broadcast(newScene);
 
+			m_bWaitFirstFullFrame = true;
 			return true;
 		}
 
+		assetprefetch::cancel();
 		return false;
 	}
 }
\ No newline at end of file
@@ -72,6 +72,10 @@ namespace chord
 	private:
 		SceneWeak m_scene;
 
+		// Scene open wait first full frame, all scene assets upload finish.
+		bool m_bWaitFirstFullFrame = false;
+		uint32 m_prefetchCount = 0;
+
 		// Static const registered component infos.
 		std::unordered_map<std::string, const UIComponentDrawDetails*> m_registeredComponentUIDrawDetails;
 
@@ -8,8 +8,6 @@
 	#include <wrl.h>
 	#include <dxc/dxcapi.h>
 	#include <dxc/d3d12shader.h>
-#else
-	#error "Shader compiler current only support windows."
 #endif 
 
 namespace chord::graphics
@@ -263,7 +261,20 @@ namespace chord::graphics
 	};
 	using PlatformShaderCompiler = Win32DxcShaderCompiler;
 #else
-	#error "Shader compiler current only implement windows."
+	// Dxc only integrate on windows now, other platform only run headless cooker which never compile shader.
+	class NullShaderCompiler final : public IPlatformShaderCompiler
+	{
+	public:
+		virtual void compileShader(
+			SizedBuffer shaderData,
+			const std::vector<std::string>& args,
+			ShaderCompileResult& result) const override
+		{
+			result.bSuccess = false;
+			result.errorMsg = "Shader compiler current only implement windows.";
+		}
+	};
+	using PlatformShaderCompiler = NullShaderCompiler;
 #endif 
 
 	ShaderCompilerManager::ShaderCompilerManager(uint32 freeCount, uint32 desiredMaxCompileThreadCount)
@@ -46,18 +46,36 @@ namespace chord
 	{
 		clear();
 
-		// Remodify component.
-		m_component = getComponentFromChannelRemapType(remapType);
-		m_dimension.z = 1;
+		int component;
+		int32 width, height;
+		auto* pixels = stbi_load(path.c_str(), &width, &height, &component, 4);
+
+		return fillFromPixels(pixels, width, height, remapType);
+	}
+
+	bool ImageLdr2D::fillFromMemory(const uint8* data, uint64 size, EImageChannelRemapType remapType)
+	{
+		clear();
 
 		int component;
-		auto* pixels = stbi_load(path.c_str(), &m_dimension.x, &m_dimension.y, &component, 4);
+		int32 width, height;
+		auto* pixels = stbi_load_from_memory(data, int32(size), &width, &height, &component, 4);
+
+		return fillFromPixels(pixels, width, height, remapType);
+	}
+
+	bool ImageLdr2D::fillFromPixels(uint8* pixels, int32 width, int32 height, EImageChannelRemapType remapType)
+	{
 		if (pixels == nullptr)
 		{
 			clear();
 			return false;
 		}
 
+		// Remodify component.
+		m_component = getComponentFromChannelRemapType(remapType);
+		m_dimension = { width, height, 1 };
+
 		//
 		m_pixels.resize(m_dimension.x * m_dimension.y * m_component);
 
@@ -91,7 +91,14 @@ namespace chord
 		void fillChessboard(RGBA c0, RGBA c1, int32 width, int32 height, int32 blockDim);
 		bool fillFromFile(const std::string& path, EImageChannelRemapType remapType = EImageChannelRemapType::eRGBA);
 
+		// Decode encoded image bytes (png, jpg...) in memory.
+		bool fillFromMemory(const uint8* data, uint64 size, EImageChannelRemapType remapType = EImageChannelRemapType::eRGBA);
+
 		virtual ~ImageLdr2D(){ }
+
+	private:
+		// Take stbi rgba pixels and free them.
+		bool fillFromPixels(uint8* pixels, int32 width, int32 height, EImageChannelRemapType remapType);
 	public:
 		template<class Ar> void serialize(Ar& ar, uint32 ver)
 		{
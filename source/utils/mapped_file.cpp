@@ -0,0 +1,110 @@
+#include <utils/mapped_file.h>
+#include <utils/log.h>
+
+#ifdef _WIN32
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+namespace chord
+{
+	MappedFile::~MappedFile()
+	{
+		close();
+	}
+
+	bool MappedFile::open(const std::filesystem::path& path)
+	{
+		close();
+
+	#ifdef _WIN32
+		HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			return false;
+		}
+
+		LARGE_INTEGER fileSize { };
+		if (!::GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			::CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr)
+		{
+			::CloseHandle(file);
+			return false;
+		}
+
+		void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (view == nullptr)
+		{
+			::CloseHandle(mapping);
+			::CloseHandle(file);
+			return false;
+		}
+
+		m_fileHandle    = file;
+		m_mappingHandle = mapping;
+		m_data = (const uint8*)view;
+		m_size = (uint64)fileSize.QuadPart;
+	#else
+		int32 fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return false;
+		}
+
+		struct stat fileStat { };
+		if (::fstat(fd, &fileStat) != 0 || fileStat.st_size == 0)
+		{
+			::close(fd);
+			return false;
+		}
+
+		void* view = ::mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (view == MAP_FAILED)
+		{
+			::close(fd);
+			return false;
+		}
+
+		m_fileDescriptor = fd;
+		m_data = (const uint8*)view;
+		m_size = (uint64)fileStat.st_size;
+	#endif
+
+		return true;
+	}
+
+	void MappedFile::close()
+	{
+		if (m_data == nullptr)
+		{
+			return;
+		}
+
+	#ifdef _WIN32
+		::UnmapViewOfFile(m_data);
+		::CloseHandle((HANDLE)m_mappingHandle);
+		::CloseHandle((HANDLE)m_fileHandle);
+
+		m_mappingHandle = nullptr;
+		m_fileHandle    = nullptr;
+	#else
+		::munmap((void*)m_data, (size_t)m_size);
+		::close(m_fileDescriptor);
+
+		m_fileDescriptor = -1;
+	#endif
+
+		m_data = nullptr;
+		m_size = 0;
+	}
+}
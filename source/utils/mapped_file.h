@@ -0,0 +1,46 @@
+#pragma once
+
+#include <utils/utils.h>
+
+namespace chord
+{
+	// Read only memory mapped file, mapping keep valid until close or destruct.
+	class MappedFile : NonCopyable
+	{
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		// Map whole file into process address space, return false if fail.
+		bool open(const std::filesystem::path& path);
+
+		// Unmap and close file handle.
+		void close();
+
+		bool isValid() const
+		{
+			return m_data != nullptr;
+		}
+
+		const uint8* data() const
+		{
+			return m_data;
+		}
+
+		uint64 size() const
+		{
+			return m_size;
+		}
+
+	private:
+		const uint8* m_data = nullptr;
+		uint64 m_size = 0;
+
+	#if _WIN32
+		void* m_fileHandle = nullptr;
+		void* m_mappingHandle = nullptr;
+	#else
+		int32 m_fileDescriptor = -1;
+	#endif
+	};
+}
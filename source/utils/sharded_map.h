@@ -0,0 +1,185 @@
+#pragma once
+#include <utils/utils.h>
+#include <utils/job_system.h>
+
+namespace chord
+{
+	// Concurrent hash map split into shards, each shard own a mutex so different keys rarely contend.
+	// getOrLoad run loader outside of lock, and concurrent request of same key busy wait on the in-flight future,
+	// so one key only load once and different keys load in parallel. Waiter help job system instead of block worker.
+	template<typename KeyType, typename ValueType, uint32 kShardCount = 64>
+	class ShardedMap : NonCopyable
+	{
+	public:
+		static_assert(kShardCount > 0 && (kShardCount & (kShardCount - 1)) == 0, "Shard count must be power of two.");
+
+		// Return default value if key no exist.
+		ValueType find(const KeyType& key) const
+		{
+			const auto& shard = getShard(key);
+			std::lock_guard lock(shard.mutex);
+
+			auto iter = shard.map.find(key);
+			return iter != shard.map.end() ? iter->second : ValueType { };
+		}
+
+		bool contains(const KeyType& key) const
+		{
+			const auto& shard = getShard(key);
+			std::lock_guard lock(shard.mutex);
+
+			return shard.map.contains(key);
+		}
+
+		// Return false if key already exist or is loading.
+		bool insert(const KeyType& key, ValueType value)
+		{
+			auto& shard = getShard(key);
+			std::lock_guard lock(shard.mutex);
+
+			if (shard.loadings.contains(key))
+			{
+				return false;
+			}
+			return shard.map.emplace(key, std::move(value)).second;
+		}
+
+		// Return erased value, default value if key no exist.
+		ValueType erase(const KeyType& key)
+		{
+			auto& shard = getShard(key);
+			std::lock_guard lock(shard.mutex);
+
+			auto iter = shard.map.find(key);
+			if (iter == shard.map.end())
+			{
+				return ValueType { };
+			}
+
+			ValueType result = std::move(iter->second);
+			shard.map.erase(iter);
+			return result;
+		}
+
+		// Loader return default value when fail, failed result never insert so next request retry.
+		// bOutLoaded is true only for the caller which really run loader and insert.
+		// Loader exception clear the in-flight entry, rethrow to caller and every waiter of same key.
+		template<typename Loader>
+		ValueType getOrLoad(const KeyType& key, Loader&& loader, bool& bOutLoaded)
+		{
+			bOutLoaded = false;
+
+			auto& shard = getShard(key);
+			std::promise<ValueType> promise;
+			std::shared_future<ValueType> inflight;
+			{
+				std::lock_guard lock(shard.mutex);
+				if (auto iter = shard.map.find(key); iter != shard.map.end())
+				{
+					return iter->second;
+				}
+
+				if (auto iter = shard.loadings.find(key); iter != shard.loadings.end())
+				{
+					inflight = iter->second;
+				}
+				else
+				{
+					shard.loadings.emplace(key, promise.get_future().share());
+				}
+			}
+
+			// Other thread is loading, wait outside of lock. Loader may wait on jobs, so execute jobs when wait.
+			if (inflight.valid())
+			{
+				jobsystem::busyWaitUntil([&inflight]()
+				{
+					return inflight.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+				}, EBusyWaitType::All);
+				return inflight.get();
+			}
+
+			// No lock when load.
+			ValueType result { };
+			try
+			{
+				result = loader();
+			}
+			catch (...)
+			{
+				{
+					std::lock_guard lock(shard.mutex);
+					shard.loadings.erase(key);
+				}
+
+				promise.set_exception(std::current_exception());
+				throw;
+			}
+
+			{
+				std::lock_guard lock(shard.mutex);
+				shard.loadings.erase(key);
+
+				if (result != ValueType { })
+				{
+					shard.map.emplace(key, result);
+					bOutLoaded = true;
+				}
+			}
+
+			promise.set_value(result);
+			return result;
+		}
+
+		size_t size() const
+		{
+			size_t result = 0;
+			for (const auto& shard : m_shards)
+			{
+				std::lock_guard lock(shard.mutex);
+				result += shard.map.size();
+			}
+			return result;
+		}
+
+		void clear()
+		{
+			for (auto& shard : m_shards)
+			{
+				std::lock_guard lock(shard.mutex);
+				check(shard.loadings.empty());
+
+				shard.map.clear();
+			}
+		}
+
+	private:
+		// Cache line align avoid false sharing between shard mutex.
+		struct alignas(kCpuCachelineSize) Shard
+		{
+			mutable std::mutex mutex;
+			std::unordered_map<KeyType, ValueType> map;
+			std::unordered_map<KeyType, std::shared_future<ValueType>> loadings;
+		};
+
+		Shard& getShard(const KeyType& key)
+		{
+			return m_shards[getShardIndex(key)];
+		}
+
+		const Shard& getShard(const KeyType& key) const
+		{
+			return m_shards[getShardIndex(key)];
+		}
+
+		static uint32 getShardIndex(const KeyType& key)
+		{
+			// Mix high bits, key may already be a hash with poor low bits.
+			const uint64 hash = std::hash<KeyType>{ }(key);
+			return uint32((hash ^ (hash >> 29) ^ (hash >> 47)) & (kShardCount - 1));
+		}
+
+	private:
+		std::array<Shard, kShardCount> m_shards;
+	};
+}
@@ -4,6 +4,7 @@
 #include <application/application.h>
 
 #include <utils/work_stealing_queue.h>
+#include <csignal>
 
 #define UUID_SYSTEM_GENERATOR
 #include <stduuid/uuid.h>
@@ -245,7 +246,11 @@ namespace chord
 	{
 		if (isDebuggerAttach())
 		{
+		#if _WIN32
 			__debugbreak();
+		#else
+			std::raise(SIGTRAP);
+		#endif
 		}
 		else
 		{
@@ -122,6 +122,12 @@ do { static bool b = false; if(!b && !(x)) { b = true; p("Ensure '{4}' failed wi
 	template<class Ar>                                                                   \
 	void chord::AssetNameXX::serialize(Ar& ar, std::uint32_t const version)
 
+// Basic class with own version, append member behind version check keep old archive loadable.
+#define registerPODClassMemberVersion(AssetNameXX, Version)                              \
+	CEREAL_CLASS_VERSION(chord::AssetNameXX, Version);                                   \
+	template<class Ar>                                                                   \
+	void chord::AssetNameXX::serialize(Ar& ar, std::uint32_t const version)
+
 #define REGISTER_BODY_DECLARE(...)  \
 	ARCHIVE_DECLARE                 \
 	RTTR_ENABLE(__VA_ARGS__);       \
@@ -456,6 +462,15 @@ namespace chord
 	extern std::wstring_view getCurrentThreadName();
 	extern void namedCurrentThread(const std::wstring& name);
 
+	struct ProcessMemoryInfo
+	{
+		uint64 residentBytes = 0;
+		uint64 peakResidentBytes = 0;
+	};
+
+	// Resident memory of current process, zero if platform not support.
+	extern ProcessMemoryInfo getProcessMemoryInfo();
+
 	extern void reportCrash();
 	extern void reportBreakpoint();
 
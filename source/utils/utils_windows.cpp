@@ -4,6 +4,11 @@
 	#include <windows.h>
 	#include <dbghelp.h>
 	#include <consoleapi2.h>
+	#include <psapi.h>
+#else
+	#include <sys/resource.h>
+	#include <unistd.h>
+	#include <pthread.h>
 #endif
 
 void chord::setConsoleUtf8()
@@ -55,6 +60,10 @@ void chord::namedCurrentThread(const std::wstring& name)
 	sThreadName = name;
 #if _WIN32
 	SetThreadDescription(GetCurrentThread(), name.c_str());
+#else
+	// Linux thread name max 15 chars without null terminator, name is ascii.
+	std::string shortName(name.begin(), name.begin() + std::min<size_t>(name.size(), 15));
+	::pthread_setname_np(::pthread_self(), shortName.c_str());
 #endif
 }
 
@@ -72,6 +81,16 @@ bool chord::isDebuggerAttach()
 
 	return IsDebuggerPresent();
 #else 
+	// Tracer pid is non zero when debugger attach.
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+	{
+		if (line.starts_with("TracerPid:"))
+		{
+			return std::stoi(line.substr(10)) != 0;
+		}
+	}
 	return false;
 #endif 
 }
@@ -105,4 +124,34 @@ bool chord::createDump(bool bFullDump, const std::wstring& dumpFilePath)
 #else 
 	return false;
 #endif
-}
\ No newline at end of file
+}
+
+chord::ProcessMemoryInfo chord::getProcessMemoryInfo()
+{
+	ProcessMemoryInfo result { };
+#if _WIN32
+	PROCESS_MEMORY_COUNTERS counters { };
+	if (::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		result.residentBytes = counters.WorkingSetSize;
+		result.peakResidentBytes = counters.PeakWorkingSetSize;
+	}
+#else
+	// Second field of statm is resident pages.
+	std::ifstream statm("/proc/self/statm");
+	uint64 sizePages = 0;
+	uint64 residentPages = 0;
+	if (statm >> sizePages >> residentPages)
+	{
+		result.residentBytes = residentPages * uint64(::sysconf(_SC_PAGESIZE));
+	}
+
+	// Linux report max resident in KB.
+	rusage usage { };
+	if (::getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+		result.peakResidentBytes = uint64(usage.ru_maxrss) * 1024;
+	}
+#endif
+	return result;
+}